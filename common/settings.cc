@@ -62,6 +62,20 @@ std::string Settings::ToString() const {
   stream << "frame_rasterized_callback set: " << !!frame_rasterized_callback
          << std::endl;
   stream << "old_gen_heap_size: " << old_gen_heap_size << std::endl;
+  stream << "text_layout_cache_bytes: " << text_layout_cache_bytes
+         << std::endl;
+  for (const auto& [locale, path] : hyphenation_dictionaries) {
+    stream << "hyphenation_dictionaries[" << locale << "]: " << path
+           << std::endl;
+  }
+  stream << "animated_image_decode_ahead_frames: "
+         << animated_image_decode_ahead_frames << std::endl;
+  stream << "animated_image_frame_cache_bytes: "
+         << animated_image_frame_cache_bytes << std::endl;
+  stream << "image_upload_budget_bytes: " << image_upload_budget_bytes
+         << std::endl;
+  stream << "image_memory_ceiling_bytes: " << image_memory_ceiling_bytes
+         << std::endl;
   return stream.str();
 }
 
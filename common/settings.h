@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -165,6 +166,38 @@ struct Settings {
   // Selects the SkParagraph implementation of the text layout engine.
   bool enable_skparagraph = false;
 
+  // The memory budget in bytes of the process-wide cache of shaped words used
+  // by the libtxt text layout engine, or 0 for the default budget. This is a
+  // process-wide option: only the value of the first shell created in the
+  // process is used.
+  size_t text_layout_cache_bytes = 0;
+
+  // The paths of the hyphenation pattern dictionaries used by paragraphs that
+  // enable hyphenation, keyed on locale. Relative paths are resolved against
+  // |assets_path|. Dictionaries are shared by all the engines in the process,
+  // and a dictionary already in use is not replaced by a later shell.
+  std::map<std::string, std::string> hyphenation_dictionaries;
+
+  // The number of frames of an animated image decoded ahead of the frame being
+  // displayed, or -1 for the default. This is a process-wide option: only the
+  // value of the first shell created in the process is used.
+  int64_t animated_image_decode_ahead_frames = -1;
+
+  // The memory budget in bytes of the animated images whose decoded frames
+  // are all cached, or -1 for the default. The budget is shared by all the
+  // engines in the process, and only the value of the first shell created in
+  // the process is used.
+  int64_t animated_image_frame_cache_bytes = -1;
+
+  // The memory budget in bytes of the images being decoded or waiting to be
+  // uploaded to the GPU by an engine, or -1 for the default.
+  int64_t image_upload_budget_bytes = -1;
+
+  // The memory in bytes held by the image caches of an engine above which they
+  // are trimmed, or -1 for no ceiling. Live images and images being decoded
+  // cannot be trimmed, so they do not count.
+  int64_t image_memory_ceiling_bytes = -1;
+
   // Selects the DisplayList for storage of rendering operations.
   bool enable_display_list = false;
 
@@ -182,6 +215,11 @@ struct Settings {
   // associated resources.
   bool leak_vm = true;
 
+  // Lets independent steps of shell creation, like ICU initialization, Skia
+  // initialization and snapshot mapping, run concurrently on the IO and
+  // raster task runners of the shell.
+  bool enable_concurrent_startup = true;
+
   // Engine settings
   TaskObserverAdd task_observer_add;
   TaskObserverRemove task_observer_remove;
@@ -249,6 +249,19 @@ bool RasterCache::Prepare(GrDirectContext* context,
     return false;
   }
   if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    // A picture that is otherwise ready to be cached is left for
+    // |PrepareNextDeferred|.
+    PictureRasterCacheKey cache_key(picture->uniqueID(),
+                                    transformation_matrix);
+    auto found = picture_cache_.find(cache_key);
+    if (found != picture_cache_.end() && !found->second.image &&
+        found->second.access_count >= access_threshold_ &&
+        IsPictureWorthRasterizing(picture, will_change, is_complex) &&
+        MatrixDecomposition(transformation_matrix).IsValid()) {
+      deferred_pictures_[cache_key] = {sk_ref_sp(picture),
+                                       transformation_matrix,
+                                       sk_ref_sp(dst_color_space)};
+    }
     return false;
   }
   if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
@@ -293,6 +306,19 @@ bool RasterCache::Prepare(GrDirectContext* context,
     return false;
   }
   if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    // A display list that is otherwise ready to be cached is left for
+    // |PrepareNextDeferred|.
+    DisplayListRasterCacheKey cache_key(display_list->unique_id(),
+                                        transformation_matrix);
+    auto found = display_list_cache_.find(cache_key);
+    if (found != display_list_cache_.end() && !found->second.image &&
+        found->second.access_count >= access_threshold_ &&
+        IsDisplayListWorthRasterizing(display_list, will_change, is_complex) &&
+        MatrixDecomposition(transformation_matrix).IsValid()) {
+      deferred_display_lists_[cache_key] = {sk_ref_sp(display_list),
+                                            transformation_matrix,
+                                            sk_ref_sp(dst_color_space)};
+    }
     return false;
   }
   if (!IsDisplayListWorthRasterizing(display_list, will_change, is_complex)) {
@@ -328,6 +354,40 @@ bool RasterCache::Prepare(GrDirectContext* context,
   return true;
 }
 
+bool RasterCache::PrepareNextDeferred(GrDirectContext* context) {
+  while (!deferred_pictures_.empty()) {
+    auto deferred = deferred_pictures_.extract(deferred_pictures_.begin());
+    auto found = picture_cache_.find(deferred.key());
+    // A later frame may have cached the picture in the meantime.
+    if (found == picture_cache_.end() || found->second.image) {
+      continue;
+    }
+    const DeferredPicture& picture = deferred.mapped();
+    found->second.image =
+        RasterizePicture(picture.picture.get(), context, picture.matrix,
+                         picture.dst_color_space.get(), checkerboard_images_);
+    return true;
+  }
+  while (!deferred_display_lists_.empty()) {
+    auto deferred =
+        deferred_display_lists_.extract(deferred_display_lists_.begin());
+    auto found = display_list_cache_.find(deferred.key());
+    if (found == display_list_cache_.end() || found->second.image) {
+      continue;
+    }
+    const DeferredDisplayList& display_list = deferred.mapped();
+    found->second.image = RasterizeDisplayList(
+        display_list.display_list.get(), context, display_list.matrix,
+        display_list.dst_color_space.get(), checkerboard_images_);
+    return true;
+  }
+  return false;
+}
+
+size_t RasterCache::GetDeferredEntriesCount() const {
+  return deferred_pictures_.size() + deferred_display_lists_.size();
+}
+
 bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
   PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
   auto it = picture_cache_.find(cache_key);
@@ -393,6 +453,8 @@ void RasterCache::SweepAfterFrame() {
   SweepOneCacheAfterFrame(picture_cache_);
   SweepOneCacheAfterFrame(display_list_cache_);
   SweepOneCacheAfterFrame(layer_cache_);
+  SweepDeferredAfterFrame(picture_cache_, deferred_pictures_);
+  SweepDeferredAfterFrame(display_list_cache_, deferred_display_lists_);
   picture_cached_this_frame_ = 0;
   TraceStatsToTimeline();
 }
@@ -401,6 +463,8 @@ void RasterCache::Clear() {
   picture_cache_.clear();
   display_list_cache_.clear();
   layer_cache_.clear();
+  deferred_pictures_.clear();
+  deferred_display_lists_.clear();
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
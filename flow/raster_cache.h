@@ -12,7 +12,9 @@
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkSize.h"
 
 namespace flutter {
@@ -138,7 +140,9 @@ class RasterCache {
   // 2. The matrix is singular
   // 3. The picture is accessed too few times
   // 4. There are too many pictures to be cached in the current frame.
-  //    (See also kDefaultPictureCacheLimitPerFrame.)
+  //    (See also kDefaultPictureCacheLimitPerFrame.) Pictures that are
+  //    otherwise ready to be cached are then deferred until
+  //    |PrepareNextDeferred| is called.
   bool Prepare(GrDirectContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -154,6 +158,18 @@ class RasterCache {
 
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
+  // Rasterizes one of the pictures or display lists that were ready to be
+  // cached but went over the per-frame limit, so that the frames that follow
+  // can draw it from the cache. This lets the caller populate the cache when
+  // the frame budget has room for it, rather than one frame's limit at a time.
+  //
+  // Return true if an entry was rasterized, and false if none was deferred.
+  bool PrepareNextDeferred(GrDirectContext* context);
+
+  // Returns the number of pictures and display lists waiting for
+  // |PrepareNextDeferred|.
+  size_t GetDeferredEntriesCount() const;
+
   // Find the raster cache for the picture and draw it to the canvas.
   //
   // Return true if it's found and drawn.
@@ -225,6 +241,30 @@ class RasterCache {
     std::unique_ptr<RasterCacheResult> image;
   };
 
+  struct DeferredPicture {
+    sk_sp<SkPicture> picture;
+    SkMatrix matrix;
+    sk_sp<SkColorSpace> dst_color_space;
+  };
+
+  struct DeferredDisplayList {
+    sk_sp<DisplayList> display_list;
+    SkMatrix matrix;
+    sk_sp<SkColorSpace> dst_color_space;
+  };
+
+  // Drops the deferred entries whose cache entries were swept.
+  template <class Cache, class Deferred>
+  static void SweepDeferredAfterFrame(const Cache& cache, Deferred& deferred) {
+    for (auto it = deferred.begin(); it != deferred.end();) {
+      if (cache.find(it->first) == cache.end()) {
+        it = deferred.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   template <class Cache>
   static void SweepOneCacheAfterFrame(Cache& cache) {
     std::vector<typename Cache::iterator> dead;
@@ -248,6 +288,8 @@ class RasterCache {
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable DisplayListRasterCacheKey::Map<Entry> display_list_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
+  PictureRasterCacheKey::Map<DeferredPicture> deferred_pictures_;
+  DisplayListRasterCacheKey::Map<DeferredDisplayList> deferred_display_lists_;
   bool checkerboard_images_;
 
   void TraceStatsToTimeline() const;
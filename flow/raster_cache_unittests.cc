@@ -103,6 +103,74 @@ TEST(RasterCache, PictureCacheLimitPerFrameIsRespectedWhenZero) {
   ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
 }
 
+TEST(RasterCache, DefersPicturesOverTheLimitPerFrame) {
+  size_t threshold = 1;
+  size_t picture_cache_limit_per_frame = 1;
+  flutter::RasterCache cache(threshold, picture_cache_limit_per_frame);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto first_picture = GetSamplePicture();
+  auto second_picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, first_picture.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(cache.Prepare(NULL, second_picture.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(cache.Draw(*first_picture, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*second_picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  // Only the first picture fits in the limit of this frame.
+  ASSERT_TRUE(cache.Prepare(NULL, first_picture.get(), matrix, srgb.get(),
+                            true, false));
+  ASSERT_FALSE(cache.Prepare(NULL, second_picture.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_EQ(cache.GetDeferredEntriesCount(), 1u);
+  ASSERT_FALSE(cache.Draw(*second_picture, dummy_canvas));
+
+  // The second picture is cached when the deferred entries are prepared.
+  ASSERT_TRUE(cache.PrepareNextDeferred(NULL));
+  ASSERT_EQ(cache.GetDeferredEntriesCount(), 0u);
+  ASSERT_FALSE(cache.PrepareNextDeferred(NULL));
+  ASSERT_TRUE(cache.Draw(*first_picture, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*second_picture, dummy_canvas));
+}
+
+TEST(RasterCache, SweepsDropDeferredPicturesThatAreNoLongerUsed) {
+  size_t threshold = 1;
+  size_t picture_cache_limit_per_frame = 1;
+  flutter::RasterCache cache(threshold, picture_cache_limit_per_frame);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto first_picture = GetSamplePicture();
+  auto second_picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  cache.Prepare(NULL, first_picture.get(), matrix, srgb.get(), true, false);
+  cache.Prepare(NULL, second_picture.get(), matrix, srgb.get(), true, false);
+  cache.Draw(*first_picture, dummy_canvas);
+  cache.Draw(*second_picture, dummy_canvas);
+  cache.SweepAfterFrame();
+
+  cache.Prepare(NULL, first_picture.get(), matrix, srgb.get(), true, false);
+  cache.Prepare(NULL, second_picture.get(), matrix, srgb.get(), true, false);
+  ASSERT_EQ(cache.GetDeferredEntriesCount(), 1u);
+
+  // The second picture is not drawn in this frame, so its entry is swept.
+  cache.Draw(*first_picture, dummy_canvas);
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetDeferredEntriesCount(), 0u);
+  ASSERT_FALSE(cache.PrepareNextDeferred(NULL));
+}
+
 TEST(RasterCache, SweepsRemoveUnusedFrames) {
   size_t threshold = 1;
   flutter::RasterCache cache(threshold);
@@ -154,6 +154,13 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
+size_t ConcurrentTaskRunner::GetWorkerCount() const {
+  if (auto loop = weak_loop_.lock()) {
+    return loop->GetWorkerCount();
+  }
+  return 0;
+}
+
 void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   if (!task) {
     return;
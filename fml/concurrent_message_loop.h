@@ -67,6 +67,9 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  // Returns the number of workers of the loop, or zero if it has died.
+  size_t GetWorkerCount() const;
+
  private:
   friend ConcurrentMessageLoop;
 
@@ -298,6 +298,14 @@ TEST(MessageLoop, CanCreateAndShutdownConcurrentMessageLoopsOverAndOver) {
   }
 }
 
+TEST(MessageLoop, ConcurrentTaskRunnerReportsWorkerCount) {
+  auto loop = fml::ConcurrentMessageLoop::Create(3u);
+  auto task_runner = loop->GetTaskRunner();
+  ASSERT_EQ(task_runner->GetWorkerCount(), 3u);
+  loop.reset();
+  ASSERT_EQ(task_runner->GetWorkerCount(), 0u);
+}
+
 TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   auto loop = fml::ConcurrentMessageLoop::Create();
   auto task_runner = loop->GetTaskRunner();
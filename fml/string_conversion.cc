@@ -0,0 +1,344 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/string_conversion.h"
+
+#include <cstdint>
+
+#include "flutter/fml/build_config.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FML_STRING_CONVERSION_SSE2 1
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64) && defined(__ARM_NEON)
+#define FML_STRING_CONVERSION_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace fml {
+
+namespace {
+
+constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+bool IsSurrogate(char16_t unit) {
+  return (unit & 0xF800) == 0xD800;
+}
+
+bool IsLeadSurrogate(char16_t unit) {
+  return (unit & 0xFC00) == 0xD800;
+}
+
+bool IsTrailSurrogate(char16_t unit) {
+  return (unit & 0xFC00) == 0xDC00;
+}
+
+// Returns the number of ASCII bytes at the start of |src|.
+size_t CountLeadingAscii(const uint8_t* src, size_t length) {
+  size_t i = 0;
+#if FML_STRING_CONVERSION_SSE2
+  for (; i + 16 <= length; i += 16) {
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(bytes) != 0) {
+      break;
+    }
+  }
+#elif FML_STRING_CONVERSION_NEON
+  for (; i + 16 <= length; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(src + i)) >= 0x80) {
+      break;
+    }
+  }
+#endif
+  while (i < length && src[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+// Widens the ASCII bytes at the start of |src| into |dst| and returns their
+// number.
+size_t WidenLeadingAscii(const uint8_t* src, size_t length, char16_t* dst) {
+  size_t i = 0;
+#if FML_STRING_CONVERSION_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(bytes) != 0) {
+      break;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_unpacklo_epi8(bytes, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8),
+                     _mm_unpackhi_epi8(bytes, zero));
+  }
+#elif FML_STRING_CONVERSION_NEON
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t bytes = vld1q_u8(src + i);
+    if (vmaxvq_u8(bytes) >= 0x80) {
+      break;
+    }
+    uint16_t* out = reinterpret_cast<uint16_t*>(dst + i);
+    vst1q_u16(out, vmovl_u8(vget_low_u8(bytes)));
+    vst1q_u16(out + 8, vmovl_high_u8(bytes));
+  }
+#endif
+  for (; i < length && src[i] < 0x80; i++) {
+    dst[i] = src[i];
+  }
+  return i;
+}
+
+// Narrows the ASCII code units at the start of |src| into |dst| and returns
+// their number.
+size_t NarrowLeadingAscii(const char16_t* src, size_t length, char* dst) {
+  size_t i = 0;
+#if FML_STRING_CONVERSION_SSE2
+  const __m128i non_ascii_mask = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    const __m128i non_ascii =
+        _mm_and_si128(_mm_or_si128(low, high), non_ascii_mask);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) != 0xFFFF) {
+      break;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(low, high));
+  }
+#elif FML_STRING_CONVERSION_NEON
+  for (; i + 16 <= length; i += 16) {
+    const uint16_t* in = reinterpret_cast<const uint16_t*>(src + i);
+    const uint16x8_t low = vld1q_u16(in);
+    const uint16x8_t high = vld1q_u16(in + 8);
+    if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80) {
+      break;
+    }
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i),
+             vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+  }
+#endif
+  for (; i < length && src[i] < 0x80; i++) {
+    dst[i] = static_cast<char>(src[i]);
+  }
+  return i;
+}
+
+// Returns the number of code units at the start of |src| that aren't
+// surrogates.
+size_t CountLeadingNonSurrogates(const char16_t* src, size_t length) {
+  size_t i = 0;
+#if FML_STRING_CONVERSION_SSE2
+  const __m128i surrogate_mask = _mm_set1_epi16(static_cast<int16_t>(0xF800));
+  const __m128i surrogate_bits = _mm_set1_epi16(static_cast<int16_t>(0xD800));
+  for (; i + 8 <= length; i += 8) {
+    const __m128i units =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i surrogates = _mm_cmpeq_epi16(
+        _mm_and_si128(units, surrogate_mask), surrogate_bits);
+    if (_mm_movemask_epi8(surrogates) != 0) {
+      break;
+    }
+  }
+#elif FML_STRING_CONVERSION_NEON
+  const uint16x8_t surrogate_mask = vdupq_n_u16(0xF800);
+  const uint16x8_t surrogate_bits = vdupq_n_u16(0xD800);
+  for (; i + 8 <= length; i += 8) {
+    const uint16x8_t units =
+        vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+    const uint16x8_t surrogates =
+        vceqq_u16(vandq_u16(units, surrogate_mask), surrogate_bits);
+    if (vmaxvq_u16(surrogates) != 0) {
+      break;
+    }
+  }
+#endif
+  while (i < length && !IsSurrogate(src[i])) {
+    i++;
+  }
+  return i;
+}
+
+// Decodes the UTF-8 sequence at the start of |src|. On success, stores the code
+// point and returns true. Otherwise returns false and |consumed| holds the
+// length of the maximal subpart of the ill-formed sequence. See table 3-7 of
+// the Unicode standard for the well-formed byte ranges.
+bool DecodeUtf8(const uint8_t* src,
+                size_t length,
+                char32_t* code_point,
+                size_t* consumed) {
+  const uint8_t lead = src[0];
+  size_t trail_count;
+  char32_t value;
+  uint8_t lower = 0x80;
+  uint8_t upper = 0xBF;
+  if (lead < 0x80) {
+    *code_point = lead;
+    *consumed = 1;
+    return true;
+  } else if (lead >= 0xC2 && lead <= 0xDF) {
+    trail_count = 1;
+    value = lead & 0x1F;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    trail_count = 2;
+    value = lead & 0x0F;
+    if (lead == 0xE0) {
+      lower = 0xA0;
+    } else if (lead == 0xED) {
+      upper = 0x9F;
+    }
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    trail_count = 3;
+    value = lead & 0x07;
+    if (lead == 0xF0) {
+      lower = 0x90;
+    } else if (lead == 0xF4) {
+      upper = 0x8F;
+    }
+  } else {
+    *consumed = 1;
+    return false;
+  }
+
+  for (size_t i = 1; i <= trail_count; i++) {
+    if (i >= length || src[i] < lower || src[i] > upper) {
+      *consumed = i;
+      return false;
+    }
+    value = (value << 6) | (src[i] & 0x3F);
+    lower = 0x80;
+    upper = 0xBF;
+  }
+  *code_point = value;
+  *consumed = trail_count + 1;
+  return true;
+}
+
+}  // namespace
+
+std::u16string Utf8ToUtf16(std::string_view string) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(string.data());
+  const size_t length = string.size();
+
+  // Every UTF-8 sequence is at least as long as its UTF-16 encoding.
+  std::u16string result(length, u'\0');
+  char16_t* dst = result.data();
+  size_t i = 0;
+  while (i < length) {
+    const size_t ascii = WidenLeadingAscii(src + i, length - i, dst);
+    i += ascii;
+    dst += ascii;
+    if (i == length) {
+      break;
+    }
+
+    char32_t code_point;
+    size_t consumed;
+    if (!DecodeUtf8(src + i, length - i, &code_point, &consumed)) {
+      code_point = kReplacementCharacter;
+    }
+    i += consumed;
+    if (code_point >= 0x10000) {
+      code_point -= 0x10000;
+      *dst++ = static_cast<char16_t>(0xD800 + (code_point >> 10));
+      *dst++ = static_cast<char16_t>(0xDC00 + (code_point & 0x3FF));
+    } else {
+      *dst++ = static_cast<char16_t>(code_point);
+    }
+  }
+  result.resize(dst - result.data());
+  return result;
+}
+
+std::string Utf16ToUtf8(std::u16string_view string) {
+  const char16_t* src = string.data();
+  const size_t length = string.size();
+
+  // A code unit takes at most three bytes in UTF-8. Surrogate pairs take four
+  // bytes for two code units.
+  std::string result(length * 3, '\0');
+  char* dst = result.data();
+  size_t i = 0;
+  while (i < length) {
+    const size_t ascii = NarrowLeadingAscii(src + i, length - i, dst);
+    i += ascii;
+    dst += ascii;
+    if (i == length) {
+      break;
+    }
+
+    char32_t code_point = src[i++];
+    if (IsSurrogate(code_point)) {
+      if (IsLeadSurrogate(code_point) && i < length &&
+          IsTrailSurrogate(src[i])) {
+        code_point =
+            0x10000 + ((code_point - 0xD800) << 10) + (src[i++] - 0xDC00);
+      } else {
+        code_point = kReplacementCharacter;
+      }
+    }
+
+    if (code_point < 0x800) {
+      *dst++ = static_cast<char>(0xC0 | (code_point >> 6));
+    } else {
+      if (code_point < 0x10000) {
+        *dst++ = static_cast<char>(0xE0 | (code_point >> 12));
+      } else {
+        *dst++ = static_cast<char>(0xF0 | (code_point >> 18));
+        *dst++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+      }
+      *dst++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    }
+    *dst++ = static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+  result.resize(dst - result.data());
+  return result;
+}
+
+bool IsValidUtf8(std::string_view string) {
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(string.data());
+  const size_t length = string.size();
+  size_t i = 0;
+  while (i < length) {
+    i += CountLeadingAscii(src + i, length - i);
+    if (i == length) {
+      break;
+    }
+
+    char32_t code_point;
+    size_t consumed;
+    if (!DecodeUtf8(src + i, length - i, &code_point, &consumed)) {
+      return false;
+    }
+    i += consumed;
+  }
+  return true;
+}
+
+bool IsValidUtf16(std::u16string_view string) {
+  const char16_t* src = string.data();
+  const size_t length = string.size();
+  size_t i = 0;
+  while (i < length) {
+    i += CountLeadingNonSurrogates(src + i, length - i);
+    if (i == length) {
+      break;
+    }
+
+    if (!IsLeadSurrogate(src[i]) || i + 1 == length ||
+        !IsTrailSurrogate(src[i + 1])) {
+      return false;
+    }
+    i += 2;
+  }
+  return true;
+}
+
+}  // namespace fml
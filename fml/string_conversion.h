@@ -0,0 +1,53 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_STRING_CONVERSION_H_
+#define FLUTTER_FML_STRING_CONVERSION_H_
+
+#include <string>
+#include <string_view>
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      Converts a UTF-8 string to UTF-16.
+///
+///             Runs of ASCII characters are widened with SIMD instructions
+///             where available (SSE2 on x86, NEON on arm64). Ill-formed
+///             sequences are replaced with U+FFFD REPLACEMENT CHARACTER, one
+///             for each maximal subpart of the sequence.
+///
+/// @param[in]  string  The UTF-8 string.
+///
+/// @return     The UTF-16 string.
+///
+std::u16string Utf8ToUtf16(std::string_view string);
+
+//------------------------------------------------------------------------------
+/// @brief      Converts a UTF-16 string to UTF-8.
+///
+///             Runs of ASCII characters are narrowed with SIMD instructions
+///             where available. Unpaired surrogates are replaced with U+FFFD
+///             REPLACEMENT CHARACTER.
+///
+/// @param[in]  string  The UTF-16 string.
+///
+/// @return     The UTF-8 string.
+///
+std::string Utf16ToUtf8(std::u16string_view string);
+
+//------------------------------------------------------------------------------
+/// @return     Whether the string is well-formed UTF-8.
+///
+bool IsValidUtf8(std::string_view string);
+
+//------------------------------------------------------------------------------
+/// @return     Whether the string is well-formed UTF-16, that is, whether every
+///             surrogate in it is part of a surrogate pair.
+///
+bool IsValidUtf16(std::u16string_view string);
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_STRING_CONVERSION_H_
@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/string_conversion.h"
+
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+// Samples of text as it is typically found in applications, each a mix of
+// ASCII punctuation and digits with the characters of one or more scripts.
+const char* kLatinSample =
+    "The quick brown fox jumps over the lazy dog. Voix ambiguë d'un "
+    "cœur qui au zéphyr préfère les jattes de kiwis. ";
+const char* kCJKSample =
+    "吾輩は猫である。名前はまだ無い。(1905) "
+    "한국어 텍스트입니다. ";
+const char* kMixedSample =
+    "Order #4521 — مرحبا привет שלום "
+    "\U0001F600\U0001F44D café 日本 ";
+
+std::string MakeUtf8Text(const char* sample, size_t length) {
+  std::string text;
+  while (text.size() < length) {
+    text += sample;
+  }
+  return text;
+}
+
+}  // namespace
+
+static void BM_Utf8ToUtf16(benchmark::State& state,  // NOLINT
+                           const char* sample) {
+  const std::string text = MakeUtf8Text(sample, state.range(0));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(Utf8ToUtf16(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+static void BM_Utf16ToUtf8(benchmark::State& state,  // NOLINT
+                           const char* sample) {
+  const std::u16string text =
+      Utf8ToUtf16(MakeUtf8Text(sample, state.range(0)));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(Utf16ToUtf8(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size() *
+                          sizeof(char16_t));
+}
+
+static void BM_IsValidUtf8(benchmark::State& state,  // NOLINT
+                           const char* sample) {
+  const std::string text = MakeUtf8Text(sample, state.range(0));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(IsValidUtf8(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+static void BM_IsValidUtf16(benchmark::State& state,  // NOLINT
+                            const char* sample) {
+  const std::u16string text =
+      Utf8ToUtf16(MakeUtf8Text(sample, state.range(0)));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(IsValidUtf16(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size() *
+                          sizeof(char16_t));
+}
+
+#define STRING_CONVERSION_BENCHMARKS(name)                              \
+  BENCHMARK_CAPTURE(name, Latin, kLatinSample)->Range(1 << 6, 1 << 16); \
+  BENCHMARK_CAPTURE(name, CJK, kCJKSample)->Range(1 << 6, 1 << 16);     \
+  BENCHMARK_CAPTURE(name, Mixed, kMixedSample)->Range(1 << 6, 1 << 16);
+
+STRING_CONVERSION_BENCHMARKS(BM_Utf8ToUtf16)
+STRING_CONVERSION_BENCHMARKS(BM_Utf16ToUtf8)
+STRING_CONVERSION_BENCHMARKS(BM_IsValidUtf8)
+STRING_CONVERSION_BENCHMARKS(BM_IsValidUtf16)
+
+#undef STRING_CONVERSION_BENCHMARKS
+
+}  // namespace benchmarking
+}  // namespace fml
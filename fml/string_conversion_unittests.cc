@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/string_conversion.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(StringConversion, Utf8ToUtf16) {
+  ASSERT_EQ(Utf8ToUtf16(""), u"");
+  ASSERT_EQ(Utf8ToUtf16("abc"), u"abc");
+  ASSERT_EQ(Utf8ToUtf16("café 日本 \U0001F600"),
+            u"café 日本 \U0001F600");
+}
+
+TEST(StringConversion, Utf16ToUtf8) {
+  ASSERT_EQ(Utf16ToUtf8(u""), "");
+  ASSERT_EQ(Utf16ToUtf8(u"abc"), "abc");
+  ASSERT_EQ(Utf16ToUtf8(u"café 日本 \U0001F600"),
+            "café 日本 \U0001F600");
+}
+
+TEST(StringConversion, ConvertsAcrossVectorBoundaries) {
+  // Place non-ASCII characters at every offset within and after a block of
+  // ASCII characters so that both the vector and the scalar paths are used.
+  for (size_t prefix = 0; prefix < 40; prefix++) {
+    std::string utf8(prefix, 'a');
+    std::u16string utf16(prefix, u'a');
+    utf8 += "é\U0001F600" + std::string(prefix, 'z');
+    utf16 += u"é\U0001F600" + std::u16string(prefix, u'z');
+    ASSERT_EQ(Utf8ToUtf16(utf8), utf16) << "prefix " << prefix;
+    ASSERT_EQ(Utf16ToUtf8(utf16), utf8) << "prefix " << prefix;
+    ASSERT_TRUE(IsValidUtf8(utf8));
+    ASSERT_TRUE(IsValidUtf16(utf16));
+  }
+}
+
+TEST(StringConversion, ReplacesIllFormedUtf8) {
+  // Lone continuation byte.
+  ASSERT_EQ(Utf8ToUtf16("a\x80z"), u"a\uFFFDz");
+  // Truncated sequence at the end of the string.
+  ASSERT_EQ(Utf8ToUtf16("a\xE6\x97"), u"a\uFFFD");
+  // Truncated sequence followed by ASCII.
+  ASSERT_EQ(Utf8ToUtf16("\xE6\x97z"), u"\uFFFDz");
+  // Overlong encoding of '/'.
+  ASSERT_EQ(Utf8ToUtf16("\xC0\xAF"), u"\uFFFD\uFFFD");
+  // Encoded surrogate.
+  ASSERT_EQ(Utf8ToUtf16("\xED\xA0\x80"), u"\uFFFD\uFFFD\uFFFD");
+  // Code point above U+10FFFF.
+  ASSERT_EQ(Utf8ToUtf16("\xF4\x90\x80\x80"), u"\uFFFD\uFFFD\uFFFD\uFFFD");
+}
+
+TEST(StringConversion, ReplacesUnpairedSurrogates) {
+  ASSERT_EQ(Utf16ToUtf8(u"a\xD800z"), "a\uFFFDz");
+  ASSERT_EQ(Utf16ToUtf8(u"a\xDC00z"), "a\uFFFDz");
+  ASSERT_EQ(Utf16ToUtf8(u"a\xD800"), "a\uFFFD");
+}
+
+TEST(StringConversion, IsValidUtf8) {
+  ASSERT_TRUE(IsValidUtf8(""));
+  ASSERT_TRUE(IsValidUtf8("café \U0001F600 \uFFFD"));
+  ASSERT_FALSE(IsValidUtf8("a\x80"));
+  ASSERT_FALSE(IsValidUtf8("\xE6\x97"));
+  ASSERT_FALSE(IsValidUtf8("\xED\xA0\x80"));
+  ASSERT_FALSE(IsValidUtf8(std::string(64, 'a') + "\xFF"));
+}
+
+TEST(StringConversion, IsValidUtf16) {
+  ASSERT_TRUE(IsValidUtf16(u""));
+  ASSERT_TRUE(IsValidUtf16(u"café \U0001F600"));
+  ASSERT_FALSE(IsValidUtf16(u"\xD800"));
+  ASSERT_FALSE(IsValidUtf16(u"\xDC00\xD800"));
+  ASSERT_FALSE(IsValidUtf16(std::u16string(64, u'a') + u"\xDBFF"));
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -19,6 +19,7 @@
 #include "flutter/lib/ui/painting/image_filter.h"
 #include "flutter/lib/ui/painting/image_shader.h"
 #include "flutter/lib/ui/painting/immutable_buffer.h"
+#include "flutter/lib/ui/painting/incremental_image_descriptor.h"
 #include "flutter/lib/ui/painting/path.h"
 #include "flutter/lib/ui/painting/path_measure.h"
 #include "flutter/lib/ui/painting/picture.h"
@@ -70,6 +71,7 @@ void DartUI::InitForGlobal() {
     ImageFilter::RegisterNatives(g_natives);
     ImageShader::RegisterNatives(g_natives);
     ImmutableBuffer::RegisterNatives(g_natives);
+    IncrementalImageDescriptor::RegisterNatives(g_natives);
     IsolateNameServerNatives::RegisterNatives(g_natives);
     NativeStringAttribute::RegisterNatives(g_natives);
     Paragraph::RegisterNatives(g_natives);
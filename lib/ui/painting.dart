@@ -1602,6 +1602,100 @@ enum ImageByteFormat {
   ///  * <https://en.wikipedia.org/wiki/Portable_Network_Graphics>, the Wikipedia page on PNG.
   ///  * <https://tools.ietf.org/rfc/rfc2083.txt>, the PNG standard.
   png,
+
+  /// QOI format.
+  ///
+  /// A loss-less compression format for images that is much faster to encode
+  /// than [png], at the cost of larger files. This format is well suited for
+  /// images that are encoded often, such as screenshots that are compared or
+  /// uploaded elsewhere. Transparency is supported. Large images are encoded
+  /// in parallel.
+  ///
+  /// QOI images normally use the `.qoi` file extension.
+  ///
+  /// The web engines cannot encode images in this format.
+  ///
+  /// See also:
+  ///
+  ///  * <https://qoiformat.org>, the QOI specification.
+  qoi,
+
+  /// WebP format.
+  ///
+  /// A compression format for images that is lossy unless
+  /// [ImageEncodingOptions.quality] is 100. Lossy WebP images are much smaller
+  /// than [png] images, and are well suited for photographs. Transparency is
+  /// supported.
+  ///
+  /// WebP images normally use the `.webp` file extension and the `image/webp`
+  /// MIME type.
+  ///
+  /// The web engines cannot encode images in this format.
+  ///
+  /// See also:
+  ///
+  ///  * <https://developers.google.com/speed/webp>, the WebP documentation.
+  webp,
+}
+
+/// The filters that rows of [ImageByteFormat.png] images may be encoded with.
+///
+/// Filtering a row makes it more compressible by storing the differences
+/// between its pixels and neighboring pixels. Trying fewer filters encodes
+/// faster, and usually produces larger images.
+enum PngFilter {
+  /// Each row is encoded with the filter that is expected to compress it best.
+  all,
+
+  /// Rows are not filtered.
+  none,
+
+  /// Rows store the difference with the pixel on their left.
+  sub,
+
+  /// Rows store the difference with the pixel above them.
+  up,
+
+  /// Rows store the difference with the average of the pixels on their left
+  /// and above them.
+  average,
+
+  /// Rows store the difference with the pixel on their left, above them, or
+  /// above and on their left, whichever is closest to a linear prediction.
+  paeth,
+}
+
+/// Options for encoding an [Image] with [Image.toByteData].
+///
+/// Each option only applies to some [ImageByteFormat]s, and is ignored by the
+/// others.
+class ImageEncodingOptions {
+  /// Creates options for encoding images.
+  ///
+  /// The defaults match the encoding used when no options are given.
+  const ImageEncodingOptions({
+    this.compressionLevel = 6,
+    this.pngFilter = PngFilter.all,
+    this.quality = 100,
+  }) : assert(compressionLevel >= 0 && compressionLevel <= 9),
+       assert(quality >= 0 && quality <= 100);
+
+  /// How hard the encoder tries to compress the image, from 0 (fastest) to 9
+  /// (smallest).
+  ///
+  /// This is the zlib compression level of [ImageByteFormat.png] images, and
+  /// the effort spent on loss-less [ImageByteFormat.webp] images.
+  final int compressionLevel;
+
+  /// The filters that rows of [ImageByteFormat.png] images may be encoded
+  /// with.
+  final PngFilter pngFilter;
+
+  /// The quality of [ImageByteFormat.webp] images, from 0 to 100.
+  ///
+  /// Images with a quality of 100 are encoded loss-lessly. Lower qualities
+  /// produce smaller images with more compression artifacts.
+  final int quality;
 }
 
 /// The format of pixel data given to [decodeImageFromPixels].
@@ -1706,13 +1800,17 @@ class Image {
   /// Converts the [Image] object into a byte array.
   ///
   /// The [format] argument specifies the format in which the bytes will be
-  /// returned.
+  /// returned. The [options] argument specifies how formats that compress the
+  /// image trade speed for size or quality.
   ///
   /// Returns a future that completes with the binary image data or an error
   /// if encoding fails.
-  Future<ByteData?> toByteData({ImageByteFormat format = ImageByteFormat.rawRgba}) {
+  Future<ByteData?> toByteData({
+    ImageByteFormat format = ImageByteFormat.rawRgba,
+    ImageEncodingOptions options = const ImageEncodingOptions(),
+  }) {
     assert(!_disposed && !_image._disposed);
-    return _image.toByteData(format: format);
+    return _image.toByteData(format: format, options: options);
   }
 
   /// If asserts are enabled, returns the [StackTrace]s of each open handle from
@@ -1844,16 +1942,25 @@ class _Image extends NativeFieldWrapperClass1 {
 
   int get height native 'Image_height';
 
-  Future<ByteData?> toByteData({ImageByteFormat format = ImageByteFormat.rawRgba}) {
+  Future<ByteData?> toByteData({
+    ImageByteFormat format = ImageByteFormat.rawRgba,
+    ImageEncodingOptions options = const ImageEncodingOptions(),
+  }) {
     return _futurize((_Callback<ByteData> callback) {
-      return _toByteData(format.index, (Uint8List? encoded) {
-        callback(encoded!.buffer.asByteData());
-      });
+      return _toByteData(
+        format.index,
+        options.compressionLevel,
+        options.pngFilter.index,
+        options.quality,
+        (Uint8List? encoded) {
+          callback(encoded!.buffer.asByteData());
+        },
+      );
     });
   }
 
   /// Returns an error message on failure, null on success.
-  String? _toByteData(int format, _Callback<Uint8List?> callback) native 'Image_toByteData';
+  String? _toByteData(int format, int compressionLevel, int pngFilter, int quality, _Callback<Uint8List?> callback) native 'Image_toByteData';
 
   bool _disposed = false;
   void dispose() {
@@ -1945,6 +2052,29 @@ class FrameInfo {
   final Image image;
 }
 
+/// How urgently the frames of a [Codec] are needed.
+///
+/// Images are decoded in priority order, so that the decodes of visible images
+/// are not delayed by the decodes of images that are not visible yet or no
+/// longer are.
+///
+/// See also:
+///
+///  * [Codec.setDecodePriority], which sets the priority of a codec.
+enum ImageDecodePriority {
+  /// The image is visible or about to be.
+  ///
+  /// This is the default priority.
+  visible,
+
+  /// The image will likely become visible soon, for example because it is next
+  /// in the scroll direction.
+  prefetch,
+
+  /// The image is not expected to become visible soon.
+  background,
+}
+
 /// A handle to an image codec.
 ///
 /// This class is created by the engine, and should not be instantiated
@@ -2005,8 +2135,24 @@ class Codec extends NativeFieldWrapperClass1 {
   /// Returns an error message on failure, null on success.
   String? _getNextFrame(void Function(_Image?, int) callback) native 'Codec_getNextFrame';
 
+  /// Sets how urgently the frames of this codec are needed.
+  ///
+  /// The priority can be raised or lowered until the decode of a frame
+  /// requested by [getNextFrame] starts, for example as the image scrolls into
+  /// or out of view. Animated images with the
+  /// [ImageDecodePriority.background] priority do not decode their next frames
+  /// ahead of time.
+  void setDecodePriority(ImageDecodePriority priority) {
+    _setDecodePriority(priority.index);
+  }
+  void _setDecodePriority(int priority) native 'Codec_setDecodePriority';
+
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
+  ///
+  /// The futures returned by [getNextFrame] that have not completed yet
+  /// complete with an error. The decodes they requested are cancelled if they
+  /// have not started yet.
   void dispose() native 'Codec_dispose';
 }
 
@@ -5199,7 +5345,7 @@ class Shadow {
 /// The creator of this object is responsible for calling [dispose] when it is
 /// no longer needed.
 class ImmutableBuffer extends NativeFieldWrapperClass1 {
-  ImmutableBuffer._(this.length);
+  ImmutableBuffer._(this._length);
 
   /// Creates a copy of the data from a [Uint8List] suitable for internal use
   /// in the engine.
@@ -5209,10 +5355,50 @@ class ImmutableBuffer extends NativeFieldWrapperClass1 {
       instance._init(list, callback);
     }).then((_) => instance);
   }
+
+  /// Creates an [ImmutableBuffer] from the asset with the key [assetKey].
+  ///
+  /// The bytes of the asset are used where the engine holds them, typically
+  /// in a memory mapping of the asset bundle, without being copied into the
+  /// Dart heap. Prefer this over loading the asset into a [Uint8List] to
+  /// decode images from assets.
+  ///
+  /// Throws an [Exception] if the asset does not exist.
+  static Future<ImmutableBuffer> fromAsset(String assetKey) {
+    // The flutter tool converts all asset keys with spaces into URI
+    // encoded paths (replacing ' ' with '%20', for example). We perform
+    // the same encoding here so that users can load assets with the same
+    // key they have written in the pubspec.
+    final String encodedKey = Uri(path: Uri.encodeFull(assetKey)).path;
+    final ImmutableBuffer instance = ImmutableBuffer._(0);
+    return _futurize((_Callback<int> callback) {
+      return instance._initFromAsset(encodedKey, callback);
+    }).then((int length) => instance.._length = length);
+  }
+
+  /// Creates an [ImmutableBuffer] from a memory mapping of the file at [path].
+  ///
+  /// The file is not read into the Dart heap. Its pages are loaded on demand,
+  /// when the engine reads them, and the file must not be modified while the
+  /// buffer or any object created from it is alive.
+  ///
+  /// Throws an [Exception] if the file cannot be mapped.
+  static Future<ImmutableBuffer> fromFilePath(String path) {
+    final ImmutableBuffer instance = ImmutableBuffer._(0);
+    return _futurize((_Callback<int> callback) {
+      return instance._initFromFile(path, callback);
+    }).then((int length) => instance.._length = length);
+  }
+
   void _init(Uint8List list, _Callback<void> callback) native 'ImmutableBuffer_init';
 
+  String? _initFromAsset(String assetKey, _Callback<int> callback) native 'ImmutableBuffer_initFromAsset';
+
+  String? _initFromFile(String path, _Callback<int> callback) native 'ImmutableBuffer_initFromFile';
+
   /// The length, in bytes, of the underlying data.
-  final int length;
+  int get length => _length;
+  int _length;
 
   bool _debugDisposed = false;
 
@@ -5351,6 +5537,91 @@ class ImageDescriptor extends NativeFieldWrapperClass1 {
   void _instantiateCodec(Codec outCodec, int targetWidth, int targetHeight) native 'ImageDescriptor_instantiateCodec';
 }
 
+/// The result of [IncrementalImageDescriptor.decode].
+class PartialImageInfo {
+  /// This class is created by the engine, and should not be instantiated
+  /// or extended directly.
+  ///
+  /// To obtain an instance of the [PartialImageInfo] interface, see
+  /// [IncrementalImageDescriptor.decode].
+  PartialImageInfo._({this.image, required this.decodedRows, required this.isComplete});
+
+  /// The decoded part of the image, or null if no rows could be decoded yet.
+  ///
+  /// Until the image is complete, the image only holds the rows decoded so
+  /// far: it has the width of the encoded image and a height of [decodedRows].
+  ///
+  /// This object must be disposed by the recipient of this info.
+  final Image? image;
+
+  /// The number of rows decoded from the top of the image.
+  final int decodedRows;
+
+  /// Whether the image is fully decoded.
+  final bool isComplete;
+}
+
+/// A descriptor of encoded image data that arrives in chunks, for example from
+/// the network, which can be decoded before all of its data has arrived.
+///
+/// Add the chunks with [addChunk] as they arrive, call [decode] to decode the
+/// data added so far, and call [close] once all the chunks have been added.
+///
+/// Non-interlaced PNG images are decoded as their rows arrive, and the encoded
+/// data of the rows is released once they are decoded. Other images are
+/// decoded once [close] has been called.
+class IncrementalImageDescriptor extends NativeFieldWrapperClass1 {
+  /// Creates a descriptor without any encoded data.
+  IncrementalImageDescriptor() { _constructor(); }
+  void _constructor() native 'IncrementalImageDescriptor_constructor';
+
+  /// Appends the next chunk of the encoded image.
+  ///
+  /// The bytes of the chunk are not copied, so the chunk can be disposed as
+  /// soon as it has been added. Chunks must not be added after [close] has
+  /// been called.
+  void addChunk(ImmutableBuffer chunk) native 'IncrementalImageDescriptor_addChunk';
+
+  /// Signals that all the chunks of the encoded image have been added.
+  void close() native 'IncrementalImageDescriptor_close';
+
+  /// Decodes the chunks added so far.
+  ///
+  /// Once the image is complete, the returned future completes with the
+  /// complete image. The returned future completes with an error if the image
+  /// could not be decoded, including when the image data ended before the
+  /// image was complete.
+  ///
+  /// The caller of this method is responsible for disposing the
+  /// [PartialImageInfo.image] on the returned object.
+  Future<PartialImageInfo> decode() {
+    final Completer<PartialImageInfo> completer = Completer<PartialImageInfo>.sync();
+    final String? error = _decode((_Image? image, int decodedRows, int status) {
+      // The status must be kept in sync with IncrementalImageDecoder::Status.
+      if (status == 2) {
+        completer.completeError(Exception('Failed to decode the image, possibly due to invalid image data.'));
+      } else {
+        completer.complete(PartialImageInfo._(
+          image: image == null ? null : Image._(image),
+          decodedRows: decodedRows,
+          isComplete: status == 1,
+        ));
+      }
+    });
+    if (error != null) {
+      throw Exception(error);
+    }
+    return completer.future;
+  }
+
+  /// Returns an error message on failure, null on success.
+  String? _decode(void Function(_Image?, int, int) callback) native 'IncrementalImageDescriptor_decode';
+
+  /// Release the resources used by this object. The object is no longer usable
+  /// after this method is called.
+  void dispose() native 'IncrementalImageDescriptor_dispose';
+}
+
 /// Generic callback signature, used by [_futurize].
 typedef _Callback<T> = void Function(T result);
 
@@ -0,0 +1,354 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+std::mutex g_default_options_mutex;
+AnimatedFrameDecoder::Options g_default_options;
+
+// The decoders alive in the process, which are purged under memory pressure.
+std::mutex g_decoders_mutex;
+std::set<AnimatedFrameDecoder*> g_decoders;
+std::atomic<size_t> g_cached_frame_bytes = 0;
+// The bytes reserved from the cache budget by the decoders keeping all the
+// frames of their animation.
+std::atomic<size_t> g_kept_frame_bytes = 0;
+
+size_t GetFrameBytes(const std::shared_ptr<ImageGenerator>& generator) {
+  return generator->GetInfo()
+      .makeColorType(kN32_SkColorType)
+      .computeMinByteSize();
+}
+
+size_t GetFrameBytes(const AnimatedFrameDecoder::Frame& frame) {
+  return frame.image ? frame.image->imageInfo().computeMinByteSize() : 0;
+}
+
+// Reserves |bytes| from the cache budget shared by all the decoders. Returns
+// false if they do not fit in |budget_bytes| next to the bytes already kept.
+bool ReserveKeptFrameBytes(size_t bytes, size_t budget_bytes) {
+  size_t kept_bytes = g_kept_frame_bytes;
+  do {
+    if (kept_bytes > budget_bytes || bytes > budget_bytes - kept_bytes) {
+      return false;
+    }
+  } while (!g_kept_frame_bytes.compare_exchange_weak(kept_bytes,
+                                                     kept_bytes + bytes));
+  return true;
+}
+
+}  // namespace
+
+// Copied the source bitmap to the destination. If this cannot occur due to
+// running out of memory or the image info not being compatible, returns false.
+static bool CopyToBitmap(SkBitmap* dst,
+                         SkColorType dstColorType,
+                         const SkBitmap& src) {
+  SkPixmap srcPM;
+  if (!src.peekPixels(&srcPM)) {
+    return false;
+  }
+
+  SkBitmap tmpDst;
+  SkImageInfo dstInfo = srcPM.info().makeColorType(dstColorType);
+  if (!tmpDst.setInfo(dstInfo)) {
+    return false;
+  }
+
+  if (!tmpDst.tryAllocPixels()) {
+    return false;
+  }
+
+  SkPixmap dstPM;
+  if (!tmpDst.peekPixels(&dstPM)) {
+    return false;
+  }
+
+  if (!srcPM.readPixels(dstPM)) {
+    return false;
+  }
+
+  dst->swap(tmpDst);
+  return true;
+}
+
+void AnimatedFrameDecoder::SetDefaultOptions(const Options& options) {
+  std::scoped_lock lock(g_default_options_mutex);
+  g_default_options = options;
+}
+
+AnimatedFrameDecoder::Options AnimatedFrameDecoder::GetDefaultOptions() {
+  std::scoped_lock lock(g_default_options_mutex);
+  return g_default_options;
+}
+
+size_t AnimatedFrameDecoder::GetCachedFrameBytes() {
+  return g_cached_frame_bytes;
+}
+
+void AnimatedFrameDecoder::PurgeCachedFrames() {
+  TRACE_EVENT0("flutter", "AnimatedFrameDecoder::PurgeCachedFrames");
+  std::scoped_lock lock(g_decoders_mutex);
+  for (auto* decoder : g_decoders) {
+    decoder->DropFrames();
+  }
+}
+
+void AnimatedFrameDecoder::TrimCachedFrames(size_t bytes) {
+  TRACE_EVENT0("flutter", "AnimatedFrameDecoder::TrimCachedFrames");
+  std::scoped_lock lock(g_decoders_mutex);
+  // Dropping the largest caches first disturbs the fewest animations.
+  std::vector<std::pair<size_t, AnimatedFrameDecoder*>> decoders;
+  for (auto* decoder : g_decoders) {
+    decoders.emplace_back(decoder->GetCachedBytes(), decoder);
+  }
+  std::sort(decoders.begin(), decoders.end(), std::greater<>());
+  size_t dropped_bytes = 0;
+  for (const auto& [cached_bytes, decoder] : decoders) {
+    if (dropped_bytes >= bytes || cached_bytes == 0) {
+      break;
+    }
+    dropped_bytes += decoder->DropFrames();
+  }
+}
+
+AnimatedFrameDecoder::AnimatedFrameDecoder(
+    std::shared_ptr<ImageGenerator> generator,
+    const Options& options)
+    : generator_(std::move(generator)),
+      frame_count_(generator_->GetFrameCount()),
+      // Decoding more frames ahead than the animation has would wrap around.
+      decode_ahead_frames_(frame_count_ > 1
+                               ? std::min<size_t>(options.decode_ahead_frames,
+                                                  frame_count_ - 1)
+                               : 0),
+      all_frames_bytes_(frame_count_ * GetFrameBytes(generator_)),
+      keep_all_frames_(frame_count_ > 1 &&
+                       ReserveKeptFrameBytes(all_frames_bytes_,
+                                             options.frame_cache_bytes)) {
+  std::scoped_lock lock(g_decoders_mutex);
+  g_decoders.insert(this);
+}
+
+AnimatedFrameDecoder::~AnimatedFrameDecoder() {
+  {
+    std::scoped_lock lock(g_decoders_mutex);
+    g_decoders.erase(this);
+  }
+  g_cached_frame_bytes -= cached_bytes_;
+  if (keep_all_frames_) {
+    g_kept_frame_bytes -= all_frames_bytes_;
+  }
+}
+
+AnimatedFrameDecoder::Frame AnimatedFrameDecoder::GetFrame(int index) {
+  FML_DCHECK(index >= 0 && index < frame_count_);
+  Frame frame;
+  if (TakeDecodedFrame(index, &frame)) {
+    return frame;
+  }
+
+  std::scoped_lock decode_lock(decode_mutex_);
+  // The frame may have been decoded ahead while waiting for the lock.
+  if (TakeDecodedFrame(index, &frame)) {
+    return frame;
+  }
+
+  // Decode the frames in order up to the requested one. This decodes a single
+  // frame unless the frames before it were dropped from the cache. Unless all
+  // the frames are kept, the frames before the requested one are outside of
+  // the decode-ahead window, so they are not stored, and a purged cache is
+  // not refilled with them.
+  while (true) {
+    const int decoded_index = next_decode_index_;
+    frame = DecodeNextFrame();
+    std::scoped_lock lock(frames_mutex_);
+    if (keep_all_frames_) {
+      StoreFrame(decoded_index, frame);
+    }
+    if (decoded_index == index) {
+      stats_.waited_frames++;
+      return frame;
+    }
+  }
+}
+
+void AnimatedFrameDecoder::DecodeAhead(
+    int index,
+    const std::shared_ptr<ImageDecodeScheduler>& scheduler) {
+  if (decode_ahead_frames_ == 0 || decode_ahead_pending_.exchange(true)) {
+    return;
+  }
+  // The decoder is not kept alive by the job, so that the remaining frames
+  // are not decoded once the animation is collected. The frames are small
+  // next to the upload budget, so they reserve nothing from it.
+  std::weak_ptr<AnimatedFrameDecoder> weak_decoder = weak_from_this();
+  scheduler->Schedule(
+      ImageDecodeScheduler::Priority::kPrefetch,
+      [weak_decoder, index]() {
+        if (auto decoder = weak_decoder.lock()) {
+          decoder->DecodeFramesAfter(index);
+          decoder->decode_ahead_pending_ = false;
+        }
+      },
+      [weak_decoder]() {
+        if (auto decoder = weak_decoder.lock()) {
+          decoder->decode_ahead_pending_ = false;
+        }
+      });
+}
+
+AnimatedFrameDecoder::Stats AnimatedFrameDecoder::GetStats() const {
+  std::scoped_lock lock(frames_mutex_);
+  return stats_;
+}
+
+void AnimatedFrameDecoder::DecodeFramesAfter(int index) {
+  TRACE_EVENT0("flutter", "AnimatedFrameDecoder::DecodeFramesAfter");
+  std::scoped_lock decode_lock(decode_mutex_);
+  while (true) {
+    {
+      std::scoped_lock lock(frames_mutex_);
+      if (keep_all_frames_ &&
+          frames_.size() == static_cast<size_t>(frame_count_)) {
+        return;
+      }
+    }
+    // The number of frames following |index| that have been decoded.
+    const size_t decoded_ahead =
+        (next_decode_index_ - index - 1 + frame_count_) % frame_count_;
+    if (decoded_ahead >= decode_ahead_frames_) {
+      return;
+    }
+    const int decoded_index = next_decode_index_;
+    Frame frame = DecodeNextFrame();
+    std::scoped_lock lock(frames_mutex_);
+    StoreFrame(decoded_index, std::move(frame));
+  }
+}
+
+bool AnimatedFrameDecoder::TakeDecodedFrame(int index, Frame* frame) {
+  std::scoped_lock lock(frames_mutex_);
+  auto found = frames_.find(index);
+  if (found == frames_.end()) {
+    return false;
+  }
+  stats_.ready_frames++;
+  if (keep_all_frames_) {
+    *frame = found->second;
+  } else {
+    *frame = std::move(found->second);
+    frames_.erase(found);
+    const size_t bytes = GetFrameBytes(*frame);
+    cached_bytes_ -= bytes;
+    g_cached_frame_bytes -= bytes;
+  }
+  return true;
+}
+
+void AnimatedFrameDecoder::StoreFrame(int index, Frame frame) {
+  const size_t bytes = GetFrameBytes(frame);
+  auto [found, inserted] = frames_.try_emplace(index, std::move(frame));
+  if (!inserted) {
+    const size_t replaced_bytes = GetFrameBytes(found->second);
+    cached_bytes_ -= replaced_bytes;
+    g_cached_frame_bytes -= replaced_bytes;
+    found->second = std::move(frame);
+  }
+  cached_bytes_ += bytes;
+  g_cached_frame_bytes += bytes;
+}
+
+size_t AnimatedFrameDecoder::GetCachedBytes() const {
+  std::scoped_lock lock(frames_mutex_);
+  return cached_bytes_;
+}
+
+size_t AnimatedFrameDecoder::DropFrames() {
+  std::scoped_lock lock(frames_mutex_);
+  if (keep_all_frames_.exchange(false)) {
+    g_kept_frame_bytes -= all_frames_bytes_;
+  }
+  frames_.clear();
+  const size_t dropped_bytes = cached_bytes_;
+  g_cached_frame_bytes -= dropped_bytes;
+  cached_bytes_ = 0;
+  return dropped_bytes;
+}
+
+AnimatedFrameDecoder::Frame AnimatedFrameDecoder::DecodeNextFrame() {
+  TRACE_EVENT0("flutter", "AnimatedFrameDecoder::DecodeNextFrame");
+  const int frame_index = next_decode_index_;
+  next_decode_index_ = (next_decode_index_ + 1) % frame_count_;
+  {
+    std::scoped_lock lock(frames_mutex_);
+    stats_.decoded_frames++;
+  }
+
+  SkBitmap bitmap = SkBitmap();
+  SkImageInfo info = generator_->GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
+    info = updated;
+  }
+  bitmap.allocPixels(info);
+
+  ImageGenerator::FrameInfo frameInfo = generator_->GetFrameInfo(frame_index);
+
+  const int requiredFrameIndex =
+      frameInfo.required_frame.value_or(SkCodec::kNoFrame);
+  std::optional<unsigned int> prior_frame_index = std::nullopt;
+
+  if (requiredFrameIndex != SkCodec::kNoFrame) {
+    if (last_required_frame_ == nullptr) {
+      FML_LOG(ERROR) << "Frame " << frame_index << " depends on frame "
+                     << requiredFrameIndex
+                     << " and no required frames are cached.";
+      return {};
+    } else if (last_required_frame_index_ != requiredFrameIndex) {
+      FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
+                     << " is not cached. Using " << last_required_frame_index_
+                     << " instead";
+    }
+
+    if (last_required_frame_->getPixels() &&
+        CopyToBitmap(&bitmap, last_required_frame_->colorType(),
+                     *last_required_frame_)) {
+      prior_frame_index = requiredFrameIndex;
+    }
+  }
+
+  if (!generator_->GetPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
+                             frame_index, requiredFrameIndex)) {
+    FML_LOG(ERROR) << "Could not getPixels for frame " << frame_index;
+    return {};
+  }
+
+  // The pixels are not written to anymore, so that the frame image and the
+  // required frame can share them.
+  bitmap.setImmutable();
+
+  // Hold onto this if we need it to decode future frames.
+  if (frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep) {
+    last_required_frame_ = std::make_unique<SkBitmap>(bitmap);
+    last_required_frame_index_ = frame_index;
+  }
+
+  return {SkImage::MakeFromBitmap(bitmap), frameInfo.duration};
+}
+
+}  // namespace flutter
@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_ANIMATED_FRAME_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_ANIMATED_FRAME_DECODER_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+// Decodes the frames of an animated image into raster images.
+//
+// Frames are decoded in order, since each frame may be drawn over the frame
+// before it. After a frame is requested, the frames that follow it can be
+// decoded ahead on the worker pool, so that they are ready by the time they
+// are displayed. The decoded frames of animations that fit in the cache budget
+// are all kept, so that looping animations are only decoded once. The budget is
+// shared by all the decoders in the process: an animation whose frames do not
+// fit next to the frames already kept by the others only keeps the frames
+// decoded ahead.
+//
+// All methods are thread safe.
+class AnimatedFrameDecoder
+    : public std::enable_shared_from_this<AnimatedFrameDecoder> {
+ public:
+  struct Options {
+    // The number of frames decoded ahead of the last requested frame.
+    size_t decode_ahead_frames = 2;
+    // The memory budget in bytes of the animations whose decoded frames are
+    // all kept, across all the decoders in the process.
+    size_t frame_cache_bytes = 8 << 20;
+  };
+
+  struct Frame {
+    // A raster image of the frame, or null if the frame could not be decoded.
+    sk_sp<SkImage> image;
+    // The duration of the frame in milliseconds.
+    int duration = 0;
+  };
+
+  struct Stats {
+    // The number of frames decoded, ahead or on demand.
+    size_t decoded_frames = 0;
+    // The number of requested frames that were already decoded.
+    size_t ready_frames = 0;
+    // The number of requested frames that had to be decoded on demand.
+    size_t waited_frames = 0;
+  };
+
+  // Sets the options of the decoders created from now on, in every engine of
+  // the process.
+  static void SetDefaultOptions(const Options& options);
+
+  static Options GetDefaultOptions();
+
+  // Returns the bytes of the decoded frames held by all the decoders in the
+  // process.
+  static size_t GetCachedFrameBytes();
+
+  // Drops the decoded frames held by all the decoders in the process, and
+  // stops them from keeping all the frames of their animation. Frames are
+  // still decoded ahead.
+  static void PurgeCachedFrames();
+
+  // Drops the decoded frames of the decoders holding the most, until at least
+  // |bytes| are freed. The other decoders keep their frames.
+  static void TrimCachedFrames(size_t bytes);
+
+  AnimatedFrameDecoder(std::shared_ptr<ImageGenerator> generator,
+                       const Options& options = GetDefaultOptions());
+
+  ~AnimatedFrameDecoder();
+
+  int GetFrameCount() const { return frame_count_; }
+
+  // Returns whether all the decoded frames are kept.
+  bool KeepsAllFrames() const { return keep_all_frames_; }
+
+  // Returns frame |index|, decoding it first if it is not decoded yet.
+  Frame GetFrame(int index);
+
+  // Decodes the frames that follow frame |index| with |scheduler|, up to the
+  // decode-ahead window. The frames are decoded at prefetch priority, behind
+  // the images that are visible. Does nothing if a decode-ahead is already
+  // pending.
+  void DecodeAhead(int index,
+                   const std::shared_ptr<ImageDecodeScheduler>& scheduler);
+
+  Stats GetStats() const;
+
+ private:
+  const std::shared_ptr<ImageGenerator> generator_;
+  const int frame_count_;
+  const size_t decode_ahead_frames_;
+  // The bytes of all the decoded frames, which are reserved from the cache
+  // budget while all the frames are kept.
+  const size_t all_frames_bytes_;
+  std::atomic_bool keep_all_frames_;
+  std::atomic_bool decode_ahead_pending_{false};
+
+  // Guards the decoded frames and the stats.
+  mutable std::mutex frames_mutex_;
+  std::map<int, Frame> frames_;
+  // The bytes of the images in |frames_|.
+  size_t cached_bytes_ = 0;
+  Stats stats_;
+
+  // Guards the decoding state below. Held while a frame is decoded.
+  std::mutex decode_mutex_;
+  int next_decode_index_ = 0;
+  // The last decoded frame that's required to decode any subsequent frames.
+  std::unique_ptr<SkBitmap> last_required_frame_;
+  // The index of the last decoded required frame.
+  int last_required_frame_index_ = -1;
+
+  // Decodes the frame at |next_decode_index_| and advances it. Must be called
+  // with the decode lock held.
+  Frame DecodeNextFrame();
+
+  // Decodes the frames following |index| that are not decoded yet, up to the
+  // decode-ahead window.
+  void DecodeFramesAfter(int index);
+
+  // Returns the decoded frame |index| in |frame| if there is one, and drops it
+  // from the cache unless all frames are kept.
+  bool TakeDecodedFrame(int index, Frame* frame);
+
+  // Adds |frame| to the cache. Must be called with the frames lock held.
+  void StoreFrame(int index, Frame frame);
+
+  // Returns the bytes of the frames in the cache.
+  size_t GetCachedBytes() const;
+
+  // Drops the frames in the cache, and stops keeping all the frames. Returns
+  // the bytes dropped.
+  size_t DropFrames();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AnimatedFrameDecoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_ANIMATED_FRAME_DECODER_H_
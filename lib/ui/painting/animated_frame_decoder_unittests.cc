@@ -0,0 +1,232 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::shared_ptr<ImageGenerator> CreateAnimatedGenerator() {
+  auto mapping = OpenFixtureAsMapping("hello_loop_2.webp");
+  FML_CHECK(mapping);
+  auto data = SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+  ImageGeneratorRegistry registry;
+  auto generator = registry.CreateCompatibleGenerator(data);
+  FML_CHECK(generator);
+  FML_CHECK(generator->GetFrameCount() > 1);
+  return generator;
+}
+
+bool HaveSamePixels(const sk_sp<SkImage>& a, const sk_sp<SkImage>& b) {
+  SkPixmap a_pixels;
+  SkPixmap b_pixels;
+  return a && b && a->peekPixels(&a_pixels) && b->peekPixels(&b_pixels) &&
+         a_pixels.computeByteSize() == b_pixels.computeByteSize() &&
+         std::memcmp(a_pixels.addr(), b_pixels.addr(),
+                     a_pixels.computeByteSize()) == 0;
+}
+
+}  // namespace
+
+TEST(AnimatedFrameDecoderTest, DecodesFramesOnDemand) {
+  auto generator = CreateAnimatedGenerator();
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 0;
+  options.frame_cache_bytes = 0;
+  AnimatedFrameDecoder decoder(generator, options);
+  ASSERT_FALSE(decoder.KeepsAllFrames());
+
+  const int frame_count = decoder.GetFrameCount();
+  for (int i = 0; i < 2 * frame_count; i++) {
+    auto frame = decoder.GetFrame(i % frame_count);
+    ASSERT_TRUE(frame.image);
+    ASSERT_EQ(frame.image->dimensions(), generator->GetInfo().dimensions());
+  }
+
+  // Every loop decodes every frame again.
+  auto stats = decoder.GetStats();
+  ASSERT_EQ(stats.decoded_frames, 2u * frame_count);
+  ASSERT_EQ(stats.waited_frames, 2u * frame_count);
+  ASSERT_EQ(stats.ready_frames, 0u);
+}
+
+TEST(AnimatedFrameDecoderTest, KeepsTheFramesOfShortAnimations) {
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 0;
+  AnimatedFrameDecoder decoder(CreateAnimatedGenerator(), options);
+  ASSERT_TRUE(decoder.KeepsAllFrames());
+
+  const int frame_count = decoder.GetFrameCount();
+  std::vector<sk_sp<SkImage>> first_loop;
+  for (int i = 0; i < frame_count; i++) {
+    first_loop.push_back(decoder.GetFrame(i).image);
+  }
+  for (int i = 0; i < frame_count; i++) {
+    ASSERT_EQ(decoder.GetFrame(i).image, first_loop[i]);
+  }
+
+  auto stats = decoder.GetStats();
+  ASSERT_EQ(stats.decoded_frames, static_cast<size_t>(frame_count));
+  ASSERT_EQ(stats.ready_frames, static_cast<size_t>(frame_count));
+}
+
+TEST(AnimatedFrameDecoderTest, PurgesCachedFrames) {
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 0;
+  auto decoder = std::make_unique<AnimatedFrameDecoder>(
+      CreateAnimatedGenerator(), options);
+  ASSERT_TRUE(decoder->KeepsAllFrames());
+  const size_t other_bytes = AnimatedFrameDecoder::GetCachedFrameBytes();
+
+  const int frame_count = decoder->GetFrameCount();
+  for (int i = 0; i < frame_count; i++) {
+    decoder->GetFrame(i);
+  }
+  ASSERT_GT(AnimatedFrameDecoder::GetCachedFrameBytes(), other_bytes);
+
+  // Purged frames are decoded again, and are no longer kept.
+  AnimatedFrameDecoder::PurgeCachedFrames();
+  ASSERT_FALSE(decoder->KeepsAllFrames());
+  ASSERT_EQ(AnimatedFrameDecoder::GetCachedFrameBytes(), 0u);
+  ASSERT_TRUE(decoder->GetFrame(0).image);
+  ASSERT_EQ(decoder->GetStats().decoded_frames,
+            static_cast<size_t>(frame_count) + 1);
+  ASSERT_EQ(AnimatedFrameDecoder::GetCachedFrameBytes(), 0u);
+
+  // Destroyed decoders no longer count their frames.
+  decoder = std::make_unique<AnimatedFrameDecoder>(CreateAnimatedGenerator(),
+                                                   options);
+  decoder->GetFrame(0);
+  ASSERT_GT(AnimatedFrameDecoder::GetCachedFrameBytes(), 0u);
+  decoder.reset();
+  ASSERT_EQ(AnimatedFrameDecoder::GetCachedFrameBytes(), 0u);
+}
+
+TEST(AnimatedFrameDecoderTest, DoesNotRefillPurgedCachesWhenCatchingUp) {
+  auto generator = CreateAnimatedGenerator();
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 2;
+  AnimatedFrameDecoder decoder(generator, options);
+  ASSERT_TRUE(decoder.KeepsAllFrames());
+  const size_t window_bytes =
+      options.decode_ahead_frames *
+      generator->GetInfo().makeColorType(kN32_SkColorType).computeMinByteSize();
+
+  const int frame_count = decoder.GetFrameCount();
+  ASSERT_GT(frame_count, 3);
+  const int middle = frame_count / 2;
+  for (int i = 0; i <= middle; i++) {
+    decoder.GetFrame(i);
+  }
+  AnimatedFrameDecoder::PurgeCachedFrames();
+  ASSERT_EQ(AnimatedFrameDecoder::GetCachedFrameBytes(), 0u);
+
+  ASSERT_TRUE(decoder.GetFrame(middle + 1).image);
+  ASSERT_LE(AnimatedFrameDecoder::GetCachedFrameBytes(), window_bytes);
+
+  // Wrapping around decodes the frames up to the requested one again, but
+  // does not keep them.
+  ASSERT_TRUE(decoder.GetFrame(1).image);
+  ASSERT_LE(AnimatedFrameDecoder::GetCachedFrameBytes(), window_bytes);
+}
+
+TEST(AnimatedFrameDecoderTest, TrimsTheLargestFrameCachesFirst) {
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 0;
+  AnimatedFrameDecoder large(CreateAnimatedGenerator(), options);
+  AnimatedFrameDecoder small(CreateAnimatedGenerator(), options);
+  ASSERT_TRUE(large.KeepsAllFrames());
+  ASSERT_TRUE(small.KeepsAllFrames());
+  for (int i = 0; i < large.GetFrameCount(); i++) {
+    large.GetFrame(i);
+  }
+  small.GetFrame(0);
+  const size_t small_bytes =
+      CreateAnimatedGenerator()->GetInfo().computeMinByteSize();
+  const size_t other_bytes = AnimatedFrameDecoder::GetCachedFrameBytes() -
+                             large.GetFrameCount() * small_bytes - small_bytes;
+
+  // Dropping the frames of the large cache is enough.
+  AnimatedFrameDecoder::TrimCachedFrames(1);
+  ASSERT_FALSE(large.KeepsAllFrames());
+  ASSERT_TRUE(small.KeepsAllFrames());
+  ASSERT_EQ(AnimatedFrameDecoder::GetCachedFrameBytes(),
+            other_bytes + small_bytes);
+}
+
+TEST(AnimatedFrameDecoderTest, SharesTheFrameCacheBudget) {
+  auto generator = CreateAnimatedGenerator();
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 0;
+  options.frame_cache_bytes =
+      generator->GetFrameCount() *
+      generator->GetInfo().makeColorType(kN32_SkColorType).computeMinByteSize();
+  auto first = std::make_unique<AnimatedFrameDecoder>(generator, options);
+  ASSERT_TRUE(first->KeepsAllFrames());
+
+  // The first animation takes the whole budget.
+  AnimatedFrameDecoder second(CreateAnimatedGenerator(), options);
+  ASSERT_FALSE(second.KeepsAllFrames());
+
+  // Purged decoders release their share of the budget.
+  AnimatedFrameDecoder::PurgeCachedFrames();
+  auto third = std::make_unique<AnimatedFrameDecoder>(CreateAnimatedGenerator(),
+                                                      options);
+  ASSERT_TRUE(third->KeepsAllFrames());
+
+  // So do destroyed decoders.
+  third.reset();
+  AnimatedFrameDecoder fourth(CreateAnimatedGenerator(), options);
+  ASSERT_TRUE(fourth.KeepsAllFrames());
+}
+
+TEST(AnimatedFrameDecoderTest, DecodesFramesAhead) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto scheduler = std::make_shared<ImageDecodeScheduler>(
+      loop->GetTaskRunner(), ImageDecodeScheduler::Limits{1, 1, 1});
+
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = 2;
+  options.frame_cache_bytes = 0;
+  auto decoder = std::make_shared<AnimatedFrameDecoder>(
+      CreateAnimatedGenerator(), options);
+  AnimatedFrameDecoder reference(CreateAnimatedGenerator(), options);
+
+  const int frame_count = decoder->GetFrameCount();
+  for (int i = 0; i < 2 * frame_count; i++) {
+    const int index = i % frame_count;
+    auto frame = decoder->GetFrame(index);
+    auto expected_frame = reference.GetFrame(index);
+    // Frames decoded ahead match the frames decoded in order on demand.
+    ASSERT_TRUE(HaveSamePixels(frame.image, expected_frame.image));
+    ASSERT_EQ(frame.duration, expected_frame.duration);
+
+    decoder->DecodeAhead(index, scheduler);
+    // A single job runs at once, so this runs after the frames are decoded.
+    fml::AutoResetWaitableEvent latch;
+    scheduler->Schedule(
+        ImageDecodeScheduler::Priority::kPrefetch,
+        [&latch]() { latch.Signal(); }, nullptr);
+    latch.Wait();
+  }
+
+  // Only the very first frame had to be decoded on demand.
+  auto stats = decoder->GetStats();
+  ASSERT_EQ(stats.waited_frames, 1u);
+  ASSERT_EQ(stats.ready_frames, 2u * frame_count - 1);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,164 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/box_downsampler.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/row_bands.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kChannels = 4;
+
+}  // namespace
+
+bool BoxDownsampler::CanDownsample(const SkImageInfo& info,
+                                   SkISize dimensions) {
+  return (info.colorType() == kRGBA_8888_SkColorType ||
+          info.colorType() == kBGRA_8888_SkColorType) &&
+         (info.alphaType() == kPremul_SkAlphaType ||
+          info.alphaType() == kOpaque_SkAlphaType) &&
+         !dimensions.isEmpty() && dimensions.width() <= info.width() &&
+         dimensions.height() <= info.height();
+}
+
+bool BoxDownsampler::Downsample(
+    const SkPixmap& src,
+    const SkPixmap& dst,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& runner) {
+  TRACE_EVENT0("flutter", "BoxDownsampler::Downsample");
+  if (!CanDownsample(src.info(), dst.dimensions()) ||
+      src.colorType() != dst.colorType()) {
+    return false;
+  }
+
+  const RowBands bands(dst.height(),
+                       static_cast<int64_t>(src.width()) * src.height(),
+                       runner);
+  bands.Process([&src, &dst, &bands](int band) {
+    TRACE_EVENT0("flutter", "BoxDownsampler::DownsampleBand");
+    BoxDownsampler downsampler(src.dimensions(), dst, bands.GetTop(band),
+                               bands.GetBottom(band));
+    for (int y = downsampler.GetSourceTop(); y < downsampler.GetSourceBottom();
+         y++) {
+      downsampler.AddRow(y, src.addr(0, y));
+    }
+  });
+  return true;
+}
+
+BoxDownsampler::BoxDownsampler(SkISize src_dimensions,
+                               const SkPixmap& dst,
+                               int dst_top,
+                               int dst_bottom)
+    : src_dimensions_(src_dimensions),
+      dst_(dst),
+      dst_top_(dst_top),
+      dst_bottom_(dst_bottom),
+      src_top_(static_cast<int64_t>(dst_top) * src_dimensions.height() /
+               dst.height()),
+      src_bottom_((static_cast<int64_t>(dst_bottom) * src_dimensions.height() +
+                   dst.height() - 1) /
+                  dst.height()),
+      current_row_(dst_top),
+      current_sums_(dst.width() * kChannels),
+      next_sums_(dst.width() * kChannels),
+      row_sums_(dst.width() * kChannels) {
+  FML_DCHECK(CanDownsample(dst.info().makeDimensions(src_dimensions),
+                           dst.dimensions()));
+  FML_DCHECK(dst_top >= 0 && dst_top <= dst_bottom &&
+             dst_bottom <= dst.height());
+  columns_.reserve(src_dimensions.width());
+  for (int x = 0; x < src_dimensions.width(); x++) {
+    columns_.push_back(GetCoverage(x, src_dimensions.width(), dst.width()));
+  }
+}
+
+BoxDownsampler::BoxDownsampler(SkISize src_dimensions, const SkPixmap& dst)
+    : BoxDownsampler(src_dimensions, dst, 0, dst.height()) {}
+
+BoxDownsampler::~BoxDownsampler() = default;
+
+BoxDownsampler::Coverage BoxDownsampler::GetCoverage(int src_index,
+                                                     int src_size,
+                                                     int dst_size) {
+  // Measured in units in which a source pixel is |dst_size| long and a
+  // destination pixel is |src_size| long, so that the bounds of all the
+  // pixels are integers.
+  const int64_t start = static_cast<int64_t>(src_index) * dst_size;
+  const int64_t end = start + dst_size;
+  const int64_t first = start / src_size;
+  const int64_t first_overlap = std::min(end, (first + 1) * src_size) - start;
+  return {static_cast<int>(first),
+          static_cast<float>(first_overlap) / src_size,
+          static_cast<float>(dst_size - first_overlap) / src_size};
+}
+
+void BoxDownsampler::AddRow(int y, const void* row) {
+  FML_DCHECK(y >= src_top_ && y < src_bottom_);
+
+  // Downsample the row horizontally.
+  std::fill(row_sums_.begin(), row_sums_.end(), 0.0f);
+  const auto* pixels = static_cast<const uint8_t*>(row);
+  for (const Coverage& column : columns_) {
+    float* sums = &row_sums_[column.first * kChannels];
+    for (int c = 0; c < kChannels; c++) {
+      sums[c] += pixels[c] * column.first_weight;
+    }
+    if (column.second_weight > 0) {
+      for (int c = 0; c < kChannels; c++) {
+        sums[kChannels + c] += pixels[c] * column.second_weight;
+      }
+    }
+    pixels += kChannels;
+  }
+
+  // Add it to the destination rows it covers.
+  const Coverage coverage =
+      GetCoverage(y, src_dimensions_.height(), dst_.height());
+  const int rows[] = {coverage.first, coverage.first + 1};
+  const float weights[] = {coverage.first_weight, coverage.second_weight};
+  for (int i = 0; i < 2; i++) {
+    std::vector<float>* sums = nullptr;
+    if (rows[i] == current_row_) {
+      sums = &current_sums_;
+    } else if (rows[i] == current_row_ + 1) {
+      sums = &next_sums_;
+    }
+    // Rows above the band are only partially covered by the band's first
+    // source row, and are left to the band above.
+    if (!sums || weights[i] == 0) {
+      continue;
+    }
+    for (size_t j = 0; j < row_sums_.size(); j++) {
+      (*sums)[j] += row_sums_[j] * weights[i];
+    }
+  }
+
+  // Write the rows that end at or before the end of this row.
+  while (current_row_ < dst_bottom_ &&
+         static_cast<int64_t>(y + 1) * dst_.height() >=
+             static_cast<int64_t>(current_row_ + 1) *
+                 src_dimensions_.height()) {
+    WriteCurrentRow();
+  }
+}
+
+void BoxDownsampler::WriteCurrentRow() {
+  auto* pixels = static_cast<uint8_t*>(dst_.writable_addr(0, current_row_));
+  for (size_t i = 0; i < current_sums_.size(); i++) {
+    pixels[i] = static_cast<uint8_t>(
+        std::clamp(static_cast<int>(current_sums_[i] + 0.5f), 0, 255));
+  }
+  std::swap(current_sums_, next_sums_);
+  std::fill(next_sums_.begin(), next_sums_.end(), 0.0f);
+  current_row_++;
+}
+
+}  // namespace flutter
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_BOX_DOWNSAMPLER_H_
+#define FLUTTER_LIB_UI_PAINTING_BOX_DOWNSAMPLER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace flutter {
+
+// Downsamples images with 8-bit RGBA or BGRA premultiplied pixels, by
+// averaging the source pixels that each destination pixel covers.
+//
+// Unlike bilinear filtering, every source pixel contributes to the result, so
+// large downscales do not alias. The source rows are added from top to bottom
+// one at a time, so that the source image never needs to be fully decoded, and
+// the destination can be split into bands of rows that are downsampled in
+// parallel.
+class BoxDownsampler {
+ public:
+  // Returns whether images with |info| can be downsampled to |dimensions|.
+  static bool CanDownsample(const SkImageInfo& info, SkISize dimensions);
+
+  // Downsamples |src| into |dst|, which must have the same color type. The
+  // rows of |dst| are split into bands, which are downsampled on the calling
+  // thread and on the workers of |runner| if there is one. Returns false if
+  // the images cannot be downsampled.
+  static bool Downsample(
+      const SkPixmap& src,
+      const SkPixmap& dst,
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& runner);
+
+  // Downsamples the rows of a source image with |src_dimensions| into the rows
+  // [|dst_top|, |dst_bottom|) of |dst|.
+  BoxDownsampler(SkISize src_dimensions,
+                 const SkPixmap& dst,
+                 int dst_top,
+                 int dst_bottom);
+
+  // Downsamples the rows of a source image into all the rows of |dst|.
+  BoxDownsampler(SkISize src_dimensions, const SkPixmap& dst);
+
+  ~BoxDownsampler();
+
+  // The first source row that covers the destination rows.
+  int GetSourceTop() const { return src_top_; }
+
+  // The source row after the last one that covers the destination rows.
+  int GetSourceBottom() const { return src_bottom_; }
+
+  // Adds the source row |y|. The rows must be added in order, from
+  // |GetSourceTop|. Each destination row is written as soon as all the source
+  // rows that cover it have been added.
+  void AddRow(int y, const void* row);
+
+ private:
+  // How a source column or row contributes to the destination, in which it
+  // covers at most two columns or rows.
+  struct Coverage {
+    int first;
+    float first_weight;
+    float second_weight;
+  };
+
+  const SkISize src_dimensions_;
+  const SkPixmap dst_;
+  const int dst_top_;
+  const int dst_bottom_;
+  const int src_top_;
+  const int src_bottom_;
+  std::vector<Coverage> columns_;
+  // The destination row that is being accumulated, and the sums of the
+  // channels of that row and the next one.
+  int current_row_;
+  std::vector<float> current_sums_;
+  std::vector<float> next_sums_;
+  // The source row being added, downsampled horizontally.
+  std::vector<float> row_sums_;
+
+  // Returns how |src_index| covers a destination of |dst_size|.
+  static Coverage GetCoverage(int src_index, int src_size, int dst_size);
+
+  void WriteCurrentRow();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BoxDownsampler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_BOX_DOWNSAMPLER_H_
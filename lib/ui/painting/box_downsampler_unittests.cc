@@ -0,0 +1,130 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/box_downsampler.h"
+
+#include <cstring>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+SkBitmap CreateBitmap(int width, int height) {
+  SkBitmap bitmap;
+  FML_CHECK(bitmap.tryAllocPixels(
+      SkImageInfo::Make(width, height, kRGBA_8888_SkColorType,
+                        kPremul_SkAlphaType)));
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  return bitmap;
+}
+
+// Fills |bitmap| with varied premultiplied pixels.
+void FillPattern(const SkBitmap& bitmap) {
+  for (int y = 0; y < bitmap.height(); y++) {
+    auto* pixel = static_cast<uint8_t*>(bitmap.getAddr(0, y));
+    for (int x = 0; x < bitmap.width(); x++, pixel += 4) {
+      const uint8_t alpha = (x * 7 + y * 13) % 256;
+      pixel[0] = (x * 3) % (alpha + 1);
+      pixel[1] = (y * 5) % (alpha + 1);
+      pixel[2] = (x + y) % (alpha + 1);
+      pixel[3] = alpha;
+    }
+  }
+}
+
+bool HaveSamePixels(const SkBitmap& a, const SkBitmap& b) {
+  return a.dimensions() == b.dimensions() &&
+         std::memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()) == 0;
+}
+
+}  // namespace
+
+TEST(BoxDownsamplerTest, CanOnlyDownsamplePremultipliedRGBA) {
+  const auto info = SkImageInfo::Make(100, 100, kRGBA_8888_SkColorType,
+                                      kPremul_SkAlphaType);
+  ASSERT_TRUE(BoxDownsampler::CanDownsample(info, {50, 100}));
+  ASSERT_TRUE(BoxDownsampler::CanDownsample(
+      info.makeColorType(kBGRA_8888_SkColorType), {50, 50}));
+  ASSERT_FALSE(BoxDownsampler::CanDownsample(info, {200, 50}));
+  ASSERT_FALSE(BoxDownsampler::CanDownsample(info, {0, 50}));
+  ASSERT_FALSE(BoxDownsampler::CanDownsample(
+      info.makeAlphaType(kUnpremul_SkAlphaType), {50, 50}));
+  ASSERT_FALSE(BoxDownsampler::CanDownsample(
+      info.makeColorType(kRGBA_F16_SkColorType), {50, 50}));
+}
+
+TEST(BoxDownsamplerTest, AveragesTheCoveredPixels) {
+  auto src = CreateBitmap(4, 2);
+  const uint8_t values[] = {0, 100, 200, 50, 20, 40, 60, 250};
+  for (int i = 0; i < 8; i++) {
+    *src.getAddr32(i % 4, i / 4) =
+        SkPackARGB32NoCheck(255, values[i], values[i], values[i]);
+  }
+  auto dst = CreateBitmap(2, 1);
+
+  ASSERT_TRUE(BoxDownsampler::Downsample(src.pixmap(), dst.pixmap(), nullptr));
+
+  ASSERT_EQ(*dst.getAddr32(0, 0), SkPackARGB32NoCheck(255, 40, 40, 40));
+  ASSERT_EQ(*dst.getAddr32(1, 0), SkPackARGB32NoCheck(255, 140, 140, 140));
+}
+
+TEST(BoxDownsamplerTest, PreservesUniformColorsAtFractionalScales) {
+  auto src = CreateBitmap(997, 613);
+  src.eraseColor(SkColorSetARGB(128, 200, 100, 50));
+  auto dst = CreateBitmap(331, 97);
+
+  ASSERT_TRUE(BoxDownsampler::Downsample(src.pixmap(), dst.pixmap(), nullptr));
+
+  for (int y = 0; y < dst.height(); y++) {
+    for (int x = 0; x < dst.width(); x++) {
+      ASSERT_EQ(*dst.getAddr32(x, y), *src.getAddr32(0, 0));
+    }
+  }
+}
+
+TEST(BoxDownsamplerTest, BandsMatchTheWholeImage) {
+  auto src = CreateBitmap(301, 203);
+  FillPattern(src);
+  auto expected = CreateBitmap(97, 61);
+  ASSERT_TRUE(
+      BoxDownsampler::Downsample(src.pixmap(), expected.pixmap(), nullptr));
+
+  auto dst = CreateBitmap(97, 61);
+  const int bands[] = {0, 13, 14, 40, 61};
+  for (int i = 0; i < 4; i++) {
+    BoxDownsampler downsampler(src.dimensions(), dst.pixmap(), bands[i],
+                               bands[i + 1]);
+    for (int y = downsampler.GetSourceTop(); y < downsampler.GetSourceBottom();
+         y++) {
+      downsampler.AddRow(y, src.getAddr(0, y));
+    }
+  }
+
+  ASSERT_TRUE(HaveSamePixels(dst, expected));
+}
+
+TEST(BoxDownsamplerTest, DownsamplesLargeImagesInParallel) {
+  auto src = CreateBitmap(2048, 1024);
+  FillPattern(src);
+  auto expected = CreateBitmap(300, 150);
+  BoxDownsampler downsampler(src.dimensions(), expected.pixmap());
+  for (int y = 0; y < src.height(); y++) {
+    downsampler.AddRow(y, src.getAddr(0, y));
+  }
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto dst = CreateBitmap(300, 150);
+  ASSERT_TRUE(BoxDownsampler::Downsample(src.pixmap(), dst.pixmap(),
+                                         loop->GetTaskRunner()));
+
+  ASSERT_TRUE(HaveSamePixels(dst, expected));
+}
+
+}  // namespace testing
+}  // namespace flutter
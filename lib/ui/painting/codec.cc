@@ -18,10 +18,11 @@ namespace flutter {
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Codec);
 
-#define FOR_EACH_BINDING(V) \
-  V(Codec, getNextFrame)    \
-  V(Codec, frameCount)      \
-  V(Codec, repetitionCount) \
+#define FOR_EACH_BINDING(V)   \
+  V(Codec, getNextFrame)      \
+  V(Codec, frameCount)        \
+  V(Codec, repetitionCount)   \
+  V(Codec, setDecodePriority) \
   V(Codec, dispose)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
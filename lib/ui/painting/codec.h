@@ -32,7 +32,13 @@ class Codec : public RefCountedDartWrappable<Codec> {
 
   virtual Dart_Handle getNextFrame(Dart_Handle callback_handle) = 0;
 
-  void dispose();
+  // Sets the priority of the decodes started by |getNextFrame|, as the index
+  // of an |ImageDecodeScheduler::Priority|.
+  virtual void setDecodePriority(int priority) = 0;
+
+  // Releases the codec. The frames requested by |getNextFrame| that have not
+  // been delivered yet are delivered without an image.
+  virtual void dispose();
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 };
@@ -0,0 +1,161 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <iterator>
+#include <string_view>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  return hash == other.hash && target_width == other.target_width &&
+         target_height == other.target_height && row_bytes == other.row_bytes &&
+         image_info == other.image_info &&
+         (data == other.data ||
+          (data && other.data && data->equals(other.data.get())));
+}
+
+DecodedImageCache& DecodedImageCache::GetInstance() {
+  static DecodedImageCache* instance = new DecodedImageCache();
+  return *instance;
+}
+
+DecodedImageCache::DecodedImageCache(size_t budget) : budget_(budget) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(
+    const ImageDescriptor& descriptor,
+    uint32_t target_width,
+    uint32_t target_height) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  Key key;
+  key.data = descriptor.data();
+  key.image_info = descriptor.image_info();
+  key.row_bytes = descriptor.is_compressed() ? 0 : descriptor.row_bytes();
+  key.target_width = target_width;
+  key.target_height = target_height;
+
+  std::string_view bytes;
+  if (key.data) {
+    bytes = std::string_view(static_cast<const char*>(key.data->data()),
+                             key.data->size());
+  }
+  key.hash = fml::HashCombine(std::hash<std::string_view>()(bytes),
+                              key.image_info.width(), key.image_info.height(),
+                              key.image_info.colorType(),
+                              key.image_info.alphaType(), key.row_bytes,
+                              target_width, target_height);
+  return key;
+}
+
+void DecodedImageCache::GetOrDecode(Key key,
+                                    const Decoder& decoder,
+                                    ImageCallback callback) {
+  sk_sp<SkImage> cached;
+  bool coalesced = false;
+  Stats stats;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      stats_.hits++;
+      entries_.splice(entries_.begin(), entries_, found->second);
+      cached = found->second->image;
+    } else if (auto in_flight = in_flight_.find(key);
+               in_flight != in_flight_.end()) {
+      stats_.coalesced++;
+      in_flight->second.push_back(std::move(callback));
+      coalesced = true;
+    } else {
+      stats_.misses++;
+      in_flight_.emplace(key, std::vector<ImageCallback>{});
+    }
+    stats = stats_;
+  }
+  FML_TRACE_COUNTER("flutter", "DecodedImageCache",
+                    reinterpret_cast<int64_t>(this), "Hits", stats.hits,
+                    "Misses", stats.misses, "Coalesced", stats.coalesced);
+  if (coalesced) {
+    return;
+  }
+  if (cached) {
+    callback(std::move(cached));
+    return;
+  }
+
+  sk_sp<SkImage> image = decoder();
+
+  std::vector<ImageCallback> waiters;
+  {
+    std::scoped_lock lock(mutex_);
+    auto in_flight = in_flight_.find(key);
+    FML_DCHECK(in_flight != in_flight_.end());
+    waiters = std::move(in_flight->second);
+    in_flight_.erase(in_flight);
+
+    if (image) {
+      // The entry also keeps the image data alive.
+      const size_t bytes = image->imageInfo().computeMinByteSize() +
+                           (key.data ? key.data->size() : 0);
+      if (bytes <= budget_) {
+        entries_.push_front({key, image, bytes});
+        index_.emplace(std::move(key), entries_.begin());
+        stats_.entries++;
+        stats_.bytes += bytes;
+        TrimTo(budget_);
+      }
+    }
+  }
+
+  callback(image);
+  for (const ImageCallback& waiter : waiters) {
+    waiter(image);
+  }
+}
+
+void DecodedImageCache::SetBudget(size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  budget_ = bytes;
+  TrimTo(budget_);
+}
+
+void DecodedImageCache::Purge() {
+  std::scoped_lock lock(mutex_);
+  stats_.evictions += entries_.size();
+  entries_.clear();
+  index_.clear();
+  stats_.entries = 0;
+  stats_.bytes = 0;
+}
+
+void DecodedImageCache::Trim(size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  TrimTo(stats_.bytes > bytes ? stats_.bytes - bytes : 0);
+}
+
+DecodedImageCache::Stats DecodedImageCache::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  Stats stats = stats_;
+  stats.budget = budget_;
+  return stats;
+}
+
+void DecodedImageCache::TrimTo(size_t bytes) {
+  while (stats_.bytes > bytes && !entries_.empty()) {
+    EntryList::iterator oldest = std::prev(entries_.end());
+    index_.erase(oldest->key);
+    stats_.bytes -= oldest->bytes;
+    stats_.entries--;
+    stats_.evictions++;
+    entries_.erase(oldest);
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,146 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_descriptor.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// A process-wide cache of decoded raster images, shared by the image decoders
+/// of all shells.
+///
+/// Images are keyed on the bytes of the image data along with the image info
+/// of the source and the dimensions the image is decoded to. An image
+/// requested again, by the same or by another shell, is decoded only once
+/// while it stays in the cache. Requests for an image that is being decoded
+/// wait for that decode instead of starting their own.
+///
+/// The least recently used images are evicted once the memory used by the
+/// cache exceeds its budget. All methods are thread safe.
+///
+/// The number of hits, misses and coalesced requests is traced as the
+/// `DecodedImageCache` counter of the timeline, and reported along with the
+/// evictions by the `_flutter.getImageMemoryUsage` service protocol extension.
+///
+class DecodedImageCache {
+ public:
+  struct Key {
+    size_t hash = 0;
+    sk_sp<SkData> data;
+    SkImageInfo image_info;
+    size_t row_bytes = 0;
+    uint32_t target_width = 0;
+    uint32_t target_height = 0;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    // Requests that waited for a decode of the same image already in flight.
+    size_t coalesced = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t budget = 0;
+  };
+
+  using Decoder = std::function<sk_sp<SkImage>()>;
+  using ImageCallback = std::function<void(sk_sp<SkImage>)>;
+
+  static constexpr size_t kDefaultBudget = 16 << 20;
+
+  static DecodedImageCache& GetInstance();
+
+  explicit DecodedImageCache(size_t budget = kDefaultBudget);
+
+  ~DecodedImageCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the key of the image decoded from the descriptor at
+  ///             the given target dimensions. This reads all the bytes of the
+  ///             image data, so it should not be called on the UI thread.
+  ///
+  static Key MakeKey(const ImageDescriptor& descriptor,
+                     uint32_t target_width,
+                     uint32_t target_height);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Invokes the callback with the image for the key.
+  ///
+  ///             A cached image is passed to the callback right away.
+  ///             Otherwise, if the same image is being decoded on another
+  ///             thread, the callback is invoked on that thread once the
+  ///             decode completes. Otherwise, the image is decoded with the
+  ///             decoder on the calling thread, and cached if the decode
+  ///             succeeds. The image passed to the callback is null if the
+  ///             decode failed.
+  ///
+  void GetOrDecode(Key key, const Decoder& decoder, ImageCallback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the memory budget of the cache, in bytes. A budget of
+  ///             zero disables caching but still coalesces concurrent
+  ///             decodes.
+  ///
+  void SetBudget(size_t bytes);
+
+  void Purge();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Evicts the least recently used images until at least |bytes|
+  ///             are freed or the cache is empty.
+  ///
+  void Trim(size_t bytes);
+
+  Stats GetStats() const;
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  struct Entry {
+    Key key;
+    sk_sp<SkImage> image;
+    size_t bytes;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  mutable std::mutex mutex_;
+  // Entries ordered from the most to the least recently used.
+  EntryList entries_;
+  std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+  // The callbacks waiting for each image being decoded.
+  std::unordered_map<Key, std::vector<ImageCallback>, KeyHash> in_flight_;
+  size_t budget_;
+  Stats stats_;
+
+  // Evicts the least recently used images until the cache holds at most
+  // |bytes|. Must be called while holding the lock.
+  void TrimTo(size_t bytes);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
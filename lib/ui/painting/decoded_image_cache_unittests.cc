@@ -0,0 +1,174 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string>
+#include <thread>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+DecodedImageCache::Key MakeCacheKey(const char* bytes,
+                                    uint32_t target_width = 10,
+                                    uint32_t target_height = 10) {
+  DecodedImageCache::Key key;
+  key.data = SkData::MakeWithCString(bytes);
+  key.image_info = SkImageInfo::MakeN32Premul(10, 10);
+  key.target_width = target_width;
+  key.target_height = target_height;
+  key.hash = std::hash<std::string>()(bytes);
+  return key;
+}
+
+sk_sp<SkImage> MakeRasterImage() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 10);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+}  // namespace
+
+TEST(DecodedImageCacheTest, DecodesEachImageOnce) {
+  DecodedImageCache cache;
+  size_t decodes = 0;
+  auto decoder = [&decodes]() {
+    decodes++;
+    return MakeRasterImage();
+  };
+
+  sk_sp<SkImage> first;
+  sk_sp<SkImage> second;
+  cache.GetOrDecode(MakeCacheKey("avatar"), decoder,
+                    [&first](sk_sp<SkImage> image) { first = image; });
+  cache.GetOrDecode(MakeCacheKey("avatar"), decoder,
+                    [&second](sk_sp<SkImage> image) { second = image; });
+  ASSERT_EQ(decodes, 1u);
+  ASSERT_TRUE(first);
+  ASSERT_EQ(first, second);
+
+  // The same bytes decoded to other dimensions are another image.
+  cache.GetOrDecode(MakeCacheKey("avatar", 5, 5), decoder,
+                    [](sk_sp<SkImage> image) {});
+  ASSERT_EQ(decodes, 2u);
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.hits, 1u);
+  ASSERT_EQ(stats.misses, 2u);
+  ASSERT_EQ(stats.entries, 2u);
+}
+
+TEST(DecodedImageCacheTest, DoesNotCacheFailedDecodes) {
+  DecodedImageCache cache;
+  size_t decodes = 0;
+  auto decoder = [&decodes]() -> sk_sp<SkImage> {
+    decodes++;
+    return nullptr;
+  };
+
+  bool called = false;
+  cache.GetOrDecode(MakeCacheKey("invalid"), decoder,
+                    [&called](sk_sp<SkImage> image) {
+                      ASSERT_FALSE(image);
+                      called = true;
+                    });
+  cache.GetOrDecode(MakeCacheKey("invalid"), decoder,
+                    [](sk_sp<SkImage> image) {});
+  ASSERT_TRUE(called);
+  ASSERT_EQ(decodes, 2u);
+  ASSERT_EQ(cache.GetStats().entries, 0u);
+}
+
+TEST(DecodedImageCacheTest, CoalescesConcurrentDecodes) {
+  DecodedImageCache cache;
+  fml::AutoResetWaitableEvent decode_started;
+  fml::AutoResetWaitableEvent finish_decode;
+  size_t decodes = 0;
+
+  sk_sp<SkImage> first;
+  std::thread thread([&]() {
+    cache.GetOrDecode(
+        MakeCacheKey("avatar"),
+        [&]() {
+          decodes++;
+          decode_started.Signal();
+          finish_decode.Wait();
+          return MakeRasterImage();
+        },
+        [&first](sk_sp<SkImage> image) { first = image; });
+  });
+  decode_started.Wait();
+
+  sk_sp<SkImage> second;
+  cache.GetOrDecode(
+      MakeCacheKey("avatar"),
+      [&decodes]() {
+        decodes++;
+        return MakeRasterImage();
+      },
+      [&second](sk_sp<SkImage> image) { second = image; });
+  // The callback waits for the decode in flight.
+  ASSERT_FALSE(second);
+
+  finish_decode.Signal();
+  thread.join();
+  ASSERT_EQ(decodes, 1u);
+  ASSERT_TRUE(first);
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(cache.GetStats().coalesced, 1u);
+}
+
+TEST(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  const size_t image_bytes = 10 * 10 * 4;
+  DecodedImageCache cache(2 * (image_bytes + sizeof("avatar-1")));
+  auto decoder = []() { return MakeRasterImage(); };
+  auto ignore = [](sk_sp<SkImage> image) {};
+
+  cache.GetOrDecode(MakeCacheKey("avatar-1"), decoder, ignore);
+  cache.GetOrDecode(MakeCacheKey("avatar-2"), decoder, ignore);
+  // Use the first image so that the second one is evicted.
+  cache.GetOrDecode(MakeCacheKey("avatar-1"), decoder, ignore);
+  cache.GetOrDecode(MakeCacheKey("avatar-3"), decoder, ignore);
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.entries, 2u);
+  ASSERT_EQ(stats.evictions, 1u);
+  ASSERT_EQ(stats.hits, 1u);
+
+  cache.GetOrDecode(MakeCacheKey("avatar-1"), decoder, ignore);
+  ASSERT_EQ(cache.GetStats().hits, 2u);
+  cache.GetOrDecode(MakeCacheKey("avatar-2"), decoder, ignore);
+  ASSERT_EQ(cache.GetStats().misses, 4u);
+}
+
+TEST(DecodedImageCacheTest, TrimsLeastRecentlyUsedImages) {
+  DecodedImageCache cache;
+  auto decoder = []() { return MakeRasterImage(); };
+  auto ignore = [](sk_sp<SkImage> image) {};
+
+  cache.GetOrDecode(MakeCacheKey("avatar-1"), decoder, ignore);
+  cache.GetOrDecode(MakeCacheKey("avatar-2"), decoder, ignore);
+  cache.GetOrDecode(MakeCacheKey("avatar-3"), decoder, ignore);
+  cache.GetOrDecode(MakeCacheKey("avatar-1"), decoder, ignore);
+
+  // A single byte is freed by evicting the least recently used image only.
+  cache.Trim(1);
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.entries, 2u);
+  ASSERT_EQ(stats.evictions, 1u);
+  cache.GetOrDecode(MakeCacheKey("avatar-1"), decoder, ignore);
+  cache.GetOrDecode(MakeCacheKey("avatar-3"), decoder, ignore);
+  ASSERT_EQ(cache.GetStats().hits, 3u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/lib/ui/painting/image.h"
 
+#include <atomic>
+
 #include "flutter/lib/ui/painting/image_encoding.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
@@ -23,6 +25,16 @@ static const tonic::DartWrapperInfo kDartWrapperInfo_ui_Image = {
 const tonic::DartWrapperInfo& Image::dart_wrapper_info_ =
     kDartWrapperInfo_ui_Image;
 
+namespace {
+
+std::atomic<size_t> g_live_image_bytes = 0;
+
+size_t GetImageBytes(const sk_sp<SkImage>& image) {
+  return image ? image->imageInfo().computeMinByteSize() : 0;
+}
+
+}  // namespace
+
 #define FOR_EACH_BINDING(V) \
   V(Image, width)           \
   V(Image, height)          \
@@ -37,14 +49,40 @@ void CanvasImage::RegisterNatives(tonic::DartLibraryNatives* natives) {
 
 CanvasImage::CanvasImage() = default;
 
-CanvasImage::~CanvasImage() = default;
+CanvasImage::~CanvasImage() {
+  ResetImage();
+}
 
-Dart_Handle CanvasImage::toByteData(int format, Dart_Handle callback) {
-  return EncodeImage(this, format, callback);
+void CanvasImage::set_image(flutter::SkiaGPUObject<SkImage> image) {
+  g_live_image_bytes += GetImageBytes(image.skia_object());
+  ResetImage();
+  image_ = std::move(image);
 }
 
-void CanvasImage::dispose() {
+size_t CanvasImage::GetLiveImageBytes() {
+  return g_live_image_bytes;
+}
+
+void CanvasImage::ResetImage() {
+  g_live_image_bytes -= GetImageBytes(image_.skia_object());
   image_.reset();
+}
+
+Dart_Handle CanvasImage::toByteData(int format,
+                                    int compression_level,
+                                    int png_filter,
+                                    int quality,
+                                    Dart_Handle callback) {
+  ImageEncodingOptions options;
+  options.format = static_cast<ImageByteFormat>(format);
+  options.compression_level = compression_level;
+  options.png_filter = static_cast<PngFilter>(png_filter);
+  options.quality = quality;
+  return EncodeImage(this, options, callback);
+}
+
+void CanvasImage::dispose() {
+  ResetImage();
   ClearDartWrapper();
 }
 
@@ -30,23 +30,31 @@ class CanvasImage final : public RefCountedDartWrappable<CanvasImage> {
 
   int height() { return image_.skia_object()->height(); }
 
-  Dart_Handle toByteData(int format, Dart_Handle callback);
+  Dart_Handle toByteData(int format,
+                         int compression_level,
+                         int png_filter,
+                         int quality,
+                         Dart_Handle callback);
 
   void dispose();
 
   sk_sp<SkImage> image() const { return image_.skia_object(); }
-  void set_image(flutter::SkiaGPUObject<SkImage> image) {
-    image_ = std::move(image);
-  }
+  void set_image(flutter::SkiaGPUObject<SkImage> image);
 
   size_t GetAllocationSize() const override;
 
+  // Returns the bytes of the pixels of all the images that are held by
+  // |CanvasImage|s in the process.
+  static size_t GetLiveImageBytes();
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
   CanvasImage();
 
   flutter::SkiaGPUObject<SkImage> image_;
+
+  void ResetImage();
 };
 
 }  // namespace flutter
@@ -0,0 +1,246 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
+
+#include <algorithm>
+#include <map>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+struct ImageDecodeScheduler::WorkerPool {
+  // Also keeps the address of the task runner, which identifies the pool,
+  // from being reused while the pool is alive.
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner;
+  std::mutex mutex;
+  size_t running_count = 0;
+  // The schedulers with queued jobs waiting for a running job to end.
+  std::vector<std::weak_ptr<ImageDecodeScheduler>> waiting_schedulers;
+
+  // Returns the pool of |task_runner|, shared with the other schedulers and
+  // the worker reservations that use it.
+  static std::shared_ptr<WorkerPool> Get(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+    static std::mutex pools_mutex;
+    static auto* pools =
+        new std::map<fml::ConcurrentTaskRunner*, std::weak_ptr<WorkerPool>>();
+    std::scoped_lock lock(pools_mutex);
+    for (auto it = pools->begin(); it != pools->end();) {
+      it = it->second.expired() ? pools->erase(it) : std::next(it);
+    }
+    std::weak_ptr<WorkerPool>& entry = (*pools)[task_runner.get()];
+    std::shared_ptr<WorkerPool> pool = entry.lock();
+    if (!pool) {
+      pool = std::make_shared<WorkerPool>();
+      pool->task_runner = std::move(task_runner);
+      entry = pool;
+    }
+    return pool;
+  }
+};
+
+ImageDecodeScheduler::Limits ImageDecodeScheduler::GetDefaultLimits(
+    size_t worker_count) {
+  // Leave at least one worker for the other tasks in the pool, and only run
+  // background decodes while no other decodes are running.
+  const size_t visible = std::max<size_t>(worker_count, 2) - 1;
+  const size_t prefetch = std::max<size_t>(visible / 2, 1);
+  return {visible, prefetch, 1};
+}
+
+ImageDecodeScheduler::ImageDecodeScheduler(
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+    Limits limits,
+    Reserve reserve)
+    : pool_(WorkerPool::Get(std::move(concurrent_task_runner))),
+      limits_(limits),
+      reserve_(std::move(reserve)) {
+  FML_DCHECK(pool_->task_runner);
+}
+
+ImageDecodeScheduler::~ImageDecodeScheduler() {
+  // Running jobs keep the scheduler alive, so all the remaining jobs are
+  // queued. Their owners may be waiting for them to complete.
+  for (JobQueue& queue : queues_) {
+    for (Job& job : queue) {
+      if (job.on_cancel) {
+        job.on_cancel();
+      }
+    }
+  }
+}
+
+ImageDecodeScheduler::JobId ImageDecodeScheduler::Schedule(
+    Priority priority,
+    fml::closure task,
+    fml::closure on_cancel,
+    size_t cost) {
+  JobId id;
+  {
+    std::scoped_lock lock(mutex_);
+    id = next_job_id_++;
+    JobQueue& queue = queues_[static_cast<size_t>(priority)];
+    queue.push_back({id, std::move(task), std::move(on_cancel), cost});
+    locations_[id] = {priority, std::prev(queue.end())};
+  }
+  Dispatch();
+  return id;
+}
+
+bool ImageDecodeScheduler::SetPriority(JobId job, Priority priority) {
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = locations_.find(job);
+    if (found == locations_.end()) {
+      return false;
+    }
+    JobLocation& location = found->second;
+    if (location.priority == priority) {
+      return true;
+    }
+    JobQueue& from = queues_[static_cast<size_t>(location.priority)];
+    JobQueue& to = queues_[static_cast<size_t>(priority)];
+    to.splice(to.end(), from, location.position);
+    location.priority = priority;
+  }
+  // A higher priority may allow the job to start right away.
+  Dispatch();
+  return true;
+}
+
+bool ImageDecodeScheduler::Cancel(JobId job) {
+  fml::closure on_cancel;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = locations_.find(job);
+    if (found == locations_.end()) {
+      return false;
+    }
+    JobQueue& queue = queues_[static_cast<size_t>(found->second.priority)];
+    on_cancel = std::move(found->second.position->on_cancel);
+    queue.erase(found->second.position);
+    locations_.erase(found);
+  }
+  if (on_cancel) {
+    on_cancel();
+  }
+  // The cancelled job may have been waiting for resources in front of others.
+  Dispatch();
+  return true;
+}
+
+size_t ImageDecodeScheduler::GetQueuedCount(Priority priority) const {
+  std::scoped_lock lock(mutex_);
+  return queues_[static_cast<size_t>(priority)].size();
+}
+
+size_t ImageDecodeScheduler::GetRunningCount() const {
+  std::scoped_lock lock(mutex_);
+  return running_count_;
+}
+
+void ImageDecodeScheduler::Dispatch() {
+  std::vector<fml::closure> tasks;
+  {
+    std::scoped_lock lock(mutex_, pool_->mutex);
+    bool waiting_for_resources = false;
+    bool waiting_for_worker = false;
+    for (size_t priority = 0;
+         priority < kPriorityCount && !waiting_for_resources; priority++) {
+      JobQueue& queue = queues_[priority];
+      while (!queue.empty()) {
+        if (pool_->running_count >= limits_[priority]) {
+          waiting_for_worker = true;
+          break;
+        }
+        // The jobs behind a job waiting for resources wait too, so that
+        // costly jobs are not starved by a stream of cheap ones.
+        if (reserve_ && !reserve_(queue.front().cost)) {
+          waiting_for_resources = true;
+          break;
+        }
+        locations_.erase(queue.front().id);
+        tasks.push_back(std::move(queue.front().task));
+        queue.pop_front();
+        running_count_++;
+        pool_->running_count++;
+      }
+    }
+    if (waiting_for_worker) {
+      std::weak_ptr<ImageDecodeScheduler> self = weak_from_this();
+      auto& waiting = pool_->waiting_schedulers;
+      auto found = std::find_if(
+          waiting.begin(), waiting.end(), [&self](const auto& scheduler) {
+            return !scheduler.owner_before(self) &&
+                   !self.owner_before(scheduler);
+          });
+      if (found == waiting.end()) {
+        waiting.push_back(std::move(self));
+      }
+    }
+  }
+  for (fml::closure& task : tasks) {
+    pool_->task_runner->PostTask(
+        [scheduler = shared_from_this(), task = std::move(task)]() {
+          scheduler->RunJob(task);
+        });
+  }
+}
+
+ImageDecodeScheduler::WorkerReservation::WorkerReservation(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+    size_t max_count)
+    : pool_(WorkerPool::Get(std::move(task_runner))) {
+  const Limits limits = GetDefaultLimits(pool_->task_runner->GetWorkerCount());
+  const size_t limit = limits[static_cast<size_t>(Priority::kVisible)];
+  std::scoped_lock lock(pool_->mutex);
+  if (pool_->running_count < limit) {
+    count_ = std::min(max_count, limit - pool_->running_count);
+    pool_->running_count += count_;
+  }
+}
+
+ImageDecodeScheduler::WorkerReservation::~WorkerReservation() {
+  if (count_ == 0) {
+    return;
+  }
+  std::vector<std::weak_ptr<ImageDecodeScheduler>> waiting;
+  {
+    std::scoped_lock lock(pool_->mutex);
+    FML_DCHECK(pool_->running_count >= count_);
+    pool_->running_count -= count_;
+    waiting.swap(pool_->waiting_schedulers);
+  }
+  for (const auto& weak_scheduler : waiting) {
+    if (auto scheduler = weak_scheduler.lock()) {
+      scheduler->Dispatch();
+    }
+  }
+}
+
+void ImageDecodeScheduler::RunJob(fml::closure task) {
+  TRACE_EVENT0("flutter", "ImageDecodeScheduler::RunJob");
+  task();
+  std::vector<std::weak_ptr<ImageDecodeScheduler>> waiting;
+  {
+    std::scoped_lock lock(mutex_, pool_->mutex);
+    FML_DCHECK(running_count_ > 0);
+    running_count_--;
+    pool_->running_count--;
+    waiting.swap(pool_->waiting_schedulers);
+  }
+  Dispatch();
+  // The worker may also be available to the jobs of other schedulers.
+  for (const auto& weak_scheduler : waiting) {
+    auto scheduler = weak_scheduler.lock();
+    if (scheduler && scheduler.get() != this) {
+      scheduler->Dispatch();
+    }
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,170 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_SCHEDULER_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_SCHEDULER_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+// Schedules image decodes on the concurrent worker pool in priority order.
+//
+// Jobs are queued by priority and handed to the worker pool only once a slot
+// is available, so that decodes for images that just scrolled into view are
+// not stuck behind the decodes for images that already scrolled away. The
+// priority of a queued job can be changed, and a queued job can be cancelled.
+//
+// Each priority bounds the number of decodes running at once when a job of
+// that priority is started. Lower priorities have lower limits, which leaves
+// worker threads free for visible images and for the other tasks that share
+// the pool, like Skia's. The limits bound the decodes of all the schedulers
+// that share a task runner, like the engines sharing the worker pool of the
+// Dart VM, and not only the decodes of each scheduler.
+//
+// Jobs may also reserve resources, like the memory of their decoded image,
+// before they start. A job whose reservation is refused stays queued, along
+// with the jobs behind it, until |Dispatch| is called once resources have
+// been released.
+//
+// Jobs that are still queued when the scheduler is destroyed are cancelled.
+//
+// A running job may also reserve more workers of the pool with a
+// |WorkerReservation|, to split its work across them. The reserved workers
+// count against the limits like running decodes.
+//
+// All methods are thread safe.
+class ImageDecodeScheduler
+    : public std::enable_shared_from_this<ImageDecodeScheduler> {
+ public:
+  enum class Priority {
+    // The image is visible or about to be.
+    kVisible,
+    // The image will likely become visible soon, for example because it is
+    // next in the scroll direction.
+    kPrefetch,
+    // The image is not expected to become visible soon.
+    kBackground,
+  };
+
+  static constexpr size_t kPriorityCount = 3;
+
+  using JobId = uint64_t;
+
+  // The identifier of a job that was never scheduled.
+  static constexpr JobId kInvalidJobId = 0;
+
+  // The maximum number of decodes running at once, indexed by priority.
+  using Limits = std::array<size_t, kPriorityCount>;
+
+  // Reserves the resources of a job of the given cost before it starts.
+  // Returns false if the job must wait for resources to be released. Called
+  // with the scheduler's lock held, so it must not call into the scheduler.
+  using Reserve = std::function<bool(size_t cost)>;
+
+  // Returns the limits used by default for a pool of |worker_count| threads.
+  static Limits GetDefaultLimits(size_t worker_count);
+
+  class WorkerReservation;
+
+  ImageDecodeScheduler(
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+      Limits limits,
+      Reserve reserve = nullptr);
+
+  ~ImageDecodeScheduler();
+
+  // Queues |task| to run on the worker pool. If the job is cancelled before
+  // it is started, |on_cancel| runs instead on the thread cancelling the job.
+  // |cost| is passed to the reserve callback before the job starts.
+  JobId Schedule(Priority priority,
+                 fml::closure task,
+                 fml::closure on_cancel,
+                 size_t cost = 0);
+
+  // Changes the priority of a queued job. Returns false if the job has
+  // already started or does not exist.
+  bool SetPriority(JobId job, Priority priority);
+
+  // Cancels a queued job. Returns false if the job has already started or
+  // does not exist.
+  bool Cancel(JobId job);
+
+  // Returns the number of jobs waiting for a worker with the given priority.
+  size_t GetQueuedCount(Priority priority) const;
+
+  // Returns the number of jobs of this scheduler running on the worker pool.
+  size_t GetRunningCount() const;
+
+  // Posts queued jobs to the worker pool while the limits and the reserve
+  // callback allow it. Must be called once resources that a queued job may
+  // be waiting for have been released.
+  void Dispatch();
+
+ private:
+  struct Job {
+    JobId id;
+    fml::closure task;
+    fml::closure on_cancel;
+    size_t cost;
+  };
+
+  using JobQueue = std::list<Job>;
+
+  struct JobLocation {
+    Priority priority;
+    JobQueue::iterator position;
+  };
+
+  // The jobs running on a task runner, across all of its schedulers.
+  struct WorkerPool;
+
+  const std::shared_ptr<WorkerPool> pool_;
+  const Limits limits_;
+  const Reserve reserve_;
+  mutable std::mutex mutex_;
+  std::array<JobQueue, kPriorityCount> queues_;
+  std::unordered_map<JobId, JobLocation> locations_;
+  JobId next_job_id_ = kInvalidJobId + 1;
+  size_t running_count_ = 0;
+
+  void RunJob(fml::closure task);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecodeScheduler);
+};
+
+// Reserves up to |max_count| workers of a task runner, within the default
+// limit of the visible decodes of its pool, until it is destroyed. Reserves
+// fewer workers, possibly none, when the pool is busy.
+class ImageDecodeScheduler::WorkerReservation {
+ public:
+  WorkerReservation(std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+                    size_t max_count);
+
+  ~WorkerReservation();
+
+  // The number of workers reserved.
+  size_t GetCount() const { return count_; }
+
+ private:
+  const std::shared_ptr<WorkerPool> pool_;
+  size_t count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WorkerReservation);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_SCHEDULER_H_
@@ -0,0 +1,279 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+using Priority = ImageDecodeScheduler::Priority;
+
+class ImageDecodeSchedulerTest : public ::testing::Test {
+ public:
+  ImageDecodeSchedulerTest()
+      : scheduler_(std::make_shared<ImageDecodeScheduler>(
+            GetLoop()->GetTaskRunner(),
+            ImageDecodeScheduler::Limits{2, 1, 1})) {}
+
+  ImageDecodeScheduler& scheduler() { return *scheduler_; }
+
+  // The loop is shared by all tests. A worker posting the next job holds a
+  // reference to the loop, which must not be the last one.
+  static std::shared_ptr<fml::ConcurrentMessageLoop> GetLoop() {
+    static auto loop = fml::ConcurrentMessageLoop::Create(4);
+    return loop;
+  }
+
+  // Schedules a job that blocks its worker until |Unblock| is called.
+  void ScheduleBlockingJob() {
+    fml::AutoResetWaitableEvent started;
+    scheduler_->Schedule(
+        Priority::kVisible,
+        [this, &started]() {
+          started.Signal();
+          unblock_.Wait();
+        },
+        nullptr);
+    started.Wait();
+  }
+
+  void Unblock() { unblock_.Signal(); }
+
+  // Schedules a job that records its name once it runs.
+  ImageDecodeScheduler::JobId ScheduleNamedJob(Priority priority,
+                                               std::string name,
+                                               fml::CountDownLatch& latch) {
+    return scheduler_->Schedule(
+        priority,
+        [this, name, &latch]() {
+          {
+            std::scoped_lock lock(mutex_);
+            order_.push_back(name);
+          }
+          latch.CountDown();
+        },
+        nullptr);
+  }
+
+  std::vector<std::string> GetOrder() {
+    std::scoped_lock lock(mutex_);
+    return order_;
+  }
+
+ private:
+  std::shared_ptr<ImageDecodeScheduler> scheduler_;
+  fml::ManualResetWaitableEvent unblock_;
+  std::mutex mutex_;
+  std::vector<std::string> order_;
+};
+
+}  // namespace
+
+TEST_F(ImageDecodeSchedulerTest, RunsJobsInPriorityOrder) {
+  // Occupy the only slot available to prefetch and background jobs.
+  ScheduleBlockingJob();
+
+  fml::CountDownLatch latch(2);
+  ScheduleNamedJob(Priority::kBackground, "background", latch);
+  ScheduleNamedJob(Priority::kPrefetch, "prefetch", latch);
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kBackground), 1u);
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kPrefetch), 1u);
+
+  Unblock();
+  latch.Wait();
+  ASSERT_EQ(GetOrder(),
+            (std::vector<std::string>{"prefetch", "background"}));
+}
+
+TEST_F(ImageDecodeSchedulerTest, ChangesThePriorityOfQueuedJobs) {
+  ScheduleBlockingJob();
+
+  fml::CountDownLatch latch(2);
+  ScheduleNamedJob(Priority::kBackground, "first", latch);
+  auto second = ScheduleNamedJob(Priority::kBackground, "second", latch);
+  ASSERT_TRUE(scheduler().SetPriority(second, Priority::kPrefetch));
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kBackground), 1u);
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kPrefetch), 1u);
+
+  Unblock();
+  latch.Wait();
+  ASSERT_EQ(GetOrder(), (std::vector<std::string>{"second", "first"}));
+  // Started jobs cannot be changed anymore.
+  ASSERT_FALSE(scheduler().SetPriority(second, Priority::kVisible));
+}
+
+TEST_F(ImageDecodeSchedulerTest, CancelsQueuedJobs) {
+  ScheduleBlockingJob();
+
+  bool ran = false;
+  bool cancelled = false;
+  auto job = scheduler().Schedule(
+      Priority::kBackground, [&ran]() { ran = true; },
+      [&cancelled]() { cancelled = true; });
+  ASSERT_TRUE(scheduler().Cancel(job));
+  ASSERT_TRUE(cancelled);
+  ASSERT_FALSE(scheduler().Cancel(job));
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kBackground), 0u);
+
+  fml::CountDownLatch latch(1);
+  ScheduleNamedJob(Priority::kBackground, "after", latch);
+  Unblock();
+  latch.Wait();
+  ASSERT_FALSE(ran);
+}
+
+TEST_F(ImageDecodeSchedulerTest, BoundsConcurrencyByPriority) {
+  ScheduleBlockingJob();
+
+  // Lower priorities wait while a visible job runs...
+  fml::CountDownLatch latch(2);
+  ScheduleNamedJob(Priority::kPrefetch, "prefetch", latch);
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kPrefetch), 1u);
+
+  // ...but another visible job can still start.
+  fml::CountDownLatch visible_latch(1);
+  ScheduleNamedJob(Priority::kVisible, "visible", visible_latch);
+  visible_latch.Wait();
+  ASSERT_EQ(scheduler().GetQueuedCount(Priority::kPrefetch), 1u);
+
+  Unblock();
+  ScheduleNamedJob(Priority::kBackground, "background", latch);
+  latch.Wait();
+  ASSERT_EQ(GetOrder(), (std::vector<std::string>{"visible", "prefetch",
+                                                   "background"}));
+}
+
+TEST(ImageDecodeSchedulerReserveTest, QueuesJobsUntilResourcesAreReleased) {
+  std::mutex mutex;
+  size_t available = 0;
+  auto scheduler = std::make_shared<ImageDecodeScheduler>(
+      ImageDecodeSchedulerTest::GetLoop()->GetTaskRunner(),
+      ImageDecodeScheduler::Limits{2, 2, 2}, [&mutex, &available](size_t cost) {
+        std::scoped_lock lock(mutex);
+        if (cost > available) {
+          return false;
+        }
+        available -= cost;
+        return true;
+      });
+
+  fml::CountDownLatch latch(1);
+  bool cancelled = false;
+  auto costly = scheduler->Schedule(
+      Priority::kVisible, []() {}, [&cancelled]() { cancelled = true; }, 10);
+  // Waits behind the costly job, although it is cheap.
+  scheduler->Schedule(
+      Priority::kBackground, [&latch]() { latch.CountDown(); }, nullptr, 1);
+  ASSERT_EQ(scheduler->GetQueuedCount(Priority::kVisible), 1u);
+  ASSERT_EQ(scheduler->GetQueuedCount(Priority::kBackground), 1u);
+
+  // Jobs waiting for resources can still be cancelled.
+  ASSERT_TRUE(scheduler->Cancel(costly));
+  ASSERT_TRUE(cancelled);
+
+  {
+    std::scoped_lock lock(mutex);
+    available = 1;
+  }
+  scheduler->Dispatch();
+  latch.Wait();
+  ASSERT_EQ(scheduler->GetQueuedCount(Priority::kBackground), 0u);
+}
+
+TEST(ImageDecodeSchedulerPoolTest, SharesTheLimitsOfATaskRunner) {
+  auto task_runner = ImageDecodeSchedulerTest::GetLoop()->GetTaskRunner();
+  const ImageDecodeScheduler::Limits limits = {1, 1, 1};
+  auto first = std::make_shared<ImageDecodeScheduler>(task_runner, limits);
+  auto second = std::make_shared<ImageDecodeScheduler>(task_runner, limits);
+
+  fml::AutoResetWaitableEvent started;
+  fml::AutoResetWaitableEvent unblock;
+  first->Schedule(
+      Priority::kVisible,
+      [&started, &unblock]() {
+        started.Signal();
+        unblock.Wait();
+      },
+      nullptr);
+  started.Wait();
+
+  // The job of the other scheduler waits for the worker used by the first.
+  fml::AutoResetWaitableEvent ran;
+  second->Schedule(
+      Priority::kVisible, [&ran]() { ran.Signal(); }, nullptr);
+  ASSERT_EQ(second->GetQueuedCount(Priority::kVisible), 1u);
+  ASSERT_EQ(second->GetRunningCount(), 0u);
+
+  unblock.Signal();
+  ran.Wait();
+  ASSERT_EQ(second->GetQueuedCount(Priority::kVisible), 0u);
+}
+
+TEST(ImageDecodeSchedulerPoolTest, CancelsQueuedJobsWhenDestroyed) {
+  auto scheduler = std::make_shared<ImageDecodeScheduler>(
+      ImageDecodeSchedulerTest::GetLoop()->GetTaskRunner(),
+      ImageDecodeScheduler::Limits{1, 1, 1},
+      [](size_t cost) { return cost == 0; });
+
+  bool ran = false;
+  bool cancelled = false;
+  // Waits for resources that are never released.
+  scheduler->Schedule(
+      Priority::kVisible, [&ran]() { ran = true; },
+      [&cancelled]() { cancelled = true; }, 1);
+  ASSERT_FALSE(cancelled);
+
+  scheduler.reset();
+  ASSERT_TRUE(cancelled);
+  ASSERT_FALSE(ran);
+}
+
+TEST(ImageDecodeSchedulerPoolTest, CountsReservedWorkersAgainstTheLimits) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto scheduler = std::make_shared<ImageDecodeScheduler>(
+      loop->GetTaskRunner(), ImageDecodeScheduler::Limits{3, 3, 3});
+
+  // One worker is left for the other tasks of the pool.
+  auto reservation = std::make_unique<ImageDecodeScheduler::WorkerReservation>(
+      loop->GetTaskRunner(), 8);
+  ASSERT_EQ(reservation->GetCount(), 3u);
+  ImageDecodeScheduler::WorkerReservation busy(loop->GetTaskRunner(), 1);
+  ASSERT_EQ(busy.GetCount(), 0u);
+
+  // Jobs wait for the reserved workers to be released.
+  fml::AutoResetWaitableEvent ran;
+  scheduler->Schedule(
+      Priority::kVisible, [&ran]() { ran.Signal(); }, nullptr);
+  ASSERT_EQ(scheduler->GetQueuedCount(Priority::kVisible), 1u);
+
+  reservation.reset();
+  ran.Wait();
+  ASSERT_EQ(scheduler->GetQueuedCount(Priority::kVisible), 0u);
+}
+
+TEST(ImageDecodeSchedulerLimitsTest, LeavesWorkersForOtherTasks) {
+  auto limits = ImageDecodeScheduler::GetDefaultLimits(8);
+  ASSERT_EQ(limits[0], 7u);
+  ASSERT_EQ(limits[1], 3u);
+  ASSERT_EQ(limits[2], 1u);
+
+  limits = ImageDecodeScheduler::GetDefaultLimits(1);
+  ASSERT_EQ(limits[0], 1u);
+  ASSERT_EQ(limits[1], 1u);
+  ASSERT_EQ(limits[2], 1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
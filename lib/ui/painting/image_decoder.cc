@@ -7,6 +7,8 @@
 #include <algorithm>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/lib/ui/painting/box_downsampler.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 
 namespace flutter {
@@ -14,21 +16,42 @@ namespace flutter {
 ImageDecoder::ImageDecoder(
     TaskRunners runners,
     std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-    fml::WeakPtr<IOManager> io_manager)
+    fml::WeakPtr<IOManager> io_manager,
+    size_t upload_budget_bytes)
     : runners_(std::move(runners)),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
+      upload_queue_(
+          std::make_shared<TextureUploadQueue>(runners_.GetIOTaskRunner(),
+                                               upload_budget_bytes)),
+      scheduler_(std::make_shared<ImageDecodeScheduler>(
+          concurrent_task_runner_,
+          ImageDecodeScheduler::GetDefaultLimits(
+              concurrent_task_runner_->GetWorkerCount()),
+          [upload_queue = upload_queue_](size_t decoded_bytes) {
+            return upload_queue->TryReserve(decoded_bytes);
+          })),
       io_manager_(std::move(io_manager)),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
       << "The image decoder must be created & collected on the UI thread.";
+  // Decodes waiting for memory stay queued, with their priority, until the
+  // uploads of earlier images end their reservations.
+  upload_queue_->SetReleaseCallback(
+      [scheduler = std::weak_ptr<ImageDecodeScheduler>(scheduler_)]() {
+        if (auto strong_scheduler = scheduler.lock()) {
+          strong_scheduler->Dispatch();
+        }
+      });
 }
 
 ImageDecoder::~ImageDecoder() = default;
 
-static sk_sp<SkImage> ResizeRasterImage(sk_sp<SkImage> image,
-                                        const SkISize& resized_dimensions,
-                                        const fml::tracing::TraceFlow& flow) {
+static sk_sp<SkImage> ResizeRasterImage(
+    sk_sp<SkImage> image,
+    const SkISize& resized_dimensions,
+    const fml::tracing::TraceFlow& flow,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
   FML_DCHECK(!image->isTextureBacked());
 
   TRACE_EVENT0("flutter", __FUNCTION__);
@@ -53,10 +76,17 @@ static sk_sp<SkImage> ResizeRasterImage(sk_sp<SkImage> image,
     return nullptr;
   }
 
-  if (!image->scalePixels(
-          scaled_bitmap.pixmap(),
-          SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone),
-          SkImage::kDisallow_CachingHint)) {
+  // Downscales are split into bands of rows that are averaged in parallel.
+  // Other resizes are filtered bilinearly on this thread.
+  SkPixmap pixmap;
+  if (BoxDownsampler::CanDownsample(image->imageInfo(), resized_dimensions) &&
+      image->peekPixels(&pixmap)) {
+    BoxDownsampler::Downsample(pixmap, scaled_bitmap.pixmap(),
+                               concurrent_task_runner);
+  } else if (!image->scalePixels(
+                 scaled_bitmap.pixmap(),
+                 SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone),
+                 SkImage::kDisallow_CachingHint)) {
     FML_LOG(ERROR) << "Could not scale pixels";
     return nullptr;
   }
@@ -78,7 +108,8 @@ static sk_sp<SkImage> ImageFromDecompressedData(
     ImageDescriptor* descriptor,
     uint32_t target_width,
     uint32_t target_height,
-    const fml::tracing::TraceFlow& flow) {
+    const fml::tracing::TraceFlow& flow,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
   auto image = SkImage::MakeRasterData(
@@ -95,13 +126,55 @@ static sk_sp<SkImage> ImageFromDecompressedData(
   }
 
   return ResizeRasterImage(std::move(image),
-                           SkISize::Make(target_width, target_height), flow);
+                           SkISize::Make(target_width, target_height), flow,
+                           concurrent_task_runner);
 }
 
-sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
-                                       uint32_t target_width,
-                                       uint32_t target_height,
-                                       const fml::tracing::TraceFlow& flow) {
+// Decodes the image one batch of rows at a time and averages the rows into an
+// image of |resized_dimensions| as they are decoded, so that the image is never
+// held in memory at |decode_dimensions|. Returns null if the image cannot be
+// decoded this way.
+static sk_sp<SkImage> DownsampleScanlines(ImageDescriptor* descriptor,
+                                          const SkISize& decode_dimensions,
+                                          const SkISize& resized_dimensions,
+                                          const fml::tracing::TraceFlow& flow) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  auto decode_info = descriptor->image_info().makeDimensions(decode_dimensions);
+  if (decode_info.alphaType() == kUnpremul_SkAlphaType) {
+    decode_info = decode_info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  if (!BoxDownsampler::CanDownsample(decode_info, resized_dimensions)) {
+    return nullptr;
+  }
+
+  SkBitmap scaled_bitmap;
+  if (!scaled_bitmap.tryAllocPixels(
+          decode_info.makeDimensions(resized_dimensions))) {
+    return nullptr;
+  }
+
+  BoxDownsampler downsampler(decode_dimensions, scaled_bitmap.pixmap());
+  if (!descriptor->get_scanlines(decode_info,
+                                 [&downsampler](int y, const void* row) {
+                                   downsampler.AddRow(y, row);
+                                 })) {
+    return nullptr;
+  }
+
+  // Marking this as immutable makes the MakeFromBitmap call share the pixels
+  // instead of copying.
+  scaled_bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(scaled_bitmap);
+}
+
+sk_sp<SkImage> ImageFromCompressedData(
+    ImageDescriptor* descriptor,
+    uint32_t target_width,
+    uint32_t target_height,
+    const fml::tracing::TraceFlow& flow,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
 
@@ -121,6 +194,15 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                static_cast<double>(resized_dimensions.height()) /
                    source_dimensions.height()));
 
+  // If the image still needs to be resized once decoded, try to resize its rows
+  // as they are decoded instead.
+  if (decode_dimensions != resized_dimensions) {
+    if (auto image = DownsampleScanlines(descriptor, decode_dimensions,
+                                         resized_dimensions, flow)) {
+      return image;
+    }
+  }
+
   // If the codec supports efficient sub-pixel decoding, decoded at a resolution
   // close to the target resolution before resizing.
   if (decode_dimensions != source_dimensions) {
@@ -148,7 +230,7 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
         return nullptr;
       }
       return ResizeRasterImage(std::move(decoded_image), resized_dimensions,
-                               flow);
+                               flow, concurrent_task_runner);
     }
   }
 
@@ -157,7 +239,8 @@ sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
     return nullptr;
   }
 
-  return ResizeRasterImage(std::move(image), resized_dimensions, flow);
+  return ResizeRasterImage(std::move(image), resized_dimensions, flow,
+                           concurrent_task_runner);
 }
 
 static SkiaGPUObject<SkImage> UploadRasterImage(
@@ -216,10 +299,23 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return result;
 }
 
-void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
-                          uint32_t target_width,
-                          uint32_t target_height,
-                          const ImageResult& callback) {
+// Returns the size of the image that will be decoded and uploaded for
+// |descriptor|, assuming 32-bit pixels.
+static size_t GetDecodedByteSize(const ImageDescriptor& descriptor,
+                                 uint32_t target_width,
+                                 uint32_t target_height) {
+  const bool has_target_size = target_width > 0 && target_height > 0;
+  const uint64_t width = has_target_size ? target_width : descriptor.width();
+  const uint64_t height = has_target_size ? target_height : descriptor.height();
+  return static_cast<size_t>(width * height * 4);
+}
+
+ImageDecoder::DecodeId ImageDecoder::Decode(
+    fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
+    uint32_t target_width,
+    uint32_t target_height,
+    const ImageResult& callback,
+    Priority priority) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
 
@@ -260,71 +356,112 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
 
   if (!raw_descriptor->data() || raw_descriptor->data()->size() == 0) {
     result({}, std::move(flow));
-    return;
+    return ImageDecodeScheduler::kInvalidJobId;
   }
 
-  concurrent_task_runner_->PostTask(
-      fml::MakeCopyable([raw_descriptor,                          //
-                         io_manager = io_manager_,                //
-                         io_runner = runners_.GetIOTaskRunner(),  //
-                         result,                                  //
-                         target_width = target_width,             //
-                         target_height = target_height,           //
-                         flow = std::move(flow)                   //
-  ]() mutable {
-        // Step 1: Decompress the image.
-        // On Worker.
-
-        auto decompressed = raw_descriptor->is_compressed()
-                                ? ImageFromCompressedData(raw_descriptor,  //
-                                                          target_width,    //
-                                                          target_height,   //
-                                                          flow)
-                                : ImageFromDecompressedData(raw_descriptor,  //
-                                                            target_width,    //
-                                                            target_height,   //
-                                                            flow);
-
-        if (!decompressed) {
-          FML_DLOG(ERROR) << "Could not decompress image.";
-          result({}, std::move(flow));
-          return;
-        }
+  // The flow is shared by the decode task and the cancellation callback, only
+  // one of which runs.
+  auto shared_flow = std::make_shared<fml::tracing::TraceFlow>(std::move(flow));
+
+  const size_t decoded_bytes =
+      GetDecodedByteSize(*raw_descriptor, target_width, target_height);
+
+  auto task = [raw_descriptor,                                    //
+               io_manager = io_manager_,                          //
+               upload_queue = upload_queue_,                      //
+               concurrent_task_runner = concurrent_task_runner_,  //
+               result,                                            //
+               target_width = target_width,                       //
+               target_height = target_height,                     //
+               decoded_bytes,                                     //
+               shared_flow                                        //
+  ]() {
+    // Step 1: Decompress the image, unless the same image is cached or being
+    // decompressed for another request, possibly from another shell. The
+    // scheduler has already reserved the memory of the decoded image.
+    // On Worker.
+
+    auto decode = [raw_descriptor, target_width, target_height,
+                   concurrent_task_runner, &flow = *shared_flow]() {
+      return raw_descriptor->is_compressed()
+                 ? ImageFromCompressedData(raw_descriptor,         //
+                                           target_width,           //
+                                           target_height,          //
+                                           flow,                   //
+                                           concurrent_task_runner)
+                 : ImageFromDecompressedData(raw_descriptor,         //
+                                             target_width,           //
+                                             target_height,          //
+                                             flow,                   //
+                                             concurrent_task_runner);
+    };
+
+    auto upload = [io_manager, upload_queue, result, decoded_bytes,
+                   shared_flow](sk_sp<SkImage> decompressed) {
+      fml::tracing::TraceFlow flow = std::move(*shared_flow);
+      if (!decompressed) {
+        FML_DLOG(ERROR) << "Could not decompress image.";
+        upload_queue->Release(decoded_bytes);
+        result({}, std::move(flow));
+        return;
+      }
+
+      // Step 2: Update the image to the GPU, in a batch with the other images
+      // decoded in the meantime.
+      // On IO Thread.
+
+      upload_queue->Upload(
+          decoded_bytes,
+          fml::MakeCopyable([io_manager, decompressed, result,
+                             flow = std::move(flow)]() mutable {
+            if (!io_manager) {
+              FML_DLOG(ERROR) << "Could not acquire IO manager.";
+              result({}, std::move(flow));
+              return;
+            }
+
+            // If the IO manager does not have a resource context, the caller
+            // might not have set one or a software backend could be in use.
+            // Either way, just return the image as-is.
+            if (!io_manager->GetResourceContext()) {
+              result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
+                     std::move(flow));
+              return;
+            }
+
+            auto uploaded =
+                UploadRasterImage(std::move(decompressed), io_manager, flow);
+
+            if (!uploaded.skia_object()) {
+              FML_DLOG(ERROR) << "Could not upload image to the GPU.";
+              result({}, std::move(flow));
+              return;
+            }
+
+            // Finally, all done.
+            result(std::move(uploaded), std::move(flow));
+          }));
+    };
+
+    DecodedImageCache::GetInstance().GetOrDecode(
+        DecodedImageCache::MakeKey(*raw_descriptor, target_width,
+                                   target_height),
+        decode, upload);
+  };
+
+  auto on_cancel = [result, shared_flow]() {
+    result({}, std::move(*shared_flow));
+  };
+
+  return scheduler_->Schedule(priority, task, on_cancel, decoded_bytes);
+}
+
+bool ImageDecoder::SetDecodePriority(DecodeId decode, Priority priority) {
+  return scheduler_->SetPriority(decode, priority);
+}
 
-        // Step 2: Update the image to the GPU.
-        // On IO Thread.
-
-        io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
-                                               flow =
-                                                   std::move(flow)]() mutable {
-          if (!io_manager) {
-            FML_DLOG(ERROR) << "Could not acquire IO manager.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // If the IO manager does not have a resource context, the caller
-          // might not have set one or a software backend could be in use.
-          // Either way, just return the image as-is.
-          if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
-            return;
-          }
-
-          auto uploaded =
-              UploadRasterImage(std::move(decompressed), io_manager, flow);
-
-          if (!uploaded.skia_object()) {
-            FML_DLOG(ERROR) << "Could not upload image to the GPU.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // Finally, all done.
-          result(std::move(uploaded), std::move(flow));
-        }));
-      }));
+bool ImageDecoder::CancelDecode(DecodeId decode) {
+  return scheduler_->Cancel(decode);
 }
 
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
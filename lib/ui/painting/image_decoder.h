@@ -15,7 +15,9 @@
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
+#include "flutter/lib/ui/painting/texture_upload_queue.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -34,37 +36,78 @@ class ImageDecoder {
   ImageDecoder(
       TaskRunners runners,
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-      fml::WeakPtr<IOManager> io_manager);
+      fml::WeakPtr<IOManager> io_manager,
+      size_t upload_budget_bytes = TextureUploadQueue::kDefaultBudgetBytes);
 
   ~ImageDecoder();
 
   using ImageResult = std::function<void(SkiaGPUObject<SkImage>)>;
 
+  using Priority = ImageDecodeScheduler::Priority;
+
+  using DecodeId = ImageDecodeScheduler::JobId;
+
   // Takes an image descriptor and returns a handle to a texture resident on the
   // GPU. All image decompression and resizes are done on a worker thread
-  // concurrently. Texture upload is done on the IO thread and the result
-  // returned back on the UI thread. On error, the texture is null but the
-  // callback is guaranteed to return on the UI thread.
-  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
-              uint32_t target_width,
-              uint32_t target_height,
-              const ImageResult& result);
+  // concurrently, in the order of their priority, and are deferred while the
+  // images being decoded or uploaded exceed the upload queue's memory budget.
+  // Texture upload is batched on the IO thread and the result returned back on
+  // the UI thread. On error or when the decode is cancelled, the texture is
+  // null but the callback is guaranteed to return on the UI thread.
+  //
+  // Returns an identifier for the decode that can be used to change its
+  // priority or cancel it until it starts.
+  DecodeId Decode(fml::RefPtr<ImageDescriptor> descriptor,
+                  uint32_t target_width,
+                  uint32_t target_height,
+                  const ImageResult& result,
+                  Priority priority = Priority::kVisible);
+
+  // Changes the priority of a decode that has not started yet. Returns false
+  // if the decode has already started.
+  bool SetDecodePriority(DecodeId decode, Priority priority);
+
+  // Cancels a decode that has not started yet. Returns false if the decode
+  // has already started.
+  bool CancelDecode(DecodeId decode);
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
+  // The queue that budgets and uploads the decoded images. Unlike the decoder,
+  // it may be used on any thread.
+  const std::shared_ptr<TextureUploadQueue>& GetUploadQueue() const {
+    return upload_queue_;
+  }
+
+  // The scheduler of the decodes on the worker pool. Unlike the decoder, it
+  // may be used on any thread.
+  const std::shared_ptr<ImageDecodeScheduler>& GetScheduler() const {
+    return scheduler_;
+  }
+
  private:
   TaskRunners runners_;
+  // Also used by the scheduled decodes to resize large images in parallel.
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  // Declared before the scheduler, which reserves memory from it.
+  std::shared_ptr<TextureUploadQueue> upload_queue_;
+  std::shared_ptr<ImageDecodeScheduler> scheduler_;
   fml::WeakPtr<IOManager> io_manager_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
 };
 
-sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
-                                       uint32_t target_width,
-                                       uint32_t target_height,
-                                       const fml::tracing::TraceFlow& flow);
+// Decodes the image of |descriptor| and resizes it to the target dimensions.
+// Large downscales are split across the workers of |concurrent_task_runner| if
+// there is one.
+sk_sp<SkImage> ImageFromCompressedData(
+    ImageDescriptor* descriptor,
+    uint32_t target_width,
+    uint32_t target_height,
+    const fml::tracing::TraceFlow& flow,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner =
+        nullptr);
 
 }  // namespace flutter
 
@@ -6,6 +6,7 @@
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/runtime/dart_vm.h"
@@ -379,6 +380,82 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithoutAGPUContext) {
   latch.Wait();
 }
 
+TEST_F(ImageDecoderFixtureTest, DecodesOverTheUploadBudgetWaitToBeScheduled) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  // Every decode is over the budget, so each one waits for the upload of the
+  // decode before it.
+  std::unique_ptr<IOManager> io_manager;
+  fml::AutoResetWaitableEvent latch;
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager =
+        std::make_unique<TestIOManager>(runners.GetIOTaskRunner(), false);
+    latch.Signal();
+  });
+  latch.Wait();
+
+  fml::ManualResetWaitableEvent unblock_io;
+  fml::CountDownLatch decodes_done(3);
+  std::unique_ptr<ImageDecoder> image_decoder;
+  sk_sp<SkImage> first_image;
+  sk_sp<SkImage> cancelled_image;
+  sk_sp<SkImage> last_image;
+  bool cancelled = false;
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager(),
+        /*upload_budget_bytes=*/1);
+
+    auto data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+    ASSERT_TRUE(data);
+    ImageGeneratorRegistry registry;
+    auto decode = [&](int size, sk_sp<SkImage>* result) {
+      auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+          data, registry.CreateCompatibleGenerator(data));
+      return image_decoder->Decode(
+          descriptor, size, size,
+          [result, &decodes_done](SkiaGPUObject<SkImage> image) {
+            *result = image.skia_object();
+            decodes_done.CountDown();
+          });
+    };
+
+    // The first decode holds its reservation until its upload has run.
+    runners.GetIOTaskRunner()->PostTask([&unblock_io]() { unblock_io.Wait(); });
+    decode(10, &first_image);
+    auto second_decode = decode(20, &cancelled_image);
+    decode(30, &last_image);
+
+    // The second decode is still queued, so it can be cancelled.
+    cancelled = image_decoder->CancelDecode(second_decode);
+    unblock_io.Signal();
+  });
+
+  decodes_done.Wait();
+  EXPECT_TRUE(cancelled);
+  EXPECT_TRUE(first_image);
+  EXPECT_FALSE(cancelled_image);
+  EXPECT_TRUE(last_image);
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   const auto image_dimensions =
       SkImage::MakeFromEncoded(OpenFixtureAsSkData("DashInNooglerHat.jpg"))
@@ -4,12 +4,15 @@
 
 #include "flutter/lib/ui/painting/image_descriptor.h"
 
+#include <algorithm>
+
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/lib/ui/painting/single_frame_codec.h"
 #include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 
@@ -149,4 +152,31 @@ bool ImageDescriptor::get_pixels(const SkPixmap& pixmap) const {
                                pixmap.rowBytes());
 }
 
+bool ImageDescriptor::get_scanlines(
+    const SkImageInfo& info,
+    const std::function<void(int y, const void* row)>& on_row) const {
+  FML_DCHECK(generator_);
+  if (!generator_->StartScanlineDecode(info)) {
+    return false;
+  }
+  // Decoding a few rows per call amortizes the cost of the call without
+  // holding much of the image.
+  constexpr int kRowsPerBatch = 16;
+  SkBitmap batch;
+  if (!batch.tryAllocPixels(info.makeWH(info.width(), kRowsPerBatch))) {
+    return false;
+  }
+  for (int y = 0; y < info.height(); y += kRowsPerBatch) {
+    const int count = std::min(kRowsPerBatch, info.height() - y);
+    if (generator_->GetScanlines(batch.getPixels(), count, batch.rowBytes()) !=
+        count) {
+      return false;
+    }
+    for (int i = 0; i < count; i++) {
+      on_row(y + i, batch.getAddr(0, i));
+    }
+  }
+  return true;
+}
+
 }  // namespace flutter
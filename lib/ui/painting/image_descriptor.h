@@ -6,6 +6,7 @@
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DESCRIPTOR_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -106,6 +107,16 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   ///         orientation tag, if applicable.
   bool get_pixels(const SkPixmap& pixmap) const;
 
+  /// @brief  Decodes the rows of this image from the top, a batch at a time,
+  ///         and passes each of them to `on_row` so that the whole image is
+  ///         never held in memory.
+  /// @return False if the generator cannot decode the image with `info` one
+  ///         row at a time, or if the decode fails.
+  /// @see    `ImageGenerator::StartScanlineDecode`
+  bool get_scanlines(
+      const SkImageInfo& info,
+      const std::function<void(int y, const void* row)>& on_row) const;
+
   void dispose() {
     buffer_.reset();
     generator_.reset();
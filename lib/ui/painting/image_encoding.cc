@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/painting/image_encoding.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -12,11 +13,15 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/qoi_encoder.h"
 #include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
-#include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/encode/SkPngEncoder.h"
+#include "third_party/skia/include/encode/SkWebpEncoder.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 #include "third_party/tonic/typed_data/typed_list.h"
@@ -28,13 +33,6 @@ using tonic::ToDart;
 namespace flutter {
 namespace {
 
-// This must be kept in sync with the enum in painting.dart
-enum ImageByteFormat {
-  kRawRGBA,
-  kRawUnmodified,
-  kPNG,
-};
-
 void FinalizeSkData(void* isolate_callback_data, void* peer) {
   SkData* buffer = reinterpret_cast<SkData*>(peer);
   buffer->unref();
@@ -186,41 +184,97 @@ sk_sp<SkData> CopyImageByteData(sk_sp<SkImage> raster_image,
   return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
 }
 
-sk_sp<SkData> EncodeImage(sk_sp<SkImage> raster_image, ImageByteFormat format) {
-  TRACE_EVENT0("flutter", __FUNCTION__);
+SkPngEncoder::FilterFlag ToSkPngFilterFlags(PngFilter filter) {
+  switch (filter) {
+    case PngFilter::kAll:
+      return SkPngEncoder::FilterFlag::kAll;
+    case PngFilter::kNone:
+      return SkPngEncoder::FilterFlag::kNone;
+    case PngFilter::kSub:
+      return SkPngEncoder::FilterFlag::kSub;
+    case PngFilter::kUp:
+      return SkPngEncoder::FilterFlag::kUp;
+    case PngFilter::kAverage:
+      return SkPngEncoder::FilterFlag::kAvg;
+    case PngFilter::kPaeth:
+      return SkPngEncoder::FilterFlag::kPaeth;
+  }
+  return SkPngEncoder::FilterFlag::kAll;
+}
 
-  if (!raster_image) {
+sk_sp<SkData> EncodePNG(const sk_sp<SkImage>& raster_image,
+                        const ImageEncodingOptions& options) {
+  SkPixmap pixmap;
+  if (!raster_image->peekPixels(&pixmap)) {
+    FML_LOG(ERROR) << "Could not read pixels from the raster image.";
     return nullptr;
   }
 
-  switch (format) {
-    case kPNG: {
-      auto png_image =
-          raster_image->encodeToData(SkEncodedImageFormat::kPNG, 0);
-
-      if (png_image == nullptr) {
-        FML_LOG(ERROR) << "Could not convert raster image to PNG.";
-        return nullptr;
-      };
-      return png_image;
-    } break;
-    case kRawRGBA: {
-      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType);
-    } break;
-    case kRawUnmodified: {
-      return CopyImageByteData(raster_image, raster_image->colorType());
-    } break;
+  SkPngEncoder::Options png_options;
+  png_options.fZLibLevel = std::clamp(options.compression_level, 0, 9);
+  png_options.fFilterFlags = ToSkPngFilterFlags(options.png_filter);
+
+  SkDynamicMemoryWStream stream;
+  if (!SkPngEncoder::Encode(&stream, pixmap, png_options)) {
+    FML_LOG(ERROR) << "Could not convert raster image to PNG.";
+    return nullptr;
   }
+  return stream.detachAsData();
+}
 
-  FML_LOG(ERROR) << "Unknown error encoding image.";
-  return nullptr;
+sk_sp<SkData> EncodeWebP(const sk_sp<SkImage>& raster_image,
+                         const ImageEncodingOptions& options) {
+  SkPixmap pixmap;
+  if (!raster_image->peekPixels(&pixmap)) {
+    FML_LOG(ERROR) << "Could not read pixels from the raster image.";
+    return nullptr;
+  }
+
+  SkWebpEncoder::Options webp_options;
+  if (options.quality >= 100) {
+    // For lossless images, the quality is the effort spent compressing them.
+    webp_options.fCompression = SkWebpEncoder::Compression::kLossless;
+    webp_options.fQuality =
+        std::clamp(options.compression_level, 0, 9) * 100.0f / 9;
+  } else {
+    webp_options.fCompression = SkWebpEncoder::Compression::kLossy;
+    webp_options.fQuality = std::max(options.quality, 0);
+  }
+
+  SkDynamicMemoryWStream stream;
+  if (!SkWebpEncoder::Encode(&stream, pixmap, webp_options)) {
+    FML_LOG(ERROR) << "Could not convert raster image to WebP.";
+    return nullptr;
+  }
+  return stream.detachAsData();
+}
+
+sk_sp<SkData> EncodeQOI(
+    const sk_sp<SkImage>& raster_image,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
+  // QOI images have unpremultiplied RGBA pixels.
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(
+          SkImageInfo::Make(raster_image->dimensions(), kRGBA_8888_SkColorType,
+                            kUnpremul_SkAlphaType)) ||
+      !raster_image->readPixels(bitmap.pixmap(), 0, 0)) {
+    FML_LOG(ERROR) << "Could not read pixels from the raster image.";
+    return nullptr;
+  }
+
+  auto qoi_image = QoiEncoder::Encode(bitmap.pixmap(), concurrent_task_runner);
+  if (qoi_image == nullptr) {
+    FML_LOG(ERROR) << "Could not convert raster image to QOI.";
+  }
+  return qoi_image;
 }
 
 void EncodeImageAndInvokeDataCallback(
     sk_sp<SkImage> image,
     std::unique_ptr<DartPersistentValue> callback,
-    ImageByteFormat format,
+    const ImageEncodingOptions& options,
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     fml::RefPtr<fml::TaskRunner> raster_task_runner,
     fml::RefPtr<fml::TaskRunner> io_task_runner,
     GrDirectContext* resource_context,
@@ -230,9 +284,11 @@ void EncodeImageAndInvokeDataCallback(
         InvokeDataCallback(std::move(callback), std::move(encoded));
       });
 
-  auto encode_task = [callback_task = std::move(callback_task), format,
-                      ui_task_runner](sk_sp<SkImage> raster_image) {
-    sk_sp<SkData> encoded = EncodeImage(std::move(raster_image), format);
+  auto encode_task = [callback_task = std::move(callback_task), options,
+                      ui_task_runner, concurrent_task_runner](
+                         sk_sp<SkImage> raster_image) {
+    sk_sp<SkData> encoded = EncodeRasterImage(std::move(raster_image), options,
+                                              concurrent_task_runner);
     ui_task_runner->PostTask([callback_task = std::move(callback_task),
                               encoded = std::move(encoded)]() mutable {
       callback_task(std::move(encoded));
@@ -245,9 +301,44 @@ void EncodeImageAndInvokeDataCallback(
 
 }  // namespace
 
+sk_sp<SkData> EncodeRasterImage(
+    sk_sp<SkImage> raster_image,
+    const ImageEncodingOptions& options,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+
+  if (!raster_image) {
+    return nullptr;
+  }
+
+  switch (options.format) {
+    case kPNG:
+      return EncodePNG(raster_image, options);
+    case kQOI:
+      return EncodeQOI(raster_image, concurrent_task_runner);
+    case kWebP:
+      return EncodeWebP(raster_image, options);
+    case kRawRGBA:
+      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType);
+    case kRawUnmodified:
+      return CopyImageByteData(raster_image, raster_image->colorType());
+  }
+
+  FML_LOG(ERROR) << "Unknown error encoding image.";
+  return nullptr;
+}
+
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
                         Dart_Handle callback_handle) {
+  ImageEncodingOptions options;
+  options.format = static_cast<ImageByteFormat>(format);
+  return EncodeImage(canvas_image, options, callback_handle);
+}
+
+Dart_Handle EncodeImage(CanvasImage* canvas_image,
+                        const ImageEncodingOptions& options,
+                        Dart_Handle callback_handle) {
   if (!canvas_image) {
     return ToDart("encode called with non-genuine Image.");
   }
@@ -256,25 +347,25 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
     return ToDart("Callback must be a function.");
   }
 
-  ImageByteFormat image_format = static_cast<ImageByteFormat>(format);
-
   auto callback = std::make_unique<DartPersistentValue>(
       tonic::DartState::Current(), callback_handle);
 
-  const auto& task_runners = UIDartState::Current()->GetTaskRunners();
+  auto* dart_state = UIDartState::Current();
+  const auto& task_runners = dart_state->GetTaskRunners();
 
   task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
-      [callback = std::move(callback), image = canvas_image->image(),
-       image_format, ui_task_runner = task_runners.GetUITaskRunner(),
+      [callback = std::move(callback), image = canvas_image->image(), options,
+       ui_task_runner = task_runners.GetUITaskRunner(),
+       concurrent_task_runner = dart_state->GetConcurrentTaskRunner(),
        raster_task_runner = task_runners.GetRasterTaskRunner(),
        io_task_runner = task_runners.GetIOTaskRunner(),
-       io_manager = UIDartState::Current()->GetIOManager(),
-       snapshot_delegate =
-           UIDartState::Current()->GetSnapshotDelegate()]() mutable {
+       io_manager = dart_state->GetIOManager(),
+       snapshot_delegate = dart_state->GetSnapshotDelegate()]() mutable {
         EncodeImageAndInvokeDataCallback(
-            std::move(image), std::move(callback), image_format,
-            std::move(ui_task_runner), std::move(raster_task_runner),
-            std::move(io_task_runner), io_manager->GetResourceContext().get(),
+            std::move(image), std::move(callback), options,
+            std::move(ui_task_runner), std::move(concurrent_task_runner),
+            std::move(raster_task_runner), std::move(io_task_runner),
+            io_manager->GetResourceContext().get(),
             std::move(snapshot_delegate));
       }));
 
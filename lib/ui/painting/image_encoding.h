@@ -5,16 +5,64 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_H_
 
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/tonic/dart_library_natives.h"
 
 namespace flutter {
 
 class CanvasImage;
 
+// This must be kept in sync with the enum in painting.dart
+enum ImageByteFormat {
+  kRawRGBA,
+  kRawUnmodified,
+  kPNG,
+  kQOI,
+  kWebP,
+};
+
+// This must be kept in sync with the enum in painting.dart
+enum class PngFilter {
+  kAll,
+  kNone,
+  kSub,
+  kUp,
+  kAverage,
+  kPaeth,
+};
+
+// How images are encoded by |EncodeImage|. This must be kept in sync with
+// `ImageEncodingOptions` in painting.dart.
+struct ImageEncodingOptions {
+  ImageByteFormat format = kRawRGBA;
+  // The zlib compression level of PNG images, from 0 (fastest) to 9 (smallest).
+  int compression_level = 6;
+  // The filters that PNG rows may be encoded with.
+  PngFilter png_filter = PngFilter::kAll;
+  // The quality of WebP images, from 0 to 100. 100 encodes losslessly.
+  int quality = 100;
+};
+
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
                         Dart_Handle callback_handle);
 
+Dart_Handle EncodeImage(CanvasImage* canvas_image,
+                        const ImageEncodingOptions& options,
+                        Dart_Handle callback_handle);
+
+// Encodes an image that must be backed by pixels in memory. Formats that
+// support it are encoded in parallel on the workers of
+// |concurrent_task_runner|, if there is one. Returns null on failure.
+sk_sp<SkData> EncodeRasterImage(
+    sk_sp<SkImage> raster_image,
+    const ImageEncodingOptions& options,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner);
+
 }  // namespace flutter
 
 #endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_H_
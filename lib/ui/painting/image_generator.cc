@@ -10,6 +10,14 @@ namespace flutter {
 
 ImageGenerator::~ImageGenerator() = default;
 
+bool ImageGenerator::StartScanlineDecode(const SkImageInfo& info) {
+  return false;
+}
+
+int ImageGenerator::GetScanlines(void* pixels, int count, size_t row_bytes) {
+  return 0;
+}
+
 sk_sp<SkImage> ImageGenerator::GetImage() {
   SkImageInfo info = GetInfo();
 
@@ -79,7 +87,8 @@ BuiltinSkiaCodecImageGenerator::~BuiltinSkiaCodecImageGenerator() = default;
 
 BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
     std::unique_ptr<SkCodec> codec)
-    : codec_generator_(static_cast<SkCodecImageGenerator*>(
+    : codec_(codec.get()),
+      codec_generator_(static_cast<SkCodecImageGenerator*>(
           SkCodecImageGenerator::MakeFromCodec(std::move(codec)).release())) {}
 
 BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
@@ -131,6 +140,42 @@ bool BuiltinSkiaCodecImageGenerator::GetPixels(
   return codec_generator_->getPixels(info, pixels, row_bytes, &options);
 }
 
+bool BuiltinSkiaCodecImageGenerator::StartScanlineDecode(
+    const SkImageInfo& info) {
+  // Rows that are not in display order cannot be consumed as they are decoded.
+  if (!codec_ || codec_->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return false;
+  }
+  return codec_->startScanlineDecode(info) == SkCodec::kSuccess &&
+         codec_->getScanlineOrder() == SkCodec::kTopDown_SkScanlineOrder;
+}
+
+int BuiltinSkiaCodecImageGenerator::GetScanlines(void* pixels,
+                                                 int count,
+                                                 size_t row_bytes) {
+  FML_DCHECK(codec_);
+  return codec_->getScanlines(pixels, count, row_bytes);
+}
+
+bool BuiltinSkiaCodecImageGenerator::StartIncrementalDecode(
+    const SkImageInfo& info,
+    void* pixels,
+    size_t row_bytes) {
+  // The rows would need to be reoriented, which cannot be done until the whole
+  // image is decoded.
+  if (!codec_ || codec_->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return false;
+  }
+  return codec_->startIncrementalDecode(info, pixels, row_bytes) ==
+         SkCodec::kSuccess;
+}
+
+SkCodec::Result BuiltinSkiaCodecImageGenerator::IncrementalDecode(
+    int* rows_decoded) {
+  FML_DCHECK(codec_);
+  return codec_->incrementalDecode(rows_decoded);
+}
+
 std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::MakeFromData(
     sk_sp<SkData> data) {
   auto codec = SkCodec::MakeFromData(data);
@@ -140,4 +185,14 @@ std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::MakeFromData(
   return std::make_unique<BuiltinSkiaCodecImageGenerator>(std::move(codec));
 }
 
+std::unique_ptr<BuiltinSkiaCodecImageGenerator>
+BuiltinSkiaCodecImageGenerator::MakeFromStream(std::unique_ptr<SkStream> stream,
+                                               SkCodec::Result* result) {
+  auto codec = SkCodec::MakeFromStream(std::move(stream), result);
+  if (!codec) {
+    return nullptr;
+  }
+  return std::make_unique<BuiltinSkiaCodecImageGenerator>(std::move(codec));
+}
+
 }  // namespace flutter
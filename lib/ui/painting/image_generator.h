@@ -8,6 +8,7 @@
 #include <optional>
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/src/codec/SkCodecImageGenerator.h"
 
 namespace flutter {
@@ -123,6 +124,29 @@ class ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) = 0;
 
+  /// @brief      Starts decoding the first frame of the image one batch of rows
+  ///             at a time, from the top, so that the rows can be consumed
+  ///             without the whole image being held in memory.
+  /// @param[in]  info  The size and color info of the decoded rows. The size
+  ///                   must be one returned by `GetScaledDimensions`.
+  /// @return     True if the decode was started, in which case `GetScanlines`
+  ///             decodes the rows. The default implementation does not
+  ///             support scanline decoding and returns false.
+  /// @see        `GetScanlines`
+  virtual bool StartScanlineDecode(const SkImageInfo& info);
+
+  /// @brief      Decodes the next rows of the decode started by
+  ///             `StartScanlineDecode`.
+  /// @param[in]  pixels     The location where the decoded rows are written.
+  /// @param[in]  count      The number of rows to decode.
+  /// @param[in]  row_bytes  The total number of bytes of a single row of
+  ///                        decoded image data.
+  /// @return     The number of rows decoded, which is less than `count` if the
+  ///             image data is incomplete or invalid.
+  /// @note       This method performs potentially long synchronous work, and
+  ///             so it should never be executed on the UI thread.
+  virtual int GetScanlines(void* pixels, int count, size_t row_bytes);
+
   /// @brief   Creates an `SkImage` based on the current `ImageInfo` of this
   ///          `ImageGenerator`.
   /// @return  A new `SkImage` containing the decoded image data.
@@ -199,10 +223,59 @@ class BuiltinSkiaCodecImageGenerator : public ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) override;
 
+  // |ImageGenerator|
+  bool StartScanlineDecode(const SkImageInfo& info) override;
+
+  // |ImageGenerator|
+  int GetScanlines(void* pixels, int count, size_t row_bytes) override;
+
+  /// @brief      Starts decoding the image into a given buffer while its
+  ///             encoded data is still arriving. This is only supported by
+  ///             generators created with `MakeFromStream` for formats that
+  ///             Skia can decode incrementally, and for images that are
+  ///             stored in their display orientation.
+  /// @param[in]  info       The size and color info of the decoded image. The
+  ///                        size must be the size of the image.
+  /// @param[in]  pixels     The location where the decoded rows are written.
+  ///                        It must remain valid until the decode completes.
+  /// @param[in]  row_bytes  The total number of bytes of a single row of
+  ///                        decoded image data.
+  /// @return     True if the decode was started, in which case
+  ///             `IncrementalDecode` decodes the data read so far.
+  /// @see        `IncrementalDecode`
+  bool StartIncrementalDecode(const SkImageInfo& info,
+                              void* pixels,
+                              size_t row_bytes);
+
+  /// @brief      Decodes as much of the image started by
+  ///             `StartIncrementalDecode` as the data available in the stream
+  ///             allows.
+  /// @param[out] rows_decoded  The number of rows written from the top of the
+  ///                           image, when the image is not fully decoded.
+  /// @return     `SkCodec::kSuccess` once the image is fully decoded, and
+  ///             `SkCodec::kIncompleteInput` when the stream ran out of data
+  ///             before that.
+  /// @note       This method performs potentially long synchronous work, and
+  ///             so it should never be executed on the UI thread.
+  SkCodec::Result IncrementalDecode(int* rows_decoded);
+
   static std::unique_ptr<ImageGenerator> MakeFromData(sk_sp<SkData> data);
 
+  /// @brief      Creates a generator that reads the encoded image from a
+  ///             stream, which does not need to hold the whole image yet.
+  /// @param[in]  stream  The encoded image data.
+  /// @param[out] result  Why no generator could be created, if applicable.
+  ///                     `SkCodec::kIncompleteInput` means that the stream
+  ///                     does not hold the whole header of the image yet.
+  /// @return     A generator for the image, or null.
+  static std::unique_ptr<BuiltinSkiaCodecImageGenerator> MakeFromStream(
+      std::unique_ptr<SkStream> stream,
+      SkCodec::Result* result);
+
  private:
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(BuiltinSkiaCodecImageGenerator);
+  // The codec owned by |codec_generator_|, if it was created from a codec.
+  SkCodec* codec_ = nullptr;
   std::unique_ptr<SkCodecImageGenerator> codec_generator_;
 };
 
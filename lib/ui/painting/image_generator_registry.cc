@@ -3,9 +3,11 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <vector>
 
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/lib/ui/painting/parallel_jpeg_image_generator.h"
 #include "third_party/skia/include/codec/SkCodec.h"
 #include "third_party/skia/include/core/SkImageGenerator.h"
 #include "third_party/skia/src/codec/SkCodecImageGenerator.h"
@@ -17,7 +19,20 @@
 
 namespace flutter {
 
-ImageGeneratorRegistry::ImageGeneratorRegistry() : weak_factory_(this) {
+ImageGeneratorRegistry::ImageGeneratorRegistry(
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner)
+    : weak_factory_(this) {
+#if FLUTTER_ENABLE_PARALLEL_IMAGE_DECODERS
+  if (concurrent_task_runner) {
+    AddFactory(
+        [concurrent_task_runner](sk_sp<SkData> buffer) {
+          return ParallelJpegImageGenerator::MakeFromData(
+              std::move(buffer), concurrent_task_runner);
+        },
+        1);
+  }
+#endif  // FLUTTER_ENABLE_PARALLEL_IMAGE_DECODERS
+
   AddFactory(
       [](sk_sp<SkData> buffer) {
         return BuiltinSkiaCodecImageGenerator::MakeFromData(buffer);
@@ -72,6 +87,23 @@ ImageGeneratorRegistry::CreateCompatibleGenerator(sk_sp<SkData> buffer) {
   return nullptr;
 }
 
+ImageGeneratorFactory ImageGeneratorRegistry::GetFactorySnapshot() const {
+  std::vector<ImageGeneratorFactory> factories;
+  for (const auto& factory : image_generator_factories_) {
+    factories.push_back(factory.callback);
+  }
+  return [factories = std::move(factories)](
+             sk_sp<SkData> buffer) -> std::shared_ptr<ImageGenerator> {
+    for (const auto& factory : factories) {
+      std::shared_ptr<ImageGenerator> result = factory(buffer);
+      if (result) {
+        return result;
+      }
+    }
+    return nullptr;
+  };
+}
+
 fml::WeakPtr<ImageGeneratorRegistry> ImageGeneratorRegistry::GetWeakPtr()
     const {
   return weak_factory_.GetWeakPtr();
@@ -6,8 +6,10 @@
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_GENERATOR_REGISTRY_H_
 
 #include <functional>
+#include <memory>
 #include <set>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/lib/ui/painting/image_generator.h"
@@ -27,7 +29,16 @@ using ImageGeneratorFactory =
 ///        controller).
 class ImageGeneratorRegistry {
  public:
-  ImageGeneratorRegistry();
+  /// @brief      Creates a registry with the built-in decoders installed.
+  ///             Engines built with `flutter_enable_parallel_image_decoders`
+  ///             also install the `ParallelJpegImageGenerator` at priority 1,
+  ///             ahead of the Skia decoders.
+  /// @param[in]  concurrent_task_runner  Runs the bands of the images decoded
+  ///                                     in parallel. The parallel decoders
+  ///                                     are not installed without one.
+  explicit ImageGeneratorRegistry(
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner =
+          nullptr);
 
   ~ImageGeneratorRegistry();
 
@@ -58,6 +69,14 @@ class ImageGeneratorRegistry {
   std::shared_ptr<ImageGenerator> CreateCompatibleGenerator(
       sk_sp<SkData> buffer);
 
+  /// @brief      Returns a factory that walks the image generator builders
+  ///             installed so far like `CreateCompatibleGenerator`. Unlike the
+  ///             registry, the returned factory may be called on any thread,
+  ///             for instance to find the generator of an image whose data is
+  ///             assembled on the IO thread.
+  /// @see        `CreateCompatibleGenerator`
+  ImageGeneratorFactory GetFactorySnapshot() const;
+
   fml::WeakPtr<ImageGeneratorRegistry> GetWeakPtr() const;
 
  private:
@@ -111,5 +111,27 @@ TEST_F(ShellTest, DefaultGeneratorsTakePrecedentOverNegativePriority) {
   ASSERT_EQ(result->GetInfo().width(), 3024);
 }
 
+TEST_F(ShellTest, FactorySnapshotUsesTheFactoriesInstalledSoFar) {
+  ImageGeneratorRegistry registry;
+  registry.AddFactory(
+      [](sk_sp<SkData> buffer) {
+        return std::make_unique<FakeImageGenerator>(1337);
+      },
+      1);
+  auto factory = registry.GetFactorySnapshot();
+  registry.AddFactory(
+      [](sk_sp<SkData> buffer) {
+        return std::make_unique<FakeImageGenerator>(42);
+      },
+      2);
+
+  ASSERT_EQ(factory(LoadValidImageFixture())->GetInfo().width(), 1337);
+
+  ImageGeneratorRegistry default_registry;
+  auto default_factory = default_registry.GetFactorySnapshot();
+  ASSERT_EQ(default_factory(LoadValidImageFixture())->GetInfo().width(), 3024);
+  ASSERT_EQ(default_factory(SkData::MakeEmpty()), nullptr);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_memory_usage.h"
+
+#include <numeric>
+
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+#include "flutter/lib/ui/painting/image.h"
+
+namespace flutter {
+
+size_t ImageMemoryUsage::GetTotal() const {
+  return std::accumulate(bytes.begin(), bytes.end(), size_t{0});
+}
+
+size_t ImageMemoryUsage::GetTrimmableTotal() const {
+  size_t total = 0;
+  for (Category category : kTrimOrder) {
+    total += bytes[category];
+  }
+  return total;
+}
+
+const char* ImageMemoryUsage::GetCategoryName(Category category) {
+  switch (category) {
+    case kDecodePipeline:
+      return "decodePipelineBytes";
+    case kImages:
+      return "imageBytes";
+    case kDecodedImageCache:
+      return "decodedImageCacheBytes";
+    case kAnimatedFrames:
+      return "animatedFrameBytes";
+    case kRasterCache:
+      return "rasterCacheBytes";
+    case kResourceCache:
+      return "resourceCacheBytes";
+    case kCategoryCount:
+      break;
+  }
+  return "";
+}
+
+ImageMemoryUsage ImageMemoryUsage::GetSharedUsage() {
+  ImageMemoryUsage usage;
+  usage.bytes[kImages] = CanvasImage::GetLiveImageBytes();
+  usage.bytes[kDecodedImageCache] =
+      DecodedImageCache::GetInstance().GetStats().bytes;
+  usage.bytes[kAnimatedFrames] = AnimatedFrameDecoder::GetCachedFrameBytes();
+  return usage;
+}
+
+ImageMemoryUsage ImageMemoryUsage::TrimToCeiling(
+    ImageMemoryUsage usage,
+    size_t ceiling,
+    const std::array<Trim, kCategoryCount>& trims,
+    const std::function<ImageMemoryUsage()>& measure) {
+  for (Category category : kTrimOrder) {
+    const size_t trimmable = usage.GetTrimmableTotal();
+    if (trimmable <= ceiling) {
+      break;
+    }
+    if (!trims[category] || usage.bytes[category] == 0) {
+      continue;
+    }
+    trims[category](trimmable - ceiling);
+    usage = measure();
+  }
+  return usage;
+}
+
+}  // namespace flutter
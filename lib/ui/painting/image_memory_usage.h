@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_MEMORY_USAGE_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_MEMORY_USAGE_H_
+
+#include <array>
+#include <cstddef>
+#include <functional>
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      The memory held by the images of an engine, in bytes, broken
+///             down by the stage of the image pipeline that holds it.
+///
+///             The decode pipeline, the raster cache and the resource cache
+///             belong to each engine. The other categories are shared by all
+///             the engines of the process, and are reported in full by each of
+///             them.
+///
+struct ImageMemoryUsage {
+  enum Category : size_t {
+    /// Images being decoded or waiting to be uploaded to the GPU.
+    kDecodePipeline,
+    /// Images held by `ui.Image` objects that are not disposed. Shared.
+    kImages,
+    /// Images kept by the `DecodedImageCache`. Shared.
+    kDecodedImageCache,
+    /// Frames of animated images decoded ahead or kept for looping. Shared.
+    kAnimatedFrames,
+    /// Layers and pictures rasterized by the raster cache.
+    kRasterCache,
+    /// The resources held by Skia's resource cache for the onscreen context.
+    kResourceCache,
+    kCategoryCount,
+  };
+
+  /// Trims the cache of a category by at least the given number of bytes,
+  /// if it holds that many.
+  using Trim = std::function<void(size_t bytes)>;
+
+  /// The trimmable categories, from the cheapest to refill to the most
+  /// expensive: decoded images are decoded again when next requested,
+  /// animated frames when next shown, the raster cache when next painted,
+  /// and Skia's resources when next drawn.
+  static constexpr Category kTrimOrder[] = {
+      kDecodedImageCache,
+      kAnimatedFrames,
+      kRasterCache,
+      kResourceCache,
+  };
+
+  std::array<size_t, kCategoryCount> bytes = {};
+
+  size_t GetTotal() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the bytes of the categories in `kTrimOrder`. The
+  ///             images being decoded and the live images cannot be freed by
+  ///             the engine, so they do not count towards the ceiling.
+  ///
+  size_t GetTrimmableTotal() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the name of the category in service protocol
+  ///             responses and timeline counters.
+  ///
+  static const char* GetCategoryName(Category category);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the usage of the categories shared by all the engines,
+  ///             with the other categories left at zero.
+  ///
+  static ImageMemoryUsage GetSharedUsage();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Trims the categories in `kTrimOrder` until the trimmable
+  ///             bytes no longer exceed the ceiling. Each category is trimmed
+  ///             by the bytes over the ceiling only, so that caches shared
+  ///             with other engines lose no more than needed.
+  ///
+  /// @param[in]  usage    The usage before trimming.
+  /// @param[in]  ceiling  The most trimmable bytes to keep.
+  /// @param[in]  trims    The trim of each category, indexed by category.
+  /// @param[in]  measure  Measures the usage again after a trim.
+  ///
+  /// @return     The usage after trimming.
+  ///
+  static ImageMemoryUsage TrimToCeiling(
+      ImageMemoryUsage usage,
+      size_t ceiling,
+      const std::array<Trim, kCategoryCount>& trims,
+      const std::function<ImageMemoryUsage()>& measure);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_MEMORY_USAGE_H_
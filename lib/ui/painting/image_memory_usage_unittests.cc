@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_memory_usage.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+using Category = ImageMemoryUsage::Category;
+
+// Trims that record their category and free the bytes they are asked for.
+class FakeCaches {
+ public:
+  explicit FakeCaches(const ImageMemoryUsage& usage) : usage_(usage) {
+    for (Category category : ImageMemoryUsage::kTrimOrder) {
+      trims_[category] = [this, category](size_t bytes) {
+        trimmed_.push_back(category);
+        usage_.bytes[category] -= std::min(bytes, usage_.bytes[category]);
+      };
+    }
+  }
+
+  ImageMemoryUsage Trim(size_t ceiling) {
+    return ImageMemoryUsage::TrimToCeiling(usage_, ceiling, trims_,
+                                           [this]() { return usage_; });
+  }
+
+  const std::vector<Category>& trimmed() const { return trimmed_; }
+
+ private:
+  ImageMemoryUsage usage_;
+  std::array<ImageMemoryUsage::Trim, ImageMemoryUsage::kCategoryCount> trims_;
+  std::vector<Category> trimmed_;
+};
+
+ImageMemoryUsage MakeUsage(size_t bytes_per_category) {
+  ImageMemoryUsage usage;
+  usage.bytes.fill(bytes_per_category);
+  return usage;
+}
+
+}  // namespace
+
+TEST(ImageMemoryUsageTest, CountsOnlyTrimmableCategoriesAgainstTheCeiling) {
+  auto usage = MakeUsage(10);
+  ASSERT_EQ(usage.GetTotal(), 60u);
+  ASSERT_EQ(usage.GetTrimmableTotal(), 40u);
+
+  // Live images over the ceiling do not cause the caches to be trimmed.
+  usage.bytes[ImageMemoryUsage::kImages] = 1000;
+  FakeCaches caches(usage);
+  auto trimmed = caches.Trim(40);
+  ASSERT_TRUE(caches.trimmed().empty());
+  ASSERT_EQ(trimmed.bytes, usage.bytes);
+}
+
+TEST(ImageMemoryUsageTest, TrimsFromTheCheapestToRefill) {
+  FakeCaches caches(MakeUsage(10));
+  auto trimmed = caches.Trim(0);
+  ASSERT_EQ(caches.trimmed(),
+            (std::vector<Category>{ImageMemoryUsage::kDecodedImageCache,
+                                   ImageMemoryUsage::kAnimatedFrames,
+                                   ImageMemoryUsage::kRasterCache,
+                                   ImageMemoryUsage::kResourceCache}));
+  ASSERT_EQ(trimmed.GetTrimmableTotal(), 0u);
+  ASSERT_EQ(trimmed.bytes[ImageMemoryUsage::kImages], 10u);
+}
+
+TEST(ImageMemoryUsageTest, StopsTrimmingUnderTheCeiling) {
+  auto usage = MakeUsage(10);
+  usage.bytes[ImageMemoryUsage::kDecodedImageCache] = 5;
+  FakeCaches caches(usage);
+
+  // Trimming the decoded images is not enough, and the animated frames are
+  // only trimmed by the bytes still over the ceiling.
+  auto trimmed = caches.Trim(27);
+  ASSERT_EQ(caches.trimmed(),
+            (std::vector<Category>{ImageMemoryUsage::kDecodedImageCache,
+                                   ImageMemoryUsage::kAnimatedFrames}));
+  ASSERT_EQ(trimmed.bytes[ImageMemoryUsage::kDecodedImageCache], 0u);
+  ASSERT_EQ(trimmed.bytes[ImageMemoryUsage::kAnimatedFrames], 7u);
+  ASSERT_EQ(trimmed.GetTrimmableTotal(), 27u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -6,7 +6,9 @@
 
 #include <cstring>
 
+#include "flutter/assets/asset_manager.h"
 #include "flutter/lib/ui/ui_dart_state.h"
+#include "flutter/lib/ui/window/platform_configuration.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
@@ -28,8 +30,12 @@ FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 ImmutableBuffer::~ImmutableBuffer() {}
 
 void ImmutableBuffer::RegisterNatives(tonic::DartLibraryNatives* natives) {
-  natives->Register({{"ImmutableBuffer_init", ImmutableBuffer::init, 3, true},
-                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+  natives->Register(
+      {{"ImmutableBuffer_init", ImmutableBuffer::init, 3, true},
+       {"ImmutableBuffer_initFromAsset", ImmutableBuffer::initFromAsset, 3,
+        true},
+       {"ImmutableBuffer_initFromFile", ImmutableBuffer::initFromFile, 3, true},
+       FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
 void ImmutableBuffer::init(Dart_NativeArguments args) {
@@ -49,6 +55,76 @@ void ImmutableBuffer::init(Dart_NativeArguments args) {
   tonic::DartInvoke(callback_handle, {Dart_TypeVoid()});
 }
 
+void ImmutableBuffer::initFromAsset(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  Dart_Handle callback_handle = Dart_GetNativeArgument(args, 2);
+  if (!Dart_IsClosure(callback_handle)) {
+    Dart_SetReturnValue(args, tonic::ToDart("Callback must be a function"));
+    return;
+  }
+
+  std::string asset_name = tonic::DartConverter<std::string>::FromDart(
+      Dart_GetNativeArgument(args, 1));
+  PlatformConfiguration* platform_configuration =
+      UIDartState::Current()->platform_configuration();
+  std::shared_ptr<AssetManager> asset_manager =
+      platform_configuration
+          ? platform_configuration->client()->GetAssetManager()
+          : nullptr;
+  std::unique_ptr<fml::Mapping> mapping =
+      asset_manager ? asset_manager->GetAsMapping(asset_name) : nullptr;
+  if (!mapping) {
+    Dart_SetReturnValue(args, tonic::ToDart("Asset not found"));
+    return;
+  }
+  InitWithMapping(args, std::move(mapping));
+}
+
+void ImmutableBuffer::initFromFile(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  Dart_Handle callback_handle = Dart_GetNativeArgument(args, 2);
+  if (!Dart_IsClosure(callback_handle)) {
+    Dart_SetReturnValue(args, tonic::ToDart("Callback must be a function"));
+    return;
+  }
+
+  std::string file_path = tonic::DartConverter<std::string>::FromDart(
+      Dart_GetNativeArgument(args, 1));
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(file_path);
+  if (!mapping) {
+    Dart_SetReturnValue(args, tonic::ToDart("Could not map file"));
+    return;
+  }
+  InitWithMapping(args, std::move(mapping));
+}
+
+void ImmutableBuffer::InitWithMapping(Dart_NativeArguments args,
+                                      std::unique_ptr<fml::Mapping> mapping) {
+  Dart_Handle buffer_handle = Dart_GetNativeArgument(args, 0);
+  Dart_Handle callback_handle = Dart_GetNativeArgument(args, 2);
+
+  auto sk_data = MakeSkDataWithMapping(std::move(mapping));
+  const size_t length = sk_data->size();
+  auto buffer = fml::MakeRefCounted<ImmutableBuffer>(std::move(sk_data));
+  buffer->AssociateWithDartWrapper(buffer_handle);
+  tonic::DartInvoke(callback_handle, {tonic::ToDart(length)});
+}
+
+sk_sp<SkData> ImmutableBuffer::MakeSkDataWithMapping(
+    std::unique_ptr<fml::Mapping> mapping) {
+  const uint8_t* bytes = mapping->GetMapping();
+  const size_t length = mapping->GetSize();
+  if (bytes == nullptr || length == 0) {
+    return SkData::MakeEmpty();
+  }
+
+  SkData::ReleaseProc proc = [](const void* ptr, void* context) {
+    delete reinterpret_cast<fml::Mapping*>(context);
+  };
+  return SkData::MakeWithProc(bytes, length, proc, mapping.release());
+}
+
 size_t ImmutableBuffer::GetAllocationSize() const {
   return sizeof(ImmutableBuffer) + data_->size();
 }
@@ -8,6 +8,7 @@
 #include <cstdint>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/tonic/dart_library_natives.h"
@@ -39,6 +40,35 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
   /// when the copy has completed.
   static void init(Dart_NativeArguments args);
 
+  /// Initializes a new ImmutableData from an asset matching a provided asset
+  /// string.
+  ///
+  /// The mapping of the asset is wrapped without copying it, so its bytes do
+  /// not pass through the Dart heap.
+  ///
+  /// The zero indexed argument is the the caller that will be registered as the
+  /// Dart peer of the native ImmutableBuffer object.
+  ///
+  /// The first indexed argumented is a String corresponding to the asset
+  /// to load.
+  ///
+  /// The second indexed argument is expected to be a void callback to signal
+  /// when the buffer has been created. It is passed the length of the buffer.
+  static void initFromAsset(Dart_NativeArguments args);
+
+  /// Initializes a new ImmutableData from a memory mapping of the file at a
+  /// provided path.
+  ///
+  /// The zero indexed argument is the the caller that will be registered as the
+  /// Dart peer of the native ImmutableBuffer object.
+  ///
+  /// The first indexed argumented is a String corresponding to the path of the
+  /// file to map.
+  ///
+  /// The second indexed argument is expected to be a void callback to signal
+  /// when the buffer has been created. It is passed the length of the buffer.
+  static void initFromFile(Dart_NativeArguments args);
+
   /// The length of the data in bytes.
   size_t length() const {
     FML_DCHECK(data_);
@@ -69,6 +99,17 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
 
   static sk_sp<SkData> MakeSkDataWithCopy(const void* data, size_t length);
 
+  // Returns SkData referencing the bytes of the mapping, which is released
+  // along with the SkData.
+  static sk_sp<SkData> MakeSkDataWithMapping(
+      std::unique_ptr<fml::Mapping> mapping);
+
+  // Wraps the mapping in a new ImmutableBuffer associated with the Dart peer
+  // in the zero indexed argument, and invokes the callback in the second
+  // indexed argument with its length.
+  static void InitWithMapping(Dart_NativeArguments args,
+                              std::unique_ptr<fml::Mapping> mapping);
+
   DEFINE_WRAPPERTYPEINFO();
   FML_FRIEND_MAKE_REF_COUNTED(ImmutableBuffer);
   FML_DISALLOW_COPY_AND_ASSIGN(ImmutableBuffer);
@@ -0,0 +1,385 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkPixelRef.h"
+
+namespace flutter {
+
+// The encoded data added so far, in the chunks it was added in. Once the image
+// is decoded incrementally, the chunks that the codec has read are released.
+class IncrementalImageDecoder::EncodedData {
+ public:
+  void Add(sk_sp<SkData> chunk) {
+    std::scoped_lock lock(mutex_);
+    size_ += chunk->size();
+    chunks_.push_back(std::move(chunk));
+  }
+
+  void Close() {
+    std::scoped_lock lock(mutex_);
+    closed_ = true;
+  }
+
+  bool IsClosed() const {
+    std::scoped_lock lock(mutex_);
+    return closed_;
+  }
+
+  // The total number of bytes added, including the released ones.
+  size_t GetSize() const {
+    std::scoped_lock lock(mutex_);
+    return size_;
+  }
+
+  size_t GetBufferedBytes() const {
+    std::scoped_lock lock(mutex_);
+    return size_ - released_size_;
+  }
+
+  // Copies up to |size| bytes starting at |offset| to |buffer|, or only counts
+  // them if |buffer| is null. Returns the number of bytes available.
+  size_t Read(size_t offset, void* buffer, size_t size) const {
+    std::scoped_lock lock(mutex_);
+    FML_DCHECK(offset >= released_size_);
+    size_t read = 0;
+    size_t chunk_offset = released_size_;
+    for (const auto& chunk : chunks_) {
+      if (read == size) {
+        break;
+      }
+      const size_t chunk_end = chunk_offset + chunk->size();
+      const size_t position = offset + read;
+      if (position < chunk_end) {
+        const size_t count = std::min(size - read, chunk_end - position);
+        if (buffer) {
+          std::memcpy(static_cast<uint8_t*>(buffer) + read,
+                      chunk->bytes() + (position - chunk_offset), count);
+        }
+        read += count;
+      }
+      chunk_offset = chunk_end;
+    }
+    return read;
+  }
+
+  // Releases the chunks that end before |offset| from now on.
+  void ReleaseConsumedData() {
+    std::scoped_lock lock(mutex_);
+    release_consumed_data_ = true;
+  }
+
+  bool ReleasesConsumedData() const {
+    std::scoped_lock lock(mutex_);
+    return release_consumed_data_;
+  }
+
+  // Signals that the bytes before |offset| will not be read again.
+  void Consume(size_t offset) {
+    std::scoped_lock lock(mutex_);
+    if (!release_consumed_data_) {
+      return;
+    }
+    while (!chunks_.empty() &&
+           released_size_ + chunks_.front()->size() <= offset) {
+      released_size_ += chunks_.front()->size();
+      chunks_.pop_front();
+    }
+  }
+
+  // Returns all the data in a single buffer.
+  sk_sp<SkData> Flatten() {
+    std::scoped_lock lock(mutex_);
+    FML_DCHECK(released_size_ == 0);
+    if (chunks_.size() != 1) {
+      auto data = SkData::MakeUninitialized(size_);
+      auto* bytes = static_cast<uint8_t*>(data->writable_data());
+      for (const auto& chunk : chunks_) {
+        std::memcpy(bytes, chunk->data(), chunk->size());
+        bytes += chunk->size();
+      }
+      chunks_.clear();
+      chunks_.push_back(std::move(data));
+    }
+    return chunks_.front();
+  }
+
+  // Releases all the data once the image is decoded.
+  void Discard() {
+    std::scoped_lock lock(mutex_);
+    closed_ = true;
+    released_size_ = size_;
+    chunks_.clear();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::deque<sk_sp<SkData>> chunks_;
+  size_t size_ = 0;
+  size_t released_size_ = 0;
+  bool closed_ = false;
+  bool release_consumed_data_ = false;
+};
+
+// A stream over the encoded data added so far. Reads return fewer bytes than
+// requested when the data that follows has not been added yet.
+class IncrementalImageDecoder::EncodedDataStream : public SkStream {
+ public:
+  explicit EncodedDataStream(std::shared_ptr<EncodedData> data)
+      : data_(std::move(data)) {}
+
+  // |SkStream|
+  size_t read(void* buffer, size_t size) override {
+    const size_t read = data_->Read(position_, buffer, size);
+    position_ += read;
+    data_->Consume(position_);
+    return read;
+  }
+
+  // |SkStream|
+  size_t peek(void* buffer, size_t size) const override {
+    return data_->Read(position_, buffer, size);
+  }
+
+  // |SkStream|
+  bool isAtEnd() const override {
+    return data_->IsClosed() && position_ >= data_->GetSize();
+  }
+
+  // |SkStream|
+  bool rewind() override {
+    if (data_->ReleasesConsumedData()) {
+      return false;
+    }
+    position_ = 0;
+    return true;
+  }
+
+ private:
+  const std::shared_ptr<EncodedData> data_;
+  size_t position_ = 0;
+};
+
+namespace {
+
+// Enough bytes for Skia to recognize the format of an image, and to read the
+// interlace method of PNG images.
+constexpr size_t kHeaderSize = 29;
+
+// The offset of the interlace method in the IHDR chunk that starts PNG images.
+constexpr size_t kPngInterlaceMethodOffset = 28;
+
+// Whether the image is in a format that Skia may decode incrementally, with
+// each row written once and in order. Formats that can hold animations are
+// excluded, since only their first frame would be decoded, as are interlaced
+// PNG images, whose rows are refined by each pass.
+bool IsIncrementalFormat(const uint8_t* header, size_t size) {
+  static const uint8_t kPngSignature[] = {0x89, 'P',  'N',  'G',
+                                          '\r', '\n', 0x1a, '\n'};
+  static const uint8_t kJpegSignature[] = {0xFF, 0xD8, 0xFF};
+  return (size > kPngInterlaceMethodOffset &&
+          std::memcmp(header, kPngSignature, sizeof(kPngSignature)) == 0 &&
+          header[kPngInterlaceMethodOffset] == 0) ||
+         (size >= sizeof(kJpegSignature) &&
+          std::memcmp(header, kJpegSignature, sizeof(kJpegSignature)) == 0);
+}
+
+bool StartIncrementalDecode(BuiltinSkiaCodecImageGenerator* generator,
+                            SkBitmap* bitmap) {
+  if (generator->GetFrameCount() != 1) {
+    return false;
+  }
+  SkImageInfo info = generator->GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  // The pixels are zeroed, so that the rows that are not decoded yet are
+  // transparent.
+  if (!bitmap->tryAllocPixelsFlags(info, SkBitmap::kZeroPixels_AllocFlag)) {
+    return false;
+  }
+  return generator->StartIncrementalDecode(info, bitmap->getPixels(),
+                                           bitmap->rowBytes());
+}
+
+}  // namespace
+
+IncrementalImageDecoder::IncrementalImageDecoder(
+    ImageGeneratorFactory make_generator)
+    : make_generator_(std::move(make_generator)),
+      data_(std::make_shared<EncodedData>()) {}
+
+IncrementalImageDecoder::~IncrementalImageDecoder() = default;
+
+void IncrementalImageDecoder::AddData(sk_sp<SkData> data) {
+  if (data_->IsClosed()) {
+    FML_DLOG(ERROR) << "Data added to a closed incremental image decoder.";
+    return;
+  }
+  data_->Add(std::move(data));
+}
+
+void IncrementalImageDecoder::Close() {
+  data_->Close();
+}
+
+bool IncrementalImageDecoder::IsIncremental() const {
+  std::scoped_lock lock(mutex_);
+  return mode_ == Mode::kIncremental;
+}
+
+size_t IncrementalImageDecoder::GetBufferedBytes() const {
+  return data_->GetBufferedBytes();
+}
+
+void IncrementalImageDecoder::SetUpDecode() {
+  // The mode is only written by |Decode|, so it can be read without the lock.
+  if (mode_ != Mode::kUnknown) {
+    return;
+  }
+
+  uint8_t header[kHeaderSize];
+  const size_t header_size = data_->Read(0, header, sizeof(header));
+  if (header_size < sizeof(header) && !data_->IsClosed()) {
+    return;
+  }
+
+  if (IsIncrementalFormat(header, header_size)) {
+    SkCodec::Result result;
+    auto generator = BuiltinSkiaCodecImageGenerator::MakeFromStream(
+        std::make_unique<EncodedDataStream>(data_), &result);
+    if (!generator && result == SkCodec::kIncompleteInput &&
+        !data_->IsClosed()) {
+      // Wait for the rest of the header.
+      return;
+    }
+    SkBitmap bitmap;
+    if (generator && StartIncrementalDecode(generator.get(), &bitmap)) {
+      data_->ReleaseConsumedData();
+      std::scoped_lock lock(mutex_);
+      mode_ = Mode::kIncremental;
+      codec_generator_ = std::move(generator);
+      bitmap_ = std::move(bitmap);
+      return;
+    }
+  }
+
+  std::scoped_lock lock(mutex_);
+  mode_ = Mode::kBuffered;
+}
+
+void IncrementalImageDecoder::SetUpGenerator() {
+  if (mode_ != Mode::kBuffered || generator_ || !data_->IsClosed()) {
+    return;
+  }
+  auto generator = make_generator_(data_->Flatten());
+  std::scoped_lock lock(mutex_);
+  if (generator) {
+    generator_ = std::move(generator);
+  } else {
+    FML_LOG(ERROR) << "No image decoder was found for the image data.";
+    final_result_ = std::make_unique<Result>(Result{Status::kFailed});
+  }
+}
+
+IncrementalImageDecoder::Result IncrementalImageDecoder::Decode() {
+  TRACE_EVENT0("flutter", "IncrementalImageDecoder::Decode");
+  // The final result is only written by this method, so it can be read
+  // without the lock.
+  if (!final_result_) {
+    SetUpDecode();
+    SetUpGenerator();
+  }
+
+  std::shared_ptr<BuiltinSkiaCodecImageGenerator> codec_generator;
+  SkBitmap bitmap;
+  std::shared_ptr<ImageGenerator> generator;
+  {
+    std::scoped_lock lock(mutex_);
+    if (final_result_) {
+      return *final_result_;
+    }
+    codec_generator = codec_generator_;
+    bitmap = bitmap_;
+    generator = generator_;
+  }
+
+  if (codec_generator) {
+    return DecodeIncrementally(codec_generator, std::move(bitmap));
+  }
+  if (generator) {
+    return DecodeBuffered(generator);
+  }
+  // The header or the rest of a buffered image has not been added yet.
+  return {};
+}
+
+IncrementalImageDecoder::Result IncrementalImageDecoder::DecodeIncrementally(
+    const std::shared_ptr<BuiltinSkiaCodecImageGenerator>& codec_generator,
+    SkBitmap bitmap) {
+  // Read before decoding, so that running out of data after the image was
+  // closed means that the image is truncated.
+  const bool closed = data_->IsClosed();
+  int rows_decoded = 0;
+  const SkCodec::Result result =
+      codec_generator->IncrementalDecode(&rows_decoded);
+
+  if (result == SkCodec::kSuccess) {
+    bitmap.setImmutable();
+    return Finish({Status::kComplete, SkImage::MakeFromBitmap(bitmap),
+                   bitmap.height()});
+  }
+
+  if (result != SkCodec::kIncompleteInput || closed) {
+    FML_LOG(ERROR) << "Could not decode the image incrementally: "
+                   << SkCodec::ResultToString(result);
+    return Finish({Status::kFailed});
+  }
+
+  Result partial;
+  partial.decoded_rows = rows_decoded;
+  SkPixmap rows;
+  if (rows_decoded > 0 &&
+      bitmap.pixmap().extractSubset(
+          &rows, SkIRect::MakeWH(bitmap.width(), rows_decoded))) {
+    // The decoded rows are not written again, so the partial image shares
+    // them with |bitmap|, where the decode of the rows below goes on.
+    partial.image = SkImage::MakeFromRaster(
+        rows,
+        [](const void* pixels, void* pixel_ref) {
+          static_cast<SkPixelRef*>(pixel_ref)->unref();
+        },
+        SkSafeRef(bitmap.pixelRef()));
+  }
+  return partial;
+}
+
+IncrementalImageDecoder::Result IncrementalImageDecoder::DecodeBuffered(
+    const std::shared_ptr<ImageGenerator>& generator) {
+  sk_sp<SkImage> image = generator->GetImage();
+  if (!image) {
+    return Finish({Status::kFailed});
+  }
+  const int height = image->height();
+  return Finish({Status::kComplete, std::move(image), height});
+}
+
+IncrementalImageDecoder::Result IncrementalImageDecoder::Finish(Result result) {
+  data_->Discard();
+  std::scoped_lock lock(mutex_);
+  final_result_ = std::make_unique<Result>(result);
+  codec_generator_.reset();
+  bitmap_.reset();
+  generator_.reset();
+  return result;
+}
+
+}  // namespace flutter
@@ -0,0 +1,126 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DECODER_H_
+
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+// Decodes an encoded image while its data is still arriving.
+//
+// Images that Skia can decode incrementally are decoded as far as the data
+// added so far allows, and each chunk of encoded data is released once it has
+// been decoded. Other images are decoded once all their data has been added.
+//
+// |AddData| and |Close| only append the data, so that they are cheap enough
+// for the UI thread. The codec, the pixels of the image and the generator of
+// buffered images are all set up by |Decode|, which can be called on any
+// thread, but not concurrently with itself.
+class IncrementalImageDecoder {
+ public:
+  // This must be kept in sync with the status handled by
+  // `IncrementalImageDescriptor.decode` in painting.dart.
+  enum class Status {
+    // More data is needed to decode the rest of the image.
+    kIncomplete,
+    // The image is fully decoded.
+    kComplete,
+    // The image could not be decoded.
+    kFailed,
+  };
+
+  struct Result {
+    Status status = Status::kIncomplete;
+    // The rows decoded so far, or null if no rows are decoded yet. Until the
+    // image is complete, this only holds the decoded rows, which it shares
+    // with the pixels the rest of the image is decoded to.
+    sk_sp<SkImage> image;
+    // The number of rows decoded from the top of the image.
+    int decoded_rows = 0;
+  };
+
+  // |make_generator| creates the generator of images that cannot be decoded
+  // incrementally once all their data has been added. It is called on the
+  // thread that calls |Decode|.
+  explicit IncrementalImageDecoder(ImageGeneratorFactory make_generator);
+
+  ~IncrementalImageDecoder();
+
+  // Appends the next chunk of the encoded image.
+  void AddData(sk_sp<SkData> data);
+
+  // Signals that the whole encoded image has been added.
+  void Close();
+
+  // Returns whether the image is decoded as its data arrives. This is only
+  // known once the header of the image has been added and decoded.
+  bool IsIncremental() const;
+
+  // The number of bytes of encoded data added and not released yet.
+  size_t GetBufferedBytes() const;
+
+  // Decodes the data added so far. Once the image is complete, this returns
+  // the complete image.
+  Result Decode();
+
+ private:
+  class EncodedData;
+  class EncodedDataStream;
+
+  enum class Mode {
+    // The header of the image has not been added yet.
+    kUnknown,
+    kIncremental,
+    // The image is decoded once all its data has been added.
+    kBuffered,
+  };
+
+  const ImageGeneratorFactory make_generator_;
+  const std::shared_ptr<EncodedData> data_;
+
+  // Guards the members below, which are set up by |Decode| and also read by
+  // the other methods. The lock is not held while decoding.
+  mutable std::mutex mutex_;
+  Mode mode_ = Mode::kUnknown;
+  // Set up when the image is decoded incrementally.
+  std::shared_ptr<BuiltinSkiaCodecImageGenerator> codec_generator_;
+  SkBitmap bitmap_;
+  // Set up once all the data of a buffered image has been added.
+  std::shared_ptr<ImageGenerator> generator_;
+  // Set once the image is complete or has failed.
+  std::unique_ptr<Result> final_result_;
+
+  // Decides how the image is decoded once enough of it has been added, and
+  // sets up the decode.
+  void SetUpDecode();
+
+  // Creates the generator of a buffered image once all its data has been
+  // added.
+  void SetUpGenerator();
+
+  Result DecodeIncrementally(
+      const std::shared_ptr<BuiltinSkiaCodecImageGenerator>& codec_generator,
+      SkBitmap bitmap);
+
+  Result DecodeBuffered(const std::shared_ptr<ImageGenerator>& generator);
+
+  // Records the final result of the decode, and releases the decode state.
+  Result Finish(Result result);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IncrementalImageDecoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DECODER_H_
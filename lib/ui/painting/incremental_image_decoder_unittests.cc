@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkData> OpenFixture(const char* name) {
+  auto mapping = OpenFixtureAsMapping(name);
+  FML_CHECK(mapping);
+  return SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+}
+
+std::unique_ptr<IncrementalImageDecoder> CreateDecoder(
+    ImageGeneratorRegistry& registry) {
+  return std::make_unique<IncrementalImageDecoder>(
+      [&registry](sk_sp<SkData> buffer) {
+        return registry.CreateCompatibleGenerator(std::move(buffer));
+      });
+}
+
+// Adds |size| bytes of |data| from |offset|, in chunks of |chunk_size| bytes.
+void AddData(IncrementalImageDecoder& decoder,
+             const sk_sp<SkData>& data,
+             size_t offset,
+             size_t size,
+             size_t chunk_size) {
+  for (size_t end = offset + size; offset < end; offset += chunk_size) {
+    decoder.AddData(SkData::MakeSubset(data.get(), offset,
+                                       std::min(chunk_size, end - offset)));
+  }
+}
+
+bool HaveSamePixels(const sk_sp<SkImage>& a, const sk_sp<SkImage>& b) {
+  if (!a || !b || a->dimensions() != b->dimensions()) {
+    return false;
+  }
+  const auto info = SkImageInfo::MakeN32Premul(a->dimensions());
+  SkBitmap a_pixels;
+  SkBitmap b_pixels;
+  return a_pixels.tryAllocPixels(info) && b_pixels.tryAllocPixels(info) &&
+         a->readPixels(a_pixels.pixmap(), 0, 0) &&
+         b->readPixels(b_pixels.pixmap(), 0, 0) &&
+         std::memcmp(a_pixels.getPixels(), b_pixels.getPixels(),
+                     info.computeMinByteSize()) == 0;
+}
+
+}  // namespace
+
+TEST(IncrementalImageDecoderTest, DecodesPngsAsTheirDataArrives) {
+  ImageGeneratorRegistry registry;
+  auto decoder = CreateDecoder(registry);
+  auto data = OpenFixture("Horizontal.png");
+  const size_t half = data->size() / 2;
+
+  AddData(*decoder, data, 0, half, 1024);
+  // The data is only looked at by the decode.
+  ASSERT_FALSE(decoder->IsIncremental());
+  auto partial = decoder->Decode();
+  ASSERT_TRUE(decoder->IsIncremental());
+  ASSERT_EQ(partial.status, IncrementalImageDecoder::Status::kIncomplete);
+  ASSERT_TRUE(partial.image);
+  ASSERT_GT(partial.decoded_rows, 0);
+  // The partial image only holds the decoded rows.
+  ASSERT_EQ(partial.decoded_rows, partial.image->height());
+  // The chunks that have been decoded are released.
+  ASSERT_LT(decoder->GetBufferedBytes(), 1024u);
+
+  AddData(*decoder, data, half, data->size() - half, 1024);
+  decoder->Close();
+  auto complete = decoder->Decode();
+  ASSERT_EQ(complete.status, IncrementalImageDecoder::Status::kComplete);
+  ASSERT_EQ(complete.decoded_rows, complete.image->height());
+  ASSERT_EQ(decoder->GetBufferedBytes(), 0u);
+
+  auto expected = registry.CreateCompatibleGenerator(data)->GetImage();
+  ASSERT_TRUE(HaveSamePixels(complete.image, expected));
+  // The rows of the partial image were not changed by the rest of the decode.
+  ASSERT_TRUE(HaveSamePixels(
+      partial.image,
+      expected->makeSubset(SkIRect::MakeWH(expected->width(),
+                                           partial.decoded_rows))));
+
+  // The complete image is returned again.
+  ASSERT_EQ(decoder->Decode().image, complete.image);
+}
+
+TEST(IncrementalImageDecoderTest, WaitsForTheHeader) {
+  ImageGeneratorRegistry registry;
+  auto decoder = CreateDecoder(registry);
+  auto data = OpenFixture("Horizontal.png");
+
+  AddData(*decoder, data, 0, 8, 8);
+  ASSERT_FALSE(decoder->IsIncremental());
+  auto result = decoder->Decode();
+  ASSERT_EQ(result.status, IncrementalImageDecoder::Status::kIncomplete);
+  ASSERT_FALSE(result.image);
+
+  AddData(*decoder, data, 8, data->size() - 8, 1024);
+  decoder->Decode();
+  ASSERT_TRUE(decoder->IsIncremental());
+}
+
+TEST(IncrementalImageDecoderTest, DecodesAnimatedImagesOnceComplete) {
+  ImageGeneratorRegistry registry;
+  auto decoder = CreateDecoder(registry);
+  auto data = OpenFixture("hello_loop_2.gif");
+
+  AddData(*decoder, data, 0, data->size(), 256);
+  auto result = decoder->Decode();
+  ASSERT_FALSE(decoder->IsIncremental());
+  ASSERT_EQ(result.status, IncrementalImageDecoder::Status::kIncomplete);
+  ASSERT_FALSE(result.image);
+  ASSERT_EQ(decoder->GetBufferedBytes(), data->size());
+
+  decoder->Close();
+  result = decoder->Decode();
+  ASSERT_EQ(result.status, IncrementalImageDecoder::Status::kComplete);
+  ASSERT_TRUE(HaveSamePixels(
+      result.image, registry.CreateCompatibleGenerator(data)->GetImage()));
+}
+
+TEST(IncrementalImageDecoderTest, FailsWhenTheDataEndsEarly) {
+  ImageGeneratorRegistry registry;
+  auto decoder = CreateDecoder(registry);
+  auto data = OpenFixture("Horizontal.png");
+
+  AddData(*decoder, data, 0, data->size() / 2, 1024);
+  decoder->Close();
+  auto result = decoder->Decode();
+  ASSERT_EQ(result.status, IncrementalImageDecoder::Status::kFailed);
+  ASSERT_FALSE(result.image);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,176 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/incremental_image_descriptor.h"
+
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/tonic/dart_args.h"
+#include "third_party/tonic/dart_binding_macros.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+
+namespace flutter {
+
+static void IncrementalImageDescriptor_constructor(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  DartCallConstructor(&IncrementalImageDescriptor::Create, args);
+}
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, IncrementalImageDescriptor);
+
+#define FOR_EACH_BINDING(V)               \
+  V(IncrementalImageDescriptor, addChunk) \
+  V(IncrementalImageDescriptor, close)    \
+  V(IncrementalImageDescriptor, decode)   \
+  V(IncrementalImageDescriptor, dispose)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void IncrementalImageDescriptor::RegisterNatives(
+    tonic::DartLibraryNatives* natives) {
+  natives->Register({{"IncrementalImageDescriptor_constructor",
+                      IncrementalImageDescriptor_constructor, 1, true},
+                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+fml::RefPtr<IncrementalImageDescriptor> IncrementalImageDescriptor::Create() {
+  // The generator is created by the decode on the IO thread, which cannot use
+  // the registry itself.
+  auto registry = UIDartState::Current()->GetImageGeneratorRegistry();
+  ImageGeneratorFactory make_generator;
+  if (registry) {
+    make_generator = registry->GetFactorySnapshot();
+  } else {
+    make_generator = [](sk_sp<SkData>) -> std::shared_ptr<ImageGenerator> {
+      return nullptr;
+    };
+  }
+  return fml::MakeRefCounted<IncrementalImageDescriptor>(
+      std::move(make_generator));
+}
+
+IncrementalImageDescriptor::IncrementalImageDescriptor(
+    ImageGeneratorFactory make_generator)
+    : decoder_(std::make_shared<IncrementalImageDecoder>(
+          std::move(make_generator))) {}
+
+IncrementalImageDescriptor::~IncrementalImageDescriptor() = default;
+
+void IncrementalImageDescriptor::addChunk(fml::RefPtr<ImmutableBuffer> chunk) {
+  if (decoder_ && chunk) {
+    decoder_->AddData(chunk->data());
+  }
+}
+
+void IncrementalImageDescriptor::close() {
+  if (decoder_) {
+    decoder_->Close();
+  }
+}
+
+static void InvokeDecodeCallback(
+    fml::RefPtr<CanvasImage> image,
+    int decoded_rows,
+    IncrementalImageDecoder::Status status,
+    std::unique_ptr<tonic::DartPersistentValue> callback) {
+  std::shared_ptr<tonic::DartState> dart_state = callback->dart_state().lock();
+  if (!dart_state) {
+    FML_DLOG(ERROR) << "Could not acquire Dart state while attempting to fire "
+                       "incremental decode callback.";
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+  tonic::DartInvoke(callback->value(),
+                    {tonic::ToDart(image), tonic::ToDart(decoded_rows),
+                     tonic::ToDart(static_cast<int>(status))});
+}
+
+// Uploads the decoded part of the image to the GPU if there is a resource
+// context.
+static sk_sp<SkImage> UploadImage(
+    sk_sp<SkImage> image,
+    fml::WeakPtr<GrDirectContext> resource_context) {
+  if (!image || !resource_context) {
+    return image;
+  }
+  SkPixmap pixmap;
+  if (!image->peekPixels(&pixmap)) {
+    return nullptr;
+  }
+  return SkImage::MakeCrossContextFromPixmap(resource_context.get(), pixmap,
+                                             true);
+}
+
+static void DecodeAndInvokeCallback(
+    const std::shared_ptr<IncrementalImageDecoder>& decoder,
+    std::unique_ptr<tonic::DartPersistentValue> callback,
+    fml::RefPtr<fml::TaskRunner> ui_task_runner,
+    fml::WeakPtr<GrDirectContext> resource_context,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
+  TRACE_EVENT0("flutter", "IncrementalImageDescriptor::Decode");
+  IncrementalImageDecoder::Result result = decoder->Decode();
+  fml::RefPtr<CanvasImage> image;
+  if (result.status != IncrementalImageDecoder::Status::kFailed) {
+    sk_sp<SkImage> sk_image =
+        UploadImage(std::move(result.image), std::move(resource_context));
+    if (sk_image) {
+      image = CanvasImage::Create();
+      image->set_image({std::move(sk_image), std::move(unref_queue)});
+    }
+  }
+  ui_task_runner->PostTask(fml::MakeCopyable(
+      [image = std::move(image), decoded_rows = result.decoded_rows,
+       status = result.status, callback = std::move(callback)]() mutable {
+        InvokeDecodeCallback(std::move(image), decoded_rows, status,
+                             std::move(callback));
+      }));
+}
+
+Dart_Handle IncrementalImageDescriptor::decode(Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+  if (!decoder_) {
+    return tonic::ToDart("The descriptor has been disposed");
+  }
+
+  auto* dart_state = UIDartState::Current();
+  const auto& task_runners = dart_state->GetTaskRunners();
+
+  // The IO task runner runs the decodes one at a time, in order.
+  task_runners.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
+      [callback = std::make_unique<tonic::DartPersistentValue>(
+           tonic::DartState::Current(), callback_handle),
+       weak_decoder = std::weak_ptr<IncrementalImageDecoder>(decoder_),
+       ui_task_runner = task_runners.GetUITaskRunner(),
+       io_manager = dart_state->GetIOManager()]() mutable {
+        auto decoder = weak_decoder.lock();
+        if (!decoder) {
+          ui_task_runner->PostTask(fml::MakeCopyable(
+              [callback = std::move(callback)]() { callback->Clear(); }));
+          return;
+        }
+        DecodeAndInvokeCallback(decoder, std::move(callback),
+                                std::move(ui_task_runner),
+                                io_manager->GetResourceContext(),
+                                io_manager->GetSkiaUnrefQueue());
+      }));
+
+  return Dart_Null();
+}
+
+void IncrementalImageDescriptor::dispose() {
+  // Releases the encoded data, unless a decode is running.
+  decoder_.reset();
+  ClearDartWrapper();
+}
+
+size_t IncrementalImageDescriptor::GetAllocationSize() const {
+  return sizeof(*this) + (decoder_ ? decoder_->GetBufferedBytes() : 0);
+}
+
+}  // namespace flutter
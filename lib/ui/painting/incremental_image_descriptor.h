@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DESCRIPTOR_H_
+#define FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DESCRIPTOR_H_
+
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/dart_wrapper.h"
+#include "flutter/lib/ui/painting/immutable_buffer.h"
+#include "flutter/lib/ui/painting/incremental_image_decoder.h"
+#include "third_party/tonic/dart_library_natives.h"
+
+namespace flutter {
+
+/// @brief  Describes an encoded image whose data arrives in chunks, for
+///         example from the network. The image can be decoded before all of
+///         its data has arrived, and the decoded part of the image is
+///         delivered to Dart as it grows.
+/// @see    `IncrementalImageDecoder`
+class IncrementalImageDescriptor
+    : public RefCountedDartWrappable<IncrementalImageDescriptor> {
+  DEFINE_WRAPPERTYPEINFO();
+  FML_FRIEND_MAKE_REF_COUNTED(IncrementalImageDescriptor);
+
+ public:
+  static fml::RefPtr<IncrementalImageDescriptor> Create();
+
+  ~IncrementalImageDescriptor() override;
+
+  /// @brief  Appends the next chunk of the encoded image. The bytes of the
+  ///         chunk are shared with the buffer, not copied.
+  void addChunk(fml::RefPtr<ImmutableBuffer> chunk);
+
+  /// @brief  Signals that all the chunks of the encoded image have been added.
+  void close();
+
+  /// @brief  Decodes the chunks added so far on the IO thread, and invokes
+  ///         the callback with the decoded part of the image, the number of
+  ///         rows decoded and the `IncrementalImageDecoder::Status` of the
+  ///         decode.
+  /// @return An error message on failure, null on success.
+  Dart_Handle decode(Dart_Handle callback_handle);
+
+  void dispose();
+
+  size_t GetAllocationSize() const override;
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  explicit IncrementalImageDescriptor(ImageGeneratorFactory make_generator);
+
+  // Shared with the decodes running on the IO thread, which do not keep it
+  // alive once the descriptor is disposed.
+  std::shared_ptr<IncrementalImageDecoder> decoder_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IncrementalImageDescriptor);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_INCREMENTAL_IMAGE_DESCRIPTOR_H_
@@ -4,19 +4,56 @@
 
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
 #include "third_party/dart/runtime/include/dart_api.h"
-#include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 
 namespace flutter {
 
+namespace {
+
+std::mutex g_stats_mutex;
+MultiFrameCodec::Stats g_stats;
+
+void RecordFrameLatency(fml::TimeDelta latency) {
+  {
+    std::scoped_lock lock(g_stats_mutex);
+    g_stats.frames++;
+    g_stats.total_latency = g_stats.total_latency + latency;
+    g_stats.max_latency = std::max(g_stats.max_latency, latency);
+  }
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "MultiFrameCodec", 0, "FrameLatencyMicros",
+                    latency.ToMicroseconds());
+#endif  // !FLUTTER_RELEASE
+}
+
+// Returns the scheduler that decodes the frames ahead, or null if the decoder
+// is gone. Must be called on the UI thread, where the decoder lives.
+std::shared_ptr<ImageDecodeScheduler> GetDecodeScheduler(
+    UIDartState* dart_state) {
+  auto decoder = dart_state->GetImageDecoder();
+  return decoder ? decoder->GetScheduler() : nullptr;
+}
+
+}  // namespace
+
 MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator)
     : state_(new State(std::move(generator))) {}
 
 MultiFrameCodec::~MultiFrameCodec() = default;
 
+MultiFrameCodec::Stats MultiFrameCodec::GetStats() {
+  std::scoped_lock lock(g_stats_mutex);
+  return g_stats;
+}
+
 MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
     : generator_(std::move(generator)),
       frameCount_(generator_->GetFrameCount()),
@@ -24,13 +61,18 @@ MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
                                ImageGenerator::kInfinitePlayCount
                            ? -1
                            : generator_->GetPlayCount() - 1),
+      decoder_(std::make_shared<AnimatedFrameDecoder>(generator_)),
+      priority_(ImageDecodeScheduler::Priority::kVisible),
+      disposed_(false),
       nextFrameIndex_(0) {}
 
 static void InvokeNextFrameCallback(
     fml::RefPtr<CanvasImage> image,
     int duration,
     std::unique_ptr<DartPersistentValue> callback,
-    size_t trace_id) {
+    size_t trace_id,
+    fml::TimePoint request_time) {
+  RecordFrameLatency(fml::TimePoint::Now() - request_time);
   std::shared_ptr<tonic::DartState> dart_state = callback->dart_state().lock();
   if (!dart_state) {
     FML_DLOG(ERROR) << "Could not acquire Dart state while attempting to fire "
@@ -42,129 +84,79 @@ static void InvokeNextFrameCallback(
                     {tonic::ToDart(image), tonic::ToDart(duration)});
 }
 
-// Copied the source bitmap to the destination. If this cannot occur due to
-// running out of memory or the image info not being compatible, returns false.
-static bool CopyToBitmap(SkBitmap* dst,
-                         SkColorType dstColorType,
-                         const SkBitmap& src) {
-  SkPixmap srcPM;
-  if (!src.peekPixels(&srcPM)) {
-    return false;
-  }
-
-  SkBitmap tmpDst;
-  SkImageInfo dstInfo = srcPM.info().makeColorType(dstColorType);
-  if (!tmpDst.setInfo(dstInfo)) {
-    return false;
-  }
-
-  if (!tmpDst.tryAllocPixels()) {
-    return false;
-  }
-
-  SkPixmap dstPM;
-  if (!tmpDst.peekPixels(&dstPM)) {
-    return false;
-  }
-
-  if (!srcPM.readPixels(dstPM)) {
-    return false;
-  }
-
-  dst->swap(tmpDst);
-  return true;
-}
-
-sk_sp<SkImage> MultiFrameCodec::State::GetNextFrameImage(
+sk_sp<SkImage> MultiFrameCodec::State::UploadFrameImage(
+    sk_sp<SkImage> frame,
     fml::WeakPtr<GrDirectContext> resourceContext) {
-  SkBitmap bitmap = SkBitmap();
-  SkImageInfo info = generator_->GetInfo().makeColorType(kN32_SkColorType);
-  if (info.alphaType() == kUnpremul_SkAlphaType) {
-    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
-    info = updated;
-  }
-  bitmap.allocPixels(info);
-
-  ImageGenerator::FrameInfo frameInfo =
-      generator_->GetFrameInfo(nextFrameIndex_);
-
-  const int requiredFrameIndex =
-      frameInfo.required_frame.value_or(SkCodec::kNoFrame);
-  std::optional<unsigned int> prior_frame_index = std::nullopt;
-
-  if (requiredFrameIndex != SkCodec::kNoFrame) {
-    if (lastRequiredFrame_ == nullptr) {
-      FML_LOG(ERROR) << "Frame " << nextFrameIndex_ << " depends on frame "
-                     << requiredFrameIndex
-                     << " and no required frames are cached.";
-      return nullptr;
-    } else if (lastRequiredFrameIndex_ != requiredFrameIndex) {
-      FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
-                     << " is not cached. Using " << lastRequiredFrameIndex_
-                     << " instead";
-    }
-
-    if (lastRequiredFrame_->getPixels() &&
-        CopyToBitmap(&bitmap, lastRequiredFrame_->colorType(),
-                     *lastRequiredFrame_)) {
-      prior_frame_index = requiredFrameIndex;
-    }
-  }
-
-  if (!generator_->GetPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
-                             nextFrameIndex_, requiredFrameIndex)) {
-    FML_LOG(ERROR) << "Could not getPixels for frame " << nextFrameIndex_;
+  if (!frame) {
     return nullptr;
   }
-
-  // Hold onto this if we need it to decode future frames.
-  if (frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep) {
-    lastRequiredFrame_ = std::make_unique<SkBitmap>(bitmap);
-    lastRequiredFrameIndex_ = nextFrameIndex_;
-  }
-
   if (resourceContext) {
-    SkPixmap pixmap(bitmap.info(), bitmap.pixelRef()->pixels(),
-                    bitmap.pixelRef()->rowBytes());
+    SkPixmap pixmap;
+    if (!frame->peekPixels(&pixmap)) {
+      return nullptr;
+    }
     return SkImage::MakeCrossContextFromPixmap(resourceContext.get(), pixmap,
                                                true);
   } else {
     // Defer decoding until time of draw later on the raster thread. Can happen
     // when GL operations are currently forbidden such as in the background
     // on iOS.
-    return SkImage::MakeFromBitmap(bitmap);
+    return frame;
   }
 }
 
 void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
     std::unique_ptr<DartPersistentValue> callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
+    std::shared_ptr<ImageDecodeScheduler> scheduler,
     fml::WeakPtr<GrDirectContext> resourceContext,
     fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
-    size_t trace_id) {
+    size_t trace_id,
+    fml::TimePoint request_time) {
+  if (disposed_) {
+    ui_task_runner->PostTask(fml::MakeCopyable(
+        [callback = std::move(callback), trace_id, request_time]() mutable {
+          InvokeNextFrameCallback(nullptr, 0, std::move(callback), trace_id,
+                                  request_time);
+        }));
+    return;
+  }
+
   fml::RefPtr<CanvasImage> image = nullptr;
   int duration = 0;
-  sk_sp<SkImage> skImage = GetNextFrameImage(resourceContext);
+  AnimatedFrameDecoder::Frame frame = decoder_->GetFrame(nextFrameIndex_);
+  sk_sp<SkImage> skImage =
+      UploadFrameImage(std::move(frame.image), resourceContext);
   if (skImage) {
     image = CanvasImage::Create();
     image->set_image({skImage, std::move(unref_queue)});
-    ImageGenerator::FrameInfo frameInfo =
-        generator_->GetFrameInfo(nextFrameIndex_);
-    duration = frameInfo.duration;
+    duration = frame.duration;
+  }
+
+  // Decode the next frames while this one is displayed.
+  if (scheduler && priority_ != ImageDecodeScheduler::Priority::kBackground) {
+    decoder_->DecodeAhead(nextFrameIndex_, scheduler);
   }
   nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
-  ui_task_runner->PostTask(fml::MakeCopyable([callback = std::move(callback),
-                                              image = std::move(image),
-                                              duration, trace_id]() mutable {
-    InvokeNextFrameCallback(std::move(image), duration, std::move(callback),
-                            trace_id);
-  }));
+  ui_task_runner->PostTask(fml::MakeCopyable(
+      [callback = std::move(callback), image = std::move(image), duration,
+       trace_id, request_time,
+       weak_state = weak_from_this()]() mutable {
+        // The codec may have been disposed while the frame was decoded.
+        auto state = weak_state.lock();
+        if (state && state->disposed_) {
+          image = nullptr;
+        }
+        InvokeNextFrameCallback(std::move(image), duration,
+                                std::move(callback), trace_id, request_time);
+      }));
 }
 
 Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   static size_t trace_counter = 1;
   const size_t trace_id = trace_counter++;
+  const fml::TimePoint request_time = fml::TimePoint::Now();
 
   if (!Dart_IsClosure(callback_handle)) {
     return tonic::ToDart("Callback must be a function");
@@ -177,10 +169,11 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   if (state_->frameCount_ == 0) {
     FML_LOG(ERROR) << "Could not provide any frame.";
     task_runners.GetUITaskRunner()->PostTask(fml::MakeCopyable(
-        [trace_id,
+        [trace_id, request_time,
          callback = std::make_unique<DartPersistentValue>(
              tonic::DartState::Current(), callback_handle)]() mutable {
-          InvokeNextFrameCallback(nullptr, 0, std::move(callback), trace_id);
+          InvokeNextFrameCallback(nullptr, 0, std::move(callback), trace_id,
+                                  request_time);
         }));
     return Dart_Null();
   }
@@ -189,7 +182,8 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
       [callback = std::make_unique<DartPersistentValue>(
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
-       ui_task_runner = task_runners.GetUITaskRunner(),
+       request_time, ui_task_runner = task_runners.GetUITaskRunner(),
+       scheduler = GetDecodeScheduler(dart_state),
        io_manager = dart_state->GetIOManager()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
@@ -199,13 +193,27 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
         }
         state->GetNextFrameAndInvokeCallback(
             std::move(callback), std::move(ui_task_runner),
+            std::move(scheduler),
             io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
-            trace_id);
+            trace_id, request_time);
       }));
 
   return Dart_Null();
 }
 
+void MultiFrameCodec::setDecodePriority(int priority) {
+  if (priority < 0 ||
+      priority >= static_cast<int>(ImageDecodeScheduler::kPriorityCount)) {
+    return;
+  }
+  state_->priority_ = static_cast<ImageDecodeScheduler::Priority>(priority);
+}
+
+void MultiFrameCodec::dispose() {
+  state_->disposed_ = true;
+  Codec::dispose();
+}
+
 int MultiFrameCodec::frameCount() const {
   return state_->frameCount_;
 }
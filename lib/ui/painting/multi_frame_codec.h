@@ -5,14 +5,32 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 
+#include <atomic>
+#include <memory>
+
 #include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
 #include "flutter/lib/ui/painting/codec.h"
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
 #include "flutter/lib/ui/painting/image_generator.h"
 
 namespace flutter {
 
 class MultiFrameCodec : public Codec {
  public:
+  // The latency of the frames delivered by all the multi-frame codecs in the
+  // process, from the call to |getNextFrame| to the invocation of its
+  // callback.
+  struct Stats {
+    size_t frames = 0;
+    fml::TimeDelta total_latency;
+    fml::TimeDelta max_latency;
+  };
+
+  static Stats GetStats();
+
   MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
 
   ~MultiFrameCodec() override;
@@ -26,6 +44,12 @@ class MultiFrameCodec : public Codec {
   // |Codec|
   Dart_Handle getNextFrame(Dart_Handle args) override;
 
+  // |Codec|
+  void setDecodePriority(int priority) override;
+
+  // |Codec|
+  void dispose() override;
+
  private:
   // Captures the state shared between the IO and UI task runners.
   //
@@ -36,32 +60,39 @@ class MultiFrameCodec : public Codec {
   // Instead, the MultiFrameCodec creates this object when it is constructed,
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
-  struct State {
+  struct State : public std::enable_shared_from_this<State> {
     State(std::shared_ptr<ImageGenerator> generator);
 
     const std::shared_ptr<ImageGenerator> generator_;
     const int frameCount_;
     const int repetitionCount_;
+    // Decodes the frames, possibly ahead of time on the worker pool.
+    const std::shared_ptr<AnimatedFrameDecoder> decoder_;
+    // Set on the UI thread. Frames are not decoded ahead for background
+    // codecs, which are not expected to be displayed soon.
+    std::atomic<ImageDecodeScheduler::Priority> priority_;
+    // Set on the UI thread when the codec is disposed. The frames that were
+    // requested but not delivered yet are then delivered without an image.
+    std::atomic<bool> disposed_;
 
     // The non-const members and functions below here are only read or written
     // to on the IO thread. They are not safe to access or write on the UI
     // thread.
     int nextFrameIndex_;
-    // The last decoded frame that's required to decode any subsequent frames.
-    std::unique_ptr<SkBitmap> lastRequiredFrame_;
-
-    // The index of the last decoded required frame.
-    int lastRequiredFrameIndex_ = -1;
 
-    sk_sp<SkImage> GetNextFrameImage(
+    // Uploads a decoded frame to the GPU if there is a resource context.
+    sk_sp<SkImage> UploadFrameImage(
+        sk_sp<SkImage> frame,
         fml::WeakPtr<GrDirectContext> resourceContext);
 
     void GetNextFrameAndInvokeCallback(
         std::unique_ptr<DartPersistentValue> callback,
         fml::RefPtr<fml::TaskRunner> ui_task_runner,
+        std::shared_ptr<ImageDecodeScheduler> scheduler,
         fml::WeakPtr<GrDirectContext> resourceContext,
         fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
-        size_t trace_id);
+        size_t trace_id,
+        fml::TimePoint request_time);
   };
 
   // Shared across the UI and IO task runners.
@@ -0,0 +1,406 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/parallel_jpeg_image_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/row_bands.h"
+#include "third_party/skia/include/codec/SkEncodedOrigin.h"
+
+namespace flutter {
+
+namespace {
+
+// JPEG markers, from ITU T.81 table B.1.
+constexpr uint8_t kMarkerPrefix = 0xFF;
+constexpr uint8_t kStartOfImage = 0xD8;
+constexpr uint8_t kEndOfImage = 0xD9;
+constexpr uint8_t kStartOfScan = 0xDA;
+constexpr uint8_t kDefineRestartInterval = 0xDD;
+constexpr uint8_t kFirstRestart = 0xD0;
+constexpr uint8_t kLastRestart = 0xD7;
+constexpr uint8_t kStuffedZero = 0x00;
+constexpr uint8_t kBaselineFrame = 0xC0;
+constexpr uint8_t kExtendedSequentialFrame = 0xC1;
+constexpr uint8_t kDefineHuffmanTables = 0xC4;
+constexpr uint8_t kReservedForExtensions = 0xC8;
+constexpr uint8_t kDefineArithmeticConditioning = 0xCC;
+
+// Restart markers are numbered modulo 8.
+constexpr int kRestartMarkerCount = 8;
+
+// Without restart markers, each band entropy decodes all the rows above it,
+// so the work grows quadratically with the number of bands. Two bands bound
+// the extra work to half of the entropy decoding of the image.
+constexpr int kMaxSkippingBands = 2;
+
+bool IsStartOfFrame(uint8_t marker) {
+  return marker >= 0xC0 && marker <= 0xCF && marker != kDefineHuffmanTables &&
+         marker != kReservedForExtensions &&
+         marker != kDefineArithmeticConditioning;
+}
+
+int ReadUint16(const uint8_t* bytes) {
+  return (bytes[0] << 8) | bytes[1];
+}
+
+}  // namespace
+
+struct ParallelJpegImageGenerator::RestartIntervals {
+  // The offset of the image height in the frame header.
+  size_t height_offset = 0;
+  // The offset of the first byte of entropy-coded data, after the headers.
+  size_t scan_offset = 0;
+  // The offset of the marker that ends the entropy-coded data.
+  size_t scan_end = 0;
+  // The offset of each restart marker, in order.
+  std::vector<size_t> markers;
+  int image_height = 0;
+  // The height in pixels of a row of MCUs.
+  int mcu_height = 0;
+  int mcus_per_row = 0;
+  int mcu_row_count = 0;
+  // The number of MCUs in each restart interval.
+  int restart_interval = 0;
+};
+
+ParallelJpegImageGenerator::ParallelJpegImageGenerator(
+    std::unique_ptr<SkCodec> codec,
+    sk_sp<SkData> data,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner)
+    : BuiltinSkiaCodecImageGenerator(std::move(codec)),
+      data_(std::move(data)),
+      concurrent_task_runner_(std::move(concurrent_task_runner)),
+      restart_intervals_(FindRestartIntervals(*data_)) {}
+
+ParallelJpegImageGenerator::~ParallelJpegImageGenerator() = default;
+
+bool ParallelJpegImageGenerator::GetPixels(
+    const SkImageInfo& info,
+    void* pixels,
+    size_t row_bytes,
+    unsigned int frame_index,
+    std::optional<unsigned int> prior_frame) {
+  if (frame_index == 0 &&
+      (restart_intervals_ ? DecodeRestartIntervals(info, pixels, row_bytes)
+                          : DecodeSkippingRows(info, pixels, row_bytes))) {
+    return true;
+  }
+
+  // Images decoded as a single band, and incomplete images, are decoded by
+  // Skia's codec, which fills in the rows that are missing.
+  return BuiltinSkiaCodecImageGenerator::GetPixels(info, pixels, row_bytes,
+                                                   frame_index, prior_frame);
+}
+
+bool ParallelJpegImageGenerator::DecodeRestartIntervals(
+    const SkImageInfo& info,
+    void* pixels,
+    size_t row_bytes) const {
+  const RestartIntervals& intervals = *restart_intervals_;
+  const SkISize source_size = GetInfo().dimensions();
+  // Skia's codec scales JPEG images by |scale|/8 in the DCT domain, which
+  // scales the rows of MCUs to a whole number of rows.
+  int scale = 0;
+  for (int n = 1; n <= 8 && scale == 0; n++) {
+    if ((source_size.width() * n + 7) / 8 == info.width() &&
+        (source_size.height() * n + 7) / 8 == info.height()) {
+      scale = n;
+    }
+  }
+  if (scale == 0) {
+    return false;
+  }
+  const int mcu_rows = intervals.mcu_height * scale / 8;
+
+  // The bands start at rows of MCUs that start a restart interval.
+  const int aligned_mcu_rows =
+      intervals.restart_interval /
+      std::gcd(intervals.restart_interval, intervals.mcus_per_row);
+  const RowBands bands(
+      info.height(),
+      static_cast<int64_t>(source_size.width()) * source_size.height(),
+      concurrent_task_runner_, aligned_mcu_rows * mcu_rows);
+  if (bands.GetCount() == 1) {
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "ParallelJpegImageGenerator::DecodeRestartIntervals");
+  std::atomic<bool> success = true;
+  bands.Process([&](int band) {
+    TRACE_EVENT0("flutter", "ParallelJpegImageGenerator::DecodeBand");
+    const int top = bands.GetTop(band);
+    const int bottom = bands.GetBottom(band);
+    const int bottom_mcu_row = bottom == info.height()
+                                   ? intervals.mcu_row_count
+                                   : bottom / mcu_rows;
+    auto codec = SkCodec::MakeFromData(
+        MakeRestartIntervalsData(top / mcu_rows, bottom_mcu_row));
+    auto* rows = static_cast<uint8_t*>(pixels) + top * row_bytes;
+    if (!codec ||
+        codec->getPixels(info.makeWH(info.width(), bottom - top), rows,
+                         row_bytes) != SkCodec::kSuccess) {
+      success = false;
+    }
+  });
+  return success;
+}
+
+sk_sp<SkData> ParallelJpegImageGenerator::MakeRestartIntervalsData(
+    int top,
+    int bottom) const {
+  const RestartIntervals& intervals = *restart_intervals_;
+  const int64_t last_interval = intervals.markers.size();
+  const int64_t first_interval = static_cast<int64_t>(top) *
+                                 intervals.mcus_per_row /
+                                 intervals.restart_interval;
+  const int64_t end_interval = bottom == intervals.mcu_row_count
+                                   ? last_interval + 1
+                                   : static_cast<int64_t>(bottom) *
+                                         intervals.mcus_per_row /
+                                         intervals.restart_interval;
+  // Each restart marker ends the interval of the same index.
+  const size_t scan_begin = first_interval == 0
+                                ? intervals.scan_offset
+                                : intervals.markers[first_interval - 1] + 2;
+  const size_t scan_end = end_interval > last_interval
+                              ? intervals.scan_end
+                              : intervals.markers[end_interval - 1];
+  const int height =
+      std::min(bottom * intervals.mcu_height, intervals.image_height) -
+      top * intervals.mcu_height;
+
+  // The headers of the image, with the height of the band, followed by the
+  // entropy-coded data of the band.
+  const size_t size = intervals.scan_offset + (scan_end - scan_begin) + 2;
+  sk_sp<SkData> band = SkData::MakeUninitialized(size);
+  auto* bytes = static_cast<uint8_t*>(band->writable_data());
+  std::memcpy(bytes, data_->bytes(), intervals.scan_offset);
+  bytes[intervals.height_offset] = height >> 8;
+  bytes[intervals.height_offset + 1] = height & 0xFF;
+  uint8_t* scan = bytes + intervals.scan_offset;
+  std::memcpy(scan, data_->bytes() + scan_begin, scan_end - scan_begin);
+  // The restart markers of the band are numbered from the start of the band.
+  for (int64_t i = first_interval; i + 1 < end_interval; i++) {
+    scan[intervals.markers[i] - scan_begin + 1] =
+        kFirstRestart + (i - first_interval) % kRestartMarkerCount;
+  }
+  bytes[size - 2] = kMarkerPrefix;
+  bytes[size - 1] = kEndOfImage;
+  return band;
+}
+
+bool ParallelJpegImageGenerator::DecodeSkippingRows(const SkImageInfo& info,
+                                                    void* pixels,
+                                                    size_t row_bytes) const {
+  const SkImageInfo& source_info = GetInfo();
+  const RowBands bands(
+      info.height(),
+      static_cast<int64_t>(source_info.width()) * source_info.height(),
+      concurrent_task_runner_, 1, kMaxSkippingBands);
+  if (bands.GetCount() == 1) {
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "ParallelJpegImageGenerator::DecodeSkippingRows");
+  std::atomic<bool> success = true;
+  bands.Process([&](int band) {
+    if (!DecodeRows(info, pixels, row_bytes, bands.GetTop(band),
+                    bands.GetBottom(band))) {
+      success = false;
+    }
+  });
+  return success;
+}
+
+bool ParallelJpegImageGenerator::DecodeRows(const SkImageInfo& info,
+                                            void* pixels,
+                                            size_t row_bytes,
+                                            int top,
+                                            int bottom) const {
+  TRACE_EVENT0("flutter", "ParallelJpegImageGenerator::DecodeRows");
+  auto codec = SkCodec::MakeFromData(data_);
+  if (!codec || codec->startScanlineDecode(info) != SkCodec::kSuccess ||
+      codec->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder ||
+      !codec->skipScanlines(top)) {
+    return false;
+  }
+  auto* rows = static_cast<uint8_t*>(pixels) + top * row_bytes;
+  return codec->getScanlines(rows, bottom - top, row_bytes) == bottom - top;
+}
+
+std::unique_ptr<ImageGenerator> ParallelJpegImageGenerator::MakeFromData(
+    sk_sp<SkData> data,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner) {
+  if (!data || !IsSequentialJpeg(*data)) {
+    return nullptr;
+  }
+  auto codec = SkCodec::MakeFromData(data);
+  if (!codec || codec->getEncodedFormat() != SkEncodedImageFormat::kJPEG ||
+      codec->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return nullptr;
+  }
+  return std::make_unique<ParallelJpegImageGenerator>(
+      std::move(codec), std::move(data), std::move(concurrent_task_runner));
+}
+
+std::unique_ptr<const ParallelJpegImageGenerator::RestartIntervals>
+ParallelJpegImageGenerator::FindRestartIntervals(const SkData& data) {
+  const auto* bytes = data.bytes();
+  const size_t size = data.size();
+  auto intervals = std::make_unique<RestartIntervals>();
+
+  // Read the frame header, the restart interval and the scan header.
+  int width = 0;
+  int component_count = 0;
+  int max_horizontal_sampling = 1;
+  int max_vertical_sampling = 1;
+  size_t offset = 2;
+  while (true) {
+    if (offset + 3 >= size || bytes[offset] != kMarkerPrefix) {
+      return nullptr;
+    }
+    const uint8_t marker = bytes[offset + 1];
+    if (marker == kMarkerPrefix) {
+      offset++;
+      continue;
+    }
+    const size_t length = ReadUint16(bytes + offset + 2);
+    if (offset + 2 + length > size) {
+      return nullptr;
+    }
+    if (IsStartOfFrame(marker)) {
+      if (length < 8) {
+        return nullptr;
+      }
+      intervals->height_offset = offset + 5;
+      intervals->image_height = ReadUint16(bytes + offset + 5);
+      width = ReadUint16(bytes + offset + 7);
+      component_count = bytes[offset + 9];
+      if (length < 8 + 3 * static_cast<size_t>(component_count)) {
+        return nullptr;
+      }
+      for (int i = 0; i < component_count; i++) {
+        const uint8_t sampling = bytes[offset + 11 + 3 * i];
+        max_horizontal_sampling =
+            std::max(max_horizontal_sampling, sampling >> 4);
+        max_vertical_sampling = std::max(max_vertical_sampling, sampling & 0xF);
+      }
+    } else if (marker == kDefineRestartInterval) {
+      if (length != 4) {
+        return nullptr;
+      }
+      intervals->restart_interval = ReadUint16(bytes + offset + 4);
+    } else if (marker == kStartOfScan) {
+      // Images with several scans, whose scans each hold some of the
+      // components, cannot be split.
+      if (length < 3 || bytes[offset + 4] != component_count) {
+        return nullptr;
+      }
+      intervals->scan_offset = offset + 2 + length;
+      break;
+    } else if (marker == kEndOfImage) {
+      return nullptr;
+    }
+    offset += 2 + length;
+  }
+  // Images whose height is only defined after the scan cannot be split.
+  if (intervals->restart_interval == 0 || intervals->image_height == 0 ||
+      width == 0) {
+    return nullptr;
+  }
+  // The MCUs of a scan with a single component are single blocks.
+  if (component_count == 1) {
+    max_horizontal_sampling = 1;
+    max_vertical_sampling = 1;
+  }
+  const int mcu_width = 8 * max_horizontal_sampling;
+  intervals->mcu_height = 8 * max_vertical_sampling;
+  intervals->mcus_per_row = (width + mcu_width - 1) / mcu_width;
+  intervals->mcu_row_count =
+      (intervals->image_height + intervals->mcu_height - 1) /
+      intervals->mcu_height;
+
+  // Find the restart markers in the entropy-coded data, where the other
+  // 0xFF bytes are followed by a zero byte.
+  offset = intervals->scan_offset;
+  while (true) {
+    const auto* prefix = static_cast<const uint8_t*>(
+        std::memchr(bytes + offset, kMarkerPrefix, size - offset));
+    if (!prefix || prefix + 1 >= bytes + size) {
+      return nullptr;
+    }
+    offset = prefix - bytes;
+    const uint8_t marker = bytes[offset + 1];
+    if (marker == kStuffedZero) {
+      offset += 2;
+    } else if (marker == kMarkerPrefix) {
+      offset++;
+    } else if (marker >= kFirstRestart && marker <= kLastRestart) {
+      if (marker != kFirstRestart + intervals->markers.size() %
+                                        kRestartMarkerCount) {
+        return nullptr;
+      }
+      intervals->markers.push_back(offset);
+      offset += 2;
+    } else if (marker == kEndOfImage) {
+      intervals->scan_end = offset;
+      break;
+    } else {
+      return nullptr;
+    }
+  }
+
+  // Truncated or corrupt images are left to Skia's codec.
+  const int64_t mcu_count =
+      static_cast<int64_t>(intervals->mcus_per_row) * intervals->mcu_row_count;
+  const int64_t interval_count =
+      (mcu_count + intervals->restart_interval - 1) /
+      intervals->restart_interval;
+  if (static_cast<int64_t>(intervals->markers.size()) != interval_count - 1) {
+    return nullptr;
+  }
+  return intervals;
+}
+
+bool ParallelJpegImageGenerator::IsSequentialJpeg(const SkData& data) {
+  const auto* bytes = data.bytes();
+  const size_t size = data.size();
+  if (size < 2 || bytes[0] != kMarkerPrefix || bytes[1] != kStartOfImage) {
+    return false;
+  }
+
+  // Walk the marker segments that precede the frame header.
+  size_t offset = 2;
+  while (offset + 1 < size) {
+    if (bytes[offset] != kMarkerPrefix) {
+      return false;
+    }
+    const uint8_t marker = bytes[offset + 1];
+    if (marker == kMarkerPrefix) {
+      // Markers may be preceded by any number of fill bytes.
+      offset++;
+      continue;
+    }
+    if (IsStartOfFrame(marker)) {
+      return marker == kBaselineFrame || marker == kExtendedSequentialFrame;
+    }
+    if (marker == kStartOfScan || marker == kEndOfImage ||
+        offset + 3 >= size) {
+      return false;
+    }
+    // The segment length includes its own two bytes, but not the marker.
+    offset += 2 + ((bytes[offset + 2] << 8) | bytes[offset + 3]);
+  }
+  return false;
+}
+
+}  // namespace flutter
@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PARALLEL_JPEG_IMAGE_GENERATOR_H_
+#define FLUTTER_LIB_UI_PAINTING_PARALLEL_JPEG_IMAGE_GENERATOR_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_generator.h"
+
+namespace flutter {
+
+/// @brief  An image generator for baseline JPEG images that decodes large
+///         images in parallel bands of rows, each with its own instance of
+///         Skia's JPEG codec.
+///
+///         Images with restart markers are split at the markers that start
+///         rows of MCUs, and each band decodes only its own part of the
+///         entropy-coded data. Without restart markers, each band skips the
+///         rows above it, which costs their entropy decoding, and then decodes
+///         its own rows. Since the skipped rows grow with the number of bands,
+///         those images are split into at most two bands. Either way, the
+///         inverse DCT, upsampling and color conversion of the image are split
+///         across the workers of a concurrent task runner. Decodes at the
+///         sizes returned by `GetScaledDimensions` are scaled in the DCT
+///         domain, as with `BuiltinSkiaCodecImageGenerator`.
+///
+///         Progressive JPEG images cannot skip rows cheaply, and are left to
+///         the other generators.
+class ParallelJpegImageGenerator : public BuiltinSkiaCodecImageGenerator {
+ public:
+  ~ParallelJpegImageGenerator();
+
+  ParallelJpegImageGenerator(
+      std::unique_ptr<SkCodec> codec,
+      sk_sp<SkData> data,
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner);
+
+  // |ImageGenerator|
+  bool GetPixels(
+      const SkImageInfo& info,
+      void* pixels,
+      size_t row_bytes,
+      unsigned int frame_index = 0,
+      std::optional<unsigned int> prior_frame = std::nullopt) override;
+
+  /// @brief      Creates a generator for baseline JPEG images that are stored
+  ///             in their display orientation.
+  /// @param[in]  data                    The encoded image data.
+  /// @param[in]  concurrent_task_runner  Runs the decodes of the bands other
+  ///                                     than the first.
+  /// @return     A generator for the image, or null if the image is not a
+  ///             baseline JPEG image in its display orientation.
+  static std::unique_ptr<ImageGenerator> MakeFromData(
+      sk_sp<SkData> data,
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner);
+
+  /// @brief      Returns whether |data| starts with the header of a JPEG
+  ///             image whose frame is encoded sequentially (baseline or
+  ///             extended sequential with Huffman coding), as opposed to
+  ///             progressively or losslessly.
+  static bool IsSequentialJpeg(const SkData& data);
+
+ private:
+  // The layout of the entropy-coded data of an image with restart markers.
+  struct RestartIntervals;
+
+  const sk_sp<SkData> data_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  const std::unique_ptr<const RestartIntervals> restart_intervals_;
+
+  // Returns the layout of the restart intervals of a sequential JPEG image
+  // with a single scan, or null if the image has no restart markers.
+  static std::unique_ptr<const RestartIntervals> FindRestartIntervals(
+      const SkData& data);
+
+  // Decodes the image in bands split at its restart markers. Returns false if
+  // the image is decoded as a single band, or if a band cannot be decoded.
+  bool DecodeRestartIntervals(const SkImageInfo& info,
+                              void* pixels,
+                              size_t row_bytes) const;
+
+  // Returns an image made of the rows of MCUs [|top|, |bottom|) of the image,
+  // which must start at restart markers.
+  sk_sp<SkData> MakeRestartIntervalsData(int top, int bottom) const;
+
+  // Decodes the image in bands that skip the rows above them. Returns false if
+  // the image is decoded as a single band, or if a band cannot be decoded.
+  bool DecodeSkippingRows(const SkImageInfo& info,
+                          void* pixels,
+                          size_t row_bytes) const;
+
+  // Decodes the rows [|top|, |bottom|) of the image with a new codec.
+  bool DecodeRows(const SkImageInfo& info,
+                  void* pixels,
+                  size_t row_bytes,
+                  int top,
+                  int bottom) const;
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(ParallelJpegImageGenerator);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PARALLEL_JPEG_IMAGE_GENERATOR_H_
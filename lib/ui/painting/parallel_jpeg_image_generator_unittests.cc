@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/parallel_jpeg_image_generator.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+#include "third_party/skia/include/encode/SkJpegEncoder.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+sk_sp<SkData> OpenFixtureAsSkData(const char* name) {
+  auto mapping = OpenFixtureAsMapping(name);
+  FML_CHECK(mapping);
+  return SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+}
+
+sk_sp<SkData> MakeData(std::initializer_list<uint8_t> bytes) {
+  return SkData::MakeWithCopy(std::data(bytes), bytes.size());
+}
+
+SkBitmap Decode(ImageGenerator& generator, SkISize dimensions) {
+  SkBitmap bitmap;
+  FML_CHECK(bitmap.tryAllocPixels(
+      generator.GetInfo().makeDimensions(dimensions)));
+  FML_CHECK(generator.GetPixels(bitmap.info(), bitmap.getPixels(),
+                                bitmap.rowBytes()));
+  return bitmap;
+}
+
+bool HaveSamePixels(const SkBitmap& a, const SkBitmap& b) {
+  return a.dimensions() == b.dimensions() &&
+         std::memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()) == 0;
+}
+
+}  // namespace
+
+TEST(ParallelJpegImageGeneratorTest, OnlyAcceptsSequentialJpegImages) {
+  ASSERT_TRUE(ParallelJpegImageGenerator::IsSequentialJpeg(
+      *OpenFixtureAsSkData("DashInNooglerHat.jpg")));
+  ASSERT_FALSE(ParallelJpegImageGenerator::IsSequentialJpeg(
+      *OpenFixtureAsSkData("Horizontal.png")));
+
+  // An application segment and fill bytes before the frame header.
+  ASSERT_TRUE(ParallelJpegImageGenerator::IsSequentialJpeg(*MakeData(
+      {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x04, 0x00, 0x00, 0xFF, 0xFF, 0xC1})));
+  // A progressive frame header.
+  ASSERT_FALSE(ParallelJpegImageGenerator::IsSequentialJpeg(
+      *MakeData({0xFF, 0xD8, 0xFF, 0xC4, 0x00, 0x02, 0xFF, 0xC2})));
+  // A truncated header.
+  ASSERT_FALSE(ParallelJpegImageGenerator::IsSequentialJpeg(
+      *MakeData({0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10})));
+}
+
+TEST(ParallelJpegImageGeneratorTest, CannotBeCreatedForOtherFormats) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  ASSERT_EQ(ParallelJpegImageGenerator::MakeFromData(
+                OpenFixtureAsSkData("Horizontal.png"), loop->GetTaskRunner()),
+            nullptr);
+}
+
+TEST(ParallelJpegImageGeneratorTest, DecodesLikeSkiaCodec) {
+  auto data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto generator =
+      ParallelJpegImageGenerator::MakeFromData(data, loop->GetTaskRunner());
+  ASSERT_TRUE(generator);
+  auto skia_generator = BuiltinSkiaCodecImageGenerator::MakeFromData(data);
+
+  const SkISize full_size = generator->GetInfo().dimensions();
+  ASSERT_TRUE(HaveSamePixels(Decode(*generator, full_size),
+                             Decode(*skia_generator, full_size)));
+
+  // Scaled in the DCT domain.
+  const SkISize scaled_size = generator->GetScaledDimensions(0.5);
+  ASSERT_LT(scaled_size.width(), full_size.width());
+  ASSERT_TRUE(HaveSamePixels(Decode(*generator, scaled_size),
+                             Decode(*skia_generator, scaled_size)));
+}
+
+TEST(ParallelJpegImageGeneratorTest, DecodesImagesWithoutRestartMarkers) {
+  // Skia's encoder writes no restart markers, so the bands skip rows.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(1024, 1100, /*isOpaque=*/true);
+  for (int y = 0; y < bitmap.height(); y++) {
+    for (int x = 0; x < bitmap.width(); x++) {
+      *bitmap.getAddr32(x, y) =
+          SkPackARGB32(0xFF, x & 0xFF, y & 0xFF, (x ^ y) & 0xFF);
+    }
+  }
+  auto data = SkJpegEncoder::Encode(nullptr, bitmap.pixmap(), {});
+  ASSERT_TRUE(data);
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto generator =
+      ParallelJpegImageGenerator::MakeFromData(data, loop->GetTaskRunner());
+  ASSERT_TRUE(generator);
+  auto skia_generator = BuiltinSkiaCodecImageGenerator::MakeFromData(data);
+
+  const SkISize size = generator->GetInfo().dimensions();
+  ASSERT_TRUE(
+      HaveSamePixels(Decode(*generator, size), Decode(*skia_generator, size)));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -113,9 +113,6 @@ Dart_Handle Picture::RasterizeToImage(
   auto image_callback = std::make_unique<tonic::DartPersistentValue>(
       dart_state, raw_image_callback);
   auto unref_queue = dart_state->GetSkiaUnrefQueue();
-  auto ui_task_runner = dart_state->GetTaskRunners().GetUITaskRunner();
-  auto raster_task_runner = dart_state->GetTaskRunners().GetRasterTaskRunner();
-  auto snapshot_delegate = dart_state->GetSnapshotDelegate();
 
   // We can't create an image on this task runner because we don't have a
   // graphics context. Even if we did, it would be slow anyway. Also, this
@@ -151,17 +148,11 @@ Dart_Handle Picture::RasterizeToImage(
     image_callback.reset();
   });
 
-  // Kick things off on the raster rask runner.
-  fml::TaskRunner::RunNowOrPostTask(
-      raster_task_runner, [ui_task_runner, snapshot_delegate, draw_callback,
-                           picture_bounds, ui_task] {
-        sk_sp<SkImage> raster_image = snapshot_delegate->MakeRasterSnapshot(
-            draw_callback, picture_bounds);
-
-        fml::TaskRunner::RunNowOrPostTask(
-            ui_task_runner,
-            [ui_task, raster_image]() { ui_task(raster_image); });
-      });
+  // Kick things off on the raster task runner. Snapshots requested while an
+  // earlier one is still waiting for the raster task runner are rasterized in
+  // the same task.
+  dart_state->GetSnapshotBatcher()->RequestSnapshot(
+      std::move(draw_callback), picture_bounds, std::move(ui_task));
 
   return Dart_Null();
 }
@@ -0,0 +1,175 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/qoi_encoder.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/row_bands.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint8_t kOpIndex = 0x00;
+constexpr uint8_t kOpDiff = 0x40;
+constexpr uint8_t kOpLuma = 0x80;
+constexpr uint8_t kOpRun = 0xc0;
+constexpr uint8_t kOpRGB = 0xfe;
+constexpr uint8_t kOpRGBA = 0xff;
+
+constexpr int kMaxRun = 62;
+constexpr size_t kHeaderSize = 14;
+constexpr uint8_t kEndMarker[] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+struct Pixel {
+  uint8_t r = 0;
+  uint8_t g = 0;
+  uint8_t b = 0;
+  uint8_t a = 255;
+
+  bool operator==(const Pixel& other) const {
+    return r == other.r && g == other.g && b == other.b && a == other.a;
+  }
+
+  int GetIndex() const { return (r * 3 + g * 5 + b * 7 + a * 11) % 64; }
+};
+
+Pixel ReadPixel(const uint8_t* bytes) {
+  return {bytes[0], bytes[1], bytes[2], bytes[3]};
+}
+
+void WriteBigEndian(uint8_t* bytes, uint32_t value) {
+  bytes[0] = value >> 24;
+  bytes[1] = value >> 16;
+  bytes[2] = value >> 8;
+  bytes[3] = value;
+}
+
+// Encodes the rows [|top|, |bottom|) of |pixmap| as a sequence of QOI chunks.
+//
+// A decoder enters the band with the state left by the bands above, which the
+// band does not know. The previous pixel is known, since it is the last pixel
+// of the row above, but the index of recently seen pixels is not. The band
+// tracks which entries of the index it has written, and only refers to those,
+// whose values are the same for the decoder.
+std::vector<uint8_t> EncodeBand(const SkPixmap& pixmap, int top, int bottom) {
+  std::vector<uint8_t> chunks;
+  // Most chunks of typical images are a single byte.
+  chunks.reserve(static_cast<size_t>(pixmap.width()) * (bottom - top));
+
+  std::array<Pixel, 64> index;
+  std::array<bool, 64> is_indexed = {};
+  Pixel previous;
+  if (top > 0) {
+    previous = ReadPixel(pixmap.addr8(pixmap.width() - 1, top - 1));
+  }
+  int run = 0;
+
+  // Every chunk sets the index entry of the pixel it decodes to.
+  auto add_to_index = [&index, &is_indexed](const Pixel& pixel) {
+    const int position = pixel.GetIndex();
+    index[position] = pixel;
+    is_indexed[position] = true;
+  };
+  auto flush_run = [&chunks, &run, &previous, &add_to_index]() {
+    if (run > 0) {
+      chunks.push_back(kOpRun | (run - 1));
+      add_to_index(previous);
+      run = 0;
+    }
+  };
+
+  for (int y = top; y < bottom; y++) {
+    const uint8_t* row = pixmap.addr8(0, y);
+    for (int x = 0; x < pixmap.width(); x++, row += 4) {
+      const Pixel pixel = ReadPixel(row);
+      if (pixel == previous) {
+        if (++run == kMaxRun) {
+          flush_run();
+        }
+        continue;
+      }
+      flush_run();
+
+      const int position = pixel.GetIndex();
+      if (is_indexed[position] && index[position] == pixel) {
+        chunks.push_back(kOpIndex | position);
+      } else if (pixel.a == previous.a) {
+        const int8_t dr = pixel.r - previous.r;
+        const int8_t dg = pixel.g - previous.g;
+        const int8_t db = pixel.b - previous.b;
+        const int8_t dr_dg = dr - dg;
+        const int8_t db_dg = db - dg;
+        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 &&
+            db <= 1) {
+          chunks.push_back(kOpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+        } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 &&
+                   db_dg >= -8 && db_dg <= 7) {
+          chunks.push_back(kOpLuma | (dg + 32));
+          chunks.push_back((dr_dg + 8) << 4 | (db_dg + 8));
+        } else {
+          chunks.insert(chunks.end(), {kOpRGB, pixel.r, pixel.g, pixel.b});
+        }
+      } else {
+        chunks.insert(chunks.end(),
+                      {kOpRGBA, pixel.r, pixel.g, pixel.b, pixel.a});
+      }
+      add_to_index(pixel);
+      previous = pixel;
+    }
+  }
+  // Runs do not continue into the next band.
+  flush_run();
+  return chunks;
+}
+
+}  // namespace
+
+sk_sp<SkData> QoiEncoder::Encode(
+    const SkPixmap& pixmap,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& runner) {
+  TRACE_EVENT0("flutter", "QoiEncoder::Encode");
+  if (pixmap.colorType() != kRGBA_8888_SkColorType ||
+      pixmap.alphaType() == kPremul_SkAlphaType ||
+      pixmap.dimensions().isEmpty()) {
+    return nullptr;
+  }
+
+  const RowBands bands(pixmap.height(),
+                       static_cast<int64_t>(pixmap.width()) * pixmap.height(),
+                       runner);
+  std::vector<std::vector<uint8_t>> chunks(bands.GetCount());
+  bands.Process([&pixmap, &bands, &chunks](int band) {
+    TRACE_EVENT0("flutter", "QoiEncoder::EncodeBand");
+    chunks[band] =
+        EncodeBand(pixmap, bands.GetTop(band), bands.GetBottom(band));
+  });
+
+  size_t size = kHeaderSize + sizeof(kEndMarker);
+  for (const auto& band_chunks : chunks) {
+    size += band_chunks.size();
+  }
+  sk_sp<SkData> data = SkData::MakeUninitialized(size);
+  auto* bytes = static_cast<uint8_t*>(data->writable_data());
+
+  std::memcpy(bytes, "qoif", 4);
+  WriteBigEndian(bytes + 4, pixmap.width());
+  WriteBigEndian(bytes + 8, pixmap.height());
+  // 4 channels, in sRGB with linear alpha.
+  bytes[12] = 4;
+  bytes[13] = 0;
+  bytes += kHeaderSize;
+  for (const auto& band_chunks : chunks) {
+    std::memcpy(bytes, band_chunks.data(), band_chunks.size());
+    bytes += band_chunks.size();
+  }
+  std::memcpy(bytes, kEndMarker, sizeof(kEndMarker));
+  return data;
+}
+
+}  // namespace flutter
@@ -0,0 +1,35 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_QOI_ENCODER_H_
+#define FLUTTER_LIB_UI_PAINTING_QOI_ENCODER_H_
+
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+
+// Encodes images in the QOI format (https://qoiformat.org), a lossless format
+// that compresses runs and small differences between neighboring pixels. It
+// is much faster to encode than PNG, at the cost of larger files.
+//
+// Large images are split into bands of rows that are encoded in parallel. Each
+// band only refers to the pixels it has encoded itself, so the bands can be
+// concatenated into a single stream that any QOI decoder reads.
+class QoiEncoder {
+ public:
+  // Encodes |pixmap|, which must have unpremultiplied 8-bit RGBA pixels, on
+  // the calling thread and on the workers of |runner| if there is one.
+  // Returns null if the pixmap cannot be encoded.
+  static sk_sp<SkData> Encode(
+      const SkPixmap& pixmap,
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& runner);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_QOI_ENCODER_H_
@@ -0,0 +1,171 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/qoi_encoder.h"
+
+#include <cstring>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+SkBitmap CreateBitmap(int width, int height) {
+  SkBitmap bitmap;
+  FML_CHECK(bitmap.tryAllocPixels(SkImageInfo::Make(
+      width, height, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType)));
+  return bitmap;
+}
+
+// Fills |bitmap| with runs, gradients and noise, which exercise all the QOI
+// chunks.
+void FillPattern(const SkBitmap& bitmap) {
+  uint32_t seed = 1;
+  for (int y = 0; y < bitmap.height(); y++) {
+    auto* pixel = static_cast<uint8_t*>(bitmap.getAddr(0, y));
+    for (int x = 0; x < bitmap.width(); x++, pixel += 4) {
+      seed = seed * 1103515245 + 12345;
+      const int noise = (seed >> 16) % 8;
+      if ((x / 37 + y / 11) % 3 == 0) {
+        pixel[0] = 10;
+        pixel[1] = 20;
+        pixel[2] = 30;
+        pixel[3] = 255;
+        continue;
+      }
+      pixel[0] = x * 2 + noise;
+      pixel[1] = y + (noise > 3 ? 40 : 0);
+      pixel[2] = (x ^ y) & (noise > 5 ? 0xff : 0x3);
+      pixel[3] = noise == 7 ? seed >> 8 : 255;
+    }
+  }
+}
+
+uint32_t ReadBigEndian(const uint8_t* bytes) {
+  return bytes[0] << 24 | bytes[1] << 16 | bytes[2] << 8 | bytes[3];
+}
+
+// Decodes |data| following the reference decoder of the QOI specification.
+std::vector<uint8_t> Decode(const sk_sp<SkData>& data, SkISize* dimensions) {
+  const auto* bytes = data->bytes();
+  *dimensions =
+      SkISize::Make(ReadBigEndian(bytes + 4), ReadBigEndian(bytes + 8));
+  std::vector<uint8_t> pixels(dimensions->area() * 4);
+  uint8_t index[64][4] = {};
+  uint8_t pixel[4] = {0, 0, 0, 255};
+  int run = 0;
+  size_t position = 14;
+  const size_t end = data->size() - 8;
+  for (size_t offset = 0; offset < pixels.size(); offset += 4) {
+    if (run > 0) {
+      run--;
+    } else if (position < end) {
+      const uint8_t chunk = bytes[position++];
+      if (chunk == 0xfe) {
+        std::memcpy(pixel, bytes + position, 3);
+        position += 3;
+      } else if (chunk == 0xff) {
+        std::memcpy(pixel, bytes + position, 4);
+        position += 4;
+      } else if ((chunk & 0xc0) == 0x00) {
+        std::memcpy(pixel, index[chunk], 4);
+      } else if ((chunk & 0xc0) == 0x40) {
+        pixel[0] += ((chunk >> 4) & 0x03) - 2;
+        pixel[1] += ((chunk >> 2) & 0x03) - 2;
+        pixel[2] += (chunk & 0x03) - 2;
+      } else if ((chunk & 0xc0) == 0x80) {
+        const uint8_t next = bytes[position++];
+        const int dg = (chunk & 0x3f) - 32;
+        pixel[0] += dg - 8 + ((next >> 4) & 0x0f);
+        pixel[1] += dg;
+        pixel[2] += dg - 8 + (next & 0x0f);
+      } else {
+        run = chunk & 0x3f;
+      }
+      const int hash =
+          (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+      std::memcpy(index[hash], pixel, 4);
+    }
+    std::memcpy(&pixels[offset], pixel, 4);
+  }
+  EXPECT_EQ(position, end);
+  return pixels;
+}
+
+bool HasPixels(const SkBitmap& bitmap, const std::vector<uint8_t>& pixels) {
+  return bitmap.computeByteSize() == pixels.size() &&
+         std::memcmp(bitmap.getPixels(), pixels.data(), pixels.size()) == 0;
+}
+
+}  // namespace
+
+TEST(QoiEncoderTest, EncodesRunsAndDifferences) {
+  auto bitmap = CreateBitmap(4, 1);
+  const uint8_t pixels[] = {
+      0, 0, 0, 255,    // The initial pixel of the decoder.
+      0, 0, 0, 255,    //
+      1, 1, 1, 255,    //
+      200, 0, 0, 128,  //
+  };
+  std::memcpy(bitmap.getPixels(), pixels, sizeof(pixels));
+
+  auto data = QoiEncoder::Encode(bitmap.pixmap(), nullptr);
+
+  ASSERT_TRUE(data);
+  const uint8_t expected[] = {
+      'q', 'o', 'i', 'f', 0, 0, 0, 4, 0, 0, 0, 1, 4, 0,
+      // A run of 2 pixels equal to the initial pixel.
+      0xc1,
+      // A difference of 1 in every channel.
+      0x7f,
+      // A new alpha.
+      0xff, 200, 0, 0, 128,
+      // The end marker.
+      0, 0, 0, 0, 0, 0, 0, 1};
+  ASSERT_EQ(data->size(), sizeof(expected));
+  ASSERT_EQ(std::memcmp(data->data(), expected, sizeof(expected)), 0);
+}
+
+TEST(QoiEncoderTest, RoundTripsPixels) {
+  auto bitmap = CreateBitmap(301, 203);
+  FillPattern(bitmap);
+
+  auto data = QoiEncoder::Encode(bitmap.pixmap(), nullptr);
+
+  ASSERT_TRUE(data);
+  ASSERT_LT(data->size(), bitmap.computeByteSize());
+  SkISize dimensions;
+  auto pixels = Decode(data, &dimensions);
+  ASSERT_EQ(dimensions, bitmap.dimensions());
+  ASSERT_TRUE(HasPixels(bitmap, pixels));
+}
+
+TEST(QoiEncoderTest, BandsEncodedInParallelDecodeAsOneImage) {
+  auto bitmap = CreateBitmap(1500, 1200);
+  FillPattern(bitmap);
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+
+  auto data = QoiEncoder::Encode(bitmap.pixmap(), loop->GetTaskRunner());
+
+  ASSERT_TRUE(data);
+  SkISize dimensions;
+  auto pixels = Decode(data, &dimensions);
+  ASSERT_EQ(dimensions, bitmap.dimensions());
+  ASSERT_TRUE(HasPixels(bitmap, pixels));
+}
+
+TEST(QoiEncoderTest, RejectsPremultipliedPixels) {
+  SkBitmap bitmap;
+  ASSERT_TRUE(bitmap.tryAllocPixels(SkImageInfo::MakeN32Premul(4, 4)));
+  bitmap.eraseColor(SK_ColorRED);
+
+  ASSERT_FALSE(QoiEncoder::Encode(bitmap.pixmap(), nullptr));
+}
+
+}  // namespace testing
+}  // namespace flutter
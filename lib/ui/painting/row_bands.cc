@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/row_bands.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace flutter {
+
+namespace {
+
+// Bands that are each processed by the first thread that claims them. The
+// thread that waits for the bands processes them too, so that the bands are
+// all processed even when no worker is available.
+class BandQueue {
+ public:
+  BandQueue(int count, std::function<void(int)> process)
+      : count_(count), process_(std::move(process)), done_(count) {}
+
+  // Processes bands until none are left to claim.
+  void ProcessBands() {
+    for (int band = next_band_++; band < count_; band = next_band_++) {
+      process_(band);
+      done_.CountDown();
+    }
+  }
+
+  // Waits until all the claimed bands are processed.
+  void Wait() { done_.Wait(); }
+
+ private:
+  const int count_;
+  const std::function<void(int)> process_;
+  std::atomic_int next_band_ = 0;
+  fml::CountDownLatch done_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BandQueue);
+};
+
+}  // namespace
+
+RowBands::RowBands(int row_count,
+                   int64_t pixel_count,
+                   std::shared_ptr<fml::ConcurrentTaskRunner> runner,
+                   int row_alignment,
+                   int max_count)
+    : row_count_(row_count),
+      row_alignment_(row_alignment),
+      runner_(std::move(runner)) {
+  FML_DCHECK(row_alignment_ > 0);
+  if (runner_ && pixel_count >= kMinParallelPixels) {
+    const int band_count = std::max(
+        std::min({row_count / kMinBandRows, GetAlignedRowCount(), max_count,
+                  static_cast<int>(runner_->GetWorkerCount()) + 1}),
+        1);
+    workers_ = std::make_unique<ImageDecodeScheduler::WorkerReservation>(
+        runner_, band_count - 1);
+    count_ = static_cast<int>(workers_->GetCount()) + 1;
+  }
+}
+
+RowBands::~RowBands() = default;
+
+int RowBands::GetTop(int band) const {
+  const int64_t aligned_top =
+      static_cast<int64_t>(GetAlignedRowCount()) * band / count_;
+  return std::min<int64_t>(aligned_top * row_alignment_, row_count_);
+}
+
+int RowBands::GetAlignedRowCount() const {
+  return (row_count_ + row_alignment_ - 1) / row_alignment_;
+}
+
+int RowBands::GetBottom(int band) const {
+  return GetTop(band + 1);
+}
+
+void RowBands::Process(const std::function<void(int band)>& process) const {
+  if (count_ == 1) {
+    process(0);
+    return;
+  }
+  // The workers that start after all the bands are claimed hold on to the
+  // queue, but never call |process|.
+  auto bands = std::make_shared<BandQueue>(count_, process);
+  for (int i = 1; i < count_; i++) {
+    runner_->PostTask([bands]() { bands->ProcessBands(); });
+  }
+  bands->ProcessBands();
+  bands->Wait();
+}
+
+}  // namespace flutter
@@ -0,0 +1,76 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_ROW_BANDS_H_
+#define FLUTTER_LIB_UI_PAINTING_ROW_BANDS_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
+
+namespace flutter {
+
+// Splits the rows of an image into bands that are processed in parallel, on
+// the calling thread and on the workers of a concurrent task runner.
+//
+// The workers are reserved from the |ImageDecodeScheduler| pool of the task
+// runner for the lifetime of the bands, so that they count against the
+// limits of the decodes. There is one band per reserved worker, plus one for
+// the calling thread.
+//
+// Images with fewer than |kMinParallelPixels| pixels, and all images when
+// there is no task runner, are processed as a single band on the calling
+// thread, since splitting them would cost more than it saves.
+class RowBands {
+ public:
+  static constexpr int64_t kMinParallelPixels = 1 << 20;
+
+  // The minimum number of rows in a band.
+  static constexpr int kMinBandRows = 16;
+
+  // Splits |row_count| rows, of an image whose processing touches
+  // |pixel_count| pixels, into at most |max_count| bands whose first rows are
+  // multiples of |row_alignment|.
+  RowBands(int row_count,
+           int64_t pixel_count,
+           std::shared_ptr<fml::ConcurrentTaskRunner> runner,
+           int row_alignment = 1,
+           int max_count = std::numeric_limits<int>::max());
+
+  ~RowBands();
+
+  int GetCount() const { return count_; }
+
+  // The first row of |band|.
+  int GetTop(int band) const;
+
+  // The row after the last row of |band|.
+  int GetBottom(int band) const;
+
+  // Calls |process| once for each band, and returns once all the bands are
+  // processed.
+  void Process(const std::function<void(int band)>& process) const;
+
+ private:
+  const int row_count_;
+  const int row_alignment_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> runner_;
+  std::unique_ptr<ImageDecodeScheduler::WorkerReservation> workers_;
+  int count_ = 1;
+
+  // The number of groups of |row_alignment_| rows, the last one possibly
+  // shorter.
+  int GetAlignedRowCount() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RowBands);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_ROW_BANDS_H_
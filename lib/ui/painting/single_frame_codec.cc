@@ -65,10 +65,13 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   fml::RefPtr<SingleFrameCodec>* raw_codec_ref =
       new fml::RefPtr<SingleFrameCodec>(this);
 
-  decoder->Decode(
-      descriptor_, target_width_, target_height_, [raw_codec_ref](auto image) {
+  decode_id_ = decoder->Decode(
+      descriptor_, target_width_, target_height_,
+      [raw_codec_ref](auto image) {
         std::unique_ptr<fml::RefPtr<SingleFrameCodec>> codec_ref(raw_codec_ref);
         fml::RefPtr<SingleFrameCodec> codec(std::move(*codec_ref));
+        codec->decoder_.reset();
+        codec->decode_id_ = ImageDecodeScheduler::kInvalidJobId;
 
         auto state = codec->pending_callbacks_.front().dart_state().lock();
 
@@ -81,7 +84,8 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
 
         tonic::DartState::Scope scope(state.get());
 
-        if (image.skia_object()) {
+        // The image of a disposed codec is dropped.
+        if (image.skia_object() && !codec->disposed_) {
           auto canvas_image = fml::MakeRefCounted<CanvasImage>();
           canvas_image->set_image(std::move(image));
 
@@ -99,7 +103,9 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
               {tonic::ToDart(codec->cached_image_), tonic::ToDart(0)});
         }
         codec->pending_callbacks_.clear();
-      });
+      },
+      priority_);
+  decoder_ = decoder;
 
   // The encoded data is no longer needed now that it has been handed off
   // to the decoder.
@@ -110,6 +116,27 @@ Dart_Handle SingleFrameCodec::getNextFrame(Dart_Handle callback_handle) {
   return Dart_Null();
 }
 
+void SingleFrameCodec::setDecodePriority(int priority) {
+  if (priority < 0 ||
+      priority >= static_cast<int>(ImageDecodeScheduler::kPriorityCount)) {
+    return;
+  }
+  priority_ = static_cast<ImageDecoder::Priority>(priority);
+  if (decoder_) {
+    decoder_->SetDecodePriority(decode_id_, priority_);
+  }
+}
+
+void SingleFrameCodec::dispose() {
+  // Skip the decode if it has not started yet. The pending callbacks are
+  // still invoked, without an image.
+  disposed_ = true;
+  if (decoder_) {
+    decoder_->CancelDecode(decode_id_);
+  }
+  Codec::dispose();
+}
+
 size_t SingleFrameCodec::GetAllocationSize() const {
   return sizeof(*this);
 }
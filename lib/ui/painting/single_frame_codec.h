@@ -30,16 +30,27 @@ class SingleFrameCodec : public Codec {
   // |Codec|
   Dart_Handle getNextFrame(Dart_Handle args) override;
 
+  // |Codec|
+  void setDecodePriority(int priority) override;
+
+  // |Codec|
+  void dispose() override;
+
   // |DartWrappable|
   size_t GetAllocationSize() const override;
 
  private:
   enum class Status { kNew, kInProgress, kComplete };
   Status status_;
+  bool disposed_ = false;
   fml::RefPtr<ImageDescriptor> descriptor_;
   uint32_t target_width_;
   uint32_t target_height_;
   fml::RefPtr<CanvasImage> cached_image_;
+  ImageDecoder::Priority priority_ = ImageDecoder::Priority::kVisible;
+  // The decoder and the identifier of the decode while it is in progress.
+  fml::WeakPtr<ImageDecoder> decoder_;
+  ImageDecoder::DecodeId decode_id_ = ImageDecodeScheduler::kInvalidJobId;
   std::vector<DartPersistentValue> pending_callbacks_;
 
   FML_FRIEND_MAKE_REF_COUNTED(SingleFrameCodec);
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/snapshot_batcher.h"
+
+#include <utility>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+SnapshotBatcher::SnapshotBatcher(
+    const TaskRunners& task_runners,
+    fml::WeakPtr<SnapshotDelegate> snapshot_delegate)
+    : task_runners_(task_runners),
+      snapshot_delegate_(std::move(snapshot_delegate)) {}
+
+SnapshotBatcher::~SnapshotBatcher() = default;
+
+void SnapshotBatcher::RequestSnapshot(
+    std::function<void(SkCanvas*)> draw_callback,
+    SkISize picture_size,
+    ResultCallback callback) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  bool needs_flush = false;
+  {
+    std::scoped_lock lock(mutex_);
+    pending_requests_.push_back({std::move(draw_callback), picture_size});
+    pending_callbacks_.push_back(std::move(callback));
+    needs_flush = !flush_pending_;
+    flush_pending_ = true;
+  }
+
+  if (!needs_flush) {
+    // The request joins the batch that is already waiting for the raster task
+    // runner.
+    return;
+  }
+
+  // If the flush task is dropped without running, for instance because the
+  // raster task runner is being torn down, the next request must post a flush
+  // of its own instead of joining a batch that never comes.
+  auto on_dropped = std::make_unique<fml::ScopedCleanupClosure>(
+      [weak_batcher = weak_from_this()]() {
+        if (auto batcher = weak_batcher.lock()) {
+          std::scoped_lock lock(batcher->mutex_);
+          batcher->flush_pending_ = false;
+        }
+      });
+
+  // The flush may run right away if the raster and UI task runners are merged,
+  // so it must not be posted while holding the lock.
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners_.GetRasterTaskRunner(),
+      fml::MakeCopyable([batcher = shared_from_this(),
+                         on_dropped = std::move(on_dropped)]() mutable {
+        on_dropped->Release();
+        batcher->Flush();
+      }));
+}
+
+void SnapshotBatcher::Flush() {
+  TRACE_EVENT0("flutter", "SnapshotBatcher::Flush");
+  std::vector<SnapshotDelegate::SnapshotRequest> requests;
+  std::vector<ResultCallback> callbacks;
+  {
+    std::scoped_lock lock(mutex_);
+    requests.swap(pending_requests_);
+    callbacks.swap(pending_callbacks_);
+    flush_pending_ = false;
+  }
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "SnapshotBatcher",
+                    reinterpret_cast<int64_t>(this), "BatchSize",
+                    requests.size());
+#endif  // !FLUTTER_RELEASE
+
+  std::vector<sk_sp<SkImage>> images;
+  if (snapshot_delegate_) {
+    images = snapshot_delegate_->MakeRasterSnapshots(requests);
+  }
+  images.resize(callbacks.size());
+
+  // The callbacks reference objects owned by the isolate and must be invoked
+  // and collected on the UI task runner.
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners_.GetUITaskRunner(),
+      fml::MakeCopyable([callbacks = std::move(callbacks),
+                         images = std::move(images)]() mutable {
+        for (size_t i = 0; i < callbacks.size(); i++) {
+          callbacks[i](std::move(images[i]));
+        }
+        callbacks.clear();
+      }));
+}
+
+}  // namespace flutter
@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_SNAPSHOT_BATCHER_H_
+#define FLUTTER_LIB_UI_PAINTING_SNAPSHOT_BATCHER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/lib/ui/snapshot_delegate.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Coalesces raster snapshot requests made by an isolate (for
+///             instance by `Picture.toImage` and `Scene.toImage`) into batches.
+///
+///             All requests made while a batch is waiting for the raster task
+///             runner are rasterized by a single raster task, and their results
+///             are delivered by a single UI task. Apps that request many
+///             snapshots in a row (like thumbnail generators) pay the fixed
+///             cost of the thread hops once per batch instead of once per
+///             image, and the rasterizer can reuse its render context and
+///             snapshot surfaces across the batch.
+///
+class SnapshotBatcher : public std::enable_shared_from_this<SnapshotBatcher> {
+ public:
+  using ResultCallback = std::function<void(sk_sp<SkImage>)>;
+
+  SnapshotBatcher(const TaskRunners& task_runners,
+                  fml::WeakPtr<SnapshotDelegate> snapshot_delegate);
+
+  ~SnapshotBatcher();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Requests a raster snapshot. Must be called on the UI task
+  ///             runner.
+  ///
+  /// @param[in]  draw_callback  Draws the contents of the snapshot. Invoked on
+  ///                            the raster task runner.
+  /// @param[in]  picture_size   The size of the snapshot.
+  /// @param[in]  callback       Invoked on the UI task runner with the
+  ///                            snapshot, or with null if it could not be
+  ///                            made. Callbacks are invoked in the order the
+  ///                            requests were made.
+  ///
+  void RequestSnapshot(std::function<void(SkCanvas*)> draw_callback,
+                       SkISize picture_size,
+                       ResultCallback callback);
+
+ private:
+  const TaskRunners task_runners_;
+  const fml::WeakPtr<SnapshotDelegate> snapshot_delegate_;
+  std::mutex mutex_;
+  std::vector<SnapshotDelegate::SnapshotRequest> pending_requests_;
+  std::vector<ResultCallback> pending_callbacks_;
+  bool flush_pending_ = false;
+
+  void Flush();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SnapshotBatcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_SNAPSHOT_BATCHER_H_
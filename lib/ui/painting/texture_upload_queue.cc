@@ -0,0 +1,132 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/texture_upload_queue.h"
+
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+TextureUploadQueue::TextureUploadQueue(
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    size_t budget_bytes)
+    : io_task_runner_(std::move(io_task_runner)), budget_bytes_(budget_bytes) {
+  FML_DCHECK(io_task_runner_);
+}
+
+TextureUploadQueue::~TextureUploadQueue() = default;
+
+bool TextureUploadQueue::TryReserve(size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  if (!Fits(bytes)) {
+    TRACE_EVENT0("flutter", "TextureUploadQueue::Defer");
+    return false;
+  }
+  reserved_bytes_ += bytes;
+  ReportCounters();
+  return true;
+}
+
+void TextureUploadQueue::SetReleaseCallback(fml::closure on_release) {
+  std::scoped_lock lock(mutex_);
+  on_release_ = std::move(on_release);
+}
+
+void TextureUploadQueue::Upload(size_t bytes, const fml::closure& upload) {
+  bool needs_task = false;
+  {
+    std::scoped_lock lock(mutex_);
+    queued_uploads_.push_back({bytes, upload});
+    needs_task = !upload_task_pending_;
+    upload_task_pending_ = true;
+    ReportCounters();
+  }
+
+  if (needs_task) {
+    PostUploadTask();
+  }
+}
+
+void TextureUploadQueue::Release(size_t bytes) {
+  fml::closure on_release;
+  {
+    std::scoped_lock lock(mutex_);
+    FML_DCHECK(bytes <= reserved_bytes_);
+    reserved_bytes_ -= bytes;
+    on_release = on_release_;
+    ReportCounters();
+  }
+
+  // The callback may reserve again, so it runs without the lock.
+  if (on_release) {
+    on_release();
+  }
+}
+
+size_t TextureUploadQueue::GetReservedBytes() const {
+  std::scoped_lock lock(mutex_);
+  return reserved_bytes_;
+}
+
+size_t TextureUploadQueue::GetQueuedUploadCount() const {
+  std::scoped_lock lock(mutex_);
+  return queued_uploads_.size();
+}
+
+bool TextureUploadQueue::Fits(size_t bytes) const {
+  // An image larger than the budget is decoded on its own rather than never.
+  return reserved_bytes_ == 0 || (reserved_bytes_ <= budget_bytes_ &&
+                                  bytes <= budget_bytes_ - reserved_bytes_);
+}
+
+void TextureUploadQueue::PostUploadTask() {
+  io_task_runner_->PostTask(
+      [queue = shared_from_this()]() { queue->RunUploads(); });
+}
+
+void TextureUploadQueue::RunUploads() {
+  TRACE_EVENT0("flutter", "TextureUploadQueue::RunUploads");
+  std::vector<fml::closure> uploads;
+  size_t batch_bytes = 0;
+  bool needs_task = false;
+  {
+    std::scoped_lock lock(mutex_);
+    while (!queued_uploads_.empty() &&
+           (uploads.empty() ||
+            batch_bytes + queued_uploads_.front().bytes <= kMaxBatchBytes)) {
+      batch_bytes += queued_uploads_.front().bytes;
+      uploads.push_back(std::move(queued_uploads_.front().closure));
+      queued_uploads_.pop_front();
+    }
+    // The rest of the queue is uploaded by the next task, which lets the IO
+    // task runner run the tasks queued in the meantime.
+    needs_task = !queued_uploads_.empty();
+    upload_task_pending_ = needs_task;
+    ReportCounters();
+  }
+
+  if (needs_task) {
+    PostUploadTask();
+  }
+
+  for (const auto& upload : uploads) {
+    upload();
+  }
+
+  Release(batch_bytes);
+}
+
+void TextureUploadQueue::ReportCounters() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "TextureUploadQueue",
+                    reinterpret_cast<int64_t>(this), "QueuedUploads",
+                    queued_uploads_.size(), "ReservedBytes", reserved_bytes_);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
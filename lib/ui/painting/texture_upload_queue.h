@@ -0,0 +1,127 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_TEXTURE_UPLOAD_QUEUE_H_
+#define FLUTTER_LIB_UI_PAINTING_TEXTURE_UPLOAD_QUEUE_H_
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Uploads decoded images on the IO task runner in batches, and
+///             bounds the memory held by images between the start of their
+///             decode and the end of their upload.
+///
+///             Each decode reserves the bytes of its decoded image before it
+///             starts. Decodes whose reservation does not fit in the budget
+///             wait in the `ImageDecodeScheduler` until earlier uploads
+///             complete, instead of failing, so that a flood of decodes never
+///             holds much more than the budget in decoded pixels. A
+///             reservation larger than the whole budget is granted once
+///             nothing else is reserved.
+///
+///             All uploads queued while an upload task is waiting for the IO
+///             task runner are run by that single task, so that a flood of
+///             small images does not fill the IO task queue.
+///
+///             All methods are thread safe.
+///
+class TextureUploadQueue
+    : public std::enable_shared_from_this<TextureUploadQueue> {
+ public:
+  /// The budget used unless the embedder sets another one.
+  static constexpr size_t kDefaultBudgetBytes = 128 << 20;
+
+  /// The most bytes uploaded by a single IO task, unless a single image is
+  /// larger, so that batches do not hold up the other IO tasks for long.
+  static constexpr size_t kMaxBatchBytes = 32 << 20;
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  io_task_runner  Runs the uploads.
+  /// @param[in]  budget_bytes    The most bytes reserved at once.
+  ///
+  TextureUploadQueue(fml::RefPtr<fml::TaskRunner> io_task_runner,
+                     size_t budget_bytes = kDefaultBudgetBytes);
+
+  ~TextureUploadQueue();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reserves the bytes of an image about to be decoded, if they
+  ///             fit in the budget. Each reservation must be ended by exactly
+  ///             one call to `Upload` or `Release`.
+  ///
+  /// @param[in]  bytes  The size of the decoded image.
+  ///
+  /// @return     Whether the bytes were reserved. If not, the decode must
+  ///             wait for the release callback before trying again.
+  ///
+  bool TryReserve(size_t bytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the callback invoked after reservations are ended, on
+  ///             the thread ending them and without holding any lock of the
+  ///             queue. Typically resumes the decodes waiting for memory.
+  ///
+  void SetReleaseCallback(fml::closure on_release);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Queues the upload of a decoded image, and ends its
+  ///             reservation once the upload has run.
+  ///
+  /// @param[in]  bytes   The bytes that were reserved for the image.
+  /// @param[in]  upload  Uploads the image. Invoked on the IO task runner.
+  ///
+  void Upload(size_t bytes, const fml::closure& upload);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Ends the reservation of an image that has nothing to upload,
+  ///             for instance because it could not be decoded.
+  ///
+  void Release(size_t bytes);
+
+  size_t GetBudgetBytes() const { return budget_bytes_; }
+
+  size_t GetReservedBytes() const;
+
+  size_t GetQueuedUploadCount() const;
+
+ private:
+  struct Entry {
+    size_t bytes;
+    fml::closure closure;
+  };
+
+  const fml::RefPtr<fml::TaskRunner> io_task_runner_;
+  const size_t budget_bytes_;
+  mutable std::mutex mutex_;
+  size_t reserved_bytes_ = 0;
+  fml::closure on_release_;
+  std::deque<Entry> queued_uploads_;
+  bool upload_task_pending_ = false;
+
+  // Whether a reservation of |bytes| fits in the budget. Must be called while
+  // holding the lock.
+  bool Fits(size_t bytes) const;
+
+  void PostUploadTask();
+
+  void RunUploads();
+
+  // Must be called while holding the lock.
+  void ReportCounters() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextureUploadQueue);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_TEXTURE_UPLOAD_QUEUE_H_
@@ -0,0 +1,130 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/texture_upload_queue.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class TextureUploadQueueTest : public ::testing::Test {
+ public:
+  TextureUploadQueueTest()
+      : io_thread_("io"),
+        queue_(std::make_shared<TextureUploadQueue>(io_thread_.GetTaskRunner(),
+                                                    100)) {}
+
+  TextureUploadQueue& queue() { return *queue_; }
+
+  // Blocks the IO thread until |UnblockIO| is called.
+  void BlockIO() {
+    io_thread_.GetTaskRunner()->PostTask([this]() { unblock_io_.Wait(); });
+  }
+
+  void UnblockIO() { unblock_io_.Signal(); }
+
+ private:
+  fml::Thread io_thread_;
+  std::shared_ptr<TextureUploadQueue> queue_;
+  fml::ManualResetWaitableEvent unblock_io_;
+};
+
+}  // namespace
+
+TEST_F(TextureUploadQueueTest, ReservesWithinTheBudget) {
+  ASSERT_TRUE(queue().TryReserve(60));
+  ASSERT_TRUE(queue().TryReserve(40));
+  ASSERT_EQ(queue().GetReservedBytes(), 100u);
+
+  queue().Release(100);
+  ASSERT_EQ(queue().GetReservedBytes(), 0u);
+}
+
+TEST_F(TextureUploadQueueTest, RefusesReservationsOverTheBudget) {
+  ASSERT_TRUE(queue().TryReserve(60));
+  ASSERT_FALSE(queue().TryReserve(50));
+  ASSERT_EQ(queue().GetReservedBytes(), 60u);
+
+  queue().Release(60);
+  ASSERT_TRUE(queue().TryReserve(50));
+  queue().Release(50);
+}
+
+TEST_F(TextureUploadQueueTest, GrantsReservationsLargerThanTheBudgetAlone) {
+  ASSERT_TRUE(queue().TryReserve(500));
+  ASSERT_FALSE(queue().TryReserve(1));
+
+  queue().Release(500);
+  ASSERT_TRUE(queue().TryReserve(1));
+  ASSERT_FALSE(queue().TryReserve(500));
+  queue().Release(1);
+}
+
+TEST_F(TextureUploadQueueTest, CallsTheReleaseCallbackWithoutTheLock) {
+  std::vector<bool> reserved;
+  queue().SetReleaseCallback([this, &reserved]() {
+    // Reserving again from the callback must not deadlock.
+    reserved.push_back(queue().TryReserve(80));
+  });
+  ASSERT_TRUE(queue().TryReserve(90));
+  ASSERT_FALSE(queue().TryReserve(80));
+
+  queue().Release(90);
+  ASSERT_EQ(reserved, std::vector<bool>({true}));
+  ASSERT_EQ(queue().GetReservedBytes(), 80u);
+
+  queue().SetReleaseCallback(nullptr);
+  queue().Release(80);
+}
+
+TEST_F(TextureUploadQueueTest, BatchesUploadsQueuedWhileIOIsBusy) {
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(queue().TryReserve(20));
+  }
+  BlockIO();
+
+  std::mutex mutex;
+  std::vector<size_t> queued_counts;
+  fml::CountDownLatch latch(3);
+  for (int i = 0; i < 3; i++) {
+    queue().Upload(20, [this, &mutex, &queued_counts, &latch]() {
+      {
+        std::scoped_lock lock(mutex);
+        queued_counts.push_back(queue().GetQueuedUploadCount());
+      }
+      latch.CountDown();
+    });
+  }
+  ASSERT_EQ(queue().GetQueuedUploadCount(), 3u);
+
+  UnblockIO();
+  latch.Wait();
+
+  // All the uploads were taken off the queue by the first upload task.
+  ASSERT_EQ(queued_counts, std::vector<size_t>({0, 0, 0}));
+}
+
+TEST_F(TextureUploadQueueTest, UploadsEndTheirReservations) {
+  ASSERT_TRUE(queue().TryReserve(80));
+  fml::AutoResetWaitableEvent released;
+  queue().SetReleaseCallback([&released]() { released.Signal(); });
+
+  queue().Upload(80, []() {});
+  released.Wait();
+  ASSERT_EQ(queue().GetReservedBytes(), 0u);
+  queue().SetReleaseCallback(nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_LIB_UI_SNAPSHOT_DELEGATE_H_
 #define FLUTTER_LIB_UI_SNAPSHOT_DELEGATE_H_
 
+#include <functional>
+#include <vector>
+
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
@@ -12,6 +15,11 @@ namespace flutter {
 
 class SnapshotDelegate {
  public:
+  struct SnapshotRequest {
+    std::function<void(SkCanvas*)> draw_callback;
+    SkISize picture_size;
+  };
+
   virtual sk_sp<SkImage> MakeRasterSnapshot(
       std::function<void(SkCanvas*)> draw_callback,
       SkISize picture_size) = 0;
@@ -20,6 +28,11 @@ class SnapshotDelegate {
                                             SkISize picture_size) = 0;
 
   virtual sk_sp<SkImage> ConvertToRasterImage(sk_sp<SkImage> image) = 0;
+
+  /// Rasterizes a batch of snapshots in one go. The result contains one image
+  /// per request, in order. Images that could not be rasterized are null.
+  virtual std::vector<sk_sp<SkImage>> MakeRasterSnapshots(
+      const std::vector<SnapshotRequest>& requests) = 0;
 };
 
 }  // namespace flutter
@@ -2078,8 +2078,9 @@ Int32List _encodeParagraphStyle(
   StrutStyle? strutStyle,
   String? ellipsis,
   Locale? locale,
+  bool? hyphenate,
 ) {
-  final Int32List result = Int32List(7); // also update paragraph_builder.cc
+  final Int32List result = Int32List(8); // also update paragraph_builder.cc
   if (textAlign != null) {
     result[0] |= 1 << 1;
     result[1] = textAlign.index;
@@ -2128,6 +2129,10 @@ Int32List _encodeParagraphStyle(
     result[0] |= 1 << 12;
     // Passed separately to native.
   }
+  if (hyphenate != null) {
+    result[0] |= 1 << 13;
+    result[7] = hyphenate ? 1 : 0;
+  }
   return result;
 }
 
@@ -2193,6 +2198,11 @@ class ParagraphStyle {
   ///   considered equivalent and turn off this behavior.
   ///
   /// * `locale`: The locale used to select region-specific glyphs.
+  ///
+  /// * `hyphenate`: Whether words may be broken across lines with a hyphen.
+  ///   Words are hyphenated with the hyphenation dictionary registered by the
+  ///   engine for the `locale` of the paragraph, and are never hyphenated if
+  ///   there is none. Defaults to false.
   ParagraphStyle({
     TextAlign? textAlign,
     TextDirection? textDirection,
@@ -2206,6 +2216,7 @@ class ParagraphStyle {
     StrutStyle? strutStyle,
     String? ellipsis,
     Locale? locale,
+    bool? hyphenate,
   }) : _encoded = _encodeParagraphStyle(
          textAlign,
          textDirection,
@@ -2219,6 +2230,7 @@ class ParagraphStyle {
          strutStyle,
          ellipsis,
          locale,
+         hyphenate,
        ),
        _fontFamily = fontFamily,
        _fontSize = fontSize,
@@ -2272,7 +2284,8 @@ class ParagraphStyle {
              'fontSize: ${      _encoded[0] & 0x100 == 0x100 ? _fontSize                         : "unspecified"}, '
              'height: ${        _encoded[0] & 0x200 == 0x200 ? "${_height}x"                     : "unspecified"}, '
              'ellipsis: ${      _encoded[0] & 0x400 == 0x400 ? "\"$_ellipsis\""                  : "unspecified"}, '
-             'locale: ${        _encoded[0] & 0x800 == 0x800 ? _locale                           : "unspecified"}'
+             'locale: ${        _encoded[0] & 0x800 == 0x800 ? _locale                           : "unspecified"}, '
+             'hyphenate: ${     _encoded[0] & 0x2000 == 0x2000 ? _encoded[7] != 0                : "unspecified"}'
            ')';
   }
 }
@@ -3175,6 +3188,39 @@ class Paragraph extends NativeFieldWrapperClass1 {
   void layout(ParagraphConstraints constraints) => _layout(constraints.width);
   void _layout(double width) native 'Paragraph_layout';
 
+  /// Computes the size and position of each glyph in the paragraph on a
+  /// background thread, without blocking the UI thread.
+  ///
+  /// The returned future completes with no value once the layout is done. The
+  /// metrics of the new layout are then read from the paragraph's getters,
+  /// such as [height] and [computeLineMetrics]. Until then, the paragraph keeps
+  /// the metrics of its previous layout. If [layout] or [layoutAsync] is called
+  /// again before the future completes, the result of this call is discarded.
+  ///
+  /// See also:
+  ///
+  ///  * [layoutAll], which lays out several paragraphs in parallel.
+  Future<void> layoutAsync(ParagraphConstraints constraints) {
+    return layoutAll(<Paragraph>[this], <ParagraphConstraints>[constraints]);
+  }
+
+  /// Computes the layout of each paragraph with the constraints at the same
+  /// index, in parallel on background threads.
+  ///
+  /// The returned future completes once all of the paragraphs have been laid
+  /// out. Each paragraph behaves as described in [layoutAsync].
+  static Future<void> layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs.length == constraints.length);
+    final Float64List widths = Float64List(constraints.length);
+    for (int index = 0; index < constraints.length; index += 1) {
+      widths[index] = constraints[index].width;
+    }
+    return _futurize((_Callback<void> callback) {
+      return _layoutAll(paragraphs, widths, callback);
+    });
+  }
+  static String? _layoutAll(List<Paragraph> paragraphs, Float64List widths, _Callback<void> callback) native 'Paragraph_layoutAll';
+
   List<TextBox> _decodeTextBoxes(Float32List encoded) {
     final int count = encoded.length ~/ 5;
     final List<TextBox> boxes = <TextBox>[];
@@ -4,14 +4,24 @@
 
 #include "flutter/lib/ui/text/paragraph.h"
 
+#include <atomic>
+#include <utility>
+#include <vector>
+
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/logging/dart_invoke.h"
+#include "third_party/tonic/typed_data/typed_list.h"
 
 using tonic::ToDart;
 
@@ -37,7 +47,12 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Paragraph);
   V(Paragraph, getPositionForOffset)    \
   V(Paragraph, computeLineMetrics)
 
-DART_BIND_ALL(Paragraph, FOR_EACH_BINDING)
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void Paragraph::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({{"Paragraph_layoutAll", Paragraph::layoutAll, 3, true},
+                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
 
 Paragraph::Paragraph(std::unique_ptr<txt::Paragraph> paragraph)
     : m_paragraph(std::move(paragraph)) {}
@@ -84,9 +99,140 @@ bool Paragraph::didExceedMaxLines() {
 }
 
 void Paragraph::layout(double width) {
+  // Discard the results of pending asynchronous layouts.
+  m_layoutGeneration++;
   m_paragraph->Layout(width);
 }
 
+namespace {
+
+// The state of a call to `Paragraph::layoutAll` that belongs to the isolate,
+// which must only be released on the UI thread. If the task completing the
+// layout is dropped instead of run, for instance while the engine shuts down,
+// the release is bounced back to the UI task runner.
+struct ParagraphLayoutCompletion {
+  fml::RefPtr<fml::TaskRunner> ui_task_runner;
+  std::vector<fml::RefPtr<Paragraph>> targets;
+  std::vector<size_t> generations;
+  std::unique_ptr<tonic::DartPersistentValue> callback;
+
+  ~ParagraphLayoutCompletion() {
+    if (ui_task_runner->RunsTasksOnCurrentThread()) {
+      return;
+    }
+    ui_task_runner->PostTask(fml::MakeCopyable(
+        [targets = std::move(targets),
+         callback = std::move(callback)]() mutable {
+          callback.reset();
+          targets.clear();
+        }));
+  }
+};
+
+}  // namespace
+
+// The paragraphs laid out by a single call to `Paragraph::layoutAll`. Worker
+// threads only access the copies being laid out. The last worker to finish
+// hands the batch to the UI task runner, which completes it.
+struct Paragraph::LayoutBatch {
+  std::vector<std::unique_ptr<txt::Paragraph>> copies;
+  std::vector<double> widths;
+  std::atomic<size_t> remaining;
+  std::unique_ptr<ParagraphLayoutCompletion> completion;
+
+  static void LayoutCopy(const std::shared_ptr<LayoutBatch>& batch,
+                         size_t index) {
+    TRACE_EVENT0("flutter", "Paragraph::LayoutCopy");
+    batch->copies[index]->Layout(batch->widths[index]);
+    if (--batch->remaining == 0) {
+      Complete(batch);
+    }
+  }
+
+  static void Complete(const std::shared_ptr<LayoutBatch>& batch) {
+    batch->completion->ui_task_runner->PostTask([batch]() {
+      auto completion = std::move(batch->completion);
+      auto dart_state = completion->callback->dart_state().lock();
+      if (!dart_state) {
+        // The root isolate could have died in the meantime.
+        return;
+      }
+      tonic::DartState::Scope scope(dart_state);
+
+      for (size_t i = 0; i < completion->targets.size(); i++) {
+        // A later call to layout or layoutAll supersedes this layout.
+        Paragraph* target = completion->targets[i].get();
+        if (target->m_layoutGeneration == completion->generations[i]) {
+          target->m_paragraph = std::move(batch->copies[i]);
+        }
+      }
+      tonic::DartInvoke(completion->callback->Get(), {Dart_TypeVoid()});
+    });
+  }
+};
+
+void Paragraph::layoutAll(Dart_NativeArguments args) {
+  UIDartState::ThrowIfUIOperationsProhibited();
+  Dart_Handle callback_handle = Dart_GetNativeArgument(args, 2);
+  if (!Dart_IsClosure(callback_handle)) {
+    Dart_SetReturnValue(args, tonic::ToDart("Callback must be a function"));
+    return;
+  }
+
+  std::vector<Paragraph*> paragraphs =
+      tonic::DartConverter<std::vector<Paragraph*>>::FromDart(
+          Dart_GetNativeArgument(args, 0));
+  tonic::Float64List widths(Dart_GetNativeArgument(args, 1));
+  if (paragraphs.size() != static_cast<size_t>(widths.num_elements())) {
+    Dart_SetReturnValue(
+        args, tonic::ToDart("Each paragraph must have exactly one width"));
+    return;
+  }
+
+  auto* dart_state = UIDartState::Current();
+  auto batch = std::make_shared<LayoutBatch>();
+  batch->completion = std::make_unique<ParagraphLayoutCompletion>();
+  ParagraphLayoutCompletion& completion = *batch->completion;
+  completion.ui_task_runner = dart_state->GetTaskRunners().GetUITaskRunner();
+  for (size_t i = 0; i < paragraphs.size(); i++) {
+    Paragraph* paragraph = paragraphs[i];
+    if (paragraph == nullptr) {
+      continue;
+    }
+    std::unique_ptr<txt::Paragraph> copy = paragraph->m_paragraph->Clone();
+    if (!copy) {
+      // The text layout engine can't lay out this paragraph on another
+      // thread.
+      paragraph->layout(widths[i]);
+      continue;
+    }
+    completion.targets.push_back(fml::RefPtr<Paragraph>(paragraph));
+    completion.generations.push_back(++paragraph->m_layoutGeneration);
+    batch->copies.push_back(std::move(copy));
+    batch->widths.push_back(widths[i]);
+  }
+  widths.Release();
+  completion.callback = std::make_unique<tonic::DartPersistentValue>(
+      dart_state, callback_handle);
+
+  const size_t count = batch->copies.size();
+  batch->remaining = count;
+  if (count == 0) {
+    LayoutBatch::Complete(batch);
+    return;
+  }
+
+  auto worker_task_runner = dart_state->GetConcurrentTaskRunner();
+  for (size_t i = 0; i < count; i++) {
+    if (worker_task_runner) {
+      worker_task_runner->PostTask(
+          [batch, i]() { LayoutBatch::LayoutCopy(batch, i); });
+    } else {
+      LayoutBatch::LayoutCopy(batch, i);
+    }
+  }
+}
+
 void Paragraph::paint(Canvas* canvas, double x, double y) {
   SkCanvas* sk_canvas = canvas->canvas();
   if (!sk_canvas) {
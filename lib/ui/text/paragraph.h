@@ -41,6 +41,15 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   bool didExceedMaxLines();
 
   void layout(double width);
+
+  // Lays out copies of several paragraphs in parallel on the concurrent worker
+  // task runner. Each paragraph switches to its laid out copy on the UI thread
+  // right before the callback is invoked, unless it was laid out again in the
+  // meantime. Until then, the paragraphs keep their previous layout.
+  //
+  // Arguments: a list of paragraphs, a Float64List of widths (one per
+  // paragraph) and a callback invoked once all paragraphs have been laid out.
+  static void layoutAll(Dart_NativeArguments args);
   void paint(Canvas* canvas, double x, double y);
 
   tonic::Float32List getRectsForRange(unsigned start,
@@ -59,6 +68,12 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
 
  private:
   std::unique_ptr<txt::Paragraph> m_paragraph;
+  // Incremented each time a layout is requested. Used to discard asynchronous
+  // layouts that complete after a later layout was requested.
+  size_t m_layoutGeneration = 0;
+
+  // The paragraphs laid out by a single call to `layoutAll`.
+  struct LayoutBatch;
 
   explicit Paragraph(std::unique_ptr<txt::Paragraph> paragraph);
 };
@@ -9,6 +9,7 @@
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/string_conversion.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/lib/ui/ui_dart_state.h"
@@ -19,7 +20,6 @@
 #include "flutter/third_party/txt/src/txt/text_baseline.h"
 #include "flutter/third_party/txt/src/txt/text_decoration.h"
 #include "flutter/third_party/txt/src/txt/text_style.h"
-#include "third_party/icu/source/common/unicode/ustring.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
@@ -86,6 +86,11 @@ const int psHeightIndex = 9;
 const int psStrutStyleIndex = 10;
 const int psEllipsisIndex = 11;
 const int psLocaleIndex = 12;
+const int psHyphenateIndex = 13;
+
+// The encoded values of the properties passed in the Int32List past the ones
+// stored at their mask index.
+const int psHyphenateValueIndex = 7;
 
 const int psTextAlignMask = 1 << psTextAlignIndex;
 const int psTextDirectionMask = 1 << psTextDirectionIndex;
@@ -99,6 +104,7 @@ const int psTextHeightBehaviorMask = 1 << psTextHeightBehaviorIndex;
 const int psStrutStyleMask = 1 << psStrutStyleIndex;
 const int psEllipsisMask = 1 << psEllipsisIndex;
 const int psLocaleMask = 1 << psLocaleIndex;
+const int psHyphenateMask = 1 << psHyphenateIndex;
 
 // TextShadows decoding
 
@@ -296,6 +302,10 @@ ParagraphBuilder::ParagraphBuilder(
     style.locale = locale;
   }
 
+  if (mask & psHyphenateMask) {
+    style.hyphenate = encoded[psHyphenateValueIndex] != 0;
+  }
+
   FontCollection& font_collection = UIDartState::Current()
                                         ->platform_configuration()
                                         ->client()
@@ -493,13 +503,7 @@ Dart_Handle ParagraphBuilder::addText(const std::u16string& text) {
     return Dart_Null();
   }
 
-  // Use ICU to validate the UTF-16 input.  Calling u_strToUTF8 with a null
-  // output buffer will return U_BUFFER_OVERFLOW_ERROR if the input is well
-  // formed.
-  const UChar* text_ptr = reinterpret_cast<const UChar*>(text.data());
-  UErrorCode error_code = U_ZERO_ERROR;
-  u_strToUTF8(nullptr, 0, nullptr, text_ptr, text.size(), &error_code);
-  if (error_code != U_BUFFER_OVERFLOW_ERROR) {
+  if (!fml::IsValidUtf16(text)) {
     return tonic::ToDart("string is not well-formed UTF-16");
   }
 
@@ -4,14 +4,25 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+#include "flutter/lib/ui/painting/image_decode_scheduler.h"
+#include "flutter/lib/ui/painting/image_encoding.h"
+#include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/lib/ui/painting/parallel_jpeg_image_generator.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkRRect.h"
 
+#include <chrono>
 #include <future>
+#include <thread>
 
 namespace flutter {
 
@@ -112,6 +123,165 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// Measures the time spent waiting for each frame of an animated WebP played
+// in a loop, with the given number of frames decoded ahead by a scheduler with
+// a single worker and the given frame cache budget.
+static void BM_AnimatedFrameDecoder(benchmark::State& state,  // NOLINT
+                                    size_t decode_ahead_frames,
+                                    size_t frame_cache_bytes) {
+  auto mapping = testing::OpenFixtureAsMapping("hello_loop_2.webp");
+  auto data = SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+  ImageGeneratorRegistry registry;
+  AnimatedFrameDecoder::Options options;
+  options.decode_ahead_frames = decode_ahead_frames;
+  options.frame_cache_bytes = frame_cache_bytes;
+  auto decoder = std::make_shared<AnimatedFrameDecoder>(
+      registry.CreateCompatibleGenerator(data), options);
+  auto loop = fml::ConcurrentMessageLoop::Create(1);
+  auto scheduler = std::make_shared<ImageDecodeScheduler>(
+      loop->GetTaskRunner(), ImageDecodeScheduler::GetDefaultLimits(1));
+
+  int index = 0;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(decoder->GetFrame(index));
+    decoder->DecodeAhead(index, scheduler);
+    index = (index + 1) % decoder->GetFrameCount();
+
+    // Leave the worker the time it would have while the frame is displayed.
+    state.PauseTiming();
+    std::this_thread::sleep_for(std::chrono::milliseconds(4));
+    state.ResumeTiming();
+  }
+
+  auto stats = decoder->GetStats();
+  state.counters["DecodedFrames"] = stats.decoded_frames;
+  state.counters["WaitedFrames"] = stats.waited_frames;
+}
+
+// Draws an image the size of a phone screenshot, with flat areas and
+// antialiased edges like those of a typical UI.
+static sk_sp<SkImage> CreateScreenshotImage() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(1440, 2560);
+  SkCanvas canvas(bitmap);
+  canvas.clear(SK_ColorWHITE);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  for (int i = 0; i < 40; i++) {
+    paint.setColor(SkColorSetRGB(i * 6, 255 - i * 6, (i * 37) % 256));
+    canvas.drawRRect(SkRRect::MakeRectXY(
+                         SkRect::MakeXYWH(40, 64 * i + 8, 1360, 48), 12, 12),
+                     paint);
+    paint.setColor(SK_ColorBLACK);
+    canvas.drawCircle(80, 64 * i + 32, 16, paint);
+  }
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+// Measures encoding a screenshot with the given options, optionally on the
+// workers of a concurrent task runner.
+static void BM_EncodeImage(benchmark::State& state,  // NOLINT
+                           ImageEncodingOptions options,
+                           bool parallel) {
+  auto image = CreateScreenshotImage();
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  auto runner = parallel ? loop->GetTaskRunner() : nullptr;
+
+  size_t encoded_bytes = 0;
+  while (state.KeepRunning()) {
+    auto data = EncodeRasterImage(image, options, runner);
+    FML_CHECK(data);
+    encoded_bytes = data->size();
+  }
+
+  state.counters["EncodedBytes"] = encoded_bytes;
+}
+
+// Measures decoding a 12 megapixel photo at the given scale, with Skia's codec
+// or with the parallel JPEG decoder. The CPU time is that of the whole process,
+// including the workers decoding the bands, and the time is the wall time.
+static void BM_DecodeJpeg(benchmark::State& state,  // NOLINT
+                          float scale,
+                          bool parallel) {
+  auto mapping = testing::OpenFixtureAsMapping("DashInNooglerHat.jpg");
+  auto data = SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  auto generator =
+      parallel ? ParallelJpegImageGenerator::MakeFromData(data,
+                                                          loop->GetTaskRunner())
+               : BuiltinSkiaCodecImageGenerator::MakeFromData(data);
+  FML_CHECK(generator);
+
+  SkBitmap bitmap;
+  bitmap.allocPixels(generator->GetInfo().makeDimensions(
+      generator->GetScaledDimensions(scale)));
+  while (state.KeepRunning()) {
+    FML_CHECK(generator->GetPixels(bitmap.info(), bitmap.getPixels(),
+                                   bitmap.rowBytes()));
+  }
+}
+
+BENCHMARK_CAPTURE(BM_DecodeJpeg, Skia, 1.0, false)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeJpeg, Parallel, 1.0, true)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeJpeg, SkiaQuarter, 0.25, false)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_DecodeJpeg, ParallelQuarter, 0.25, true)
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_EncodeImage,
+                  PNG,
+                  ImageEncodingOptions{.format = kPNG},
+                  false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodeImage,
+                  PNGFastest,
+                  ImageEncodingOptions{.format = kPNG,
+                                       .compression_level = 1,
+                                       .png_filter = PngFilter::kNone},
+                  false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodeImage,
+                  QOI,
+                  ImageEncodingOptions{.format = kQOI},
+                  false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodeImage,
+                  QOIParallel,
+                  ImageEncodingOptions{.format = kQOI},
+                  true)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodeImage,
+                  WebPLossless,
+                  ImageEncodingOptions{.format = kWebP},
+                  false)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EncodeImage,
+                  WebPLossy,
+                  ImageEncodingOptions{.format = kWebP, .quality = 80},
+                  false)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_AnimatedFrameDecoder, OnDemand, 0, 0)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDecoder, DecodeAhead, 2, 0)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_AnimatedFrameDecoder, Cached, 0, 64 << 20)
+    ->Iterations(200)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
@@ -36,7 +36,8 @@ UIDartState::Context::Context(
     fml::WeakPtr<ImageGeneratorRegistry> image_generator_registry,
     std::string advisory_script_uri,
     std::string advisory_script_entrypoint,
-    std::shared_ptr<VolatilePathTracker> volatile_path_tracker)
+    std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner)
     : task_runners(task_runners),
       snapshot_delegate(snapshot_delegate),
       io_manager(io_manager),
@@ -45,7 +46,8 @@ UIDartState::Context::Context(
       image_generator_registry(image_generator_registry),
       advisory_script_uri(advisory_script_uri),
       advisory_script_entrypoint(advisory_script_entrypoint),
-      volatile_path_tracker(volatile_path_tracker) {}
+      volatile_path_tracker(volatile_path_tracker),
+      concurrent_task_runner(concurrent_task_runner) {}
 
 UIDartState::UIDartState(
     TaskObserverAdd add_callback,
@@ -169,6 +171,14 @@ fml::WeakPtr<SnapshotDelegate> UIDartState::GetSnapshotDelegate() const {
   return context_.snapshot_delegate;
 }
 
+std::shared_ptr<SnapshotBatcher> UIDartState::GetSnapshotBatcher() {
+  if (!snapshot_batcher_) {
+    snapshot_batcher_ = std::make_shared<SnapshotBatcher>(
+        context_.task_runners, context_.snapshot_delegate);
+  }
+  return snapshot_batcher_;
+}
+
 fml::WeakPtr<GrDirectContext> UIDartState::GetResourceContext() const {
   if (!context_.io_manager) {
     return {};
@@ -180,6 +190,11 @@ fml::WeakPtr<ImageDecoder> UIDartState::GetImageDecoder() const {
   return context_.image_decoder;
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner>
+UIDartState::GetConcurrentTaskRunner() const {
+  return context_.concurrent_task_runner;
+}
+
 fml::WeakPtr<ImageGeneratorRegistry> UIDartState::GetImageGeneratorRegistry()
     const {
   return context_.image_generator_registry;
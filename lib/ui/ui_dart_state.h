@@ -13,11 +13,13 @@
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/build_config.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/isolate_name_server/isolate_name_server.h"
 #include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/snapshot_batcher.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "third_party/dart/runtime/include/dart_api.h"
@@ -51,7 +53,8 @@ class UIDartState : public tonic::DartState {
             fml::WeakPtr<ImageGeneratorRegistry> image_generator_registry,
             std::string advisory_script_uri,
             std::string advisory_script_entrypoint,
-            std::shared_ptr<VolatilePathTracker> volatile_path_tracker);
+            std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
+            std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner);
 
     /// The task runners used by the shell hosting this runtime controller. This
     /// may be used by the isolate to scheduled asynchronous texture uploads or
@@ -89,6 +92,10 @@ class UIDartState : public tonic::DartState {
 
     /// Cache for tracking path volatility.
     std::shared_ptr<VolatilePathTracker> volatile_path_tracker;
+
+    /// The task runner of the worker pool of the VM. Used by the isolate for
+    /// work that can be done off the UI thread, like laying out paragraphs.
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
   };
 
   Dart_Port main_port() const { return main_port_; }
@@ -120,10 +127,16 @@ class UIDartState : public tonic::DartState {
 
   fml::WeakPtr<SnapshotDelegate> GetSnapshotDelegate() const;
 
+  /// The batcher through which raster snapshots are requested from the
+  /// snapshot delegate.
+  std::shared_ptr<SnapshotBatcher> GetSnapshotBatcher();
+
   fml::WeakPtr<GrDirectContext> GetResourceContext() const;
 
   fml::WeakPtr<ImageDecoder> GetImageDecoder() const;
 
+  std::shared_ptr<fml::ConcurrentTaskRunner> GetConcurrentTaskRunner() const;
+
   fml::WeakPtr<ImageGeneratorRegistry> GetImageGeneratorRegistry() const;
 
   std::shared_ptr<IsolateNameServer> GetIsolateNameServer() const;
@@ -194,6 +207,7 @@ class UIDartState : public tonic::DartState {
   const bool enable_skparagraph_;
   const bool enable_display_list_;
   UIDartState::Context context_;
+  std::shared_ptr<SnapshotBatcher> snapshot_batcher_;
 
   void AddOrRemoveTaskObserver(bool add);
 };
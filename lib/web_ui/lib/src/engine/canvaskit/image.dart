@@ -180,6 +180,9 @@ class CkAnimatedImage extends ManagedSkiaObject<SkAnimatedImage>
     _nextFrameIndex = (_nextFrameIndex + 1) % _frameCount;
     return Future<ui.FrameInfo>.value(AnimatedImageFrameInfo(duration, image));
   }
+
+  @override
+  void setDecodePriority(ui.ImageDecodePriority priority) {}
 }
 
 /// A [ui.Image] backed by an `SkImage` from Skia.
@@ -306,6 +309,7 @@ class CkImage implements ui.Image, StackTraceDebugger {
   @override
   Future<ByteData> toByteData({
     ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba,
+    ui.ImageEncodingOptions options = const ui.ImageEncodingOptions(),
   }) {
     assert(_debugCheckIsNotDisposed());
     final ByteData? data = _encodeImage(
@@ -340,6 +344,10 @@ class CkImage implements ui.Image, StackTraceDebugger {
         height: skImage.height(),
       );
       bytes = skImage.readPixels(0, 0, imageInfo);
+    } else if (format == ui.ImageByteFormat.qoi ||
+        format == ui.ImageByteFormat.webp) {
+      // CanvasKit does not expose the QOI and WebP encoders.
+      bytes = null;
     } else {
       bytes = skImage.encodeToBytes(); //defaults to PNG 100%
     }
@@ -756,6 +756,12 @@ class CkParagraph extends SkiaObject<SkParagraph> implements ui.Paragraph {
     return ui.TextRange(start: skRange.start, end: skRange.end);
   }
 
+  @override
+  Future<void> layoutAsync(ui.ParagraphConstraints constraints) {
+    layout(constraints);
+    return Future<void>.value();
+  }
+
   @override
   void layout(ui.ParagraphConstraints constraints) {
     if (_lastLayoutConstraints == constraints) {
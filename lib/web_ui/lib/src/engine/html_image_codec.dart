@@ -103,6 +103,9 @@ class HtmlCodec implements ui.Codec {
     imgElement.src = src;
   }
 
+  @override
+  void setDecodePriority(ui.ImageDecodePriority priority) {}
+
   @override
   void dispose() {}
 }
@@ -168,7 +171,10 @@ class HtmlImage implements ui.Image {
   final int height;
 
   @override
-  Future<ByteData?> toByteData({ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba}) {
+  Future<ByteData?> toByteData({
+    ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba,
+    ui.ImageEncodingOptions options = const ui.ImageEncodingOptions(),
+  }) {
     if (format == ui.ImageByteFormat.rawRgba) {
       final html.CanvasElement canvas = html.CanvasElement()
         ..width = width
@@ -178,6 +184,11 @@ class HtmlImage implements ui.Image {
       final html.ImageData imageData = ctx.getImageData(0, 0, width, height);
       return Future<ByteData?>.value(imageData.data.buffer.asByteData());
     }
+    if (format == ui.ImageByteFormat.qoi ||
+        format == ui.ImageByteFormat.webp) {
+      // The source bytes of the image are not in these formats.
+      return Future<ByteData?>.value(null);
+    }
     if (imgElement.src?.startsWith('data:') == true) {
       final UriData data = UriData.fromUri(Uri.parse(imgElement.src!));
       return Future<ByteData?>.value(data.contentAsBytes().buffer.asByteData());
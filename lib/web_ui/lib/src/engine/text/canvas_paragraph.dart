@@ -82,6 +82,12 @@ class CanvasParagraph implements EngineParagraph {
   late final TextLayoutService _layoutService = TextLayoutService(this);
   late final TextPaintService _paintService = TextPaintService(this);
 
+  @override
+  Future<void> layoutAsync(ui.ParagraphConstraints constraints) {
+    layout(constraints);
+    return Future<void>.value();
+  }
+
   @override
   void layout(ui.ParagraphConstraints constraints) {
     // When constraint width has a decimal place, we floor it to avoid getting
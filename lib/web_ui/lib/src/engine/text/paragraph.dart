@@ -357,6 +357,12 @@ class DomParagraph implements EngineParagraph {
   /// directly into a canvas without css text alignment styling.
   double _alignOffset = 0.0;
 
+  @override
+  Future<void> layoutAsync(ui.ParagraphConstraints constraints) {
+    layout(constraints);
+    return Future<void>.value();
+  }
+
   @override
   void layout(ui.ParagraphConstraints constraints) {
     // When constraint width has a decimal place, we floor it to avoid getting
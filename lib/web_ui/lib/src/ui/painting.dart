@@ -333,7 +333,10 @@ abstract class Gradient extends Shader {
 abstract class Image {
   int get width;
   int get height;
-  Future<ByteData?> toByteData({ImageByteFormat format = ImageByteFormat.rawRgba});
+  Future<ByteData?> toByteData({
+    ImageByteFormat format = ImageByteFormat.rawRgba,
+    ImageEncodingOptions options = const ImageEncodingOptions(),
+  });
   void dispose();
   bool get debugDisposed;
 
@@ -427,6 +430,30 @@ enum ImageByteFormat {
   rawRgba,
   rawUnmodified,
   png,
+  qoi,
+  webp,
+}
+
+enum PngFilter {
+  all,
+  none,
+  sub,
+  up,
+  average,
+  paeth,
+}
+
+class ImageEncodingOptions {
+  const ImageEncodingOptions({
+    this.compressionLevel = 6,
+    this.pngFilter = PngFilter.all,
+    this.quality = 100,
+  }) : assert(compressionLevel >= 0 && compressionLevel <= 9),
+       assert(quality >= 0 && quality <= 100);
+
+  final int compressionLevel;
+  final PngFilter pngFilter;
+  final int quality;
 }
 
 enum PixelFormat {
@@ -443,6 +470,12 @@ abstract class FrameInfo {
   Image get image;
 }
 
+enum ImageDecodePriority {
+  visible,
+  prefetch,
+  background,
+}
+
 class Codec {
   Codec._();
   int get frameCount => 0;
@@ -452,6 +485,7 @@ class Codec {
   }
 
   String? _getNextFrame(engine.Callback<FrameInfo> callback) => null;
+  void setDecodePriority(ImageDecodePriority priority) {}
   void dispose() {}
 }
 
@@ -714,6 +748,16 @@ class ImmutableBuffer {
     return instance;
   }
 
+  static Future<ImmutableBuffer> fromAsset(String assetKey) async {
+    final ByteData data = await _assetManager!.load(assetKey);
+    return ImmutableBuffer.fromUint8List(
+        data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes));
+  }
+
+  static Future<ImmutableBuffer> fromFilePath(String path) async {
+    throw UnsupportedError('ImmutableBuffer.fromFilePath is not supported on the web.');
+  }
+
   Uint8List? _list;
   final int length;
 
@@ -785,3 +829,53 @@ class ImageDescriptor {
     return _createBmp(_data!, width, height, _rowBytes ?? width, _format!);
   }
 }
+
+class PartialImageInfo {
+  PartialImageInfo._({this.image, required this.decodedRows, required this.isComplete});
+  final Image? image;
+  final int decodedRows;
+  final bool isComplete;
+}
+
+// The browser does not expose partially decoded images, so the image is
+// decoded once all of its chunks have been added.
+class IncrementalImageDescriptor {
+  IncrementalImageDescriptor();
+
+  final List<Uint8List> _chunks = <Uint8List>[];
+  bool _closed = false;
+
+  void addChunk(ImmutableBuffer chunk) {
+    if (chunk._list != null) {
+      _chunks.add(chunk._list!);
+    }
+  }
+
+  void close() => _closed = true;
+
+  Future<PartialImageInfo> decode() async {
+    if (!_closed) {
+      return PartialImageInfo._(decodedRows: 0, isComplete: false);
+    }
+    int length = 0;
+    for (final Uint8List chunk in _chunks) {
+      length += chunk.length;
+    }
+    final Uint8List bytes = Uint8List(length);
+    int offset = 0;
+    for (final Uint8List chunk in _chunks) {
+      bytes.setRange(offset, offset + chunk.length, chunk);
+      offset += chunk.length;
+    }
+    final Codec codec = await instantiateImageCodec(bytes);
+    final FrameInfo frame = await codec.getNextFrame();
+    codec.dispose();
+    return PartialImageInfo._(
+      image: frame.image,
+      decodedRows: frame.image.height,
+      isComplete: true,
+    );
+  }
+
+  void dispose() => _chunks.clear();
+}
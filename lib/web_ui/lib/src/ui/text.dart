@@ -377,6 +377,9 @@ abstract class ParagraphStyle {
     StrutStyle? strutStyle,
     String? ellipsis,
     Locale? locale,
+    // Hyphenation dictionaries are registered by the native engines only, so
+    // `hyphenate` has no effect on the web.
+    bool? hyphenate,
   }) {
     if (engine.useCanvasKit) {
       return engine.CkParagraphStyle(
@@ -692,6 +695,16 @@ abstract class Paragraph {
   double get ideographicBaseline;
   bool get didExceedMaxLines;
   void layout(ParagraphConstraints constraints);
+  Future<void> layoutAsync(ParagraphConstraints constraints);
+  static Future<void> layoutAll(
+      List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    // There are no background threads to lay out paragraphs on the web.
+    assert(paragraphs.length == constraints.length);
+    for (int index = 0; index < paragraphs.length; index += 1) {
+      paragraphs[index].layout(constraints[index]);
+    }
+    return Future<void>.value();
+  }
   List<TextBox> getBoxesForRange(int start, int end,
       {BoxHeightStyle boxHeightStyle = BoxHeightStyle.tight,
       BoxWidthStyle boxWidthStyle = BoxWidthStyle.tight});
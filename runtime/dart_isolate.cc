@@ -108,7 +108,8 @@ std::weak_ptr<DartIsolate> DartIsolate::SpawnIsolate(
                            GetImageGeneratorRegistry(),  //
                            advisory_script_uri,          //
                            advisory_script_entrypoint,   //
-                           GetVolatilePathTracker()},    //
+                           GetVolatilePathTracker(),     //
+                           GetConcurrentTaskRunner()},   //
       this                                               //
   );
 }
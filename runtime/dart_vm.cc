@@ -272,9 +272,11 @@ DartVM::DartVM(std::shared_ptr<const DartVMData> vm_data,
                std::shared_ptr<IsolateNameServer> isolate_name_server)
     : settings_(vm_data->GetSettings()),
       concurrent_message_loop_(fml::ConcurrentMessageLoop::Create()),
+      concurrent_task_runner_(concurrent_message_loop_->GetTaskRunner()),
       skia_concurrent_executor_(
-          [runner = concurrent_message_loop_->GetTaskRunner()](
-              fml::closure work) { runner->PostTask(work); }),
+          [runner = concurrent_task_runner_](fml::closure work) {
+            runner->PostTask(work);
+          }),
       vm_data_(vm_data),
       isolate_name_server_(std::move(isolate_name_server)),
       service_protocol_(std::make_shared<ServiceProtocol>()) {
@@ -505,7 +507,7 @@ std::shared_ptr<IsolateNameServer> DartVM::GetIsolateNameServer() const {
 
 std::shared_ptr<fml::ConcurrentTaskRunner>
 DartVM::GetConcurrentWorkerTaskRunner() const {
-  return concurrent_message_loop_->GetTaskRunner();
+  return concurrent_task_runner_;
 }
 
 std::shared_ptr<fml::ConcurrentMessageLoop> DartVM::GetConcurrentMessageLoop() {
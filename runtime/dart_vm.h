@@ -142,7 +142,8 @@ class DartVM {
   ///             Dart VM lifecycle for the lifecycle of the concurrent worker
   ///             pool as well.
   ///
-  /// @return     The task runner for the concurrent worker thread pool.
+  /// @return     The task runner for the concurrent worker thread pool. The
+  ///             same task runner is returned to every caller.
   ///
   std::shared_ptr<fml::ConcurrentTaskRunner> GetConcurrentWorkerTaskRunner()
       const;
@@ -163,6 +164,9 @@ class DartVM {
  private:
   const Settings settings_;
   std::shared_ptr<fml::ConcurrentMessageLoop> concurrent_message_loop_;
+  // Returned to every engine, so that users of the pool like the image decode
+  // scheduler can share their state across engines.
+  const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
   SkiaConcurrentExecutor skia_concurrent_executor_;
   std::shared_ptr<const DartVMData> vm_data_;
   const std::shared_ptr<IsolateNameServer> isolate_name_server_;
@@ -37,6 +37,12 @@ const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
 const std::string_view
     ServiceProtocol::kEstimateRasterCacheMemoryExtensionName =
         "_flutter.estimateRasterCacheMemory";
+const std::string_view ServiceProtocol::kGetImageMemoryUsageExtensionName =
+    "_flutter.getImageMemoryUsage";
+const std::string_view ServiceProtocol::kSetFrameCaptureExtensionName =
+    "_flutter.setFrameCapture";
+const std::string_view ServiceProtocol::kGetCapturedFrameExtensionName =
+    "_flutter.getCapturedFrame";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -56,6 +62,9 @@ ServiceProtocol::ServiceProtocol()
           kGetDisplayRefreshRateExtensionName,
           kGetSkSLsExtensionName,
           kEstimateRasterCacheMemoryExtensionName,
+          kGetImageMemoryUsageExtensionName,
+          kSetFrameCaptureExtensionName,
+          kGetCapturedFrameExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
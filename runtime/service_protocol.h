@@ -29,6 +29,9 @@ class ServiceProtocol {
   static const std::string_view kGetDisplayRefreshRateExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
   static const std::string_view kEstimateRasterCacheMemoryExtensionName;
+  static const std::string_view kGetImageMemoryUsageExtensionName;
+  static const std::string_view kSetFrameCaptureExtensionName;
+  static const std::string_view kGetCapturedFrameExtensionName;
 
   class Handler {
    public:
@@ -26,6 +26,7 @@
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "txt/layout_cache.h"
 
 namespace flutter {
 
@@ -59,7 +60,13 @@ Engine::Engine(
       activity_running_(true),
       have_surface_(false),
       font_collection_(font_collection),
-      image_decoder_(task_runners, image_decoder_task_runner, io_manager),
+      image_decoder_(task_runners,
+                     image_decoder_task_runner,
+                     io_manager,
+                     settings_.image_upload_budget_bytes >= 0
+                         ? settings_.image_upload_budget_bytes
+                         : TextureUploadQueue::kDefaultBudgetBytes),
+      image_generator_registry_(image_decoder_task_runner),
       task_runners_(std::move(task_runners)),
       weak_factory_(this) {
   pointer_data_dispatcher_ = dispatcher_maker(*this);
@@ -105,6 +112,7 @@ Engine::Engine(Delegate& delegate,
           settings_.advisory_script_uri,           // advisory script uri
           settings_.advisory_script_entrypoint,    // advisory script entrypoint
           std::move(volatile_path_tracker),        // volatile path tracker
+          vm.GetConcurrentWorkerTaskRunner(),      // concurrent task runner
       });
 }
 
@@ -155,6 +163,10 @@ fml::WeakPtr<ImageGeneratorRegistry> Engine::GetImageGeneratorRegistry() {
   return image_generator_registry_.GetWeakPtr();
 }
 
+std::shared_ptr<TextureUploadQueue> Engine::GetImageUploadQueue() const {
+  return image_decoder_.GetUploadQueue();
+}
+
 bool Engine::UpdateAssetManager(
     std::shared_ptr<AssetManager> new_asset_manager) {
   if (asset_manager_ == new_asset_manager) {
@@ -227,6 +239,7 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
 void Engine::BeginFrame(fml::TimePoint frame_time, uint64_t frame_number) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
   runtime_controller_->BeginFrame(frame_time, frame_number);
+  txt::TraceLayoutCacheStats();
 }
 
 void Engine::ReportTimings(std::vector<int64_t> timings) {
@@ -802,8 +802,8 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   // |RuntimeDelegate|
   FontCollection& GetFontCollection() override;
 
-  // Return the asset manager associated with the current engine, or nullptr.
-  std::shared_ptr<AssetManager> GetAssetManager();
+  // |RuntimeDelegate|
+  std::shared_ptr<AssetManager> GetAssetManager() override;
 
   //----------------------------------------------------------------------------
   /// @brief      Get the `ImageGeneratorRegistry` associated with the current
@@ -813,6 +813,14 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   fml::WeakPtr<ImageGeneratorRegistry> GetImageGeneratorRegistry();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Get the queue that uploads the images decoded by this engine.
+  ///             Unlike the engine, the queue may be used on any thread.
+  ///
+  /// @return     The upload queue of the engine's `ImageDecoder`.
+  ///
+  std::shared_ptr<TextureUploadQueue> GetImageUploadQueue() const;
+
   // |PointerDataDispatcher::Delegate|
   void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
                         uint64_t trace_flow_id) override;
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_capture.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+
+CapturedFrame::CapturedFrame(
+    sk_sp<SkImage> image,
+    uint64_t frame_number,
+    fml::TimePoint vsync_target_time,
+    fml::TimePoint capture_time,
+    std::shared_ptr<std::atomic<size_t>> outstanding_frames)
+    : image_(std::move(image)),
+      frame_number_(frame_number),
+      vsync_target_time_(vsync_target_time),
+      capture_time_(capture_time),
+      outstanding_frames_(std::move(outstanding_frames)) {
+  FML_DCHECK(image_);
+  (*outstanding_frames_)++;
+}
+
+CapturedFrame::~CapturedFrame() {
+  // Release the pixels before the buffer is reported as free.
+  image_.reset();
+  (*outstanding_frames_)--;
+}
+
+bool CapturedFrame::PeekPixels(SkPixmap* pixmap) const {
+  return image_->peekPixels(pixmap);
+}
+
+FrameCaptureStream::FrameCaptureStream(size_t buffer_count,
+                                       FrameCallback callback)
+    : buffer_count_(
+          std::clamp(buffer_count, kMinBufferCount, kMaxBufferCount)),
+      callback_(std::move(callback)),
+      outstanding_frames_(std::make_shared<std::atomic<size_t>>(0)) {
+  FML_DCHECK(callback_);
+}
+
+FrameCaptureStream::~FrameCaptureStream() = default;
+
+size_t FrameCaptureStream::GetOutstandingFrameCount() const {
+  return *outstanding_frames_;
+}
+
+bool FrameCaptureStream::CaptureFrame(SkSurface* surface,
+                                      uint64_t frame_number,
+                                      fml::TimePoint vsync_target_time) {
+  TRACE_EVENT0("flutter", "FrameCaptureStream::CaptureFrame");
+  if (surface == nullptr) {
+    return false;
+  }
+
+  if (GetOutstandingFrameCount() >= buffer_count_) {
+    dropped_frames_++;
+    TRACE_EVENT_INSTANT0("flutter", "FrameCaptureStream::DroppedFrame");
+    return false;
+  }
+
+  sk_sp<SkImage> image;
+  SkPixmap pixmap;
+  if (surface->peekPixels(&pixmap) &&
+      pixmap.colorType() == kN32_SkColorType &&
+      pixmap.alphaType() == kPremul_SkAlphaType) {
+    // The surface is CPU backed. The snapshot shares its pixels, and is copied
+    // when the surface is drawn into again if the frame is still held.
+    image = surface->makeImageSnapshot();
+  } else {
+    // Other surfaces are read back, which also converts software surfaces of
+    // other color types to N32.
+    image = ReadbackSurface(surface);
+  }
+
+  if (!image) {
+    FML_LOG(ERROR) << "Could not capture the contents of frame "
+                   << frame_number << ".";
+    return false;
+  }
+
+  callback_(fml::MakeRefCounted<CapturedFrame>(
+      std::move(image), frame_number, vsync_target_time,
+      fml::TimePoint::Now(), outstanding_frames_));
+  return true;
+}
+
+sk_sp<SkImage> FrameCaptureStream::ReadbackSurface(SkSurface* surface) {
+  TRACE_EVENT0("flutter", "FrameCaptureStream::ReadbackSurface");
+  const auto info = SkImageInfo::MakeN32Premul(
+      surface->width(), surface->height(), SkColorSpace::MakeSRGB());
+  const size_t row_bytes = info.minRowBytes();
+  const size_t byte_size = info.computeByteSize(row_bytes);
+
+  // A buffer is free once the only reference left is the one held by this
+  // stream. Buffers that don't match the current frame size are replaced.
+  sk_sp<SkData>* buffer = nullptr;
+  for (auto& candidate : readback_buffers_) {
+    if (candidate->unique()) {
+      if (candidate->size() != byte_size) {
+        candidate = SkData::MakeUninitialized(byte_size);
+      }
+      buffer = &candidate;
+      break;
+    }
+  }
+  if (buffer == nullptr) {
+    if (readback_buffers_.size() >= buffer_count_) {
+      return nullptr;
+    }
+    readback_buffers_.push_back(SkData::MakeUninitialized(byte_size));
+    buffer = &readback_buffers_.back();
+  }
+
+  SkPixmap pixmap(info, (*buffer)->writable_data(), row_bytes);
+  if (!surface->readPixels(pixmap, 0, 0)) {
+    return nullptr;
+  }
+  return SkImage::MakeRasterData(info, *buffer, row_bytes);
+}
+
+}  // namespace flutter
@@ -0,0 +1,194 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_FRAME_CAPTURE_H_
+#define SHELL_COMMON_FRAME_CAPTURE_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/time/time_point.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A frame captured from the on-screen surface of a rasterizer
+///             after the frame was rendered. The pixels are always CPU
+///             accessible, in the N32 color type with premultiplied alpha,
+///             whatever the color type of the surface. Holding a reference to a captured frame keeps one of
+///             the buffers of the `FrameCaptureStream` that produced it busy.
+///             Frames are dropped while all buffers are busy, so consumers must
+///             release frames as soon as they are done with them.
+///
+///             Captured frames are immutable and may be released on any
+///             thread.
+///
+class CapturedFrame : public fml::RefCountedThreadSafe<CapturedFrame> {
+ public:
+  //----------------------------------------------------------------------------
+  /// @return     A CPU backed image containing the pixels of the frame.
+  ///
+  const sk_sp<SkImage>& image() const { return image_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gets direct access to the pixels of the frame.
+  ///
+  /// @param[out] pixmap  The pixmap describing the pixels of the frame.
+  ///
+  /// @return     If the pixels could be accessed.
+  ///
+  bool PeekPixels(SkPixmap* pixmap) const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The frame number assigned by the `FrameTimingsRecorder` of the
+  ///             frame.
+  ///
+  uint64_t frame_number() const { return frame_number_; }
+
+  //----------------------------------------------------------------------------
+  /// @return     The time the frame was targeted to be presented at.
+  ///
+  fml::TimePoint vsync_target_time() const { return vsync_target_time_; }
+
+  //----------------------------------------------------------------------------
+  /// @return     The time the frame contents were captured at. This is after
+  ///             rasterization and before the frame was submitted.
+  ///
+  fml::TimePoint capture_time() const { return capture_time_; }
+
+ private:
+  sk_sp<SkImage> image_;
+  const uint64_t frame_number_;
+  const fml::TimePoint vsync_target_time_;
+  const fml::TimePoint capture_time_;
+  std::shared_ptr<std::atomic<size_t>> outstanding_frames_;
+
+  CapturedFrame(sk_sp<SkImage> image,
+                uint64_t frame_number,
+                fml::TimePoint vsync_target_time,
+                fml::TimePoint capture_time,
+                std::shared_ptr<std::atomic<size_t>> outstanding_frames);
+
+  ~CapturedFrame();
+
+  friend class FrameCaptureStream;
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(CapturedFrame);
+  FML_FRIEND_MAKE_REF_COUNTED(CapturedFrame);
+  FML_DISALLOW_COPY_AND_ASSIGN(CapturedFrame);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Hands out the contents of each frame rendered by a rasterizer
+///             without rendering the layer tree again. This is used to record
+///             the output of an engine, for instance by headless embedders
+///             running visual regression tests.
+///
+///             Frames rendered into CPU backed surfaces (the software backend)
+///             are handed out as snapshots that share the pixels of the
+///             backing store. This is not free: the snapshot is copied on
+///             write, so if the consumer still holds the frame when the next
+///             frame is drawn, Skia copies the whole backing store before
+///             drawing. Consumers that release each frame before the next one
+///             is rendered avoid the copy.
+///
+///             Frames rendered into GPU surfaces are read back into a ring of
+///             host buffers that are allocated once per frame size and reused.
+///             The captured frame wraps its buffer directly.
+///
+///             At most `buffer_count` frames may be outstanding at any time.
+///             Frames rendered while the consumer holds all of them are
+///             dropped and counted in `GetDroppedFrameCount`.
+///
+/// @attention  Frames are captured on the raster task runner and the callback
+///             is invoked there. The callback must return quickly.
+///
+class FrameCaptureStream {
+ public:
+  /// The consumers that may capture the frames of a rasterizer at the same
+  /// time. Each has its own stream, so that they don't replace each other's.
+  enum class Client {
+    kEmbedder,
+    kServiceProtocol,
+  };
+
+  using FrameCallback = std::function<void(fml::RefPtr<CapturedFrame>)>;
+
+  /// The fewest buffers a stream may use. Two buffers allow the consumer to
+  /// process one frame while the next is being captured.
+  static constexpr size_t kMinBufferCount = 2;
+
+  /// The most buffers a stream may use.
+  static constexpr size_t kMaxBufferCount = 3;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a frame capture stream.
+  ///
+  /// @param[in]  buffer_count  The number of frames that may be outstanding at
+  ///                           any time. Clamped to [kMinBufferCount,
+  ///                           kMaxBufferCount].
+  /// @param[in]  callback      The callback invoked on the raster task runner
+  ///                           with each captured frame.
+  ///
+  FrameCaptureStream(size_t buffer_count, FrameCallback callback);
+
+  ~FrameCaptureStream();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Captures the contents of a surface that a frame was just
+  ///             rendered into and hands them to the callback. Must be called
+  ///             before the frame is submitted, with the render context of the
+  ///             surface current.
+  ///
+  /// @param[in]  surface            The surface the frame was rendered into.
+  /// @param[in]  frame_number       The number of the frame.
+  /// @param[in]  vsync_target_time  The time the frame is targeted to be
+  ///                                presented at.
+  ///
+  /// @return     If the frame was captured. Frames are not captured if all
+  ///             buffers are held by the consumer or if the surface could not
+  ///             be read.
+  ///
+  bool CaptureFrame(SkSurface* surface,
+                    uint64_t frame_number,
+                    fml::TimePoint vsync_target_time);
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of buffers used by this stream.
+  ///
+  size_t GetBufferCount() const { return buffer_count_; }
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of frames handed out that have not been released
+  ///             yet.
+  ///
+  size_t GetOutstandingFrameCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of frames that were not captured because all
+  ///             buffers were held by the consumer.
+  ///
+  size_t GetDroppedFrameCount() const { return dropped_frames_; }
+
+ private:
+  const size_t buffer_count_;
+  const FrameCallback callback_;
+  std::shared_ptr<std::atomic<size_t>> outstanding_frames_;
+  std::vector<sk_sp<SkData>> readback_buffers_;
+  size_t dropped_frames_ = 0;
+
+  sk_sp<SkImage> ReadbackSurface(SkSurface* surface);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameCaptureStream);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_COMMON_FRAME_CAPTURE_H_
@@ -0,0 +1,95 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_capture.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(FrameCaptureStreamTest, ClampsBufferCount) {
+  auto callback = [](fml::RefPtr<CapturedFrame>) {};
+  ASSERT_EQ(FrameCaptureStream(0, callback).GetBufferCount(),
+            FrameCaptureStream::kMinBufferCount);
+  ASSERT_EQ(FrameCaptureStream(100, callback).GetBufferCount(),
+            FrameCaptureStream::kMaxBufferCount);
+}
+
+TEST(FrameCaptureStreamTest, CapturesRasterSurfaceContents) {
+  auto surface = SkSurface::MakeRasterN32Premul(4, 4);
+  surface->getCanvas()->clear(SK_ColorRED);
+
+  fml::RefPtr<CapturedFrame> captured;
+  FrameCaptureStream stream(
+      2, [&](fml::RefPtr<CapturedFrame> frame) { captured = frame; });
+  const auto target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(16));
+  ASSERT_TRUE(stream.CaptureFrame(surface.get(), 7, target_time));
+  ASSERT_TRUE(captured);
+  ASSERT_EQ(captured->frame_number(), 7u);
+  ASSERT_EQ(captured->vsync_target_time(), target_time);
+
+  // Drawing into the surface again must not change the captured frame.
+  surface->getCanvas()->clear(SK_ColorBLUE);
+  SkPixmap pixmap;
+  ASSERT_TRUE(captured->PeekPixels(&pixmap));
+  ASSERT_EQ(pixmap.width(), 4);
+  ASSERT_EQ(pixmap.height(), 4);
+  ASSERT_EQ(pixmap.getColor(1, 1), SK_ColorRED);
+}
+
+TEST(FrameCaptureStreamTest, ConvertsRasterSurfacesToN32) {
+  auto surface = SkSurface::MakeRaster(
+      SkImageInfo::Make(4, 4, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+  ASSERT_TRUE(surface);
+  surface->getCanvas()->clear(SK_ColorRED);
+
+  fml::RefPtr<CapturedFrame> captured;
+  FrameCaptureStream stream(
+      2, [&](fml::RefPtr<CapturedFrame> frame) { captured = frame; });
+  ASSERT_TRUE(stream.CaptureFrame(surface.get(), 1, fml::TimePoint()));
+  ASSERT_TRUE(captured);
+
+  SkPixmap pixmap;
+  ASSERT_TRUE(captured->PeekPixels(&pixmap));
+  ASSERT_EQ(pixmap.colorType(), kN32_SkColorType);
+  ASSERT_EQ(pixmap.alphaType(), kPremul_SkAlphaType);
+  ASSERT_EQ(pixmap.rowBytes(), 4u * sizeof(uint32_t));
+  ASSERT_EQ(pixmap.getColor(1, 1), SK_ColorRED);
+}
+
+TEST(FrameCaptureStreamTest, DropsFramesWhileAllBuffersAreHeld) {
+  auto surface = SkSurface::MakeRasterN32Premul(4, 4);
+  std::vector<fml::RefPtr<CapturedFrame>> held;
+  FrameCaptureStream stream(
+      2, [&](fml::RefPtr<CapturedFrame> frame) { held.push_back(frame); });
+
+  ASSERT_TRUE(stream.CaptureFrame(surface.get(), 1, fml::TimePoint()));
+  ASSERT_TRUE(stream.CaptureFrame(surface.get(), 2, fml::TimePoint()));
+  ASSERT_EQ(stream.GetOutstandingFrameCount(), 2u);
+  ASSERT_FALSE(stream.CaptureFrame(surface.get(), 3, fml::TimePoint()));
+  ASSERT_EQ(stream.GetDroppedFrameCount(), 1u);
+
+  // Releasing a frame frees its buffer for the next one.
+  held.erase(held.begin());
+  ASSERT_EQ(stream.GetOutstandingFrameCount(), 1u);
+  ASSERT_TRUE(stream.CaptureFrame(surface.get(), 4, fml::TimePoint()));
+  ASSERT_EQ(held.back()->frame_number(), 4u);
+}
+
+TEST(FrameCaptureStreamTest, NullSurfaceIsNotCaptured) {
+  bool called = false;
+  FrameCaptureStream stream(2,
+                            [&](fml::RefPtr<CapturedFrame>) { called = true; });
+  ASSERT_FALSE(stream.CaptureFrame(nullptr, 1, fml::TimePoint()));
+  ASSERT_FALSE(called);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/raster_work_scheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+RasterWorkScheduler::RasterWorkScheduler(fml::TimeDelta safety_margin,
+                                         Clock clock)
+    : safety_margin_(safety_margin), clock_(std::move(clock)) {}
+
+RasterWorkScheduler::~RasterWorkScheduler() = default;
+
+void RasterWorkScheduler::PostTask(const char* label,
+                                   fml::TimeDelta estimated_cost,
+                                   const fml::closure& task) {
+  if (!task) {
+    return;
+  }
+
+  auto found = std::find_if(tasks_.begin(), tasks_.end(),
+                            [label](const Task& pending) {
+                              return std::strcmp(pending.label, label) == 0;
+                            });
+  if (found != tasks_.end()) {
+    found->estimated_cost = estimated_cost;
+    found->closure = task;
+    return;
+  }
+
+  tasks_.push_back({label, estimated_cost, task});
+}
+
+size_t RasterWorkScheduler::RunUntil(fml::TimePoint deadline) {
+  size_t tasks_run = 0;
+  while (!tasks_.empty()) {
+    const auto& next = tasks_.front();
+    const auto cost =
+        std::max(next.estimated_cost, GetEstimatedCost(next.label));
+    if (clock_() + cost + safety_margin_ > deadline) {
+      break;
+    }
+    RunNext();
+    tasks_run++;
+  }
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "RasterWorkScheduler",
+                    reinterpret_cast<int64_t>(this), "PendingTasks",
+                    tasks_.size());
+#endif  // !FLUTTER_RELEASE
+  return tasks_run;
+}
+
+bool RasterWorkScheduler::RunNext() {
+  if (tasks_.empty()) {
+    return false;
+  }
+  Task task = std::move(tasks_.front());
+  tasks_.pop_front();
+  RunTask(std::move(task));
+  return true;
+}
+
+size_t RasterWorkScheduler::RunAll() {
+  size_t tasks_run = 0;
+  while (RunNext()) {
+    tasks_run++;
+  }
+  return tasks_run;
+}
+
+void RasterWorkScheduler::Clear() {
+  tasks_.clear();
+}
+
+fml::TimeDelta RasterWorkScheduler::GetEstimatedCost(
+    const std::string& label) const {
+  auto found = measured_costs_.find(label);
+  if (found == measured_costs_.end()) {
+    return fml::TimeDelta::Zero();
+  }
+  return found->second;
+}
+
+void RasterWorkScheduler::RunTask(Task task) {
+  TRACE_EVENT0("flutter", task.label);
+  const auto start = clock_();
+  task.closure();
+  const auto duration = clock_() - start;
+  // Remember the last observed duration so that the next estimate for the same
+  // kind of work reflects what it actually costs on this device.
+  measured_costs_[task.label] = duration;
+}
+
+}  // namespace flutter
@@ -0,0 +1,158 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_RASTER_WORK_SCHEDULER_H_
+#define SHELL_COMMON_RASTER_WORK_SCHEDULER_H_
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Schedules optional work on the raster task runner into the
+///             slack left in the budget of the frame being rasterized.
+///
+///             Work posted to this scheduler must not be required for the
+///             correctness of the current frame. Examples are purges of
+///             unused GPU resources and the population of raster cache
+///             entries over the per-frame limit of the cache.
+///             After a frame has been submitted, the rasterizer asks the
+///             scheduler to run as many tasks as fit before the vsync target
+///             time of that frame (see
+///             `FrameTimingsRecorder::GetVsyncTargetTime`). Tasks that don't
+///             fit are held over to the next frame, or to an idle period on
+///             the raster task runner.
+///
+///             Cheap frames leave more slack, so pending work gets pulled
+///             forward. Expensive frames push the work back instead of
+///             causing a missed frame.
+///
+///             Tasks are keyed by their label. Posting a task with the label
+///             of a task that is still pending replaces the pending task
+///             without changing its position in the queue. This keeps work
+///             that is requested every frame (like a resource purge) from
+///             piling up while frames are expensive.
+///
+/// @attention  This class is not thread safe. It must only be used on the
+///             raster task runner.
+///
+class RasterWorkScheduler {
+ public:
+  using Clock = std::function<fml::TimePoint()>;
+
+  //----------------------------------------------------------------------------
+  /// The time reserved before a deadline that deferred work will never
+  /// encroach upon. This accounts for the imprecision of task cost estimates
+  /// and the time needed by the platform to present the frame.
+  ///
+  static constexpr fml::TimeDelta kDefaultSafetyMargin =
+      fml::TimeDelta::FromMilliseconds(1);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a raster work scheduler.
+  ///
+  /// @param[in]  safety_margin  The time before each deadline that must be
+  ///                            left untouched by deferred work.
+  /// @param[in]  clock          The clock used to measure task cost and
+  ///                            compare against deadlines. Defaults to
+  ///                            `fml::TimePoint::Now`.
+  ///
+  explicit RasterWorkScheduler(
+      fml::TimeDelta safety_margin = kDefaultSafetyMargin,
+      Clock clock = &fml::TimePoint::Now);
+
+  ~RasterWorkScheduler();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds a task to the queue of deferred work.
+  ///
+  /// @param[in]  label           A static string used to identify the task
+  ///                             in traces and to coalesce repeated requests
+  ///                             for the same work.
+  /// @param[in]  estimated_cost  The expected duration of the task. Once the
+  ///                             task has run, the measured duration of the
+  ///                             last run for the same label is used instead
+  ///                             if it is larger.
+  /// @param[in]  task            The work to perform.
+  ///
+  void PostTask(const char* label,
+                fml::TimeDelta estimated_cost,
+                const fml::closure& task);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs pending tasks in order as long as the estimated cost of
+  ///             the next task fits before the deadline minus the safety
+  ///             margin. Stops at the first task that does not fit so that
+  ///             the order of posted work is preserved.
+  ///
+  /// @param[in]  deadline  The time by which all work must be done. For work
+  ///                       done after rasterizing a frame, this is the vsync
+  ///                       target time of that frame.
+  ///
+  /// @return     The number of tasks that were run.
+  ///
+  size_t RunUntil(fml::TimePoint deadline);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs the next pending task regardless of the frame budget.
+  ///             Used to guarantee forward progress when the raster task
+  ///             runner is idle but no task fits in the available slice.
+  ///
+  /// @return     Whether a task was run.
+  ///
+  bool RunNext();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs all pending tasks regardless of the frame budget. Used
+  ///             when the work can't be deferred any longer, for instance
+  ///             when the rasterizer is torn down.
+  ///
+  /// @return     The number of tasks that were run.
+  ///
+  size_t RunAll();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops all pending tasks without running them.
+  ///
+  void Clear();
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of tasks waiting to be run.
+  ///
+  size_t GetPendingTaskCount() const { return tasks_.size(); }
+
+  //----------------------------------------------------------------------------
+  /// @return     The measured duration of the last run of the task with the
+  ///             given label, or a zero delta if no such task has run yet.
+  ///
+  fml::TimeDelta GetEstimatedCost(const std::string& label) const;
+
+ private:
+  struct Task {
+    const char* label;
+    fml::TimeDelta estimated_cost;
+    fml::closure closure;
+  };
+
+  const fml::TimeDelta safety_margin_;
+  const Clock clock_;
+  std::deque<Task> tasks_;
+  std::map<std::string, fml::TimeDelta> measured_costs_;
+
+  void RunTask(Task task);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RasterWorkScheduler);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_COMMON_RASTER_WORK_SCHEDULER_H_
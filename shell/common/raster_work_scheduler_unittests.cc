@@ -0,0 +1,143 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/raster_work_scheduler.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+class FakeClock {
+ public:
+  fml::TimePoint Now() const { return now_; }
+  void Advance(fml::TimeDelta delta) { now_ = now_ + delta; }
+
+  RasterWorkScheduler::Clock AsClock() {
+    return [this]() { return Now(); };
+  }
+
+ private:
+  fml::TimePoint now_ = fml::TimePoint::FromTicks(1000000);
+};
+}  // namespace
+
+TEST(RasterWorkSchedulerTest, RunsTasksThatFitBeforeDeadline) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::Zero(), clock.AsClock());
+  std::vector<int> ran;
+  scheduler.PostTask("a", fml::TimeDelta::FromMilliseconds(2),
+                     [&]() { ran.push_back(1); });
+  scheduler.PostTask("b", fml::TimeDelta::FromMilliseconds(2),
+                     [&]() { ran.push_back(2); });
+
+  const auto deadline = clock.Now() + fml::TimeDelta::FromMilliseconds(4);
+  ASSERT_EQ(scheduler.RunUntil(deadline), 2u);
+  ASSERT_EQ(ran, std::vector<int>({1, 2}));
+  ASSERT_EQ(scheduler.GetPendingTaskCount(), 0u);
+}
+
+TEST(RasterWorkSchedulerTest, DefersTasksThatDoNotFit) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::FromMilliseconds(1),
+                                clock.AsClock());
+  bool ran = false;
+  scheduler.PostTask("purge", fml::TimeDelta::FromMilliseconds(4),
+                     [&]() { ran = true; });
+
+  // 4ms of work plus the 1ms margin does not fit in 4ms of slack.
+  ASSERT_EQ(scheduler.RunUntil(clock.Now() +
+                               fml::TimeDelta::FromMilliseconds(4)),
+            0u);
+  ASSERT_FALSE(ran);
+  ASSERT_EQ(scheduler.GetPendingTaskCount(), 1u);
+
+  // A cheaper frame leaves enough slack to pull the work forward.
+  ASSERT_EQ(scheduler.RunUntil(clock.Now() +
+                               fml::TimeDelta::FromMilliseconds(10)),
+            1u);
+  ASSERT_TRUE(ran);
+}
+
+TEST(RasterWorkSchedulerTest, DeadlineInThePastRunsNothing) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::Zero(), clock.AsClock());
+  bool ran = false;
+  scheduler.PostTask("a", fml::TimeDelta::Zero(), [&]() { ran = true; });
+  ASSERT_EQ(scheduler.RunUntil(clock.Now() -
+                               fml::TimeDelta::FromMilliseconds(1)),
+            0u);
+  ASSERT_FALSE(ran);
+}
+
+TEST(RasterWorkSchedulerTest, PreservesOrderWhenHeadDoesNotFit) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::Zero(), clock.AsClock());
+  std::vector<int> ran;
+  scheduler.PostTask("expensive", fml::TimeDelta::FromMilliseconds(8),
+                     [&]() { ran.push_back(1); });
+  scheduler.PostTask("cheap", fml::TimeDelta::FromMilliseconds(1),
+                     [&]() { ran.push_back(2); });
+
+  ASSERT_EQ(scheduler.RunUntil(clock.Now() +
+                               fml::TimeDelta::FromMilliseconds(2)),
+            0u);
+  ASSERT_TRUE(ran.empty());
+  ASSERT_EQ(scheduler.RunAll(), 2u);
+  ASSERT_EQ(ran, std::vector<int>({1, 2}));
+}
+
+TEST(RasterWorkSchedulerTest, CoalescesTasksWithTheSameLabel) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::Zero(), clock.AsClock());
+  std::vector<int> ran;
+  scheduler.PostTask("purge", fml::TimeDelta::Zero(),
+                     [&]() { ran.push_back(1); });
+  scheduler.PostTask("dump", fml::TimeDelta::Zero(),
+                     [&]() { ran.push_back(2); });
+  scheduler.PostTask("purge", fml::TimeDelta::Zero(),
+                     [&]() { ran.push_back(3); });
+  ASSERT_EQ(scheduler.GetPendingTaskCount(), 2u);
+  ASSERT_EQ(scheduler.RunAll(), 2u);
+  ASSERT_EQ(ran, std::vector<int>({3, 2}));
+}
+
+TEST(RasterWorkSchedulerTest, UsesMeasuredCostForLaterEstimates) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::Zero(), clock.AsClock());
+  const auto cost = fml::TimeDelta::FromMilliseconds(6);
+  scheduler.PostTask("purge", fml::TimeDelta::Zero(),
+                     [&]() { clock.Advance(cost); });
+  ASSERT_TRUE(scheduler.RunNext());
+  ASSERT_EQ(scheduler.GetEstimatedCost("purge"), cost);
+
+  // The posted estimate is too optimistic. The measured cost defers the task.
+  bool ran = false;
+  scheduler.PostTask("purge", fml::TimeDelta::Zero(), [&]() { ran = true; });
+  ASSERT_EQ(scheduler.RunUntil(clock.Now() +
+                               fml::TimeDelta::FromMilliseconds(4)),
+            0u);
+  ASSERT_FALSE(ran);
+  ASSERT_EQ(scheduler.RunUntil(clock.Now() +
+                               fml::TimeDelta::FromMilliseconds(6)),
+            1u);
+  ASSERT_TRUE(ran);
+}
+
+TEST(RasterWorkSchedulerTest, ClearDropsPendingTasks) {
+  FakeClock clock;
+  RasterWorkScheduler scheduler(fml::TimeDelta::Zero(), clock.AsClock());
+  bool ran = false;
+  scheduler.PostTask("a", fml::TimeDelta::Zero(), [&]() { ran = true; });
+  scheduler.Clear();
+  ASSERT_EQ(scheduler.GetPendingTaskCount(), 0u);
+  ASSERT_FALSE(scheduler.RunNext());
+  ASSERT_FALSE(ran);
+}
+
+}  // namespace testing
+}  // namespace flutter
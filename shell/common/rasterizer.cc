@@ -28,6 +28,22 @@ namespace flutter {
 // used within this interval.
 static constexpr std::chrono::milliseconds kSkiaCleanupExpiration(15000);
 
+// The expected cost of a deferred Skia cleanup before it has been measured on
+// this device.
+static constexpr fml::TimeDelta kSkiaCleanupEstimatedCost =
+    fml::TimeDelta::FromMilliseconds(1);
+
+// The expected cost of rasterizing a deferred raster cache entry before it has
+// been measured on this device.
+static constexpr fml::TimeDelta kRasterCacheEntryEstimatedCost =
+    fml::TimeDelta::FromMilliseconds(2);
+
+// When deferred raster work could not be run within the budget of a frame, it
+// is run in slices of at most this fraction of the frame budget while the
+// raster task runner is idle. This bounds the delay that a slice may impose on
+// a frame that becomes ready while it is running.
+static constexpr int kDeferredWorkIdleSliceDivisor = 4;
+
 Rasterizer::Rasterizer(Delegate& delegate)
     : delegate_(delegate),
       compositor_context_(std::make_unique<flutter::CompositorContext>(
@@ -37,7 +53,10 @@ Rasterizer::Rasterizer(Delegate& delegate)
   FML_DCHECK(compositor_context_);
 }
 
-Rasterizer::~Rasterizer() = default;
+Rasterizer::~Rasterizer() {
+  // Teardown is not always called before the rasterizer is collected.
+  ClearSnapshotSurfacePool();
+}
 
 fml::TaskRunnerAffineWeakPtr<Rasterizer> Rasterizer::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
@@ -88,6 +107,11 @@ void Rasterizer::Teardown() {
     compositor_context_->OnGrContextDestroyed();
   }
 
+  // Deferred work references the surface being torn down. The pooled snapshot
+  // render targets are released while the context made current above still
+  // is.
+  raster_work_scheduler_.Clear();
+  snapshot_surface_pool_.Clear();
   surface_.reset();
   last_layer_tree_.reset();
 
@@ -111,7 +135,7 @@ void Rasterizer::DisableThreadMergerIfNeeded() {
   }
 }
 
-void Rasterizer::NotifyLowMemoryWarning() const {
+void Rasterizer::NotifyLowMemoryWarning() {
   if (!surface_) {
     FML_DLOG(INFO)
         << "Rasterizer::NotifyLowMemoryWarning called with no surface.";
@@ -127,9 +151,56 @@ void Rasterizer::NotifyLowMemoryWarning() const {
   if (!context_switch->GetResult()) {
     return;
   }
+  snapshot_surface_pool_.Clear();
   context->performDeferredCleanup(std::chrono::milliseconds(0));
 }
 
+size_t Rasterizer::GetRasterCacheBytes() const {
+  const auto& raster_cache = compositor_context_->raster_cache();
+  return raster_cache.EstimateLayerCacheByteSize() +
+         raster_cache.EstimatePictureCacheByteSize() +
+         raster_cache.EstimateDisplayListCacheByteSize();
+}
+
+size_t Rasterizer::GetResourceCacheBytes() const {
+  if (!surface_ || !surface_->GetContext()) {
+    return 0;
+  }
+  size_t bytes = 0;
+  surface_->GetContext()->getResourceCacheUsage(nullptr, &bytes);
+  return bytes;
+}
+
+void Rasterizer::PurgeRasterCache() {
+  compositor_context_->raster_cache().Clear();
+}
+
+void Rasterizer::PurgeResourceCache() {
+  if (!surface_ || !surface_->GetContext()) {
+    return;
+  }
+  auto context_switch = surface_->MakeRenderContextCurrent();
+  if (!context_switch->GetResult()) {
+    return;
+  }
+  snapshot_surface_pool_.Clear();
+  surface_->GetContext()->performDeferredCleanup(std::chrono::milliseconds(0));
+}
+
+void Rasterizer::ClearSnapshotSurfacePool() {
+  if (snapshot_surface_pool_.GetIdleSurfaceCount() == 0) {
+    return;
+  }
+  // Only render targets of the onscreen context are pooled.
+  auto context_switch =
+      surface_ ? surface_->MakeRenderContextCurrent() : nullptr;
+  if (context_switch && !context_switch->GetResult()) {
+    FML_DLOG(ERROR) << "Releasing snapshot render targets without a current "
+                       "context.";
+  }
+  snapshot_surface_pool_.Clear();
+}
+
 flutter::TextureRegistry* Rasterizer::GetTextureRegistry() {
   return &compositor_context_->texture_registry();
 }
@@ -254,10 +325,16 @@ sk_sp<SkImage> DrawSnapshot(
 sk_sp<SkImage> Rasterizer::DoMakeRasterSnapshot(
     SkISize size,
     std::function<void(SkCanvas*)> draw_callback) {
+  return DoMakeRasterSnapshots({{std::move(draw_callback), size}}).front();
+}
+
+std::vector<sk_sp<SkImage>> Rasterizer::DoMakeRasterSnapshots(
+    const std::vector<SnapshotRequest>& requests) {
   TRACE_EVENT0("flutter", __FUNCTION__);
-  sk_sp<SkImage> result;
-  SkImageInfo image_info = SkImageInfo::MakeN32Premul(
-      size.width(), size.height(), SkColorSpace::MakeSRGB());
+  std::vector<sk_sp<SkImage>> results(requests.size());
+  if (requests.empty()) {
+    return results;
+  }
 
   std::unique_ptr<Surface> pbuffer_surface;
   Surface* snapshot_surface = nullptr;
@@ -269,18 +346,25 @@ sk_sp<SkImage> Rasterizer::DoMakeRasterSnapshot(
       snapshot_surface = pbuffer_surface.get();
   }
 
+  auto make_cpu_snapshots = [&]() {
+    for (size_t i = 0; i < requests.size(); i++) {
+      const auto& request = requests[i];
+      SkImageInfo image_info = SkImageInfo::MakeN32Premul(
+          request.picture_size.width(), request.picture_size.height(),
+          SkColorSpace::MakeSRGB());
+      results[i] = DrawSnapshot(SkSurface::MakeRaster(image_info),
+                                request.draw_callback);
+    }
+  };
+
   if (!snapshot_surface) {
     // Raster surface is fine if there is no on screen surface. This might
     // happen in case of software rendering.
-    sk_sp<SkSurface> sk_surface = SkSurface::MakeRaster(image_info);
-    result = DrawSnapshot(sk_surface, draw_callback);
+    make_cpu_snapshots();
   } else {
     delegate_.GetIsGpuDisabledSyncSwitch()->Execute(
         fml::SyncSwitch::Handlers()
-            .SetIfTrue([&] {
-              sk_sp<SkSurface> surface = SkSurface::MakeRaster(image_info);
-              result = DrawSnapshot(surface, draw_callback);
-            })
+            .SetIfTrue(make_cpu_snapshots)
             .SetIfFalse([&] {
               FML_DCHECK(snapshot_surface);
               auto context_switch =
@@ -291,39 +375,58 @@ sk_sp<SkImage> Rasterizer::DoMakeRasterSnapshot(
 
               GrRecordingContext* context = snapshot_surface->GetContext();
               auto max_size = context->maxRenderTargetSize();
-              double scale_factor = std::min(
-                  1.0, static_cast<double>(max_size) /
-                           static_cast<double>(std::max(image_info.width(),
-                                                        image_info.height())));
-
-              // Scale down the render target size to the max supported by the
-              // GPU if necessary. Exceeding the max would otherwise cause a
-              // null result.
-              if (scale_factor < 1.0) {
-                image_info = image_info.makeWH(
-                    static_cast<double>(image_info.width()) * scale_factor,
-                    static_cast<double>(image_info.height()) * scale_factor);
-              }
+              // Render targets are only pooled for the on screen context. The
+              // context of a pbuffer surface goes away with the surface.
+              const bool use_pool = snapshot_surface == surface_.get();
+
+              for (size_t i = 0; i < requests.size(); i++) {
+                const auto& request = requests[i];
+                SkImageInfo image_info = SkImageInfo::MakeN32Premul(
+                    request.picture_size.width(),
+                    request.picture_size.height(), SkColorSpace::MakeSRGB());
+                double scale_factor = std::min(
+                    1.0,
+                    static_cast<double>(max_size) /
+                        static_cast<double>(std::max(image_info.width(),
+                                                     image_info.height())));
+
+                // Scale down the render target size to the max supported by
+                // the GPU if necessary. Exceeding the max would otherwise
+                // cause a null result.
+                if (scale_factor < 1.0) {
+                  image_info = image_info.makeWH(
+                      static_cast<double>(image_info.width()) * scale_factor,
+                      static_cast<double>(image_info.height()) * scale_factor);
+                }
 
-              // When there is an on screen surface, we need a render target
-              // SkSurface because we want to access texture backed images.
-              sk_sp<SkSurface> sk_surface =
-                  SkSurface::MakeRenderTarget(context,          // context
-                                              SkBudgeted::kNo,  // budgeted
-                                              image_info        // image info
-                  );
-              if (!sk_surface) {
-                FML_LOG(ERROR)
-                    << "DoMakeRasterSnapshot can not create GPU render target";
-                return;
-              }
+                // When there is an on screen surface, we need a render target
+                // SkSurface because we want to access texture backed images.
+                sk_sp<SkSurface> sk_surface =
+                    use_pool
+                        ? snapshot_surface_pool_.Acquire(context, image_info)
+                        : SkSurface::MakeRenderTarget(
+                              context,          // context
+                              SkBudgeted::kNo,  // budgeted
+                              image_info        // image info
+                          );
+                if (!sk_surface) {
+                  FML_LOG(ERROR) << "DoMakeRasterSnapshot can not create GPU "
+                                    "render target";
+                  continue;
+                }
 
-              sk_surface->getCanvas()->scale(scale_factor, scale_factor);
-              result = DrawSnapshot(sk_surface, draw_callback);
+                sk_surface->getCanvas()->scale(scale_factor, scale_factor);
+                // The snapshot is transferred to the host, so the surface is
+                // not referenced by the result and can be reused right away.
+                results[i] = DrawSnapshot(sk_surface, request.draw_callback);
+                if (use_pool) {
+                  snapshot_surface_pool_.Release(std::move(sk_surface));
+                }
+              }
             }));
   }
 
-  return result;
+  return results;
 }
 
 sk_sp<SkImage> Rasterizer::MakeRasterSnapshot(
@@ -340,6 +443,11 @@ sk_sp<SkImage> Rasterizer::MakeRasterSnapshot(sk_sp<SkPicture> picture,
                               });
 }
 
+std::vector<sk_sp<SkImage>> Rasterizer::MakeRasterSnapshots(
+    const std::vector<SnapshotRequest>& requests) {
+  return DoMakeRasterSnapshots(requests);
+}
+
 sk_sp<SkImage> Rasterizer::ConvertToRasterImage(sk_sp<SkImage> image) {
   TRACE_EVENT0("flutter", __FUNCTION__);
 
@@ -510,6 +618,13 @@ RasterStatus Rasterizer::DrawToSurface(
         raster_status == RasterStatus::kSkipAndRetry) {
       return raster_status;
     }
+    if (!embedder_root_canvas) {
+      for (const auto& [client, stream] : frame_capture_streams_) {
+        stream->CaptureFrame(frame->SkiaSurface().get(),
+                             frame_timings_recorder.GetFrameNumber(),
+                             frame_timings_recorder.GetVsyncTargetTime());
+      }
+    }
     if (shared_engine_block_thread_merging_ && raster_thread_merger_ &&
         raster_thread_merger_->IsMerged()) {
       // TODO(73620): Remove when platform views are accounted for.
@@ -534,10 +649,29 @@ RasterStatus Rasterizer::DrawToSurface(
     frame_timings_recorder.RecordRasterEnd();
     FireNextFrameCallbackIfPresent();
 
+    if (compositor_context_->raster_cache().GetDeferredEntriesCount() > 0) {
+      // The raster cache entries over the per-frame limit are not needed for
+      // this frame either. Rasterize them in the slack left in the frame
+      // budget so that the next frames can draw them from the cache.
+      PostPrepareDeferredRasterCacheEntry();
+    }
     if (surface_->GetContext()) {
-      TRACE_EVENT0("flutter", "PerformDeferredSkiaCleanup");
-      surface_->GetContext()->performDeferredCleanup(kSkiaCleanupExpiration);
+      // Purging unused resources is not needed for this frame. Let the
+      // scheduler run it in the slack left in the frame budget.
+      raster_work_scheduler_.PostTask(
+          "PerformDeferredSkiaCleanup", kSkiaCleanupEstimatedCost, [this]() {
+            if (!surface_ || !surface_->GetContext()) {
+              return;
+            }
+            auto context_switch = surface_->MakeRenderContextCurrent();
+            if (!context_switch->GetResult()) {
+              return;
+            }
+            surface_->GetContext()->performDeferredCleanup(
+                kSkiaCleanupExpiration);
+          });
     }
+    RunDeferredWork(frame_timings_recorder.GetVsyncTargetTime());
 
     return raster_status;
   }
@@ -708,6 +842,16 @@ void Rasterizer::SetNextFrameCallback(const fml::closure& callback) {
   next_frame_callback_ = callback;
 }
 
+void Rasterizer::SetFrameCaptureStream(
+    FrameCaptureStream::Client client,
+    std::unique_ptr<FrameCaptureStream> stream) {
+  if (stream) {
+    frame_capture_streams_[client] = std::move(stream);
+  } else {
+    frame_capture_streams_.erase(client);
+  }
+}
+
 void Rasterizer::SetExternalViewEmbedder(
     const std::shared_ptr<ExternalViewEmbedder>& view_embedder) {
   external_view_embedder_ = view_embedder;
@@ -728,6 +872,68 @@ void Rasterizer::FireNextFrameCallbackIfPresent() {
   callback();
 }
 
+void Rasterizer::RunDeferredWork(fml::TimePoint deadline) {
+  raster_work_scheduler_.RunUntil(deadline);
+  if (raster_work_scheduler_.GetPendingTaskCount() > 0) {
+    ScheduleDeferredWorkIdleTask(deadline);
+  }
+}
+
+void Rasterizer::PostPrepareDeferredRasterCacheEntry() {
+  // One entry is rasterized per task, so that the cost of each task is that of
+  // a single entry and the scheduler can stop in between.
+  raster_work_scheduler_.PostTask(
+      "PrepareDeferredRasterCacheEntry", kRasterCacheEntryEstimatedCost,
+      [this]() {
+        if (!surface_) {
+          return;
+        }
+        auto context_switch = surface_->MakeRenderContextCurrent();
+        if (!context_switch->GetResult()) {
+          return;
+        }
+        auto& raster_cache = compositor_context_->raster_cache();
+        if (raster_cache.PrepareNextDeferred(surface_->GetContext()) &&
+            raster_cache.GetDeferredEntriesCount() > 0) {
+          PostPrepareDeferredRasterCacheEntry();
+        }
+      });
+}
+
+void Rasterizer::ScheduleDeferredWorkIdleTask(fml::TimePoint target_time) {
+  if (deferred_work_idle_task_pending_) {
+    return;
+  }
+  deferred_work_idle_task_pending_ = true;
+  // Tasks on the raster task runner are ordered by their target time. Posting
+  // for the deadline of the last frame makes sure a frame that is already
+  // queued gets rasterized before the deferred work.
+  delegate_.GetTaskRunners().GetRasterTaskRunner()->PostTaskForTime(
+      [weak_this = weak_factory_.GetWeakPtr()]() {
+        if (!weak_this) {
+          return;
+        }
+        weak_this->deferred_work_idle_task_pending_ = false;
+        const auto slice =
+            fml::TimeDelta::FromMillisecondsF(
+                weak_this->delegate_.GetFrameBudget().count()) /
+            kDeferredWorkIdleSliceDivisor;
+        const auto now = fml::TimePoint::Now();
+        // Always make progress on at least one task so that deferred work can
+        // never be postponed indefinitely.
+        if (weak_this->raster_work_scheduler_.RunUntil(
+                now + slice + RasterWorkScheduler::kDefaultSafetyMargin) ==
+            0) {
+          weak_this->raster_work_scheduler_.RunNext();
+        }
+        if (weak_this->raster_work_scheduler_.GetPendingTaskCount() > 0) {
+          weak_this->ScheduleDeferredWorkIdleTask(fml::TimePoint::Now() +
+                                                  slice);
+        }
+      },
+      target_time);
+}
+
 void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
   user_override_resource_cache_bytes_ |= from_user;
 
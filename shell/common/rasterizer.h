@@ -5,6 +5,7 @@
 #ifndef SHELL_COMMON_RASTERIZER_H_
 #define SHELL_COMMON_RASTERIZER_H_
 
+#include <map>
 #include <memory>
 #include <optional>
 
@@ -23,7 +24,10 @@
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
+#include "flutter/shell/common/frame_capture.h"
 #include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/raster_work_scheduler.h"
+#include "flutter/shell/common/snapshot_surface_pool.h"
 #include "flutter/shell/common/snapshot_surface_producer.h"
 
 namespace flutter {
@@ -140,9 +144,36 @@ class Rasterizer final : public SnapshotDelegate {
   /// @brief      Notifies the rasterizer that there is a low memory situation
   ///             and it must purge as many unnecessary resources as possible.
   ///             Currently, the Skia context associated with onscreen rendering
-  ///             is told to free GPU resources.
+  ///             is told to free GPU resources and the render targets pooled
+  ///             for raster snapshots are released.
   ///
-  void NotifyLowMemoryWarning() const;
+  void NotifyLowMemoryWarning();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns an estimate of the bytes held by the layers and
+  ///             pictures in the raster cache.
+  ///
+  size_t GetRasterCacheBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the bytes held by the resource cache of the Skia
+  ///             context associated with onscreen rendering, or zero if there
+  ///             is no such context.
+  ///
+  size_t GetResourceCacheBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops all the layers and pictures in the raster cache. They
+  ///             are rasterized again when they are next cached.
+  ///
+  void PurgeRasterCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Frees the resources in the resource cache of the Skia context
+  ///             associated with onscreen rendering that are not in use,
+  ///             including the render targets pooled for raster snapshots.
+  ///
+  void PurgeResourceCache();
 
   //----------------------------------------------------------------------------
   /// @brief      Gets a weak pointer to the rasterizer. The rasterizer may only
@@ -324,6 +355,24 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   Screenshot ScreenshotLastLayerTree(ScreenshotType type, bool base64_encode);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the stream that captures the contents of each frame
+  ///             rendered to the on-screen surface. Unlike
+  ///             `ScreenshotLastLayerTree`, capturing does not render the layer
+  ///             tree again. Frames are captured right after they are
+  ///             rasterized and before they are submitted.
+  ///
+  ///             Frames are not captured if an external view embedder renders
+  ///             the root surface.
+  ///
+  /// @param[in]  client  The consumer of the stream. Each consumer has its own
+  ///                     stream, which only it replaces.
+  /// @param[in]  stream  The frame capture stream, or `nullptr` to stop
+  ///                     capturing frames for the consumer.
+  ///
+  void SetFrameCaptureStream(FrameCaptureStream::Client client,
+                             std::unique_ptr<FrameCaptureStream> stream);
+
   //----------------------------------------------------------------------------
   /// @brief      Sets a callback that will be executed when the next layer tree
   ///             in rendered to the on-screen surface. This is used by
@@ -455,12 +504,20 @@ class Rasterizer final : public SnapshotDelegate {
   // thread configuration. This will be inserted to the front of the pipeline.
   std::unique_ptr<flutter::LayerTree> resubmitted_layer_tree_;
   fml::closure next_frame_callback_;
+  std::map<FrameCaptureStream::Client, std::unique_ptr<FrameCaptureStream>>
+      frame_capture_streams_;
   bool user_override_resource_cache_bytes_;
   std::optional<size_t> max_cache_bytes_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
   std::shared_ptr<ExternalViewEmbedder> external_view_embedder_;
   bool shared_engine_block_thread_merging_ = false;
+  // Optional work that is run in the slack left in the frame budget after a
+  // frame has been submitted. See `Rasterizer::RunDeferredWork`.
+  RasterWorkScheduler raster_work_scheduler_;
+  bool deferred_work_idle_task_pending_ = false;
+  // Render targets reused across raster snapshots of the same size.
+  SnapshotSurfacePool snapshot_surface_pool_;
 
   // |SnapshotDelegate|
   sk_sp<SkImage> MakeRasterSnapshot(
@@ -474,6 +531,10 @@ class Rasterizer final : public SnapshotDelegate {
   // |SnapshotDelegate|
   sk_sp<SkImage> ConvertToRasterImage(sk_sp<SkImage> image) override;
 
+  // |SnapshotDelegate|
+  std::vector<sk_sp<SkImage>> MakeRasterSnapshots(
+      const std::vector<SnapshotRequest>& requests) override;
+
   sk_sp<SkData> ScreenshotLayerTreeAsImage(
       flutter::LayerTree* tree,
       flutter::CompositorContext& compositor_context,
@@ -484,6 +545,13 @@ class Rasterizer final : public SnapshotDelegate {
       SkISize size,
       std::function<void(SkCanvas*)> draw_callback);
 
+  std::vector<sk_sp<SkImage>> DoMakeRasterSnapshots(
+      const std::vector<SnapshotRequest>& requests);
+
+  // Releases the render targets pooled for raster snapshots with the onscreen
+  // context current.
+  void ClearSnapshotSurfacePool();
+
   RasterStatus DoDraw(
       std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder,
       std::unique_ptr<flutter::LayerTree> layer_tree);
@@ -493,6 +561,22 @@ class Rasterizer final : public SnapshotDelegate {
 
   void FireNextFrameCallbackIfPresent();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Runs as much of the deferred raster work as fits before the
+  ///             given deadline. If work remains, a task is posted to finish
+  ///             it in short slices once the raster task runner is idle.
+  ///
+  /// @param[in]  deadline  The vsync target time of the frame that was just
+  ///                       rasterized.
+  ///
+  void RunDeferredWork(fml::TimePoint deadline);
+
+  void ScheduleDeferredWorkIdleTask(fml::TimePoint target_time);
+
+  // Posts deferred work that rasterizes the raster cache entries that went
+  // over the per-frame limit of the cache, one entry per task.
+  void PostPrepareDeferredRasterCacheEntry();
+
   static bool NoDiscard(const flutter::LayerTree& layer_tree) { return false; }
 
   FML_DISALLOW_COPY_AND_ASSIGN(Rasterizer);
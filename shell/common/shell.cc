@@ -5,7 +5,9 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include "flutter/shell/common/shell.h"
 
+#include <array>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -20,9 +22,12 @@
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/lib/ui/painting/animated_frame_decoder.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
+#include "flutter/shell/common/startup_task_graph.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
 #include "rapidjson/stringbuffer.h"
@@ -31,6 +36,8 @@
 #include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/skia/include/utils/SkBase64.h"
 #include "third_party/tonic/common/log.h"
+#include "txt/hyphenation_registry.h"
+#include "txt/layout_cache.h"
 
 namespace flutter {
 
@@ -74,7 +81,8 @@ std::unique_ptr<Engine> CreateEngine(
 // TODO(chinmaygarde): The unfortunate side effect of this call is that settings
 // that cause shell initialization failures will still lead to some of their
 // settings being applied.
-void PerformInitializationTasks(Settings& settings) {
+void PerformInitializationTasks(Settings& settings,
+                                StartupTaskGraph& startup_graph) {
   {
     fml::LogSettings log_settings;
     log_settings.min_log_level =
@@ -82,8 +90,16 @@ void PerformInitializationTasks(Settings& settings) {
     fml::SetLogSettings(log_settings);
   }
 
+  // Signaled once the process-wide steps added to the graph of the first
+  // shell have run. Shells created concurrently with the first wait on it.
+  static fml::ManualResetWaitableEvent gProcessInitialized;
+  bool initializes_process = false;
+
   static std::once_flag gShellSettingsInitialization = {};
-  std::call_once(gShellSettingsInitialization, [&settings] {
+  std::call_once(gShellSettingsInitialization, [&settings, &startup_graph,
+                                                &initializes_process] {
+    initializes_process = true;
+
     if (settings.engine_start_timestamp.count() == 0) {
       settings.engine_start_timestamp =
           std::chrono::microseconds(Dart_TimelineGetMicros());
@@ -100,24 +116,98 @@ void PerformInitializationTasks(Settings& settings) {
       fml::tracing::TraceSetAllowlist(settings.trace_allowlist);
     }
 
+    // The shaped word cache of libtxt is shared by all the engines in the
+    // process, so its budget is set once for the process.
+    if (settings.text_layout_cache_bytes != 0) {
+      txt::SetLayoutCacheBudget(settings.text_layout_cache_bytes);
+    }
+
+    // The animated frame decoders share their cache budget across engines,
+    // so their options are set once for the process.
+    AnimatedFrameDecoder::Options animated_frame_options;
+    if (settings.animated_image_decode_ahead_frames >= 0) {
+      animated_frame_options.decode_ahead_frames =
+          settings.animated_image_decode_ahead_frames;
+    }
+    if (settings.animated_image_frame_cache_bytes >= 0) {
+      animated_frame_options.frame_cache_bytes =
+          settings.animated_image_frame_cache_bytes;
+    }
+    AnimatedFrameDecoder::SetDefaultOptions(animated_frame_options);
+
+    // Tracing is set up by now. The remaining steps are independent of each
+    // other and of the creation of the VM.
+    std::vector<StartupTaskGraph::TaskId> process_tasks;
     if (!settings.skia_deterministic_rendering_on_cpu) {
-      SkGraphics::Init();
+      process_tasks.push_back(startup_graph.AddTask(
+          "SkGraphics::Init", [] { SkGraphics::Init(); }));
     } else {
       FML_DLOG(INFO) << "Skia deterministic rendering is enabled.";
     }
 
     if (settings.icu_initialization_required) {
       if (settings.icu_data_path.size() != 0) {
-        fml::icu::InitializeICU(settings.icu_data_path);
+        process_tasks.push_back(startup_graph.AddTask(
+            "InitializeICU", [icu_data_path = settings.icu_data_path] {
+              fml::icu::InitializeICU(icu_data_path);
+            }));
       } else if (settings.icu_mapper) {
-        fml::icu::InitializeICUFromMapping(settings.icu_mapper());
+        process_tasks.push_back(startup_graph.AddTask(
+            "InitializeICU", [icu_mapper = settings.icu_mapper] {
+              fml::icu::InitializeICUFromMapping(icu_mapper());
+            }));
       } else {
         FML_DLOG(WARNING) << "Skipping ICU initialization in the shell.";
       }
     }
+
+    startup_graph.AddTask(
+        "ProcessInitialized", [] { gProcessInitialized.Signal(); },
+        std::move(process_tasks));
   });
 
+  // The first shell runs the process-wide steps as part of its own graph.
+  // Other shells must not create a VM or a shell before they have completed.
+  if (!initializes_process) {
+    gProcessInitialized.Wait();
+  }
+
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+
+  // Every shell registers its dictionaries so that engines for other locales
+  // can add theirs. The registry keeps the dictionaries already in use.
+  for (const auto& [locale, path] : settings.hyphenation_dictionaries) {
+    // Paths starting with a separator or a drive letter are absolute.
+    bool is_absolute = !path.empty() && (path[0] == '/' || path[0] == '\\' ||
+                                         path.find(':') != std::string::npos);
+    std::string dictionary_path =
+        is_absolute || settings.assets_path.empty()
+            ? path
+            : fml::paths::JoinPaths({settings.assets_path, path});
+    if (!txt::HyphenationRegistry::GetInstance().RegisterDictionary(
+            locale, dictionary_path)) {
+      FML_DLOG(INFO) << "The hyphenation dictionary of " << locale
+                     << " is already in use and was not replaced.";
+    }
+  }
+}
+
+// Returns the runners the independent startup steps of a shell are posted to.
+// The IO and raster threads of the shell are idle until it has been created.
+std::vector<fml::RefPtr<fml::TaskRunner>> GetStartupRunners(
+    const Settings& settings,
+    const TaskRunners& task_runners) {
+  if (!settings.enable_concurrent_startup) {
+    return {};
+  }
+  return {task_runners.GetIOTaskRunner(), task_runners.GetRasterTaskRunner()};
+}
+
+void PerformInitializationTasks(Settings& settings,
+                                const TaskRunners& task_runners) {
+  StartupTaskGraph startup_graph;
+  PerformInitializationTasks(settings, startup_graph);
+  startup_graph.Run(GetStartupRunners(settings, task_runners));
 }
 
 }  // namespace
@@ -130,27 +220,44 @@ std::unique_ptr<Shell> Shell::Create(
     const Shell::CreateCallback<Rasterizer>& on_create_rasterizer,
     bool is_gpu_disabled) {
   // This must come first as it initializes tracing.
-  PerformInitializationTasks(settings);
+  StartupTaskGraph startup_graph;
+  PerformInitializationTasks(settings, startup_graph);
 
   TRACE_EVENT0("flutter", "Shell::Create");
 
   // Always use the `vm_snapshot` and `isolate_snapshot` provided by the
   // settings to launch the VM.  If the VM is already running, the snapshot
   // arguments are ignored.
-  auto vm_snapshot = DartSnapshot::VMSnapshotFromSettings(settings);
-  auto isolate_snapshot = DartSnapshot::IsolateSnapshotFromSettings(settings);
-  auto vm = DartVMRef::Create(settings, vm_snapshot, isolate_snapshot);
-  FML_CHECK(vm) << "Must be able to initialize the VM.";
+  fml::RefPtr<const DartSnapshot> vm_snapshot;
+  fml::RefPtr<const DartSnapshot> isolate_snapshot;
+  std::optional<DartVMRef> vm;
+  auto map_vm_snapshot = startup_graph.AddTask("MapVMSnapshot", [&] {
+    vm_snapshot = DartSnapshot::VMSnapshotFromSettings(settings);
+  });
+  auto map_isolate_snapshot = startup_graph.AddTask("MapIsolateSnapshot", [&] {
+    isolate_snapshot = DartSnapshot::IsolateSnapshotFromSettings(settings);
+  });
+  // The VM is created on this thread, like it was before startup steps could
+  // run concurrently.
+  startup_graph.AddTask(
+      "CreateDartVM",
+      [&] {
+        vm.emplace(DartVMRef::Create(settings, vm_snapshot, isolate_snapshot));
+      },
+      {map_vm_snapshot, map_isolate_snapshot},
+      StartupTaskGraph::Affinity::kCallingThread);
+  startup_graph.Run(GetStartupRunners(settings, task_runners));
+  FML_CHECK(vm && *vm) << "Must be able to initialize the VM.";
 
   // If the settings did not specify an `isolate_snapshot`, fall back to the
   // one the VM was launched with.
   if (!isolate_snapshot) {
-    isolate_snapshot = vm->GetVMData()->GetIsolateSnapshot();
+    isolate_snapshot = (*vm)->GetVMData()->GetIsolateSnapshot();
   }
   return CreateWithSnapshot(std::move(platform_data),            //
                             std::move(task_runners),             //
                             std::move(settings),                 //
-                            std::move(vm),                       //
+                            std::move(*vm),                      //
                             std::move(isolate_snapshot),         //
                             std::move(on_create_platform_view),  //
                             std::move(on_create_rasterizer),     //
@@ -309,7 +416,7 @@ std::unique_ptr<Shell> Shell::CreateWithSnapshot(
     const Shell::EngineCreateCallback& on_create_engine,
     bool is_gpu_disabled) {
   // This must come first as it initializes tracing.
-  PerformInitializationTasks(settings);
+  PerformInitializationTasks(settings, task_runners);
 
   TRACE_EVENT0("flutter", "Shell::CreateWithSnapshot");
 
@@ -415,6 +522,19 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolEstimateRasterCacheMemory, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetImageMemoryUsageExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetImageMemoryUsage, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kSetFrameCaptureExtensionName] = {
+      task_runners_.GetRasterTaskRunner(),
+      std::bind(&Shell::OnServiceProtocolSetFrameCapture, this,
+                std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetCapturedFrameExtensionName] =
+      {task_runners_.GetRasterTaskRunner(),
+       std::bind(&Shell::OnServiceProtocolGetCapturedFrame, this,
+                 std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -474,6 +594,17 @@ std::unique_ptr<Shell> Shell::Spawn(
     RunConfiguration run_configuration,
     const CreateCallback<PlatformView>& on_create_platform_view,
     const CreateCallback<Rasterizer>& on_create_rasterizer) const {
+  auto result = SpawnIdle(on_create_platform_view, on_create_rasterizer);
+  if (result) {
+    result->RunEngine(std::move(run_configuration));
+  }
+  return result;
+}
+
+std::unique_ptr<Shell> Shell::SpawnIdle(
+    const CreateCallback<PlatformView>& on_create_platform_view,
+    const CreateCallback<Rasterizer>& on_create_rasterizer) const {
+  TRACE_EVENT0("flutter", "Shell::SpawnIdle");
   FML_DCHECK(task_runners_.IsValid());
   auto shell_maker = [&](bool is_gpu_disabled) {
     std::unique_ptr<Shell> result(CreateWithSnapshot(
@@ -503,8 +634,10 @@ std::unique_ptr<Shell> Shell::Spawn(
       fml::SyncSwitch::Handlers()
           .SetIfFalse([&] { result = shell_maker(false); })
           .SetIfTrue([&] { result = shell_maker(true); }));
+  if (!result) {
+    return nullptr;
+  }
   result->shared_resource_context_ = io_manager_->GetSharedResourceContext();
-  result->RunEngine(std::move(run_configuration));
 
   task_runners_.GetRasterTaskRunner()->PostTask(
       [rasterizer = rasterizer_->GetWeakPtr(),
@@ -530,6 +663,13 @@ void Shell::NotifyLowMemoryWarning() const {
   // running.
   ::Dart_NotifyLowMemory();
 
+  // Shaped words can be shaped again when they are next laid out.
+  txt::PurgeLayoutCache();
+
+  // Images can be decoded again when they are next requested.
+  DecodedImageCache::GetInstance().Purge();
+  AnimatedFrameDecoder::PurgeCachedFrames();
+
   task_runners_.GetRasterTaskRunner()->PostTask(
       [rasterizer = rasterizer_->GetWeakPtr(), trace_id = trace_id]() {
         if (rasterizer) {
@@ -643,6 +783,10 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
 
+  // The queue is thread safe, and outlives the engine for the raster task
+  // runner's measurements of the image memory.
+  image_upload_queue_ = engine_->GetImageUploadQueue();
+
   // Setup the time-consuming default font manager right after engine created.
   fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
                                     [engine = weak_engine_] {
@@ -1371,6 +1515,83 @@ size_t Shell::UnreportedFramesCount() const {
   return unreported_timings_.size() / (FrameTiming::kCount + 1);
 }
 
+ImageMemoryUsage Shell::GetImageMemoryUsage() const {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  ImageMemoryUsage usage = ImageMemoryUsage::GetSharedUsage();
+  if (image_upload_queue_) {
+    usage.bytes[ImageMemoryUsage::kDecodePipeline] =
+        image_upload_queue_->GetReservedBytes();
+  }
+  usage.bytes[ImageMemoryUsage::kRasterCache] =
+      rasterizer_->GetRasterCacheBytes();
+  usage.bytes[ImageMemoryUsage::kResourceCache] =
+      rasterizer_->GetResourceCacheBytes();
+  return usage;
+}
+
+void Shell::CheckImageMemory() {
+  const int64_t ceiling = settings_.image_memory_ceiling_bytes;
+#if FLUTTER_RELEASE
+  // Without a ceiling, the usage is only measured for the timeline, which
+  // release builds do not have.
+  if (ceiling < 0) {
+    return;
+  }
+#endif  // FLUTTER_RELEASE
+
+  const ImageMemoryUsage usage = GetImageMemoryUsage();
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER(
+      "flutter", "ImageMemory", reinterpret_cast<int64_t>(this),
+      ImageMemoryUsage::GetCategoryName(ImageMemoryUsage::kDecodePipeline),
+      usage.bytes[ImageMemoryUsage::kDecodePipeline],
+      ImageMemoryUsage::GetCategoryName(ImageMemoryUsage::kImages),
+      usage.bytes[ImageMemoryUsage::kImages],
+      ImageMemoryUsage::GetCategoryName(ImageMemoryUsage::kDecodedImageCache),
+      usage.bytes[ImageMemoryUsage::kDecodedImageCache],
+      ImageMemoryUsage::GetCategoryName(ImageMemoryUsage::kAnimatedFrames),
+      usage.bytes[ImageMemoryUsage::kAnimatedFrames],
+      ImageMemoryUsage::GetCategoryName(ImageMemoryUsage::kRasterCache),
+      usage.bytes[ImageMemoryUsage::kRasterCache],
+      ImageMemoryUsage::GetCategoryName(ImageMemoryUsage::kResourceCache),
+      usage.bytes[ImageMemoryUsage::kResourceCache]);
+#endif  // !FLUTTER_RELEASE
+
+  if (ceiling < 0 ||
+      usage.GetTrimmableTotal() <= static_cast<size_t>(ceiling)) {
+    return;
+  }
+
+  // Trimming is not free, and the caches refill over a few frames, so it is
+  // only attempted once per second.
+  const fml::TimePoint now = fml::TimePoint::Now();
+  if (now - last_image_memory_trim_ < fml::TimeDelta::FromSeconds(1)) {
+    return;
+  }
+  last_image_memory_trim_ = now;
+  TRACE_EVENT0("flutter", "Shell::TrimImageMemory");
+
+  // The decoded image cache and the animated frames are shared with the other
+  // engines, so only the bytes over the ceiling are evicted from them. The
+  // caches of this engine are purged whole.
+  std::array<ImageMemoryUsage::Trim, ImageMemoryUsage::kCategoryCount> trims;
+  trims[ImageMemoryUsage::kDecodedImageCache] = [](size_t bytes) {
+    DecodedImageCache::GetInstance().Trim(bytes);
+  };
+  trims[ImageMemoryUsage::kAnimatedFrames] = [](size_t bytes) {
+    AnimatedFrameDecoder::TrimCachedFrames(bytes);
+  };
+  trims[ImageMemoryUsage::kRasterCache] = [this](size_t) {
+    rasterizer_->PurgeRasterCache();
+  };
+  trims[ImageMemoryUsage::kResourceCache] = [this](size_t) {
+    rasterizer_->PurgeResourceCache();
+  };
+  ImageMemoryUsage::TrimToCeiling(usage, ceiling, trims,
+                                  [this]() { return GetImageMemoryUsage(); });
+}
+
 void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
@@ -1381,6 +1602,8 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  CheckImageMemory();
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1713,6 +1936,125 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
   return true;
 }
 
+// Service protocol handler
+bool Shell::OnServiceProtocolGetImageMemoryUsage(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  const ImageMemoryUsage usage = GetImageMemoryUsage();
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "ImageMemoryUsage", allocator);
+  for (size_t i = 0; i < ImageMemoryUsage::kCategoryCount; i++) {
+    const auto category = static_cast<ImageMemoryUsage::Category>(i);
+    response->AddMember(
+        rapidjson::StringRef(ImageMemoryUsage::GetCategoryName(category)),
+        static_cast<uint64_t>(usage.bytes[i]), allocator);
+  }
+  response->AddMember<uint64_t>("totalBytes", usage.GetTotal(), allocator);
+  response->AddMember<uint64_t>("trimmableBytes", usage.GetTrimmableTotal(),
+                                allocator);
+  response->AddMember<int64_t>("ceilingBytes",
+                               settings_.image_memory_ceiling_bytes, allocator);
+
+  // The decoded image cache is shared with the other engines.
+  const DecodedImageCache::Stats cache_stats =
+      DecodedImageCache::GetInstance().GetStats();
+  rapidjson::Value cache(rapidjson::kObjectType);
+  cache.AddMember<uint64_t>("hits", cache_stats.hits, allocator);
+  cache.AddMember<uint64_t>("misses", cache_stats.misses, allocator);
+  cache.AddMember<uint64_t>("coalesced", cache_stats.coalesced, allocator);
+  cache.AddMember<uint64_t>("evictions", cache_stats.evictions, allocator);
+  cache.AddMember<uint64_t>("entries", cache_stats.entries, allocator);
+  response->AddMember("decodedImageCache", cache, allocator);
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolSetFrameCapture(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  auto enabled_param = params.find("enabled");
+  if (enabled_param == params.end()) {
+    ServiceProtocolParameterError(response, "'enabled' parameter is missing.");
+    return false;
+  }
+  const bool enabled = enabled_param->second == "true";
+
+  size_t buffer_count = FrameCaptureStream::kMaxBufferCount;
+  auto buffer_count_param = params.find("bufferCount");
+  if (buffer_count_param != params.end()) {
+    std::stringstream stream(std::string{buffer_count_param->second});
+    if (!(stream >> buffer_count)) {
+      ServiceProtocolParameterError(response,
+                                    "'bufferCount' parameter is invalid.");
+      return false;
+    }
+  }
+
+  latest_captured_frame_ = nullptr;
+  if (enabled) {
+    rasterizer_->SetFrameCaptureStream(
+        FrameCaptureStream::Client::kServiceProtocol,
+        std::make_unique<FrameCaptureStream>(
+            buffer_count, [this](fml::RefPtr<CapturedFrame> frame) {
+              latest_captured_frame_ = std::move(frame);
+            }));
+  } else {
+    rasterizer_->SetFrameCaptureStream(
+        FrameCaptureStream::Client::kServiceProtocol, nullptr);
+  }
+
+  response->SetObject();
+  response->AddMember("type", "Success", response->GetAllocator());
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetCapturedFrame(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  // Each captured frame is only returned once.
+  auto frame = std::move(latest_captured_frame_);
+  SkPixmap pixmap;
+  if (!frame || !frame->PeekPixels(&pixmap)) {
+    ServiceProtocolFailureError(
+        response, "No frame was captured since the last request.");
+    return false;
+  }
+
+  const size_t byte_size = pixmap.computeByteSize();
+  size_t b64_size = SkBase64::Encode(pixmap.addr(), byte_size, nullptr);
+  auto b64_data = SkData::MakeUninitialized(b64_size);
+  SkBase64::Encode(pixmap.addr(), byte_size, b64_data->writable_data());
+
+  response->SetObject();
+  auto& allocator = response->GetAllocator();
+  response->AddMember("type", "CapturedFrame", allocator);
+  response->AddMember<uint64_t>("frameNumber", frame->frame_number(),
+                                allocator);
+  response->AddMember<int64_t>(
+      "vsyncTargetTimeMicros",
+      frame->vsync_target_time().ToEpochDelta().ToMicroseconds(), allocator);
+  response->AddMember<int64_t>(
+      "captureTimeMicros",
+      frame->capture_time().ToEpochDelta().ToMicroseconds(), allocator);
+  response->AddMember("width", pixmap.width(), allocator);
+  response->AddMember("height", pixmap.height(), allocator);
+  response->AddMember<uint64_t>("rowBytes", pixmap.rowBytes(), allocator);
+  response->AddMember(
+      "colorType",
+      pixmap.colorType() == kBGRA_8888_SkColorType ? "bgra8888" : "rgba8888",
+      allocator);
+  rapidjson::Value pixels;
+  pixels.SetString(static_cast<const char*>(b64_data->data()),
+                   b64_data->size(), allocator);
+  response->AddMember("pixels", pixels, allocator);
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1786,6 +2128,25 @@ Rasterizer::Screenshot Shell::Screenshot(
   return screenshot;
 }
 
+void Shell::SetFrameCaptureCallback(
+    size_t buffer_count,
+    FrameCaptureStream::FrameCallback callback) {
+  TRACE_EVENT0("flutter", "Shell::SetFrameCaptureCallback");
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners_.GetRasterTaskRunner(),
+      [rasterizer = GetRasterizer(), buffer_count,
+       callback = std::move(callback)]() {
+        if (!rasterizer) {
+          return;
+        }
+        rasterizer->SetFrameCaptureStream(
+            FrameCaptureStream::Client::kEmbedder,
+            callback ? std::make_unique<FrameCaptureStream>(buffer_count,
+                                                            callback)
+                     : nullptr);
+      });
+}
+
 fml::Status Shell::WaitForFirstFrame(fml::TimeDelta timeout) {
   FML_DCHECK(is_setup_);
   if (task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread() ||
@@ -26,6 +26,7 @@
 #include "flutter/fml/thread.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/painting/image_generator_registry.h"
+#include "flutter/lib/ui/painting/image_memory_usage.h"
 #include "flutter/lib/ui/semantics/custom_accessibility_action.h"
 #include "flutter/lib/ui/semantics/semantics_node.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
@@ -197,6 +198,19 @@ class Shell final : public PlatformView::Delegate,
       const CreateCallback<PlatformView>& on_create_platform_view,
       const CreateCallback<Rasterizer>& on_create_rasterizer) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a Shell the same way as `Spawn` but does not run it.
+  ///             The engine, rasterizer and platform view of the new Shell
+  ///             are set up, but its root isolate is only launched once
+  ///             `RunEngine` is called on it. This lets the Shell and its
+  ///             rasterizer be set up ahead of time, but not its isolate.
+  ///
+  /// @see        `SpawnedShellPool`
+  ///
+  std::unique_ptr<Shell> SpawnIdle(
+      const CreateCallback<PlatformView>& on_create_platform_view,
+      const CreateCallback<Rasterizer>& on_create_rasterizer) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Starts an isolate for the given RunConfiguration.
   ///
@@ -298,6 +312,24 @@ class Shell final : public PlatformView::Delegate,
   Rasterizer::Screenshot Screenshot(Rasterizer::ScreenshotType type,
                                     bool base64_encode);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Starts or stops streaming the contents of each frame rendered
+  ///             by the rasterizer in this shell to the embedder. Frames are
+  ///             handed out as they are rendered, without rendering the layer
+  ///             tree again. Captures requested through the service protocol
+  ///             use a stream of their own and are not affected.
+  ///
+  /// @see        `FrameCaptureStream`
+  ///
+  /// @param[in]  buffer_count  The number of captured frames the callback may
+  ///                           hold on to at the same time.
+  /// @param[in]  callback      The callback invoked on the raster task runner
+  ///                           with each captured frame. A null callback stops
+  ///                           capturing frames.
+  ///
+  void SetFrameCaptureCallback(size_t buffer_count,
+                               FrameCaptureStream::FrameCallback callback);
+
   //----------------------------------------------------------------------------
   /// @brief      Pauses the calling thread until the first frame is presented.
   ///
@@ -451,6 +483,18 @@ class Shell final : public PlatformView::Delegate,
 
   sk_sp<GrDirectContext> shared_resource_context_;
 
+  // The most recent frame captured for the service protocol. Only accessed on
+  // the raster task runner.
+  fml::RefPtr<CapturedFrame> latest_captured_frame_;
+
+  // The upload queue of the engine's image decoder, which is thread safe, for
+  // measuring the images in the decode pipeline from the raster task runner.
+  std::shared_ptr<TextureUploadQueue> image_upload_queue_;
+
+  // When the image caches were last trimmed for exceeding the image memory
+  // ceiling. Only accessed on the raster task runner.
+  fml::TimePoint last_image_memory_trim_;
+
   Shell(DartVMRef vm,
         TaskRunners task_runners,
         Settings settings,
@@ -485,6 +529,15 @@ class Shell final : public PlatformView::Delegate,
 
   void ReportTimings();
 
+  // Measures the memory held by the images of this shell. Called on the raster
+  // task runner.
+  ImageMemoryUsage GetImageMemoryUsage() const;
+
+  // Reports the image memory to the timeline and, when it exceeds the ceiling
+  // in the settings, trims the image caches from the cheapest to refill to the
+  // most expensive until it no longer does. Called after each rasterized frame.
+  void CheckImageMemory();
+
   // |PlatformView::Delegate|
   void OnPlatformViewCreated(std::unique_ptr<Surface> surface) override;
 
@@ -662,6 +715,23 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  bool OnServiceProtocolGetImageMemoryUsage(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  bool OnServiceProtocolSetFrameCapture(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // The returned pixels are base64 encoded.
+  bool OnServiceProtocolGetCapturedFrame(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Creates an asset bundle from the original settings asset path or
   // directory.
   std::unique_ptr<DirectoryAssetBundle> RestoreOriginalAssetResolver();
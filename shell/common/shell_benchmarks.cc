@@ -7,26 +7,52 @@
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/fml/logging.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/spawned_shell_pool.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
+#include "flutter/testing/test_dart_native_resolver.h"
 #include "flutter/testing/testing.h"
 
 namespace flutter {
 
+// Whether a shell has been created in this process. The process-wide startup
+// steps, like Skia and ICU initialization, only run for the first one, whose
+// startup time is reported separately as the "cold_startup_ms" counter. Run a
+// single benchmark per process with --benchmark_filter to measure a cold start
+// for each configuration.
+static bool g_process_initialized = false;
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
-                                    bool measure_shutdown) {
+                                    bool measure_shutdown,
+                                    bool concurrent_startup = true,
+                                    bool wait_for_first_frame = false) {
   auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
                                        fml::FilePermission::kRead);
   std::unique_ptr<Shell> shell;
   std::unique_ptr<ThreadHost> thread_host;
   testing::ELFAOTSymbols aot_symbols;
+  auto native_resolver = std::make_shared<testing::TestDartNativeResolver>();
+  fml::AutoResetWaitableEvent first_frame_latch;
+  native_resolver->AddNativeCallback(
+      "NativeOnBeginFrame",
+      CREATE_NATIVE_ENTRY([&first_frame_latch](Dart_NativeArguments) {
+        first_frame_latch.Signal();
+      }));
+  const bool first_in_process = !g_process_initialized;
+  g_process_initialized = true;
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_startup);
+    const fml::TimePoint start = fml::TimePoint::Now();
     Settings settings = {};
     settings.task_observer_add = [](intptr_t, fml::closure) {};
     settings.task_observer_remove = [](intptr_t) {};
+    settings.isolate_create_callback = [native_resolver]() {
+      native_resolver->SetNativeResolverForIsolate();
+    };
+    settings.enable_concurrent_startup = concurrent_startup;
+    settings.assets_path = testing::GetFixturesPath();
 
     if (DartVM::IsRunningPrecompiledCode()) {
       aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
@@ -60,9 +86,35 @@ static void StartupAndShutdownShell(benchmark::State& state,
           return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
         },
         [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
-  }
+    FML_CHECK(shell);
 
-  FML_CHECK(shell);
+    // The benchmark shell has no rendering surface, so the first frame is
+    // taken to be ready once the framework is asked to build it.
+    if (wait_for_first_frame) {
+      auto configuration = RunConfiguration::InferFromSettings(settings);
+      configuration.SetEntrypoint("onBeginFrameMain");
+      shell->RunEngine(std::move(configuration));
+      fml::TaskRunner::RunNowOrPostTask(
+          thread_host->platform_thread->GetTaskRunner(),
+          [platform_view = shell->GetPlatformView()]() {
+            if (platform_view) {
+              platform_view->SetViewportMetrics({1.0, 800, 600, 22});
+            }
+          });
+      fml::TaskRunner::RunNowOrPostTask(thread_host->ui_thread->GetTaskRunner(),
+                                        [engine = shell->GetEngine()]() {
+                                          if (engine) {
+                                            engine->ScheduleFrame();
+                                          }
+                                        });
+      first_frame_latch.Wait();
+    }
+
+    if (measure_startup && first_in_process) {
+      state.counters["cold_startup_ms"] =
+          (fml::TimePoint::Now() - start).ToMillisecondsF();
+    }
+  }
 
   {
     // The ui thread could be busy processing tasks after shell created, e.g.,
@@ -96,13 +148,17 @@ static void StartupAndShutdownShell(benchmark::State& state,
   FML_CHECK(!shell);
 }
 
+// The argument selects whether independent startup steps run concurrently.
 static void BM_ShellInitialization(benchmark::State& state) {
   while (state.KeepRunning()) {
-    StartupAndShutdownShell(state, true, false);
+    StartupAndShutdownShell(state, true, false, state.range(0) != 0);
   }
 }
 
-BENCHMARK(BM_ShellInitialization);
+BENCHMARK(BM_ShellInitialization)
+    ->ArgName("concurrent_startup")
+    ->Arg(0)
+    ->Arg(1);
 
 static void BM_ShellShutdown(benchmark::State& state) {
   while (state.KeepRunning()) {
@@ -114,10 +170,125 @@ BENCHMARK(BM_ShellShutdown);
 
 static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
   while (state.KeepRunning()) {
-    StartupAndShutdownShell(state, true, true);
+    StartupAndShutdownShell(state, true, true, state.range(0) != 0);
   }
 }
 
-BENCHMARK(BM_ShellInitializationAndShutdown);
+BENCHMARK(BM_ShellInitializationAndShutdown)
+    ->ArgName("concurrent_startup")
+    ->Arg(0)
+    ->Arg(1);
+
+// Measures the time from the creation of a shell to the first frame its
+// framework is asked to build.
+static void BM_ShellTimeToFirstFrame(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    StartupAndShutdownShell(state, true, false, state.range(0) != 0, true);
+  }
+}
+
+BENCHMARK(BM_ShellTimeToFirstFrame)
+    ->ArgName("concurrent_startup")
+    ->Arg(0)
+    ->Arg(1);
+
+// Measures how long it takes to get a running shell spawned from another
+// shell, either directly or from a `SpawnedShellPool` that is refilled
+// between iterations. The argument selects whether the pool is used. Pooled
+// runs also report the spawn time that the pool saved per iteration. Both
+// launch the root isolate of the shell within the measured time, since the
+// pool does not prewarm isolates.
+static void BM_ShellSpawn(benchmark::State& state) {
+  const bool use_pool = state.range(0) != 0;
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = {};
+  settings.task_observer_add = [](intptr_t, fml::closure) {};
+  settings.task_observer_remove = [](intptr_t) {};
+  settings.assets_path = testing::GetFixturesPath();
+  if (DartVM::IsRunningPrecompiledCode()) {
+    aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary(
+        testing::kDefaultAOTAppELFFileName);
+    FML_CHECK(testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
+        << "Could not set up settings with AOT symbols.";
+  } else {
+    settings.application_kernels = [&]() {
+      std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
+      kernel_mappings.emplace_back(
+          fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
+      return kernel_mappings;
+    };
+  }
+
+  ThreadHost thread_host("io.flutter.bench.",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test",
+                           thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto on_create_platform_view = [](Shell& shell) {
+    return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+  };
+  auto on_create_rasterizer = [](Shell& shell) {
+    return std::make_unique<Rasterizer>(shell);
+  };
+  auto make_configuration = [&settings]() {
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("emptyMain");
+    return configuration;
+  };
+
+  std::unique_ptr<Shell> spawner =
+      Shell::Create(flutter::PlatformData(), task_runners, settings,
+                    on_create_platform_view, on_create_rasterizer);
+  FML_CHECK(spawner);
+
+  // Spawning and shutting down shells must happen on the platform thread.
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners.GetPlatformTaskRunner(), [&]() {
+        spawner->RunEngine(make_configuration());
+
+        std::unique_ptr<SpawnedShellPool> pool;
+        if (use_pool) {
+          pool = std::make_unique<SpawnedShellPool>(
+              *spawner, 1, on_create_platform_view, on_create_rasterizer);
+          pool->Fill();
+        }
+
+        while (state.KeepRunning()) {
+          auto configuration = make_configuration();
+          const auto start = fml::TimePoint::Now();
+          auto spawn =
+              pool ? pool->Acquire(std::move(configuration))
+                   : spawner->Spawn(std::move(configuration),
+                                    on_create_platform_view,
+                                    on_create_rasterizer);
+          state.SetIterationTime((fml::TimePoint::Now() - start).ToSecondsF());
+          FML_CHECK(spawn);
+
+          spawn.reset();
+          if (pool) {
+            pool->Fill();
+          }
+        }
+
+        if (pool) {
+          // The part of the spawn that the pool did ahead of time.
+          state.counters["SavedSpawnMicros"] = benchmark::Counter(
+              pool->GetSavedSpawnTime().ToMicroseconds(),
+              benchmark::Counter::kAvgIterations);
+        }
+        pool.reset();
+        spawner.reset();
+        latch.Signal();
+      });
+  latch.Wait();
+}
+
+BENCHMARK(BM_ShellSpawn)->ArgName("pooled")->Arg(0)->Arg(1)->UseManualTime();
 
 }  // namespace flutter
@@ -262,6 +262,9 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kEstimateRasterCacheMemory:
             shell->OnServiceProtocolEstimateRasterCacheMemory(params, response);
             break;
+          case ServiceProtocolEnum::kGetImageMemoryUsage:
+            shell->OnServiceProtocolGetImageMemoryUsage(params, response);
+            break;
           case ServiceProtocolEnum::kSetAssetBundlePath:
             shell->OnServiceProtocolSetAssetBundlePath(params, response);
             break;
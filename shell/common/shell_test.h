@@ -99,6 +99,7 @@ class ShellTest : public FixtureTest {
   enum ServiceProtocolEnum {
     kGetSkSLs,
     kEstimateRasterCacheMemory,
+    kGetImageMemoryUsage,
     kSetAssetBundlePath,
     kRunInView,
   };
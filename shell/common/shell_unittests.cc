@@ -28,6 +28,7 @@
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_external_view_embedder.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
+#include "flutter/shell/common/spawned_shell_pool.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/common/vsync_waiter_fallback.h"
@@ -2106,6 +2107,49 @@ TEST_F(ShellTest, RasterizerMakeRasterSnapshot) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, RasterizerMakeRasterSnapshots) {
+  Settings settings = CreateSettingsForFixture();
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  auto task_runner = CreateNewThread();
+  TaskRunners task_runners("test", task_runner, task_runner, task_runner,
+                           task_runner);
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(ValidateShell(shell.get()));
+  PlatformViewNotifyCreated(shell.get());
+
+  RunEngine(shell.get(), std::move(configuration));
+
+  auto latch = std::make_shared<fml::AutoResetWaitableEvent>();
+
+  PumpOneFrame(shell.get());
+
+  fml::TaskRunner::RunNowOrPostTask(
+      shell->GetTaskRunners().GetRasterTaskRunner(), [&shell, &latch]() {
+        SnapshotDelegate* delegate =
+            reinterpret_cast<Rasterizer*>(shell->GetRasterizer().get());
+        auto draw = [](SkCanvas* canvas) { canvas->clear(SK_ColorRED); };
+        std::vector<SnapshotDelegate::SnapshotRequest> requests = {
+            {draw, SkISize::Make(50, 50)},
+            {draw, SkISize::Make(20, 10)},
+            {draw, SkISize::Make(50, 50)},
+        };
+        auto images = delegate->MakeRasterSnapshots(requests);
+        EXPECT_EQ(images.size(), requests.size());
+        for (size_t i = 0; i < images.size() && i < requests.size(); i++) {
+          EXPECT_NE(images[i], nullptr);
+          if (images[i]) {
+            EXPECT_EQ(images[i]->dimensions(), requests[i].picture_size);
+          }
+        }
+
+        latch->Signal();
+      });
+  latch->Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 static sk_sp<SkPicture> MakeSizedPicture(int width, int height) {
   SkPictureRecorder recorder;
   SkCanvas* recording_canvas =
@@ -2192,6 +2236,39 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetImageMemoryUsageWorks) {
+  Settings settings = CreateSettingsForFixture();
+  settings.image_memory_ceiling_bytes = 64 << 20;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetImageMemoryUsage,
+      shell->GetTaskRunners().GetRasterTaskRunner(), empty_params, &document);
+
+  ASSERT_TRUE(document.IsObject());
+  ASSERT_STREQ(document["type"].GetString(), "ImageMemoryUsage");
+  uint64_t total_bytes = 0;
+  for (size_t i = 0; i < ImageMemoryUsage::kCategoryCount; i++) {
+    const char* name = ImageMemoryUsage::GetCategoryName(
+        static_cast<ImageMemoryUsage::Category>(i));
+    ASSERT_TRUE(document.HasMember(name)) << name;
+    total_bytes += document[name].GetUint64();
+  }
+  ASSERT_EQ(document["totalBytes"].GetUint64(), total_bytes);
+  ASSERT_LE(document["trimmableBytes"].GetUint64(), total_bytes);
+  ASSERT_EQ(document["ceilingBytes"].GetInt64(), 64 << 20);
+
+  ASSERT_TRUE(document["decodedImageCache"].IsObject());
+  for (const char* name :
+       {"hits", "misses", "coalesced", "evictions", "entries"}) {
+    ASSERT_TRUE(document["decodedImageCache"].HasMember(name)) << name;
+  }
+
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, DiscardLayerTreeOnResize) {
   auto settings = CreateSettingsForFixture();
 
@@ -2629,6 +2706,67 @@ TEST_F(ShellTest, Spawn) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, SpawnedShellPoolHandsOutIdleShells) {
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  ASSERT_TRUE(configuration.IsValid());
+  configuration.SetEntrypoint("fixturesAreFunctionalMain");
+
+  auto second_configuration = RunConfiguration::InferFromSettings(settings);
+  ASSERT_TRUE(second_configuration.IsValid());
+  second_configuration.SetEntrypoint("testCanLaunchSecondaryIsolate");
+
+  fml::AutoResetWaitableEvent main_latch;
+  AddNativeCallback(
+      "SayHiFromFixturesAreFunctionalMain",
+      CREATE_NATIVE_ENTRY([&](auto args) { main_latch.Signal(); }));
+  fml::CountDownLatch second_latch(2);
+  AddNativeCallback(
+      "NotifyNative",
+      CREATE_NATIVE_ENTRY([&](auto args) { second_latch.CountDown(); }));
+
+  RunEngine(shell.get(), std::move(configuration));
+  main_latch.Wait();
+
+  PostSync(
+      shell->GetTaskRunners().GetPlatformTaskRunner(),
+      [&spawner = shell, &second_configuration, &second_latch]() {
+        MockPlatformViewDelegate platform_view_delegate;
+        SpawnedShellPool pool(
+            *spawner, 1,
+            [&platform_view_delegate](Shell& shell) {
+              auto result = std::make_unique<MockPlatformView>(
+                  platform_view_delegate, shell.GetTaskRunners());
+              ON_CALL(*result, CreateRenderingSurface())
+                  .WillByDefault(::testing::Invoke(
+                      [] { return std::make_unique<MockSurface>(); }));
+              return result;
+            },
+            [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+        pool.Fill();
+        ASSERT_EQ(pool.GetIdleShellCount(), 1u);
+
+        auto spawn = pool.Acquire(std::move(second_configuration));
+        ASSERT_NE(nullptr, spawn.get());
+        ASSERT_TRUE(ValidateShell(spawn.get()));
+        ASSERT_EQ(pool.GetIdleShellCount(), 0u);
+        ASSERT_EQ(pool.GetMissCount(), 0u);
+        ASSERT_GT(pool.GetSavedSpawnTime(), fml::TimeDelta::Zero());
+
+        // The pooled shell only runs its entrypoint once it is acquired.
+        second_latch.Wait();
+
+        DestroyShell(std::move(spawn));
+        pool.Clear();
+      });
+
+  DestroyShell(std::move(shell));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
 TEST_F(ShellTest, UpdateAssetResolverByTypeReplaces) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   Settings settings = CreateSettingsForFixture();
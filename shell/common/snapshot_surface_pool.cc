@@ -0,0 +1,78 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/snapshot_surface_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+
+SnapshotSurfacePool::SnapshotSurfacePool(size_t max_surfaces,
+                                         size_t max_bytes)
+    : max_surfaces_(max_surfaces), max_bytes_(max_bytes) {}
+
+SnapshotSurfacePool::~SnapshotSurfacePool() = default;
+
+sk_sp<SkSurface> SnapshotSurfacePool::Acquire(GrRecordingContext* context,
+                                              const SkImageInfo& image_info) {
+  auto found = std::find_if(
+      surfaces_.begin(), surfaces_.end(), [&](const sk_sp<SkSurface>& surface) {
+        const auto& info = surface->imageInfo();
+        return surface->recordingContext() == context &&
+               info.dimensions() == image_info.dimensions() &&
+               info.colorType() == image_info.colorType();
+      });
+  if (found != surfaces_.end()) {
+    sk_sp<SkSurface> surface = std::move(*found);
+    surfaces_.erase(found);
+    idle_bytes_ -= GetSurfaceBytes(*surface);
+    reuse_count_++;
+
+    auto canvas = surface->getCanvas();
+    canvas->restoreToCount(1);
+    canvas->resetMatrix();
+    canvas->clear(SK_ColorTRANSPARENT);
+    return surface;
+  }
+
+  TRACE_EVENT0("flutter", "SnapshotSurfacePool::CreateSurface");
+  if (context == nullptr) {
+    return SkSurface::MakeRaster(image_info);
+  }
+  return SkSurface::MakeRenderTarget(context,           // context
+                                     SkBudgeted::kYes,  // budgeted
+                                     image_info         // image info
+  );
+}
+
+void SnapshotSurfacePool::Release(sk_sp<SkSurface> surface) {
+  if (!surface || max_surfaces_ == 0) {
+    return;
+  }
+  const size_t bytes = GetSurfaceBytes(*surface);
+  if (bytes > max_bytes_) {
+    return;
+  }
+  surfaces_.push_front(std::move(surface));
+  idle_bytes_ += bytes;
+  while (surfaces_.size() > max_surfaces_ || idle_bytes_ > max_bytes_) {
+    idle_bytes_ -= GetSurfaceBytes(*surfaces_.back());
+    surfaces_.pop_back();
+  }
+}
+
+void SnapshotSurfacePool::Clear() {
+  surfaces_.clear();
+  idle_bytes_ = 0;
+}
+
+size_t SnapshotSurfacePool::GetSurfaceBytes(const SkSurface& surface) {
+  return surface.imageInfo().computeMinByteSize();
+}
+
+}  // namespace flutter
@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_SNAPSHOT_SURFACE_POOL_H_
+#define SHELL_COMMON_SNAPSHOT_SURFACE_POOL_H_
+
+#include <list>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrRecordingContext.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps render targets used for raster snapshots (for instance,
+///             by `Picture.toImage`) alive between snapshots so that
+///             repeatedly snapshotting pictures of the same size doesn't
+///             allocate a new render target every time.
+///
+///             Surfaces are keyed by their context, dimensions and color type.
+///             A surface returned by `Acquire` is cleared and has its canvas
+///             state reset. Callers must drop all images snapshotted from a
+///             surface before releasing it back into the pool, otherwise the
+///             next draw into the surface forces a copy of its contents.
+///
+///             Render targets are created budgeted, so that the pooled
+///             surfaces count against the resource cache budget of their
+///             context and Skia frees other resources to make room for them.
+///
+/// @attention  This class is not thread safe. The surfaces it holds must be
+///             released on the thread of their context, with that context
+///             current. This includes calls to `Clear` and `Release`.
+///
+class SnapshotSurfacePool {
+ public:
+  /// The default number of idle surfaces kept by the pool.
+  static constexpr size_t kDefaultMaxSurfaces = 4;
+
+  /// The default limit on the combined size of the pixels of idle surfaces.
+  static constexpr size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a snapshot surface pool.
+  ///
+  /// @param[in]  max_surfaces  The number of idle surfaces to keep. The least
+  ///                           recently released surfaces are dropped first.
+  /// @param[in]  max_bytes     The combined size of the pixels of the idle
+  ///                           surfaces to keep. Surfaces larger than this are
+  ///                           never pooled.
+  ///
+  explicit SnapshotSurfacePool(size_t max_surfaces = kDefaultMaxSurfaces,
+                               size_t max_bytes = kDefaultMaxBytes);
+
+  ~SnapshotSurfacePool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Gets a surface matching the given image info, either from the
+  ///             pool or by creating a new one.
+  ///
+  /// @param[in]  context     The context to create render targets in, or
+  ///                         nullptr for CPU backed surfaces.
+  /// @param[in]  image_info  The dimensions and color type of the surface.
+  ///
+  /// @return     A cleared surface, or nullptr if one could not be created.
+  ///
+  sk_sp<SkSurface> Acquire(GrRecordingContext* context,
+                           const SkImageInfo& image_info);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a surface obtained from `Acquire` to the pool.
+  ///
+  /// @param[in]  surface  The surface that is no longer used.
+  ///
+  void Release(sk_sp<SkSurface> surface);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops all idle surfaces.
+  ///
+  void Clear();
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of idle surfaces held by the pool.
+  ///
+  size_t GetIdleSurfaceCount() const { return surfaces_.size(); }
+
+  //----------------------------------------------------------------------------
+  /// @return     The combined size of the pixels of the idle surfaces.
+  ///
+  size_t GetIdleBytes() const { return idle_bytes_; }
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of calls to `Acquire` served by an idle surface.
+  ///
+  size_t GetReuseCount() const { return reuse_count_; }
+
+ private:
+  const size_t max_surfaces_;
+  const size_t max_bytes_;
+  // Most recently released surfaces first.
+  std::list<sk_sp<SkSurface>> surfaces_;
+  size_t idle_bytes_ = 0;
+  size_t reuse_count_ = 0;
+
+  static size_t GetSurfaceBytes(const SkSurface& surface);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SnapshotSurfacePool);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_COMMON_SNAPSHOT_SURFACE_POOL_H_
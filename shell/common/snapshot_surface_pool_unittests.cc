@@ -0,0 +1,86 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/snapshot_surface_pool.h"
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(SnapshotSurfacePoolTest, ReusesSurfacesOfTheSameSize) {
+  SnapshotSurfacePool pool;
+  const auto info = SkImageInfo::MakeN32Premul(8, 8);
+  auto surface = pool.Acquire(nullptr, info);
+  ASSERT_TRUE(surface);
+  SkSurface* raw_surface = surface.get();
+  pool.Release(std::move(surface));
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 1u);
+
+  auto reused = pool.Acquire(nullptr, info);
+  ASSERT_EQ(reused.get(), raw_surface);
+  ASSERT_EQ(pool.GetReuseCount(), 1u);
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 0u);
+}
+
+TEST(SnapshotSurfacePoolTest, DoesNotReuseSurfacesOfOtherSizes) {
+  SnapshotSurfacePool pool;
+  pool.Release(pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(8, 8)));
+  auto surface = pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(16, 8));
+  ASSERT_TRUE(surface);
+  ASSERT_EQ(surface->width(), 16);
+  ASSERT_EQ(pool.GetReuseCount(), 0u);
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 1u);
+}
+
+TEST(SnapshotSurfacePoolTest, ReusedSurfacesAreReset) {
+  SnapshotSurfacePool pool;
+  const auto info = SkImageInfo::MakeN32Premul(4, 4);
+  auto surface = pool.Acquire(nullptr, info);
+  surface->getCanvas()->save();
+  surface->getCanvas()->scale(2, 2);
+  surface->getCanvas()->clear(SK_ColorRED);
+  pool.Release(std::move(surface));
+
+  surface = pool.Acquire(nullptr, info);
+  ASSERT_EQ(surface->getCanvas()->getSaveCount(), 1);
+  ASSERT_TRUE(surface->getCanvas()->getTotalMatrix().isIdentity());
+  SkPixmap pixmap;
+  ASSERT_TRUE(surface->peekPixels(&pixmap));
+  ASSERT_EQ(pixmap.getColor(0, 0), SK_ColorTRANSPARENT);
+}
+
+TEST(SnapshotSurfacePoolTest, EvictsLeastRecentlyReleasedSurfaces) {
+  SnapshotSurfacePool pool(2);
+  for (int i = 1; i <= 3; i++) {
+    pool.Release(pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(i, i)));
+  }
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 2u);
+
+  // The 1x1 surface was released first and is no longer pooled.
+  pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(1, 1));
+  ASSERT_EQ(pool.GetReuseCount(), 0u);
+  pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(3, 3));
+  ASSERT_EQ(pool.GetReuseCount(), 1u);
+
+  pool.Clear();
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 0u);
+}
+
+TEST(SnapshotSurfacePoolTest, RespectsByteLimit) {
+  // Room for one 8x8 N32 surface.
+  SnapshotSurfacePool pool(4, 8 * 8 * 4);
+  pool.Release(pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(16, 16)));
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 0u);
+
+  pool.Release(pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(8, 8)));
+  pool.Release(pool.Acquire(nullptr, SkImageInfo::MakeN32Premul(4, 4)));
+  ASSERT_EQ(pool.GetIdleSurfaceCount(), 1u);
+  ASSERT_EQ(pool.GetIdleBytes(), 4u * 4u * 4u);
+}
+
+}  // namespace testing
+}  // namespace flutter
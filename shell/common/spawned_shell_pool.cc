@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/spawned_shell_pool.h"
+
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+SpawnedShellPool::SpawnedShellPool(
+    const Shell& spawner,
+    size_t capacity,
+    Shell::CreateCallback<PlatformView> on_create_platform_view,
+    Shell::CreateCallback<Rasterizer> on_create_rasterizer,
+    fml::TimeDelta refill_delay)
+    : spawner_(spawner),
+      capacity_(capacity),
+      on_create_platform_view_(std::move(on_create_platform_view)),
+      on_create_rasterizer_(std::move(on_create_rasterizer)),
+      refill_delay_(refill_delay),
+      weak_factory_(this) {
+  FML_DCHECK(IsOnPlatformThread());
+}
+
+SpawnedShellPool::~SpawnedShellPool() {
+  FML_DCHECK(IsOnPlatformThread());
+}
+
+std::unique_ptr<Shell> SpawnedShellPool::Acquire(
+    RunConfiguration run_configuration) {
+  TRACE_EVENT0("flutter", "SpawnedShellPool::Acquire");
+  FML_DCHECK(IsOnPlatformThread());
+  last_acquire_time_ = fml::TimePoint::Now();
+  std::unique_ptr<Shell> shell;
+  if (!idle_shells_.empty()) {
+    saved_spawn_time_ = saved_spawn_time_ + idle_shells_.front().spawn_time;
+    shell = std::move(idle_shells_.front().shell);
+    idle_shells_.pop_front();
+  } else {
+    miss_count_++;
+    shell = SpawnIdleShell().shell;
+  }
+
+  if (shell) {
+    shell->RunEngine(std::move(run_configuration));
+  }
+  ScheduleRefill();
+  return shell;
+}
+
+void SpawnedShellPool::Fill() {
+  TRACE_EVENT0("flutter", "SpawnedShellPool::Fill");
+  FML_DCHECK(IsOnPlatformThread());
+  while (idle_shells_.size() < capacity_) {
+    auto shell = SpawnIdleShell();
+    if (!shell.shell) {
+      return;
+    }
+    idle_shells_.push_back(std::move(shell));
+  }
+}
+
+void SpawnedShellPool::Clear() {
+  FML_DCHECK(IsOnPlatformThread());
+  idle_shells_.clear();
+}
+
+bool SpawnedShellPool::IsOnPlatformThread() const {
+  return spawner_.GetTaskRunners()
+      .GetPlatformTaskRunner()
+      ->RunsTasksOnCurrentThread();
+}
+
+SpawnedShellPool::IdleShell SpawnedShellPool::SpawnIdleShell() {
+  const auto start = fml::TimePoint::Now();
+  auto shell =
+      spawner_.SpawnIdle(on_create_platform_view_, on_create_rasterizer_);
+  if (!shell || !shell->IsSetup()) {
+    FML_LOG(ERROR) << "Could not spawn a shell for the pool.";
+    return {};
+  }
+  return {std::move(shell), fml::TimePoint::Now() - start};
+}
+
+void SpawnedShellPool::ScheduleRefill() {
+  if (refill_pending_ || idle_shells_.size() >= capacity_) {
+    return;
+  }
+  refill_pending_ = true;
+  PostRefill(refill_delay_);
+}
+
+void SpawnedShellPool::PostRefill(fml::TimeDelta delay) {
+  spawner_.GetTaskRunners().GetPlatformTaskRunner()->PostDelayedTask(
+      [weak_pool = weak_factory_.GetWeakPtr()]() {
+        if (weak_pool) {
+          weak_pool->Refill();
+        }
+      },
+      delay);
+}
+
+void SpawnedShellPool::Refill() {
+  // Shells acquired in a burst are spawned synchronously anyway, so wait for
+  // the burst to end rather than hold up the platform thread in the middle.
+  const fml::TimeDelta idle_time = fml::TimePoint::Now() - last_acquire_time_;
+  if (idle_time < refill_delay_) {
+    PostRefill(refill_delay_ - idle_time);
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "SpawnedShellPool::Refill");
+  refill_pending_ = false;
+  if (idle_shells_.size() >= capacity_) {
+    return;
+  }
+  auto shell = SpawnIdleShell();
+  if (!shell.shell) {
+    return;
+  }
+  idle_shells_.push_back(std::move(shell));
+  // Spawn one shell per task so that other work on the platform task runner
+  // can interleave with the refill.
+  if (idle_shells_.size() < capacity_) {
+    refill_pending_ = true;
+    PostRefill(fml::TimeDelta::Zero());
+  }
+}
+
+}  // namespace flutter
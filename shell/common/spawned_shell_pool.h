@@ -0,0 +1,151 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_SPAWNED_SHELL_POOL_H_
+#define SHELL_COMMON_SPAWNED_SHELL_POOL_H_
+
+#include <deque>
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/shell.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Keeps a number of idle Shells spawned from a running Shell
+///             ready, so that handing out a new Shell skips setting up its
+///             engine, rasterizer, platform view and IO manager. This is meant
+///             for embedders that create many short-lived Shells, for instance
+///             one per embedded widget.
+///
+///             The pool only warms up the Shell and its rasterizer (see
+///             `Shell::SpawnIdle`), which is the cost that it saves and
+///             measures (see `GetSavedSpawnTime`). It does not prewarm
+///             isolates: the root isolate of a Shell is launched in the
+///             isolate group of the spawner when the Shell is acquired, since
+///             it depends on the entrypoint of the run configuration, so that
+///             cost is still paid by the caller of `Acquire`. Launching the
+///             isolate ahead of time is left for follow-up work.
+///
+///             Shells must be created and destroyed on the platform thread, so
+///             the pool is refilled on the platform task runner. To keep this
+///             work out of the way of bursts of acquisitions, the refill waits
+///             until no Shell has been acquired for the refill delay, and then
+///             spawns one Shell per task so that other work can interleave
+///             with it.
+///
+/// @attention  The pool must only be used on the platform task runner of the
+///             spawning Shell, and must be destroyed before that Shell. The
+///             platform view and rasterizer callbacks are invoked ahead of
+///             time, so they must not depend on which caller the Shell will
+///             be handed to.
+///
+class SpawnedShellPool {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a pool. The pool starts empty. Call `Fill` to
+  ///             populate it up front, or let the first `Acquire` schedule a
+  ///             refill.
+  ///
+  /// @param[in]  spawner                  The running Shell to spawn from.
+  /// @param[in]  capacity                 The number of idle Shells to keep.
+  /// @param[in]  on_create_platform_view  Creates the platform view of each
+  ///                                      spawned Shell.
+  /// @param[in]  on_create_rasterizer     Creates the rasterizer of each
+  ///                                      spawned Shell.
+  /// @param[in]  refill_delay             How long the pool must go without
+  ///                                      handing out a Shell before it is
+  ///                                      refilled.
+  ///
+  SpawnedShellPool(
+      const Shell& spawner,
+      size_t capacity,
+      Shell::CreateCallback<PlatformView> on_create_platform_view,
+      Shell::CreateCallback<Rasterizer> on_create_rasterizer,
+      fml::TimeDelta refill_delay = fml::TimeDelta::FromMilliseconds(100));
+
+  ~SpawnedShellPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Hands out a running Shell. An idle Shell is used if one is
+  ///             available; otherwise a Shell is spawned synchronously.
+  ///
+  /// @param[in]  run_configuration  The configuration to run the Shell with.
+  ///
+  /// @return     The running Shell, or null if it could not be spawned.
+  ///
+  std::unique_ptr<Shell> Acquire(RunConfiguration run_configuration);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Synchronously spawns idle Shells until the pool is at
+  ///             capacity.
+  ///
+  void Fill();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Destroys all idle Shells. The pool refills on the next call to
+  ///             `Acquire` or `Fill`.
+  ///
+  void Clear();
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of idle Shells ready to be handed out.
+  ///
+  size_t GetIdleShellCount() const { return idle_shells_.size(); }
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of calls to `Acquire` that had to spawn a Shell
+  ///             synchronously because the pool was empty.
+  ///
+  size_t GetMissCount() const { return miss_count_; }
+
+  //----------------------------------------------------------------------------
+  /// @return     The total time that spawning the Shells handed out by
+  ///             `Acquire` took ahead of time, which their callers did not
+  ///             have to wait for. Launching their root isolates is not
+  ///             included, since it happens when they are acquired.
+  ///
+  fml::TimeDelta GetSavedSpawnTime() const { return saved_spawn_time_; }
+
+ private:
+  struct IdleShell {
+    std::unique_ptr<Shell> shell;
+    // How long spawning the Shell took.
+    fml::TimeDelta spawn_time;
+  };
+
+  const Shell& spawner_;
+  const size_t capacity_;
+  const Shell::CreateCallback<PlatformView> on_create_platform_view_;
+  const Shell::CreateCallback<Rasterizer> on_create_rasterizer_;
+  const fml::TimeDelta refill_delay_;
+  std::deque<IdleShell> idle_shells_;
+  size_t miss_count_ = 0;
+  fml::TimeDelta saved_spawn_time_;
+  fml::TimePoint last_acquire_time_;
+  bool refill_pending_ = false;
+  fml::WeakPtrFactory<SpawnedShellPool> weak_factory_;
+
+  bool IsOnPlatformThread() const;
+
+  IdleShell SpawnIdleShell();
+
+  void ScheduleRefill();
+
+  void PostRefill(fml::TimeDelta delay);
+
+  // Spawns one Shell if the pool is idle, or waits until it is.
+  void Refill();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SpawnedShellPool);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_COMMON_SPAWNED_SHELL_POOL_H_
@@ -0,0 +1,189 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_task_graph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+StartupTaskGraph::StartupTaskGraph() = default;
+
+StartupTaskGraph::~StartupTaskGraph() = default;
+
+StartupTaskGraph::TaskId StartupTaskGraph::AddTask(
+    const char* label,
+    fml::closure task,
+    std::vector<TaskId> dependencies,
+    Affinity affinity) {
+  const TaskId id = tasks_.size();
+  for (auto dependency : dependencies) {
+    FML_CHECK(dependency < id)
+        << "Startup task " << label << " depends on a task added after it.";
+  }
+  tasks_.push_back({label, std::move(task), std::move(dependencies), affinity});
+  return id;
+}
+
+void StartupTaskGraph::Run(
+    const std::vector<fml::RefPtr<fml::TaskRunner>>& helper_runners) {
+  TRACE_EVENT0("flutter", "StartupTaskGraph::Run");
+  std::vector<fml::RefPtr<fml::TaskRunner>> runners;
+  for (const auto& runner : helper_runners) {
+    if (!runner || runner->RunsTasksOnCurrentThread()) {
+      continue;
+    }
+    const bool is_duplicate =
+        std::any_of(runners.begin(), runners.end(), [&runner](const auto& r) {
+          return r->GetTaskQueueId() == runner->GetTaskQueueId();
+        });
+    if (!is_duplicate) {
+      runners.push_back(runner);
+    }
+  }
+  if (!runners.empty() && tasks_.size() > 1) {
+    RunConcurrently(std::move(runners));
+  } else {
+    RunSequentially();
+  }
+  tasks_.clear();
+}
+
+void StartupTaskGraph::RunSequentially() {
+  // Dependencies always precede their dependents, so the order the tasks were
+  // added in is a valid order to run them in.
+  for (const auto& task : tasks_) {
+    RunTask(task);
+  }
+}
+
+// The state of a concurrent run. It is shared with the closures posted to the
+// helper runners, which may still be pending once the run has completed if
+// the calling thread took their task first.
+struct StartupTaskGraph::ConcurrentRun {
+  ConcurrentRun(std::vector<Task> p_tasks,
+                std::vector<fml::RefPtr<fml::TaskRunner>> p_runners)
+      : tasks(std::move(p_tasks)),
+        runners(std::move(p_runners)),
+        pending_dependencies(tasks.size()),
+        dependents(tasks.size()),
+        completed(tasks.size()) {}
+
+  const std::vector<Task> tasks;
+  const std::vector<fml::RefPtr<fml::TaskRunner>> runners;
+  std::mutex mutex;
+  std::condition_variable ready_changed;
+  std::vector<size_t> pending_dependencies;
+  std::vector<std::vector<TaskId>> dependents;
+  std::deque<TaskId> ready_any_thread;
+  std::deque<TaskId> ready_calling_thread;
+  size_t calling_thread_task_count = 0;
+  size_t next_runner = 0;
+  fml::CountDownLatch completed;
+
+  // Queues a task whose dependencies have completed. Tasks that may run
+  // anywhere are also posted to a helper runner, and run by whichever of the
+  // helper and the calling thread gets to them first. Must be called with the
+  // lock held.
+  void MakeReady(const std::shared_ptr<ConcurrentRun>& self, TaskId id) {
+    if (tasks[id].affinity == Affinity::kCallingThread) {
+      ready_calling_thread.push_back(id);
+    } else {
+      ready_any_thread.push_back(id);
+      runners[next_runner++ % runners.size()]->PostTask(
+          [self]() { self->RunReadyTask(self, false); });
+    }
+    ready_changed.notify_all();
+  }
+
+  // Runs a ready task and queues its dependents. Returns false if no task
+  // the current thread may run was ready.
+  bool RunReadyTask(const std::shared_ptr<ConcurrentRun>& self,
+                    bool is_calling_thread) {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::deque<TaskId>* queue = nullptr;
+    if (is_calling_thread && !ready_calling_thread.empty()) {
+      queue = &ready_calling_thread;
+    } else if (!ready_any_thread.empty()) {
+      queue = &ready_any_thread;
+    } else {
+      return false;
+    }
+    const TaskId id = queue->front();
+    queue->pop_front();
+
+    lock.unlock();
+    RunTask(tasks[id]);
+    lock.lock();
+
+    if (tasks[id].affinity == Affinity::kCallingThread) {
+      calling_thread_task_count--;
+    }
+    for (auto dependent : dependents[id]) {
+      if (--pending_dependencies[dependent] == 0) {
+        MakeReady(self, dependent);
+      }
+    }
+    lock.unlock();
+    completed.CountDown();
+    return true;
+  }
+};
+
+void StartupTaskGraph::RunConcurrently(
+    std::vector<fml::RefPtr<fml::TaskRunner>> runners) {
+  auto run =
+      std::make_shared<ConcurrentRun>(std::move(tasks_), std::move(runners));
+
+  {
+    std::unique_lock<std::mutex> lock(run->mutex);
+    for (TaskId id = 0; id < run->tasks.size(); id++) {
+      const auto& task = run->tasks[id];
+      run->pending_dependencies[id] = task.dependencies.size();
+      for (auto dependency : task.dependencies) {
+        run->dependents[dependency].push_back(id);
+      }
+      if (task.affinity == Affinity::kCallingThread) {
+        run->calling_thread_task_count++;
+      }
+    }
+    for (TaskId id = 0; id < run->tasks.size(); id++) {
+      if (run->pending_dependencies[id] == 0) {
+        run->MakeReady(run, id);
+      }
+    }
+
+    // The calling thread runs the tasks pinned to it, and helps with the
+    // others while it waits for those to become ready.
+    while (run->calling_thread_task_count > 0) {
+      run->ready_changed.wait(lock, [&run] {
+        return !run->ready_calling_thread.empty() ||
+               !run->ready_any_thread.empty();
+      });
+      lock.unlock();
+      run->RunReadyTask(run, true);
+      lock.lock();
+    }
+  }
+
+  while (run->RunReadyTask(run, true)) {
+  }
+  run->completed.Wait();
+}
+
+void StartupTaskGraph::RunTask(const Task& task) {
+  TRACE_EVENT0("flutter", task.label);
+  if (task.closure) {
+    task.closure();
+  }
+}
+
+}  // namespace flutter
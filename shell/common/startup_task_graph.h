@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_STARTUP_TASK_GRAPH_H_
+#define SHELL_COMMON_STARTUP_TASK_GRAPH_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Runs the steps needed to bring up a shell with their
+///             dependencies made explicit, so that independent steps (for
+///             instance ICU data mapping, Skia initialization and snapshot
+///             mapping) can overlap instead of running back to back on the
+///             thread creating the shell. Independent steps are posted to the
+///             task runners of the shell being created, whose threads are
+///             idle until the shell is set up, so no threads are spawned.
+///
+///             Each step shows up as its own span on the timeline, labeled
+///             with the label it was added with.
+///
+/// @attention  A task graph is single use. Tasks may only depend on tasks
+///             that were added before them, which rules out cycles.
+///
+class StartupTaskGraph {
+ public:
+  using TaskId = size_t;
+
+  enum class Affinity {
+    /// The task may run on any thread.
+    kAnyThread,
+    /// The task must run on the thread that calls `Run`. Used for work that
+    /// must not move between threads, like creating the Dart VM.
+    kCallingThread,
+  };
+
+  StartupTaskGraph();
+
+  ~StartupTaskGraph();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds a step to the graph.
+  ///
+  /// @param[in]  label         A static string that names the step in traces.
+  /// @param[in]  task          The work to perform.
+  /// @param[in]  dependencies  The steps that must complete before this one
+  ///                           starts.
+  /// @param[in]  affinity      The threads the step may run on.
+  ///
+  /// @return     The identifier other steps can use to depend on this one.
+  ///
+  TaskId AddTask(const char* label,
+                 fml::closure task,
+                 std::vector<TaskId> dependencies = {},
+                 Affinity affinity = Affinity::kAnyThread);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs all steps and returns once they have completed.
+  ///
+  /// @param[in]  helper_runners  The task runners independent steps may be
+  ///                             posted to, to run at the same time as the
+  ///                             steps on the calling thread. Runners that
+  ///                             run tasks on the calling thread are skipped,
+  ///                             since it blocks until all steps complete. If
+  ///                             no runner is left, the steps run on the
+  ///                             calling thread in the order they were added.
+  ///
+  void Run(const std::vector<fml::RefPtr<fml::TaskRunner>>& helper_runners);
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of steps waiting to be run.
+  ///
+  size_t GetTaskCount() const { return tasks_.size(); }
+
+ private:
+  struct Task {
+    const char* label;
+    fml::closure closure;
+    std::vector<TaskId> dependencies;
+    Affinity affinity;
+  };
+
+  std::vector<Task> tasks_;
+
+  void RunSequentially();
+
+  struct ConcurrentRun;
+
+  void RunConcurrently(std::vector<fml::RefPtr<fml::TaskRunner>> runners);
+
+  static void RunTask(const Task& task);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StartupTaskGraph);
+};
+
+}  // namespace flutter
+
+#endif  // SHELL_COMMON_STARTUP_TASK_GRAPH_H_
@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_task_graph.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class HelperThreads {
+ public:
+  HelperThreads() : first_("helper.1"), second_("helper.2") {}
+
+  std::vector<fml::RefPtr<fml::TaskRunner>> GetTaskRunners() const {
+    return {first_.GetTaskRunner(), second_.GetTaskRunner()};
+  }
+
+ private:
+  fml::Thread first_;
+  fml::Thread second_;
+};
+
+}  // namespace
+
+TEST(StartupTaskGraphTest, SequentialRunUsesInsertionOrder) {
+  StartupTaskGraph graph;
+  std::vector<int> ran;
+  auto first = graph.AddTask("first", [&]() { ran.push_back(1); });
+  graph.AddTask("second", [&]() { ran.push_back(2); });
+  graph.AddTask("third", [&]() { ran.push_back(3); }, {first});
+  graph.Run({});
+  ASSERT_EQ(ran, std::vector<int>({1, 2, 3}));
+  ASSERT_EQ(graph.GetTaskCount(), 0u);
+}
+
+TEST(StartupTaskGraphTest, ConcurrentRunRespectsDependencies) {
+  HelperThreads helpers;
+  for (int iteration = 0; iteration < 50; iteration++) {
+    StartupTaskGraph graph;
+    std::atomic<bool> a_done = false;
+    std::atomic<bool> b_done = false;
+    std::atomic<bool> ordered = false;
+    auto a = graph.AddTask("a", [&]() { a_done = true; });
+    auto b = graph.AddTask("b", [&]() { b_done = true; });
+    graph.AddTask("c", [&]() { ordered = a_done && b_done; }, {a, b});
+    graph.Run(helpers.GetTaskRunners());
+    ASSERT_TRUE(ordered);
+  }
+}
+
+TEST(StartupTaskGraphTest, IndependentTasksOverlap) {
+  HelperThreads helpers;
+  StartupTaskGraph graph;
+  std::mutex mutex;
+  std::condition_variable cv;
+  int arrived = 0;
+  // Each task waits for the other. This only completes if they run at the
+  // same time.
+  auto rendezvous = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    arrived++;
+    cv.notify_all();
+    cv.wait(lock, [&]() { return arrived == 2; });
+  };
+  graph.AddTask("a", rendezvous);
+  graph.AddTask("b", rendezvous);
+  graph.Run(helpers.GetTaskRunners());
+  ASSERT_EQ(arrived, 2);
+}
+
+TEST(StartupTaskGraphTest, CallingThreadAffinityIsHonored) {
+  HelperThreads helpers;
+  for (int iteration = 0; iteration < 50; iteration++) {
+    StartupTaskGraph graph;
+    const auto calling_thread = std::this_thread::get_id();
+    std::thread::id pinned_thread;
+    std::vector<StartupTaskGraph::TaskId> dependencies;
+    for (int i = 0; i < 4; i++) {
+      dependencies.push_back(graph.AddTask("any", []() {}));
+    }
+    graph.AddTask(
+        "pinned", [&]() { pinned_thread = std::this_thread::get_id(); },
+        dependencies, StartupTaskGraph::Affinity::kCallingThread);
+    graph.Run(helpers.GetTaskRunners());
+    ASSERT_EQ(pinned_thread, calling_thread);
+  }
+}
+
+TEST(StartupTaskGraphTest, SkipsRunnersOfTheCallingThread) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto calling_runner = fml::MessageLoop::GetCurrent().GetTaskRunner();
+  StartupTaskGraph graph;
+  std::vector<int> ran;
+  graph.AddTask("first", [&]() { ran.push_back(1); });
+  graph.AddTask("second", [&]() { ran.push_back(2); });
+  // Posting to the blocked calling thread would never complete.
+  graph.Run({calling_runner, calling_runner});
+  ASSERT_EQ(ran, std::vector<int>({1, 2}));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -399,6 +399,62 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_skparagraph =
       command_line.HasOption(FlagForSwitch(Switch::EnableSkParagraph));
 
+  if (command_line.HasOption(FlagForSwitch(Switch::TextLayoutCacheBytes))) {
+    std::string text_layout_cache_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::TextLayoutCacheBytes),
+                                &text_layout_cache_bytes);
+    settings.text_layout_cache_bytes = std::stoul(text_layout_cache_bytes);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::HyphenationDictionaries))) {
+    std::string hyphenation_dictionaries;
+    command_line.GetOptionValue(FlagForSwitch(Switch::HyphenationDictionaries),
+                                &hyphenation_dictionaries);
+    for (const auto& entry : ParseCommaDelimited(hyphenation_dictionaries)) {
+      size_t separator = entry.find('=');
+      if (separator == std::string::npos) {
+        FML_LOG(ERROR) << "Ignoring hyphenation dictionary without a locale: "
+                       << entry;
+        continue;
+      }
+      settings.hyphenation_dictionaries[entry.substr(0, separator)] =
+          entry.substr(separator + 1);
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageDecodeAheadFrames))) {
+    std::string decode_ahead_frames;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::AnimatedImageDecodeAheadFrames),
+        &decode_ahead_frames);
+    settings.animated_image_decode_ahead_frames =
+        std::stoll(decode_ahead_frames);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AnimatedImageFrameCacheBytes))) {
+    std::string frame_cache_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::AnimatedImageFrameCacheBytes),
+        &frame_cache_bytes);
+    settings.animated_image_frame_cache_bytes = std::stoll(frame_cache_bytes);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::ImageUploadBudgetBytes))) {
+    std::string upload_budget_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::ImageUploadBudgetBytes),
+                                &upload_budget_bytes);
+    settings.image_upload_budget_bytes = std::stoll(upload_budget_bytes);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::ImageMemoryCeilingBytes))) {
+    std::string memory_ceiling_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::ImageMemoryCeilingBytes),
+                                &memory_ceiling_bytes);
+    settings.image_memory_ceiling_bytes = std::stoll(memory_ceiling_bytes);
+  }
+
   std::string all_dart_flags;
   if (command_line.GetOptionValue(FlagForSwitch(Switch::DartFlags),
                                   &all_dart_flags)) {
@@ -206,6 +206,35 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
+DEF_SWITCH(TextLayoutCacheBytes,
+           "text-layout-cache-bytes",
+           "The memory budget in bytes of the cache of shaped words used for "
+           "text layout. The cache is shared by all the engines in the "
+           "process, and only the value of the first shell is used.")
+DEF_SWITCH(HyphenationDictionaries,
+           "hyphenation-dictionaries",
+           "A comma-separated list of locale=path pairs of the hyphenation "
+           "pattern dictionaries used by paragraphs that enable hyphenation. "
+           "Relative paths are resolved against the assets path.")
+DEF_SWITCH(AnimatedImageDecodeAheadFrames,
+           "animated-image-decode-ahead-frames",
+           "The number of frames of an animated image decoded ahead of the "
+           "frame being displayed. Zero disables decoding ahead. Applies to "
+           "the whole process.")
+DEF_SWITCH(AnimatedImageFrameCacheBytes,
+           "animated-image-frame-cache-bytes",
+           "The memory budget in bytes of the animated images whose decoded "
+           "frames are all cached, shared by all the engines in the process.")
+DEF_SWITCH(ImageUploadBudgetBytes,
+           "image-upload-budget-bytes",
+           "The memory budget in bytes of the images being decoded or waiting "
+           "to be uploaded to the GPU by each engine. Decodes over the budget "
+           "are deferred.")
+DEF_SWITCH(ImageMemoryCeilingBytes,
+           "image-memory-ceiling-bytes",
+           "The memory in bytes held by the image caches above which they are "
+           "trimmed, from the cheapest to refill to the most expensive. Live "
+           "images and images being decoded do not count.")
 
 DEF_SWITCHES_END
 
@@ -46,5 +46,15 @@ TEST(SwitchesTest, SkiaTraceAllowlistFlag) {
 #endif
 }
 
+TEST(SwitchesTest, HyphenationDictionariesFlag) {
+  fml::CommandLine command_line = fml::CommandLineFromInitializerList(
+      {"command",
+       "--hyphenation-dictionaries=en-US=hyph-en-us.hb,de=/tmp/hyph-de.hb,fr"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  ASSERT_EQ(settings.hyphenation_dictionaries.size(), 2ul);
+  EXPECT_EQ(settings.hyphenation_dictionaries["en-US"], "hyph-en-us.hb");
+  EXPECT_EQ(settings.hyphenation_dictionaries["de"], "/tmp/hyph-de.hb");
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -10,6 +10,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "flutter/fml/build_config.h"
@@ -57,6 +58,7 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/shell/platform/embedder/platform_view_embedder.h"
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/writer.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 
 #ifdef SHELL_ENABLE_GL
 #include "flutter/shell/platform/embedder/embedder_external_texture_gl.h"
@@ -2279,6 +2281,81 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
   }
 }
 
+namespace {
+// Owns the captured frame handed to the embedder. The public struct must be
+// the first member so that the pointer given to the embedder can be converted
+// back.
+struct EmbedderCapturedFrame {
+  FlutterCapturedFrame frame;
+  fml::RefPtr<flutter::CapturedFrame> captured_frame;
+};
+static_assert(std::is_standard_layout<EmbedderCapturedFrame>::value,
+              "The embedder frame must be convertible from its first member.");
+}  // namespace
+
+FlutterEngineResult FlutterEngineStartFrameCapture(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    size_t buffer_count,
+    FlutterCapturedFrameCallback callback,
+    void* user_data) {
+  if (raw_engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Frame capture callback was null.");
+  }
+
+  auto frame_callback = [callback,
+                         user_data](fml::RefPtr<flutter::CapturedFrame> frame) {
+    SkPixmap pixmap;
+    if (!frame->PeekPixels(&pixmap)) {
+      return;
+    }
+    auto embedder_frame = new EmbedderCapturedFrame();
+    embedder_frame->frame.struct_size = sizeof(FlutterCapturedFrame);
+    embedder_frame->frame.pixels = static_cast<const uint8_t*>(pixmap.addr());
+    embedder_frame->frame.row_bytes = pixmap.rowBytes();
+    embedder_frame->frame.width = pixmap.width();
+    embedder_frame->frame.height = pixmap.height();
+    embedder_frame->frame.frame_number = frame->frame_number();
+    embedder_frame->frame.vsync_target_time_nanos =
+        frame->vsync_target_time().ToEpochDelta().ToNanoseconds();
+    embedder_frame->frame.capture_time_nanos =
+        frame->capture_time().ToEpochDelta().ToNanoseconds();
+    embedder_frame->captured_frame = std::move(frame);
+    callback(&embedder_frame->frame, user_data);
+  };
+
+  reinterpret_cast<flutter::EmbedderEngine*>(raw_engine)
+      ->GetShell()
+      .SetFrameCaptureCallback(buffer_count, frame_callback);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineStopFrameCapture(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine) {
+  if (raw_engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  reinterpret_cast<flutter::EmbedderEngine*>(raw_engine)
+      ->GetShell()
+      .SetFrameCaptureCallback(0, nullptr);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineReleaseCapturedFrame(
+    const FlutterCapturedFrame* frame) {
+  if (frame == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid captured frame.");
+  }
+
+  delete reinterpret_cast<const EmbedderCapturedFrame*>(frame);
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -2329,6 +2406,9 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(StartFrameCapture, FlutterEngineStartFrameCapture);
+  SET_PROC(StopFrameCapture, FlutterEngineStopFrameCapture);
+  SET_PROC(ReleaseCapturedFrame, FlutterEngineReleaseCapturedFrame);
 #undef SET_PROC
 
   return kSuccess;
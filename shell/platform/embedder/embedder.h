@@ -1216,6 +1216,39 @@ typedef enum {
   kFlutterEngineDisplaysUpdateTypeCount,
 } FlutterEngineDisplaysUpdateType;
 
+/// A frame captured from the on-screen surface after it was rendered. See
+/// `FlutterEngineStartFrameCapture`.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterCapturedFrame).
+  size_t struct_size;
+  /// The pixels of the frame in 32-bit premultiplied RGBA or BGRA, depending
+  /// on the native byte order of the platform. Valid until the frame is
+  /// released with `FlutterEngineReleaseCapturedFrame`.
+  const uint8_t* pixels;
+  /// The number of bytes between the start of consecutive rows of pixels.
+  size_t row_bytes;
+  /// The width of the frame in pixels.
+  size_t width;
+  /// The height of the frame in pixels.
+  size_t height;
+  /// The number of the frame. Frame numbers increase monotonically and may
+  /// have gaps when frames are dropped.
+  uint64_t frame_number;
+  /// The time the frame was targeted to be presented at, in nanoseconds
+  /// according to `FlutterEngineGetCurrentTime`.
+  uint64_t vsync_target_time_nanos;
+  /// The time the frame contents were captured at, in nanoseconds according to
+  /// `FlutterEngineGetCurrentTime`.
+  uint64_t capture_time_nanos;
+} FlutterCapturedFrame;
+
+/// The callback invoked on the render thread for each captured frame. The
+/// frame must be released with `FlutterEngineReleaseCapturedFrame`, on any
+/// thread, once the embedder is done with it.
+typedef void (*FlutterCapturedFrameCallback)(
+    const FlutterCapturedFrame* /* frame */,
+    void* /* user data */);
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -2239,6 +2272,58 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
     const FlutterEngineDisplay* displays,
     size_t display_count);
 
+//------------------------------------------------------------------------------
+/// @brief      Starts handing the contents of every frame rendered by the
+///             engine to the embedder, without rendering frames twice. This is
+///             meant for headless recording and visual regression testing.
+///
+///             At most `buffer_count` frames may be held by the embedder at
+///             any time. Frames rendered while the embedder holds all of them
+///             are dropped, so the embedder must release frames promptly.
+///             Frames are not captured while a compositor renders the root
+///             surface.
+///
+/// @param[in]  engine        A running engine instance.
+/// @param[in]  buffer_count  The number of frames the embedder may hold at the
+///                           same time. Clamped to [2, 3].
+/// @param[in]  callback      The callback invoked on the render thread with
+///                           each captured frame.
+/// @param[in]  user_data     A baton passed by the engine to the callback.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineStartFrameCapture(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    size_t buffer_count,
+    FlutterCapturedFrameCallback callback,
+    void* user_data);
+
+//------------------------------------------------------------------------------
+/// @brief      Stops capturing frames. Frames already handed to the embedder
+///             must still be released.
+///
+/// @param[in]  engine  A running engine instance.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineStopFrameCapture(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine);
+
+//------------------------------------------------------------------------------
+/// @brief      Releases a frame handed to the embedder by the callback given
+///             to `FlutterEngineStartFrameCapture`. May be called on any
+///             thread, including after the engine was shut down.
+///
+/// @param[in]  frame  The captured frame to release.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineReleaseCapturedFrame(
+    const FlutterCapturedFrame* frame);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2355,6 +2440,15 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     FlutterEngineDisplaysUpdateType update_type,
     const FlutterEngineDisplay* displays,
     size_t display_count);
+typedef FlutterEngineResult (*FlutterEngineStartFrameCaptureFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    size_t buffer_count,
+    FlutterCapturedFrameCallback callback,
+    void* user_data);
+typedef FlutterEngineResult (*FlutterEngineStopFrameCaptureFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine);
+typedef FlutterEngineResult (*FlutterEngineReleaseCapturedFrameFnPtr)(
+    const FlutterCapturedFrame* frame);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2399,6 +2493,9 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineStartFrameCaptureFnPtr StartFrameCapture;
+  FlutterEngineStopFrameCaptureFnPtr StopFrameCapture;
+  FlutterEngineReleaseCapturedFrameFnPtr ReleaseCapturedFrame;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -1575,5 +1575,63 @@ TEST_F(EmbedderTest, BackToBackKeyEventResponsesCorrectlyInvoked) {
   shutdown_latch.Wait();
 }
 
+
+TEST_F(EmbedderTest, CanCaptureFramesWithTheSoftwareBackend) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+
+  // Outlives the engine, which may still capture frames while shutting down.
+  struct Capture {
+    fml::AutoResetWaitableEvent latch;
+    const FlutterCapturedFrame* frame = nullptr;
+  } capture;
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  ASSERT_EQ(FlutterEngineStartFrameCapture(engine.get(), 2, nullptr, nullptr),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineStartFrameCapture(
+                engine.get(), 2,
+                [](const FlutterCapturedFrame* frame, void* user_data) {
+                  auto capture = reinterpret_cast<Capture*>(user_data);
+                  if (capture->frame != nullptr) {
+                    FlutterEngineReleaseCapturedFrame(frame);
+                    return;
+                  }
+                  capture->frame = frame;
+                  capture->latch.Signal();
+                },
+                &capture),
+            kSuccess);
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  capture.latch.Wait();
+  const FlutterCapturedFrame* frame = capture.frame;
+  ASSERT_EQ(frame->struct_size, sizeof(FlutterCapturedFrame));
+  ASSERT_EQ(frame->width, 800u);
+  ASSERT_EQ(frame->height, 600u);
+  ASSERT_GE(frame->row_bytes, 800u * 4);
+  ASSERT_NE(frame->pixels, nullptr);
+  // The scene draws a translucent box at (10, 10).
+  ASSERT_NE(frame->pixels[15 * frame->row_bytes + 15 * 4 + 3], 0);
+  ASSERT_GT(frame->capture_time_nanos, 0u);
+
+  ASSERT_EQ(FlutterEngineReleaseCapturedFrame(frame), kSuccess);
+  ASSERT_EQ(FlutterEngineReleaseCapturedFrame(nullptr), kInvalidArguments);
+  ASSERT_EQ(FlutterEngineStopFrameCapture(engine.get()), kSuccess);
+}
+
 }  // namespace testing
 }  // namespace flutter
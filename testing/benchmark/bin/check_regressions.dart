@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// @dart = 2.6
+
+import 'dart:convert';
+import 'dart:io';
+
+const String kUsage = '''
+Compares two Google Benchmark JSON files and fails if any benchmark got slower.
+
+Usage: check_regressions.dart [options] <baseline_json_file> <current_json_file>
+
+Options:
+  --threshold=<ratio>  The tolerated slowdown, as a fraction of the baseline
+                       CPU time. Defaults to 0.1.
+  --filter=<regexp>    Only compare the benchmarks whose names match.''';
+
+const double kDefaultThreshold = 0.1;
+
+/// A benchmark whose CPU time grew by more than the threshold.
+class Regression {
+  Regression(this.name, this.baseline, this.current);
+
+  final String name;
+
+  /// The CPU times of the benchmark, in nanoseconds.
+  final double baseline;
+  final double current;
+
+  double get slowdown => current / baseline - 1;
+
+  @override
+  String toString() {
+    final String percent = (slowdown * 100).toStringAsFixed(1);
+    return '$name: ${baseline.toStringAsFixed(0)} ns -> '
+        '${current.toStringAsFixed(0)} ns (+$percent%)';
+  }
+}
+
+double _nanosecondsPer(String timeUnit) {
+  switch (timeUnit) {
+    case 'us':
+      return 1e3;
+    case 'ms':
+      return 1e6;
+    case 's':
+      return 1e9;
+    default:
+      return 1;
+  }
+}
+
+/// Returns the CPU time of every benchmark in a Google Benchmark JSON file, in
+/// nanoseconds. Aggregates like complexity estimates are skipped.
+Map<String, double> readCpuTimes(String jsonFileName) {
+  final Map<String, dynamic> json =
+      jsonDecode(File(jsonFileName).readAsStringSync()) as Map<String, dynamic>;
+  final Map<String, double> times = <String, double>{};
+  for (final dynamic benchmark in json['benchmarks'] as List<dynamic>) {
+    final Map<String, dynamic> entry = benchmark as Map<String, dynamic>;
+    if (!entry.containsKey('cpu_time')) {
+      continue;
+    }
+    final double cpuTime = (entry['cpu_time'] as num).toDouble();
+    times[entry['name'] as String] =
+        cpuTime * _nanosecondsPer(entry['time_unit'] as String);
+  }
+  return times;
+}
+
+/// Returns the benchmarks matching [filter] that are slower in [current] than
+/// in [baseline] by more than [threshold]. Benchmarks that only exist in one
+/// of the runs are ignored.
+List<Regression> findRegressions(
+  Map<String, double> baseline,
+  Map<String, double> current, {
+  double threshold = kDefaultThreshold,
+  RegExp filter,
+}) {
+  final List<Regression> regressions = <Regression>[];
+  for (final String name in current.keys) {
+    if (!baseline.containsKey(name) ||
+        (filter != null && !filter.hasMatch(name))) {
+      continue;
+    }
+    final Regression regression =
+        Regression(name, baseline[name], current[name]);
+    if (regression.baseline > 0 && regression.slowdown > threshold) {
+      regressions.add(regression);
+    }
+  }
+  return regressions;
+}
+
+void main(List<String> args) {
+  double threshold = kDefaultThreshold;
+  RegExp filter;
+  final List<String> files = <String>[];
+  for (final String arg in args) {
+    if (arg.startsWith('--threshold=')) {
+      threshold = double.parse(arg.substring('--threshold='.length));
+    } else if (arg.startsWith('--filter=')) {
+      filter = RegExp(arg.substring('--filter='.length));
+    } else {
+      files.add(arg);
+    }
+  }
+  if (files.length != 2) {
+    stderr.writeln(kUsage);
+    exitCode = 2;
+    return;
+  }
+
+  final List<Regression> regressions = findRegressions(
+    readCpuTimes(files[0]),
+    readCpuTimes(files[1]),
+    threshold: threshold,
+    filter: filter,
+  );
+  if (regressions.isEmpty) {
+    print('No benchmark regressed by more than ${threshold * 100}%.');
+    return;
+  }
+  stderr.writeln(
+      '${regressions.length} benchmarks regressed by more than '
+      '${threshold * 100}%:');
+  regressions.forEach(stderr.writeln);
+  exitCode = 1;
+}
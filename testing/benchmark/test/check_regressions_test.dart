@@ -0,0 +1,65 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// @dart = 2.6
+
+import 'package:litetest/litetest.dart';
+import 'package:path/path.dart' as p;
+
+import '../bin/check_regressions.dart' as cr;
+
+void main() {
+  test('readCpuTimes() skips aggregates', () {
+    final String exampleJson = p.join('example', 'txt_benchmarks.json');
+    final Map<String, double> times = cr.readCpuTimes(exampleJson);
+
+    expect(times['BM_PaintRecordInit'], equals(101.0));
+    expect(times['BM_ParagraphShortLayout'], equals(4460.0));
+    expect(times.containsKey('BM_ParagraphStylesBigO_BigO'), false);
+  });
+
+  test('findRegressions() applies the threshold', () {
+    final Map<String, double> baseline = <String, double>{
+      'Faster': 100.0,
+      'Slower': 100.0,
+      'MuchSlower': 100.0,
+      'Removed': 100.0,
+    };
+    final Map<String, double> current = <String, double>{
+      'Faster': 80.0,
+      'Slower': 105.0,
+      'MuchSlower': 150.0,
+      'Added': 100.0,
+    };
+
+    final List<cr.Regression> regressions =
+        cr.findRegressions(baseline, current);
+    expect(regressions.length, equals(1));
+    expect(regressions[0].name, equals('MuchSlower'));
+
+    expect(
+      cr.findRegressions(baseline, current, threshold: 0.01).length,
+      equals(2),
+    );
+  });
+
+  test('findRegressions() applies the filter', () {
+    final Map<String, double> baseline = <String, double>{
+      'ParagraphCorpusFixture/Shape/0': 100.0,
+      'ParagraphFixture/ShortLayout': 100.0,
+    };
+    final Map<String, double> current = <String, double>{
+      'ParagraphCorpusFixture/Shape/0': 200.0,
+      'ParagraphFixture/ShortLayout': 200.0,
+    };
+
+    final List<cr.Regression> regressions = cr.findRegressions(
+      baseline,
+      current,
+      filter: RegExp('ParagraphCorpus'),
+    );
+    expect(regressions.length, equals(1));
+    expect(regressions[0].name, equals('ParagraphCorpusFixture/Shape/0'));
+  });
+}
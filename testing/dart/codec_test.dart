@@ -85,6 +85,36 @@ void main() {
       <int>[0, 240, 246],
     ]));
   });
+
+  test('getNextFrame fails when the codec is disposed', () async {
+    for (final String fileName in <String>['baby_tux.png', 'test640x479.gif']) {
+      final Uint8List data = await _getSkiaResource(fileName).readAsBytes();
+      final ui.Codec codec = await ui.instantiateImageCodec(data);
+      final Future<ui.FrameInfo> frame = codec.getNextFrame();
+      codec.dispose();
+      try {
+        await frame;
+        fail('exception not thrown');
+      } on Exception catch (e) {
+        expect(e.toString(), contains('Codec failed'));
+      }
+    }
+  });
+
+  test('decodes with every priority', () async {
+    final Uint8List data = await _getSkiaResource('baby_tux.png').readAsBytes();
+    for (final ui.ImageDecodePriority priority in ui.ImageDecodePriority.values) {
+      final ui.Codec codec = await ui.instantiateImageCodec(data);
+      codec.setDecodePriority(priority);
+      final Future<ui.FrameInfo> frame = codec.getNextFrame();
+      // Changing the priority of a decode in progress is allowed.
+      codec.setDecodePriority(ui.ImageDecodePriority.visible);
+      final ui.FrameInfo frameInfo = await frame;
+      expect(frameInfo.image.width, 240);
+      expect(frameInfo.image.height, 246);
+      codec.dispose();
+    }
+  });
 }
 
 /// Returns a File handle to a file in the skia/resources directory.
@@ -51,6 +51,51 @@ void main() {
     final List<int> expected = await readFile('square.png');
     expect(Uint8List.view(data.buffer), expected);
   });
+
+  test('Image.toByteData PNG format uses the encoding options', () async {
+    final Image image = await Square4x4Image.image;
+    final ByteData data = (await image.toByteData(
+      format: ImageByteFormat.png,
+      options: const ImageEncodingOptions(compressionLevel: 0, pngFilter: PngFilter.none),
+    ))!;
+    final List<int> expected = await readFile('square.png');
+    expect(data.lengthInBytes, greaterThan(expected.length));
+    expect(await decodeToRgba(data), Square4x4Image.bytes);
+  });
+
+  test('Image.toByteData QOI format works with simple image', () async {
+    final Image image = await Square4x4Image.image;
+    final ByteData data = (await image.toByteData(format: ImageByteFormat.qoi))!;
+    expect(String.fromCharCodes(Uint8List.view(data.buffer, 0, 4)), 'qoif');
+    expect(data.getUint32(4), _kWidth);
+    expect(data.getUint32(8), _kWidth);
+    expect(data.lengthInBytes, lessThan(Square4x4Image.bytes.length));
+  });
+
+  test('Image.toByteData WebP format is loss-less at full quality', () async {
+    final Image image = await Square4x4Image.image;
+    final ByteData data = (await image.toByteData(format: ImageByteFormat.webp))!;
+    expect(await decodeToRgba(data), Square4x4Image.bytes);
+  });
+
+  test('Image.toByteData WebP format encodes lossy images', () async {
+    final Image image = await Square4x4Image.image;
+    final ByteData data = (await image.toByteData(
+      format: ImageByteFormat.webp,
+      options: const ImageEncodingOptions(quality: 50),
+    ))!;
+    final Codec codec = await instantiateImageCodec(Uint8List.view(data.buffer));
+    final FrameInfo frame = await codec.getNextFrame();
+    expect(frame.image.width, _kWidth);
+    expect(frame.image.height, _kWidth);
+  });
+}
+
+Future<List<int>> decodeToRgba(ByteData encoded) async {
+  final Codec codec = await instantiateImageCodec(Uint8List.view(encoded.buffer));
+  final FrameInfo frame = await codec.getNextFrame();
+  final ByteData data = (await frame.image.toByteData())!;
+  return Uint8List.view(data.buffer);
 }
 
 class Square4x4Image {
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+// FlutterTesterOptions=--flutter-assets-dir=flutter/testing/resources
+
 import 'dart:async';
 import 'dart:io';
 import 'dart:typed_data';
@@ -37,6 +39,49 @@ void main() {
     expect(codec.frameCount, 1);
   });
 
+  test('basic image descriptor - encoded - from file path', () async {
+    final String filePath =
+        path.join('flutter', 'testing', 'resources', 'square.png');
+    final ImmutableBuffer buffer = await ImmutableBuffer.fromFilePath(filePath);
+    expect(buffer.length, File(filePath).lengthSync());
+
+    final ImageDescriptor descriptor = await ImageDescriptor.encoded(buffer);
+    expect(descriptor.width, 10);
+    expect(descriptor.height, 10);
+    expect(descriptor.bytesPerPixel, 4);
+  });
+
+  test('ImmutableBuffer.fromFilePath throws for a missing file', () async {
+    bool threw = false;
+    try {
+      await ImmutableBuffer.fromFilePath('does/not/exist.png');
+    } on Exception {
+      threw = true;
+    }
+    expect(threw, true);
+  });
+
+  test('basic image descriptor - encoded - from asset', () async {
+    final ImmutableBuffer buffer = await ImmutableBuffer.fromAsset('square.png');
+    expect(buffer.length,
+        File(path.join('flutter', 'testing', 'resources', 'square.png')).lengthSync());
+
+    final ImageDescriptor descriptor = await ImageDescriptor.encoded(buffer);
+    expect(descriptor.width, 10);
+    expect(descriptor.height, 10);
+    expect(descriptor.bytesPerPixel, 4);
+  });
+
+  test('ImmutableBuffer.fromAsset throws for a missing asset', () async {
+    bool threw = false;
+    try {
+      await ImmutableBuffer.fromAsset('does/not/exist.png');
+    } on Exception {
+      threw = true;
+    }
+    expect(threw, true);
+  });
+
   test('basic image descriptor - encoded - animated', () async {
     final Uint8List bytes = await _getSkiaResource('test640x479.gif').readAsBytes();
     final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);
@@ -70,6 +115,63 @@ void main() {
     expect(codec.frameCount, 1);
   });
 
+  test('incremental image descriptor - png', () async {
+    final Uint8List bytes = await readFile('square.png');
+    final IncrementalImageDescriptor descriptor = IncrementalImageDescriptor();
+    final int half = bytes.length ~/ 2;
+    descriptor.addChunk(await ImmutableBuffer.fromUint8List(bytes.sublist(0, half)));
+
+    final PartialImageInfo partial = await descriptor.decode();
+    expect(partial.isComplete, false);
+    expect(partial.decodedRows < 10, true);
+    expect(partial.image?.height ?? 0, partial.decodedRows);
+    partial.image?.dispose();
+
+    descriptor.addChunk(await ImmutableBuffer.fromUint8List(bytes.sublist(half)));
+    descriptor.close();
+    final PartialImageInfo complete = await descriptor.decode();
+    expect(complete.isComplete, true);
+    expect(complete.decodedRows, 10);
+    expect(complete.image!.width, 10);
+    expect(complete.image!.height, 10);
+    complete.image!.dispose();
+    descriptor.dispose();
+  });
+
+  test('incremental image descriptor - animated', () async {
+    final Uint8List bytes = await _getSkiaResource('test640x479.gif').readAsBytes();
+    final IncrementalImageDescriptor descriptor = IncrementalImageDescriptor();
+    descriptor.addChunk(await ImmutableBuffer.fromUint8List(bytes));
+
+    // Images that cannot be decoded incrementally wait for all their data.
+    final PartialImageInfo partial = await descriptor.decode();
+    expect(partial.isComplete, false);
+    expect(partial.image, null);
+
+    descriptor.close();
+    final PartialImageInfo complete = await descriptor.decode();
+    expect(complete.isComplete, true);
+    expect(complete.image!.width, 640);
+    expect(complete.image!.height, 479);
+    complete.image!.dispose();
+    descriptor.dispose();
+  });
+
+  test('incremental image descriptor - invalid data', () async {
+    final IncrementalImageDescriptor descriptor = IncrementalImageDescriptor();
+    descriptor.addChunk(await ImmutableBuffer.fromUint8List(Uint8List(64)));
+    descriptor.close();
+
+    bool threw = false;
+    try {
+      await descriptor.decode();
+    } on Exception {
+      threw = true;
+    }
+    expect(threw, true);
+    descriptor.dispose();
+  });
+
   test('HEIC image', () async {
     final Uint8List bytes = await readFile('grill_chicken.heic');
     final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(bytes);
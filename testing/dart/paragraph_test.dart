@@ -59,4 +59,55 @@ void main() {
       );
     }
   });
+
+  test('lays out a paragraph asynchronously', () async {
+    const double fontSize = 10.0;
+    final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+      fontFamily: 'Ahem',
+      fontSize: fontSize,
+    ));
+    builder.addText('Test Ahem');
+    final Paragraph paragraph = builder.build();
+    await paragraph.layoutAsync(const ParagraphConstraints(width: fontSize * 5.0));
+
+    expect(paragraph.height, closeTo(fontSize * 2.0, 0.001));
+    expect(paragraph.width, closeTo(fontSize * 5.0, 0.001));
+    expect(paragraph.maxIntrinsicWidth, closeTo(fontSize * 9.0, 0.001));
+  });
+
+  test('lays out several paragraphs in parallel', () async {
+    const double fontSize = 10.0;
+    final List<Paragraph> paragraphs = <Paragraph>[];
+    final List<ParagraphConstraints> constraints = <ParagraphConstraints>[];
+    for (int lines = 1; lines <= 4; lines += 1) {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+        fontFamily: 'Ahem',
+        fontSize: fontSize,
+      ));
+      builder.addText(List<String>.filled(lines, 'Test').join(' '));
+      paragraphs.add(builder.build());
+      constraints.add(const ParagraphConstraints(width: fontSize * 4.0));
+    }
+    await Paragraph.layoutAll(paragraphs, constraints);
+
+    for (int index = 0; index < paragraphs.length; index += 1) {
+      expect(paragraphs[index].height, closeTo(fontSize * (index + 1), 0.001));
+    }
+  });
+
+  test('synchronous layout supersedes a pending asynchronous layout', () async {
+    const double fontSize = 10.0;
+    final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+      fontFamily: 'Ahem',
+      fontSize: fontSize,
+    ));
+    builder.addText('Test Ahem');
+    final Paragraph paragraph = builder.build();
+    final Future<void> pending = paragraph.layoutAsync(const ParagraphConstraints(width: fontSize * 5.0));
+    paragraph.layout(const ParagraphConstraints(width: fontSize * 20.0));
+    await pending;
+
+    expect(paragraph.height, closeTo(fontSize, 0.001));
+    expect(paragraph.width, closeTo(fontSize * 20.0, 0.001));
+  });
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <minikin/FontCollection.h>
 #include <minikin/Layout.h>
 
 #include <cstring>
@@ -33,6 +34,7 @@
 #include "txt/font_weight.h"
 #include "txt/paragraph.h"
 #include "txt/paragraph_builder_txt.h"
+#include "txt/text_blob_cache.h"
 
 namespace txt {
 
@@ -78,6 +80,58 @@ BENCHMARK_F(ParagraphFixture, ShortLayout)(benchmark::State& state) {
   }
 }
 
+// Builds and lays out many short labels, as a list of settings or a table
+// does. Every label breaks its lines once, so the cost of preparing the line
+// breaker is a large share of the work.
+static void BM_ShortLabels(benchmark::State& state,
+                           std::shared_ptr<FontCollection> font_collection,
+                           const std::vector<const char*>& labels) {
+  std::vector<std::u16string> u16_labels;
+  for (const char* label : labels) {
+    auto icu_text = icu::UnicodeString::fromUTF8(label);
+    u16_labels.emplace_back(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+  }
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  while (state.KeepRunning()) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+      txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+      builder.PushStyle(text_style);
+      builder.AddText(u16_labels[i % u16_labels.size()]);
+      builder.Pop();
+      auto paragraph = BuildParagraph(builder);
+      paragraph->Layout(300);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(ParagraphFixture, ShortLabelsAscii)
+(benchmark::State& state) {
+  BM_ShortLabels(state, font_collection_,
+                 {"Settings", "Wi-Fi", "Bluetooth", "Display", "Sound",
+                  "Battery", "Storage: 12 GB used", "About phone"});
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ShortLabelsAscii)
+    ->RangeMultiplier(4)
+    ->Range(1 << 8, 1 << 12);
+
+BENCHMARK_DEFINE_F(ParagraphFixture, ShortLabelsNonAscii)
+(benchmark::State& state) {
+  BM_ShortLabels(state, font_collection_,
+                 {"Param\u00e8tres", "R\u00e9seau", "\u00c9cran", "Son",
+                  "Batterie (80 %)", "Stockage", "\u00c0 propos",
+                  "http://example.com"});
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ShortLabelsNonAscii)
+    ->RangeMultiplier(4)
+    ->Range(1 << 8, 1 << 12);
+
 BENCHMARK_F(ParagraphFixture, LongLayout)(benchmark::State& state) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
@@ -119,6 +173,87 @@ BENCHMARK_F(ParagraphFixture, LongLayout)(benchmark::State& state) {
   }
 }
 
+// Reports how many text blobs were reused from the text blob cache instead of
+// being allocated since |before| was sampled.
+static void ReportTextBlobCacheUse(benchmark::State& state,
+                                   const TextBlobCache::Stats& before) {
+  TextBlobCache::Stats after = TextBlobCache::GetInstance().GetStats();
+  const size_t reused = after.hits - before.hits;
+  const size_t allocated = after.misses - before.misses;
+  state.SetLabel("text blobs reused: " + std::to_string(reused) + " of " +
+                 std::to_string(reused + allocated));
+}
+
+BENCHMARK_F(ParagraphFixture, ResizeLayout)(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  // Only the width changes between layouts, as when a window is resized.
+  bool wide = false;
+  TextBlobCache::Stats before = TextBlobCache::GetInstance().GetStats();
+  while (state.KeepRunning()) {
+    paragraph->Layout(wide ? 400 : 300);
+    wide = !wide;
+  }
+  ReportTextBlobCacheUse(state, before);
+}
+
+BENCHMARK_F(ParagraphFixture, ListItemsLayout)(benchmark::State& state) {
+  // Short paragraphs that repeat across rows, as in lists and tables.
+  const char* items[] = {"Inbox", "Starred", "Sent", "Drafts", "12:45 PM",
+                         "Yesterday", "Read more", "Reply"};
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  std::vector<std::unique_ptr<ParagraphTxt>> paragraphs;
+  for (size_t row = 0; row < 64; row++) {
+    auto icu_text = icu::UnicodeString::fromUTF8(items[row % 8]);
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    paragraphs.push_back(BuildParagraph(builder));
+  }
+
+  TextBlobCache::Stats before = TextBlobCache::GetInstance().GetStats();
+  while (state.KeepRunning()) {
+    for (auto& paragraph : paragraphs) {
+      paragraph->SetDirty();
+      paragraph->Layout(300);
+    }
+  }
+  ReportTextBlobCacheUse(state, before);
+}
+
 BENCHMARK_F(ParagraphFixture, JustifyLayout)(benchmark::State& state) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
@@ -245,6 +380,47 @@ BENCHMARK_REGISTER_F(ParagraphFixture, StylesBigO)
     ->Range(1 << 3, 1 << 12)
     ->Complexity(benchmark::oN);
 
+// Lays out a paragraph on several threads at once. All threads share one font
+// collection and the process-wide layout caches, as paragraphs laid out by
+// different engines or isolates do. Measured in real time, the number of
+// layouts per second should scale with the number of threads.
+static void BM_ParagraphConcurrentLayout(benchmark::State& state) {
+  static std::shared_ptr<FontCollection> font_collection =
+      GetTestFontCollection();
+
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParagraphConcurrentLayout)->ThreadRange(1, 8)->UseRealTime();
+
 BENCHMARK_F(ParagraphFixture, PaintSimple)(benchmark::State& state) {
   const char* text = "Hello world! This is a simple sentence to test drawing.";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
@@ -389,6 +565,61 @@ BENCHMARK_REGISTER_F(ParagraphFixture, MinikinDoLayout)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+static void BM_Itemize(benchmark::State& state,
+                       std::shared_ptr<FontCollection> font_collection,
+                       const char* sample) {
+  auto icu_sample = icu::UnicodeString::fromUTF8(sample);
+  std::vector<uint16_t> text;
+  while (text.size() < static_cast<size_t>(state.range(0))) {
+    text.insert(text.end(), icu_sample.getBuffer(),
+                icu_sample.getBuffer() + icu_sample.length());
+  }
+  text.resize(state.range(0));
+
+  auto collection = font_collection->GetMinikinFontCollectionForFamilies(
+      {"Roboto", "Noto Sans CJK JP", "Noto Color Emoji"}, "en-US");
+  minikin::FontStyle font;
+  std::vector<minikin::FontCollection::Run> runs;
+  while (state.KeepRunning()) {
+    runs.clear();
+    collection->itemize(text.data(), text.size(), font, &runs);
+  }
+  state.SetComplexityN(state.range(0));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(ParagraphFixture, ItemizeLatin)(benchmark::State& state) {
+  BM_Itemize(state, font_collection_,
+             "The quick brown fox jumps over the lazy dog. "
+             "Voix ambigu\u00eb d'un c\u0153ur qui au z\u00e9phyr "
+             "pr\u00e9f\u00e8re les jattes de kiwis. ");
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ItemizeLatin)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 14)
+    ->Complexity(benchmark::oN);
+
+BENCHMARK_DEFINE_F(ParagraphFixture, ItemizeCJK)(benchmark::State& state) {
+  BM_Itemize(state, font_collection_,
+             "\u543e\u8f29\u306f\u732b\u3067\u3042\u308b\u3002"
+             "\u540d\u524d\u306f\u307e\u3060\u7121\u3044\u3002");
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ItemizeCJK)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 14)
+    ->Complexity(benchmark::oN);
+
+BENCHMARK_DEFINE_F(ParagraphFixture, ItemizeMixedEmoji)
+(benchmark::State& state) {
+  BM_Itemize(state, font_collection_,
+             "Good morning \U0001F600 see you at \u99c5 \U0001F44D\U0001F3FD "
+             "caf\u00e9 \u2615\uFE0F tonight! ");
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ItemizeMixedEmoji)
+    ->RangeMultiplier(4)
+    ->Range(1 << 7, 1 << 14)
+    ->Complexity(benchmark::oN);
+
 BENCHMARK_DEFINE_F(ParagraphFixture, AddStyleRun)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < 16000 * 2; ++i) {
@@ -0,0 +1,400 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks of the text pipeline on a corpus of real-world documents.
+//
+// Every document is run through each stage of the pipeline on its own, so that
+// a regression can be attributed to a stage, and through the whole pipeline:
+//
+//   Itemize:  splitting the text into runs of the same font.
+//   Shape:    measuring the glyphs of the text, with cold layout caches.
+//   Break:    breaking the measured text into lines.
+//   Blob:     building the text blobs of the shaped glyphs, one run per font.
+//   Layout:   building and laying out the paragraphs, which includes the
+//             stages above.
+//   Paint:    drawing the text blobs of laid out paragraphs to a raster canvas.
+//   Pipeline: building, laying out and painting the paragraphs.
+//
+// The benchmarks are named ParagraphCorpusFixture/<Stage>/<Document index>, and
+// the label of each benchmark is the name of its document. Run them with
+// --benchmark_filter=ParagraphCorpus --benchmark_format=json to get results
+// that can be compared with
+// //flutter/testing/benchmark/bin/check_regressions.dart.
+
+#include <minikin/FontCollection.h>
+#include <minikin/Layout.h>
+#include <minikin/LineBreaker.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/third_party/txt/tests/txt_test_utils.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "third_party/icu/source/common/unicode/unistr.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "txt/font_collection.h"
+#include "txt/font_skia.h"
+#include "txt/paragraph.h"
+#include "txt/paragraph_builder_txt.h"
+#include "txt/paragraph_style.h"
+#include "txt/text_style.h"
+
+namespace txt {
+
+namespace {
+
+constexpr double kLayoutWidth = 400;
+constexpr double kFontSize = 16;
+
+struct CorpusDocument {
+  const char* name;
+  std::vector<std::string> font_families;
+  const char* locale;
+  TextDirection direction;
+  std::vector<const char*> paragraphs;
+};
+
+const std::vector<CorpusDocument>& GetCorpus() {
+  static const std::vector<CorpusDocument>* corpus =
+      new std::vector<CorpusDocument>{
+          {"Latin",
+           {"Roboto"},
+           "en-US",
+           TextDirection::ltr,
+           {
+               "The city council approved the new transit plan on Tuesday "
+               "after a four-hour meeting. Starting in March, buses on the "
+               "northern routes will run every 12 minutes instead of every 20, "
+               "and the night service will be extended until 1:30 a.m. on "
+               "weekends.",
+               "\u201cIt\u2019s not perfect, but it\u2019s a real step "
+               "forward,\u201d said one resident, who has commuted from the "
+               "suburbs for nearly fifteen years. Others questioned the cost "
+               "\u2014 an estimated $4.2 million per year \u2014 and asked "
+               "whether fares would rise.",
+               "Caf\u00e9 owners along the route welcomed the news. \u00abLes "
+               "clients arriveront plus t\u00f4t le matin\u00bb, explained the "
+               "owner of a small bakery, adding that the na\u00efve hope of a "
+               "quiet winter was long gone.",
+           }},
+          {"Bidi",
+           {"Roboto", "Noto Naskh Arabic"},
+           "ar",
+           TextDirection::rtl,
+           {
+               "\u0623\u0639\u0644\u0646\u062a \u0627\u0644\u0634\u0631\u0643"
+               "\u0629 \u0639\u0646 \u0625\u0635\u062f\u0627\u0631 "
+               "\u0627\u0644\u0646\u0633\u062e\u0629 3.2 \u0645\u0646 "
+               "\u062a\u0637\u0628\u064a\u0642 Flutter Gallery "
+               "\u064a\u0648\u0645 \u0627\u0644\u062e\u0645\u064a\u0633 "
+               "\u0627\u0644\u0645\u0627\u0636\u064a\u060c \u0645\u0639 "
+               "\u062f\u0639\u0645 \u0643\u0627\u0645\u0644 "
+               "\u0644\u0644\u063a\u0629 \u0627\u0644\u0639\u0631\u0628\u064a"
+               "\u0629.",
+               "\u05d4\u05e4\u05d2\u05d9\u05e9\u05d4 "
+               "\u05ea\u05ea\u05e7\u05d9\u05d9\u05dd \u05d1\u05d7\u05d3\u05e8 "
+               "204 \u05d1\u05e9\u05e2\u05d4 10:30 (\u05dc\u05e4\u05d9 "
+               "\u05e9\u05e2\u05d5\u05df \u05d9\u05e8\u05d5\u05e9\u05dc\u05d9"
+               "\u05dd), \u05d5\u05d4\u05e7\u05d9\u05e9\u05d5\u05e8 "
+               "\u05d9\u05e9\u05dc\u05d7 \u05dc\u05db\u05ea\u05d5\u05d1\u05ea "
+               "team@example.com \u05de\u05e8\u05d0\u05e9.",
+               "\u0627\u0644\u0633\u0639\u0631: 1,250 \u062f\u0631\u0647\u0645 "
+               "(\u0634\u0627\u0645\u0644 \u0627\u0644\u0636\u0631\u064a\u0628"
+               "\u0629) \u2014 \u0627\u0644\u0639\u0631\u0636 "
+               "\u0635\u0627\u0644\u062d \u062d\u062a\u0649 31/12 "
+               "\u0641\u0642\u0637. Order ID: #A-7731.",
+           }},
+          {"CJK",
+           {"Source Han Serif CN", "Noto Sans CJK JP", "Roboto"},
+           "zh-CN",
+           TextDirection::ltr,
+           {
+               "\u4eca\u5929\u4e0b\u5348\u4e09\u70b9\uff0c\u6211\u4eec\u5728"
+               "\u4f1a\u8bae\u5ba4\u8ba8\u8bba\u4e86\u65b0\u7248\u672c\u7684"
+               "\u53d1\u5e03\u8ba1\u5212\u3002\u9884\u8ba1\u5728 2024 \u5e74 3 "
+               "\u6708\u5e95\u5b8c\u6210\u6240\u6709\u6d4b\u8bd5\uff0c\u5e76"
+               "\u4e8e 4 \u6708\u521d\u6b63\u5f0f\u4e0a\u7ebf\u3002",
+               "\u543e\u8f29\u306f\u732b\u3067\u3042\u308b\u3002\u540d\u524d"
+               "\u306f\u307e\u3060\u7121\u3044\u3002\u3069\u3053\u3067\u751f"
+               "\u308c\u305f\u304b\u3068\u3093\u3068\u898b\u5f53\u304c\u3064"
+               "\u304b\u306c\u3002\u4f55\u3067\u3082\u8584\u6697\u3044\u3058"
+               "\u3081\u3058\u3081\u3057\u305f\u6240\u3067\u30cb\u30e3\u30fc"
+               "\u30cb\u30e3\u30fc\u6ce3\u3044\u3066\u3044\u305f\u4e8b\u3060"
+               "\u3051\u306f\u8a18\u61b6\u3057\u3066\u3044\u308b\u3002",
+               "\ud55c\uad6d\uc5b4 \ud14d\uc2a4\ud2b8\ub3c4 \ud568\uaed8 "
+               "\ud45c\uc2dc\ub429\ub2c8\ub2e4. \uc8fc\ubb38 "
+               "\ubc88\ud638\ub294 12345\uc774\uba70, \ubc30\uc1a1\uc740 "
+               "\ub0b4\uc77c \uc624\uc804\uc5d0 "
+               "\uc2dc\uc791\ub429\ub2c8\ub2e4.",
+           }},
+          {"EmojiChat",
+           {"Roboto", "Noto Color Emoji"},
+           "en-US",
+           TextDirection::ltr,
+           {
+               "omg are you coming tonight?? \U0001F389\U0001F389\U0001F389",
+               "yes!! \U0001F60D\U0001F60D running 10 min late tho "
+               "\U0001F605\U0001F697\U0001F4A8",
+               "no worries \U0001F44D\U0001F3FD grab me a \u2615\ufe0f on the "
+               "way? \U0001F64F",
+               "\U0001F468\u200d\U0001F469\u200d\U0001F467\u200d\U0001F466 the "
+               "whole family is here \U0001F1EB\U0001F1F7\U0001F1EF\U0001F1F5 "
+               "\u2764\ufe0f\u2764\ufe0f",
+               "haha ok \U0001F602\U0001F602\U0001F602 see u soon "
+               "\U0001F44B\U0001F3FB\U0001F31F",
+           }},
+      };
+  return *corpus;
+}
+
+std::u16string ToUtf16(const char* text) {
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  return std::u16string(icu_text.getBuffer(),
+                        icu_text.getBuffer() + icu_text.length());
+}
+
+// Registers one benchmark per document of the corpus.
+void CorpusArguments(benchmark::internal::Benchmark* benchmark) {
+  for (size_t i = 0; i < GetCorpus().size(); i++) {
+    benchmark->Arg(i);
+  }
+}
+
+}  // namespace
+
+class ParagraphCorpusFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) {
+    font_collection_ = GetTestFontCollection();
+    document_ = &GetCorpus()[state.range(0)];
+    for (const char* paragraph : document_->paragraphs) {
+      paragraphs_.push_back(ToUtf16(paragraph));
+    }
+
+    text_style_.font_families = document_->font_families;
+    text_style_.locale = document_->locale;
+    text_style_.font_size = kFontSize;
+    text_style_.color = SK_ColorBLACK;
+    paragraph_style_.text_direction = document_->direction;
+
+    minikin_collection_ = font_collection_->GetMinikinFontCollectionForFamilies(
+        document_->font_families, document_->locale);
+    minikin_paint_.size = kFontSize;
+
+    bitmap_ = std::make_unique<SkBitmap>();
+    bitmap_->allocN32Pixels(static_cast<int>(kLayoutWidth), 1000);
+    canvas_ = std::make_unique<SkCanvas>(*bitmap_);
+    canvas_->clear(SK_ColorWHITE);
+  }
+
+  void TearDown(const benchmark::State& state) {
+    canvas_.reset();
+    bitmap_.reset();
+    minikin_collection_.reset();
+    paragraphs_.clear();
+    font_collection_.reset();
+  }
+
+ protected:
+  std::shared_ptr<FontCollection> font_collection_;
+  const CorpusDocument* document_ = nullptr;
+  std::vector<std::u16string> paragraphs_;
+  TextStyle text_style_;
+  ParagraphStyle paragraph_style_;
+  std::shared_ptr<minikin::FontCollection> minikin_collection_;
+  minikin::FontStyle minikin_style_;
+  minikin::MinikinPaint minikin_paint_;
+  std::unique_ptr<SkCanvas> canvas_;
+  std::unique_ptr<SkBitmap> bitmap_;
+
+  bool IsRtl() const { return document_->direction == TextDirection::rtl; }
+
+  const uint16_t* GetText(const std::u16string& paragraph) const {
+    return reinterpret_cast<const uint16_t*>(paragraph.data());
+  }
+
+  std::unique_ptr<Paragraph> BuildAndLayout(const std::u16string& text) {
+    ParagraphBuilderTxt builder(paragraph_style_, font_collection_);
+    builder.PushStyle(text_style_);
+    builder.AddText(text);
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(kLayoutWidth);
+    return paragraph;
+  }
+
+  // Measures the advance of every code unit of the paragraph.
+  std::vector<float> Measure(const std::u16string& paragraph) {
+    std::vector<float> advances(paragraph.size());
+    minikin::Layout::measureText(GetText(paragraph), 0, paragraph.size(),
+                                 paragraph.size(), IsRtl(), minikin_style_,
+                                 minikin_paint_, minikin_collection_,
+                                 advances.data());
+    return advances;
+  }
+
+  void ReportProcessed(benchmark::State& state) {
+    size_t length = 0;
+    for (const std::u16string& paragraph : paragraphs_) {
+      length += paragraph.size();
+    }
+    state.SetLabel(document_->name);
+    state.SetItemsProcessed(state.iterations() * length);
+  }
+};
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Itemize)(benchmark::State& state) {
+  std::vector<minikin::FontCollection::Run> runs;
+  while (state.KeepRunning()) {
+    for (const std::u16string& paragraph : paragraphs_) {
+      runs.clear();
+      minikin_collection_->itemize(GetText(paragraph), paragraph.size(),
+                                   minikin_style_, &runs);
+    }
+    benchmark::DoNotOptimize(runs.data());
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Itemize)->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Shape)(benchmark::State& state) {
+  std::vector<float> advances;
+  while (state.KeepRunning()) {
+    // Shaping would otherwise be served from the layout cache.
+    state.PauseTiming();
+    minikin::Layout::purgeCaches();
+    state.ResumeTiming();
+    for (const std::u16string& paragraph : paragraphs_) {
+      advances = Measure(paragraph);
+    }
+    benchmark::DoNotOptimize(advances.data());
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Shape)->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Break)(benchmark::State& state) {
+  std::vector<std::vector<float>> widths;
+  for (const std::u16string& paragraph : paragraphs_) {
+    widths.push_back(Measure(paragraph));
+  }
+
+  minikin::LineBreaker breaker;
+  breaker.setLocale();
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < paragraphs_.size(); i++) {
+      const std::u16string& paragraph = paragraphs_[i];
+      breaker.setLineWidths(0.0f, 0, kLayoutWidth);
+      breaker.resize(paragraph.size());
+      memcpy(breaker.buffer(), paragraph.data(),
+             paragraph.size() * sizeof(paragraph[0]));
+      breaker.setText();
+      memcpy(breaker.charWidths(), widths[i].data(),
+             widths[i].size() * sizeof(float));
+      breaker.addMeasuredStyleRun(&minikin_paint_, minikin_collection_,
+                                  minikin_style_, 0, paragraph.size(),
+                                  IsRtl());
+      benchmark::DoNotOptimize(breaker.computeBreaks());
+      breaker.finish();
+    }
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Break)->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Blob)(benchmark::State& state) {
+  std::vector<std::unique_ptr<minikin::Layout>> layouts;
+  for (const std::u16string& paragraph : paragraphs_) {
+    auto layout = std::make_unique<minikin::Layout>();
+    layout->doLayout(GetText(paragraph), 0, paragraph.size(), paragraph.size(),
+                     IsRtl(), minikin_style_, minikin_paint_,
+                     minikin_collection_);
+    layouts.push_back(std::move(layout));
+  }
+
+  SkFont font;
+  font.setSize(kFontSize);
+  std::vector<SkGlyphID> glyphs;
+  std::vector<SkPoint> positions;
+  while (state.KeepRunning()) {
+    for (const std::unique_ptr<minikin::Layout>& layout : layouts) {
+      SkTextBlobBuilder builder;
+      const size_t glyph_count = layout->nGlyphs();
+      for (size_t start = 0; start < glyph_count;) {
+        // The glyphs drawn with the same font share a run of the blob.
+        const minikin::MinikinFont* run_font = layout->getFont(start);
+        size_t end = start;
+        glyphs.clear();
+        positions.clear();
+        for (; end < glyph_count && layout->getFont(end) == run_font; end++) {
+          glyphs.push_back(layout->getGlyphId(end));
+          positions.push_back(SkPoint::Make(layout->getX(end),
+                                            layout->getY(end)));
+        }
+        font.setTypeface(
+            static_cast<const FontSkia*>(run_font)->GetSkTypeface());
+        const SkTextBlobBuilder::RunBuffer& buffer =
+            builder.allocRunPos(font, glyphs.size());
+        memcpy(buffer.glyphs, glyphs.data(),
+               glyphs.size() * sizeof(SkGlyphID));
+        memcpy(buffer.pos, positions.data(),
+               positions.size() * sizeof(SkPoint));
+        start = end;
+      }
+      benchmark::DoNotOptimize(builder.make());
+    }
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Blob)->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Layout)(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    for (const std::u16string& paragraph : paragraphs_) {
+      benchmark::DoNotOptimize(BuildAndLayout(paragraph));
+    }
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Layout)->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Paint)(benchmark::State& state) {
+  std::vector<std::unique_ptr<Paragraph>> laid_out;
+  for (const std::u16string& paragraph : paragraphs_) {
+    laid_out.push_back(BuildAndLayout(paragraph));
+  }
+
+  while (state.KeepRunning()) {
+    double y = 0;
+    for (const std::unique_ptr<Paragraph>& paragraph : laid_out) {
+      paragraph->Paint(canvas_.get(), 0, y);
+      y += paragraph->GetHeight();
+    }
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Paint)->Apply(CorpusArguments);
+
+BENCHMARK_DEFINE_F(ParagraphCorpusFixture, Pipeline)
+(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    double y = 0;
+    for (const std::u16string& paragraph : paragraphs_) {
+      auto laid_out = BuildAndLayout(paragraph);
+      laid_out->Paint(canvas_.get(), 0, y);
+      y += laid_out->GetHeight();
+    }
+  }
+  ReportProcessed(state);
+}
+BENCHMARK_REGISTER_F(ParagraphCorpusFixture, Pipeline)
+    ->Apply(CorpusArguments);
+
+}  // namespace txt
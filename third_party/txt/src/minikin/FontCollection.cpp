@@ -43,7 +43,7 @@ static inline T max(T a, T b) {
 const uint32_t EMOJI_STYLE_VS = 0xFE0F;
 const uint32_t TEXT_STYLE_VS = 0xFE0E;
 
-uint32_t FontCollection::sNextId = 0;
+std::atomic<uint32_t> FontCollection::sNextId = 0;
 
 // libtxt: return a locale string for a language list ID
 std::string GetFontLocale(uint32_t langListId) {
@@ -65,7 +65,6 @@ FontCollection::FontCollection() : mMaxChar(0) {}
 
 bool FontCollection::init(
     const std::vector<std::shared_ptr<FontFamily>>& typefaces) {
-  std::scoped_lock _l(gMinikinLock);
   mId = sNextId++;
   vector<uint32_t> lastChar;
   size_t nTypefaces = typefaces.size();
@@ -130,6 +129,40 @@ bool FontCollection::init(
     ALOGE("Exceeded the maximum indexable cmap coverage.");
     return false;
   }
+  initLatin1Families();
+  return true;
+}
+
+void FontCollection::initLatin1Families() {
+  mLatin1Families.fill(kUnresolvedFamily);
+  if (mRanges.empty()) {
+    return;
+  }
+  const Range& range = mRanges[0];
+  for (uint32_t ch = 0; ch < kLatin1Size && ch < mMaxChar; ch++) {
+    int coveringFamily = -1;
+    size_t coveringCount = 0;
+    for (size_t i = range.start; i < range.end; i++) {
+      if (mFamilies[mFamilyVec[i]]->getCoverage().get(ch)) {
+        if (coveringFamily == -1) {
+          coveringFamily = mFamilyVec[i];
+        }
+        coveringCount++;
+      }
+    }
+    if (coveringFamily == 0 || coveringCount == 1) {
+      mLatin1Families[ch] = static_cast<uint8_t>(coveringFamily);
+    }
+  }
+}
+
+bool FontCollection::isPrimaryLatin1Run(const uint16_t* string,
+                                        size_t string_length) const {
+  for (size_t i = 0; i < string_length; i++) {
+    if (string[i] >= kLatin1Size || mLatin1Families[string[i]] != 0) {
+      return false;
+    }
+  }
   return true;
 }
 
@@ -299,15 +332,22 @@ uint32_t FontCollection::calcVariantMatchingScore(
 // the detail.
 // 3. Highest score wins, with ties resolved to the first font.
 // This method never returns nullptr.
-const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
+std::shared_ptr<FontFamily> FontCollection::getFamilyForChar(
     uint32_t ch,
     uint32_t vs,
     uint32_t langListId,
     int variant) const {
+  if (vs == 0 && ch < kLatin1Size) {
+    const uint8_t index = mLatin1Families[ch];
+    if (index != kUnresolvedFamily) {
+      return mFamilies[index];
+    }
+  }
+
   if (ch >= mMaxChar) {
     // libtxt: check if the fallback font provider can match this character
     if (mFallbackFontProvider) {
-      const std::shared_ptr<FontFamily>& fallback =
+      std::shared_ptr<FontFamily> fallback =
           findFallbackFont(ch, vs, langListId);
       if (fallback) {
         return fallback;
@@ -344,7 +384,7 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
   if (bestFamilyIndex == -1) {
     // libtxt: check if the fallback font provider can match this character
     if (mFallbackFontProvider) {
-      const std::shared_ptr<FontFamily>& fallback =
+      std::shared_ptr<FontFamily> fallback =
           findFallbackFont(ch, vs, langListId);
       if (fallback) {
         return fallback;
@@ -369,26 +409,36 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
                  : mFamilies[bestFamilyIndex];
 }
 
-const std::shared_ptr<FontFamily>& FontCollection::findFallbackFont(
+std::shared_ptr<FontFamily> FontCollection::findFallbackFont(
     uint32_t ch,
     uint32_t vs,
     uint32_t langListId) const {
   std::string locale = GetFontLocale(langListId);
 
-  const auto it = mCachedFallbackFamilies.find(locale);
-  if (it != mCachedFallbackFamilies.end()) {
-    for (const auto& fallbackFamily : it->second) {
-      if (calcCoverageScore(ch, vs, fallbackFamily)) {
-        return fallbackFamily;
+  {
+    std::scoped_lock lock(mCachedFallbackFamiliesMutex);
+    const auto it = mCachedFallbackFamilies.find(locale);
+    if (it != mCachedFallbackFamilies.end()) {
+      for (const auto& fallbackFamily : it->second) {
+        if (calcCoverageScore(ch, vs, fallbackFamily)) {
+          return fallbackFamily;
+        }
       }
     }
   }
 
-  const std::shared_ptr<FontFamily>& fallback =
-      mFallbackFontProvider->matchFallbackFont(ch, GetFontLocale(langListId));
+  // The provider is called without holding the lock since it may take locks
+  // of its own.
+  std::shared_ptr<FontFamily> fallback =
+      mFallbackFontProvider->matchFallbackFont(ch, locale);
 
   if (fallback) {
-    mCachedFallbackFamilies[locale].push_back(fallback);
+    std::scoped_lock lock(mCachedFallbackFamiliesMutex);
+    auto& families = mCachedFallbackFamilies[locale];
+    if (std::find(families.begin(), families.end(), fallback) ==
+        families.end()) {
+      families.push_back(fallback);
+    }
   }
   return fallback;
 }
@@ -434,8 +484,6 @@ bool FontCollection::hasVariationSelector(uint32_t baseCodepoint,
     return false;
   }
 
-  std::scoped_lock _l(gMinikinLock);
-
   // Currently mRanges can not be used here since it isn't aware of the
   // variation sequence.
   for (size_t i = 0; i < mVSFamilyVec.size(); i++) {
@@ -475,6 +523,16 @@ void FontCollection::itemize(const uint16_t* string,
     return;
   }
 
+  // Text made only of Latin-1 characters covered by the first family always
+  // itemizes into a single run of that family. None of these characters are
+  // combining marks, emoji modifiers or variation selectors, so the rules below
+  // could not split the run.
+  if (isPrimaryLatin1Run(string, string_size)) {
+    result->push_back({mFamilies[0]->getClosestMatch(style), 0,
+                       static_cast<int>(string_size)});
+    return;
+  }
+
   const uint32_t kEndOfString = 0xFFFFFFFF;
 
   uint32_t nextCh = 0;
@@ -507,7 +565,7 @@ void FontCollection::itemize(const uint16_t* string,
     }
 
     if (!shouldContinueRun) {
-      const std::shared_ptr<FontFamily>& family = getFamilyForChar(
+      const std::shared_ptr<FontFamily> family = getFamilyForChar(
           ch, isVariationSelector(nextCh) ? nextCh : 0, langListId, variant);
       if (utf16Pos == 0 || family.get() != lastFamily) {
         size_t start = utf16Pos;
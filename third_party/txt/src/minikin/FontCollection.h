@@ -17,8 +17,12 @@
 #ifndef MINIKIN_FONT_COLLECTION_H
 #define MINIKIN_FONT_COLLECTION_H
 
+#include <array>
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -27,6 +31,10 @@
 
 namespace minikin {
 
+// A font collection is immutable once it has been created and configured, so a
+// single instance may be shared by layouts running on several threads. The
+// only state that changes afterwards is the cache of fallback families, which
+// is guarded by its own lock.
 class FontCollection {
  private:
   explicit FontCollection();
@@ -36,11 +44,12 @@ class FontCollection {
       const std::vector<std::shared_ptr<FontFamily>>& typefaces);
 
   // libtxt extension: an interface for looking up fallback fonts for characters
-  // that do not match this collection's font families.
+  // that do not match this collection's font families. May be called from
+  // several threads at once, so the family is returned by value.
   class FallbackFontProvider {
    public:
     virtual ~FallbackFontProvider() = default;
-    virtual const std::shared_ptr<FontFamily>& matchFallbackFont(
+    virtual std::shared_ptr<FontFamily> matchFallbackFont(
         uint32_t ch,
         std::string locale) = 0;
   };
@@ -76,6 +85,8 @@ class FontCollection {
 
   uint32_t getId() const;
 
+  // Must be called before the collection is shared with other threads. The
+  // provider may be called from several threads at once.
   void set_fallback_font_provider(std::unique_ptr<FallbackFontProvider> ffp) {
     mFallbackFontProvider = std::move(ffp);
   }
@@ -84,6 +95,11 @@ class FontCollection {
   static const int kLogCharsPerPage = 8;
   static const int kPageMask = (1 << kLogCharsPerPage) - 1;
 
+  // The Latin-1 code points, which make up the first page of mRanges.
+  static const uint32_t kLatin1Size = 1 << kLogCharsPerPage;
+  // Marks a Latin-1 code point whose family must be chosen by scoring.
+  static const uint8_t kUnresolvedFamily = 0xFF;
+
   // mFamilyVec holds the indices of the mFamilies and mRanges holds the range
   // of indices of mFamilyVec. The maximum number of pages is 0x10FF (U+10FFFF
   // >> 8). The maximum number of the fonts is 0xFF. Thus, technically the
@@ -98,13 +114,20 @@ class FontCollection {
   // Initialize the FontCollection.
   bool init(const std::vector<std::shared_ptr<FontFamily>>& typefaces);
 
-  const std::shared_ptr<FontFamily>& getFamilyForChar(uint32_t ch,
-                                                      uint32_t vs,
-                                                      uint32_t langListId,
-                                                      int variant) const;
+  void initLatin1Families();
+
+  // Returns true if every character of the string is a Latin-1 code point
+  // that always resolves to the first family of this collection.
+  bool isPrimaryLatin1Run(const uint16_t* string, size_t string_length) const;
 
-  const std::shared_ptr<FontFamily>&
-  findFallbackFont(uint32_t ch, uint32_t vs, uint32_t langListId) const;
+  std::shared_ptr<FontFamily> getFamilyForChar(uint32_t ch,
+                                               uint32_t vs,
+                                               uint32_t langListId,
+                                               int variant) const;
+
+  std::shared_ptr<FontFamily> findFallbackFont(uint32_t ch,
+                                               uint32_t vs,
+                                               uint32_t langListId) const;
 
   uint32_t calcFamilyScore(uint32_t ch,
                            uint32_t vs,
@@ -124,7 +147,7 @@ class FontCollection {
                                            const FontFamily& fontFamily);
 
   // static for allocating unique id's
-  static uint32_t sNextId;
+  static std::atomic<uint32_t> sNextId;
 
   // unique id for this font collection (suitable for cache key)
   uint32_t mId;
@@ -145,6 +168,13 @@ class FontCollection {
   std::vector<Range> mRanges;
   std::vector<uint8_t> mFamilyVec;
 
+  // The index into mFamilies of the family used for each Latin-1 code point
+  // when no variation selector follows it, or kUnresolvedFamily if the choice
+  // depends on the requested language or variant. A family is recorded when
+  // it is the first family of the collection or the only one covering the
+  // code point, since calcFamilyScore picks it regardless of the style then.
+  std::array<uint8_t, kLatin1Size> mLatin1Families;
+
   // This vector has pointers to the font family instances which have cmap 14
   // subtables.
   std::vector<std::shared_ptr<FontFamily>> mVSFamilyVec;
@@ -156,8 +186,10 @@ class FontCollection {
   std::unique_ptr<FallbackFontProvider> mFallbackFontProvider;
 
   // libtxt extension: Fallback fonts discovered after this font collection
-  // was constructed.
-  mutable std::map<std::string, std::vector<std::shared_ptr<FontFamily>>>
+  // was constructed. Families are only ever appended, so references to them
+  // stay valid while other threads add to the cache.
+  mutable std::mutex mCachedFallbackFamiliesMutex;
+  mutable std::map<std::string, std::deque<std::shared_ptr<FontFamily>>>
       mCachedFallbackFamilies;
 };
 
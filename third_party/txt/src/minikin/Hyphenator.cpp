@@ -126,15 +126,48 @@ void Hyphenator::hyphenate(vector<HyphenationType>* result,
                            const uint16_t* word,
                            size_t len,
                            const icu::Locale& locale) {
+  std::u16string key(reinterpret_cast<const char16_t*>(word), len);
+  key.push_back(u'\0');
+  for (const char* name = locale.getName(); *name != '\0'; name++) {
+    key.push_back(static_cast<char16_t>(*name));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mMemoMutex);
+    auto it = mMemo.find(key);
+    if (it != mMemo.end()) {
+      *result = it->second;
+      return;
+    }
+  }
+
   result->clear();
   result->resize(len);
+  hyphenateWord(result->data(), word, len, locale);
+
+  std::lock_guard<std::mutex> lock(mMemoMutex);
+  if (mMemo.size() >= MAX_MEMOIZED_WORDS) {
+    mMemo.clear();
+  }
+  mMemo.emplace(std::move(key), *result);
+}
+
+size_t Hyphenator::getMemoizedWordCount() const {
+  std::lock_guard<std::mutex> lock(mMemoMutex);
+  return mMemo.size();
+}
+
+void Hyphenator::hyphenateWord(HyphenationType* result,
+                               const uint16_t* word,
+                               size_t len,
+                               const icu::Locale& locale) {
   const size_t paddedLen = len + 2;  // start and stop code each count for 1
   if (patternData != nullptr && len >= minPrefix + minSuffix &&
       paddedLen <= MAX_HYPHENATED_SIZE) {
     uint16_t alpha_codes[MAX_HYPHENATED_SIZE];
     const HyphenationType hyphenValue = alphabetLookup(alpha_codes, word, len);
     if (hyphenValue != HyphenationType::DONT_BREAK) {
-      hyphenateFromCodes(result->data(), alpha_codes, paddedLen, hyphenValue);
+      hyphenateFromCodes(result, alpha_codes, paddedLen, hyphenValue);
       return;
     }
     // TODO: try NFC normalization
@@ -143,7 +176,7 @@ void Hyphenator::hyphenate(vector<HyphenationType>* result,
   // Note that we will always get here if the word contains a hyphen or a soft
   // hyphen, because the alphabet is not expected to contain a hyphen or a soft
   // hyphen character, so alphabetLookup would return DONT_BREAK.
-  hyphenateWithNoPatterns(result->data(), word, len, locale);
+  hyphenateWithNoPatterns(result, word, len, locale);
 }
 
 // This function determines whether a character is like U+2010 HYPHEN in
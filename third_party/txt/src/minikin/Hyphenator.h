@@ -23,6 +23,8 @@
 #endif  //  U_USING_ICU_NAMESPACE
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include "unicode/locid.h"
@@ -136,6 +138,9 @@ class Hyphenator {
   // Example: word is "hyphen", result is the following, corresponding to
   // "hy-phen": [DONT_BREAK, DONT_BREAK, BREAK_AND_INSERT_HYPHEN, DONT_BREAK,
   // DONT_BREAK, DONT_BREAK]
+  //
+  // libtxt: The results are memoized per word and locale, as the same words
+  // recur throughout a text. This method is thread safe.
   void hyphenate(std::vector<HyphenationType>* result,
                  const uint16_t* word,
                  size_t len,
@@ -156,7 +161,18 @@ class Hyphenator {
                                 size_t minPrefix,
                                 size_t minSuffix);
 
+  // libtxt: Returns the number of words that are currently memoized.
+  size_t getMemoizedWordCount() const;
+
  private:
+  // The maximum number of memoized words. The memo is cleared once it is full.
+  static const size_t MAX_MEMOIZED_WORDS = 1024;
+
+  void hyphenateWord(HyphenationType* result,
+                     const uint16_t* word,
+                     size_t len,
+                     const icu::Locale& locale);
+
   // apply various hyphenation rules including hard and soft hyphens, ignoring
   // patterns
   void hyphenateWithNoPatterns(HyphenationType* result,
@@ -188,6 +204,10 @@ class Hyphenator {
   const uint8_t* patternData;
   size_t minPrefix, minSuffix;
 
+  // Maps a word followed by a NUL and the locale name to its hyphenation.
+  mutable std::mutex mMemoMutex;
+  std::unordered_map<std::u16string, std::vector<HyphenationType>> mMemo;
+
   // accessors for binary data
   const Header* getHeader() const {
     return reinterpret_cast<const Header*>(patternData);
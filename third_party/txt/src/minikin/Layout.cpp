@@ -20,8 +20,11 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,6 +33,9 @@
 #include <utils/LruCache.h>
 #include <utils/WindowsUtils.h>
 
+#include "flutter/fml/macros.h"
+#include "flutter/fml/thread_local.h"
+
 #include <hb-icu.h>
 #include <hb-ot.h>
 
@@ -52,7 +58,6 @@ struct LayoutContext {
 
   void clearHbFonts() {
     for (size_t i = 0; i < hbFonts.size(); i++) {
-      hb_font_set_funcs(hbFonts[i], nullptr, nullptr, nullptr);
       hb_font_destroy(hbFonts[i]);
     }
     hbFonts.clear();
@@ -99,6 +104,15 @@ class LayoutCacheKey {
     mChars = NULL;
   }
 
+  // The memory used by a cache entry for this key and its layout. This must
+  // not change while the entry is cached.
+  size_t getMemoryUsage(const Layout& layout) const {
+    return sizeof(LayoutCacheKey) + mNchars * sizeof(uint16_t) +
+           sizeof(Layout) + layout.mGlyphs.capacity() * sizeof(LayoutGlyph) +
+           layout.mAdvances.capacity() * sizeof(float) +
+           layout.mFaces.capacity() * sizeof(FakedFont);
+  }
+
   void doLayout(Layout* layout,
                 LayoutContext* ctx,
                 const std::shared_ptr<FontCollection>& collection) const {
@@ -129,56 +143,190 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// A shard of the layout cache. Each shard is guarded by its own lock, so that
+// threads laying out text only contend when their words map to the same shard.
+// The shard is bounded by the memory used by its entries rather than by their
+// number, since the size of a shaped word varies with its length.
+class LayoutCacheShard
+    : private android::OnEntryRemoved<LayoutCacheKey, std::shared_ptr<Layout>> {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
+  explicit LayoutCacheShard(size_t budget)
+      : mCache(decltype(mCache)::kUnlimitedCapacity), mBudget(budget) {
     mCache.setOnEntryRemovedListener(this);
   }
 
-  void clear() { mCache.clear(); }
+  void clear() {
+    std::scoped_lock lock(mMutex);
+    mCache.clear();
+  }
 
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  void setBudget(size_t budget) {
+    std::scoped_lock lock(mMutex);
+    mBudget = budget;
+    trimToBudget();
+  }
+
+  std::shared_ptr<Layout> get(const LayoutCacheKey& key) {
+    std::scoped_lock lock(mMutex);
+    std::shared_ptr<Layout> layout = mCache.get(key);
+    if (layout) {
+      mStats.hits++;
+    } else {
+      mStats.misses++;
     }
     return layout;
   }
 
+  // Takes ownership of the copied text of the key. If another thread has
+  // cached a layout for the same key in the meantime, that layout is returned
+  // instead.
+  std::shared_ptr<Layout> put(LayoutCacheKey& key,
+                              std::shared_ptr<Layout> layout) {
+    std::scoped_lock lock(mMutex);
+    std::shared_ptr<Layout> cached = mCache.get(key);
+    if (cached) {
+      key.freeText();
+      return cached;
+    }
+    size_t bytes = key.getMemoryUsage(*layout);
+    if (bytes > mBudget) {
+      // The word would evict everything else. Hand it out without caching it.
+      key.freeText();
+      return layout;
+    }
+    mCache.put(key, layout);
+    mStats.bytes += bytes;
+    trimToBudget();
+    return layout;
+  }
+
+  // Adds the counters of this shard to the given stats.
+  void addStats(LayoutCacheStats* stats) {
+    std::scoped_lock lock(mMutex);
+    stats->hits += mStats.hits;
+    stats->misses += mStats.misses;
+    stats->evictions += mStats.evictions;
+    stats->entries += mCache.size();
+    stats->bytes += mStats.bytes;
+    stats->budget += mBudget;
+  }
+
  private:
+  void trimToBudget() {
+    while (mStats.bytes > mBudget && mCache.removeOldest()) {
+      mStats.evictions++;
+    }
+  }
+
   // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
+  void operator()(LayoutCacheKey& key, std::shared_ptr<Layout>& value) {
+    mStats.bytes -= key.getMemoryUsage(*value);
     key.freeText();
-    delete value;
   }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+  std::mutex mMutex;
+  android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> mCache;
+  size_t mBudget;
+  LayoutCacheStats mStats;
+};
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+class LayoutCache {
+ public:
+  LayoutCache() {
+    for (auto& shard : mShards) {
+      shard = std::make_unique<LayoutCacheShard>(kDefaultBudget / kShardCount);
+    }
+  }
+
+  void clear() {
+    for (auto& shard : mShards) {
+      shard->clear();
+    }
+  }
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  void setBudget(size_t bytes) {
+    for (auto& shard : mShards) {
+      shard->setBudget(bytes / kShardCount);
+    }
+  }
+
+  LayoutCacheStats getStats() {
+    LayoutCacheStats stats;
+    for (auto& shard : mShards) {
+      shard->addStats(&stats);
+    }
+    return stats;
+  }
+
+  // Cached layouts are shared. Evicting a layout from the cache does not
+  // invalidate it for callers that are still using it.
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    LayoutCacheShard& shard = *mShards[key.hash() % kShardCount];
+    std::shared_ptr<Layout> layout = shard.get(key);
+    if (layout == nullptr) {
+      // Lay out the word without holding the lock of the shard. Two threads
+      // missing on the same word may both lay it out, but only one of the
+      // results is cached.
+      layout = std::make_shared<Layout>();
+      key.doLayout(layout.get(), ctx, collection);
+      key.copyText();
+      layout = shard.put(key, std::move(layout));
+    }
+    return layout;
+  }
+
+ private:
+  static const size_t kShardCount = 16;
+
+  // Roughly the footprint of the 5000 words that used to be cached before the
+  // cache was bounded by memory.
+  static const size_t kDefaultBudget = 2 * 1024 * 1024;
+
+  std::array<std::unique_ptr<LayoutCacheShard>, kShardCount> mShards;
 };
 
+// Owns a HarfBuzz buffer. Buffers hold the state of a single shaping call, so
+// each thread shapes into a buffer of its own.
+class HbBufferHolder {
+ public:
+  explicit HbBufferHolder(hb_unicode_funcs_t* unicodeFunctions)
+      : mBuffer(hb_buffer_create()) {
+    hb_buffer_set_unicode_funcs(mBuffer, unicodeFunctions);
+  }
+
+  ~HbBufferHolder() { hb_buffer_destroy(mBuffer); }
+
+  hb_buffer_t* get() const { return mBuffer; }
+
+ private:
+  hb_buffer_t* mBuffer;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(HbBufferHolder);
+};
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<HbBufferHolder> tls_hb_buffer;
+
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
+    hb_unicode_funcs_make_immutable(unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
+  // Returns the HarfBuzz buffer of the calling thread.
+  hb_buffer_t* getHbBuffer() {
+    if (tls_hb_buffer.get() == nullptr) {
+      tls_hb_buffer.reset(new HbBufferHolder(unicodeFunctions));
+    }
+    return tls_hb_buffer.get()->get();
+  }
+
   static LayoutEngine& getInstance() {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
@@ -254,34 +402,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(
+      funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +461,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared with other threads. Scale and font funcs are
+    // set on a sub font owned by this layout context instead.
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +474,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +734,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +756,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,9 +862,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -919,7 +1061,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1193,10 +1335,17 @@ void Layout::getBounds(MinikinRect* bounds) const {
 }
 
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
+}
+
+void Layout::setCacheBudget(size_t bytes) {
+  LayoutEngine::getInstance().layoutCache.setBudget(bytes);
+}
+
+LayoutCacheStats Layout::getCacheStats() {
+  return LayoutEngine::getInstance().layoutCache.getStats();
 }
 
 }  // namespace minikin
@@ -57,6 +57,18 @@ enum {
   kBidi_Mask = 0x7
 };
 
+// libtxt extension: Counters of the cache of shaped words shared by all
+// layouts. The counters are cumulative since the process started.
+struct LayoutCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t evictions = 0;
+  // The number of cached words and the memory they use, in bytes.
+  size_t entries = 0;
+  size_t bytes = 0;
+  size_t budget = 0;
+};
+
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
 // may not mutate it at the same time.
@@ -117,6 +129,13 @@ class Layout {
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // libtxt extension: Sets the memory budget of the cache of shaped words, in
+  // bytes. The least recently used words are evicted to fit the new budget.
+  static void setCacheBudget(size_t bytes);
+
+  // libtxt extension
+  static LayoutCacheStats getCacheStats();
+
  private:
   friend class LayoutCacheKey;
 
@@ -102,6 +102,11 @@ class LineBreaker {
   // of the ICU break iterator can be reused.
   void setLocale();
 
+  // libtxt extension: Same as setLocale, but hyphenates words with the given
+  // hyphenator using the rules of |locale|. Word breaking still uses the
+  // default locale.
+  void setLocale(const icu::Locale& locale, Hyphenator* hyphenator);
+
   void resize(size_t size) {
     mTextBuf.resize(size);
     mCharWidths.resize(size);
@@ -148,6 +153,18 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt extension: Same as addStyleRun, but assumes the widths of the
+  // characters in [start, end) have already been written to charWidths(), for
+  // instance from a previous call to addStyleRun for the same text. This skips
+  // shaping, so that the same text can be broken again for different line
+  // widths cheaply.
+  void addMeasuredStyleRun(MinikinPaint* paint,
+                           const std::shared_ptr<FontCollection>& typeface,
+                           FontStyle style,
+                           size_t start,
+                           size_t end,
+                           bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -19,8 +19,6 @@
 #ifndef MINIKIN_INTERNAL_H
 #define MINIKIN_INTERNAL_H
 
-#include <mutex>
-
 #include <hb.h>
 
 #include <minikin/MinikinFont.h>
@@ -28,13 +26,10 @@
 namespace minikin {
 
 // All external Minikin interfaces are designed to be thread-safe.
-// Presently, that's implemented by through a global lock, and having
-// all external interfaces take that lock.
-
-extern std::recursive_mutex gMinikinLock;
-
-// Aborts if gMinikinLock is not acquired. Do nothing on the release build.
-void assertMinikinLocked();
+// Font collections and font families are immutable once constructed. The
+// process-wide caches (HbFontCache, the layout cache and
+// FontLanguageListCache) each guard their own state, so that paragraphs can be
+// laid out on several threads at once.
 
 hb_blob_t* getFontTable(const MinikinFont* minikinFont, uint32_t tag);
 
@@ -18,6 +18,13 @@
 
 #include <log/log.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/thread_local.h"
+
 #include <minikin/Emoji.h>
 #include <minikin/Hyphenator.h>
 #include <minikin/WordBreaker.h>
@@ -37,20 +44,85 @@ const uint32_t CHAR_ZWJ = 0x200D;
 static std::once_flag gLibtxtBreakIteratorInitFlag;
 static icu::BreakIterator* gLibtxtDefaultBreakIterator = nullptr;
 
-void WordBreaker::setLocale() {
-  UErrorCode status = U_ZERO_ERROR;
-  std::call_once(gLibtxtBreakIteratorInitFlag, [&status] {
-    gLibtxtDefaultBreakIterator =
-        icu::BreakIterator::createLineInstance(icu::Locale(), status);
-  });
-  mBreakIterator.reset(gLibtxtDefaultBreakIterator->clone());
-  // TODO: handle failure status
-  if (mText != nullptr) {
-    mBreakIterator->setText(&mUText, status);
+// libtxt extension: the break iterators of finished WordBreakers are kept by
+// the thread that finished them and reused by the next WordBreaker that binds
+// text on that thread. Paragraphs only need an iterator while their lines are
+// being broken, so a few iterators per thread serve any number of paragraphs.
+class BreakIteratorPool {
+ public:
+  BreakIteratorPool() = default;
+
+  std::unique_ptr<icu::BreakIterator> acquire() {
+    if (mIterators.empty()) {
+      UErrorCode status = U_ZERO_ERROR;
+      std::call_once(gLibtxtBreakIteratorInitFlag, [&status] {
+        gLibtxtDefaultBreakIterator =
+            icu::BreakIterator::createLineInstance(icu::Locale(), status);
+      });
+      return std::unique_ptr<icu::BreakIterator>(
+          gLibtxtDefaultBreakIterator->clone());
+    }
+    std::unique_ptr<icu::BreakIterator> iterator =
+        std::move(mIterators.back());
+    mIterators.pop_back();
+    return iterator;
+  }
+
+  void release(std::unique_ptr<icu::BreakIterator> iterator) {
+    if (mIterators.size() < kMaxPooledIterators) {
+      mIterators.push_back(std::move(iterator));
+    }
   }
+
+ private:
+  // More than one iterator is only in use at a time on a thread if it breaks
+  // several paragraphs in an interleaved manner.
+  static constexpr size_t kMaxPooledIterators = 4;
+
+  std::vector<std::unique_ptr<icu::BreakIterator>> mIterators;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BreakIteratorPool);
+};
+
+FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<BreakIteratorPool>
+    tls_break_iterator_pool;
+
+static BreakIteratorPool& getBreakIteratorPool() {
+  if (tls_break_iterator_pool.get() == nullptr) {
+    tls_break_iterator_pool.reset(new BreakIteratorPool());
+  }
+  return *tls_break_iterator_pool.get();
+}
+
+void WordBreaker::setLocale() {
   mIteratorWasReset = true;
 }
 
+// libtxt extension: returns true if the only line break opportunities of the
+// text are after runs of spaces, as is the case for ASCII letters, digits,
+// spaces and quotes (UAX #14 rules LB18, LB19, LB23, LB25 and LB28). Infix
+// separators are allowed at the end of words, where they neither allow nor
+// prevent a break (LB13). Anything else is left to ICU, including text where
+// the email and URL detection needs the break iterator.
+static bool hasOnlyBreaksAfterSpaces(const uint16_t* data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    const uint16_t c = data[i];
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9') || c == ' ' || c == '\'' || c == '"') {
+      continue;
+    }
+    if (c == '.' || c == ',' || c == ';' || c == ':') {
+      const bool afterSpace = i > 0 && data[i - 1] == ' ';
+      const bool atWordEnd = i + 1 == size || data[i + 1] == ' ';
+      if (!afterSpace && atWordEnd) {
+        continue;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
 void WordBreaker::setText(const uint16_t* data, size_t size) {
   mText = data;
   mTextSize = size;
@@ -59,6 +131,13 @@ void WordBreaker::setText(const uint16_t* data, size_t size) {
   mCurrent = 0;
   mScanOffset = 0;
   mInEmailOrUrl = false;
+  mUseAsciiBreaks = hasOnlyBreaksAfterSpaces(data, size);
+  if (mUseAsciiBreaks) {
+    return;
+  }
+  if (mBreakIterator == nullptr) {
+    mBreakIterator = getBreakIteratorPool().acquire();
+  }
   UErrorCode status = U_ZERO_ERROR;
   utext_openUChars(&mUText, reinterpret_cast<const UChar*>(data), size,
                    &status);
@@ -124,6 +203,10 @@ static bool isBreakValid(const uint16_t* buf, size_t bufEnd, size_t i) {
 // Customized iteratorNext that takes care of both resets and our modifications
 // to ICU's behavior.
 int32_t WordBreaker::iteratorNext() {
+  if (mUseAsciiBreaks) {
+    mIteratorWasReset = false;
+    return asciiFollowing(mCurrent);
+  }
   int32_t result;
   do {
     if (mIteratorWasReset) {
@@ -138,6 +221,21 @@ int32_t WordBreaker::iteratorNext() {
   return result;
 }
 
+// libtxt extension: the equivalent of BreakIterator::following for text that
+// only has break opportunities after spaces. The end of the text is always a
+// boundary.
+int32_t WordBreaker::asciiFollowing(ssize_t offset) const {
+  if (offset >= static_cast<ssize_t>(mTextSize)) {
+    return icu::BreakIterator::DONE;
+  }
+  for (size_t i = offset + 1; i < mTextSize; i++) {
+    if (mText[i - 1] == ' ' && mText[i] != ' ') {
+      return i;
+    }
+  }
+  return mTextSize;
+}
+
 // Chicago Manual of Style recommends breaking after these characters in URLs
 // and email addresses
 static bool breakAfter(uint16_t c) {
@@ -288,6 +386,9 @@ void WordBreaker::finish() {
   mText = nullptr;
   // Note: calling utext_close multiply is safe
   utext_close(&mUText);
+  if (mBreakIterator != nullptr) {
+    getBreakIteratorPool().release(std::move(mBreakIterator));
+  }
 }
 
 }  // namespace minikin
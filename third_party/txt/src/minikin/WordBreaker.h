@@ -37,6 +37,11 @@ class WordBreaker {
   // of the ICU break iterator can be reused.
   void setLocale();
 
+  // libtxt extension: ICU break iterators are only bound to text between
+  // setText() and finish(). In between, the iterator is taken from a pool kept
+  // by the calling thread, and finish() returns it to the pool of the thread
+  // that calls it. Text made only of ASCII letters, digits, spaces, quotes and
+  // word-final punctuation is broken without ICU.
   void setText(const uint16_t* data, size_t size);
 
   // Advance iterator to next word break. Return offset, or -1 if EOT
@@ -58,10 +63,14 @@ class WordBreaker {
 
  private:
   int32_t iteratorNext();
+  int32_t asciiFollowing(ssize_t offset) const;
   void detectEmailOrUrl();
   ssize_t findNextBreakInEmailOrUrl();
 
   std::unique_ptr<icu::BreakIterator> mBreakIterator;
+  // libtxt extension: whether the text only has line break opportunities after
+  // spaces, so that they can be found without the break iterator.
+  bool mUseAsciiBreaks = false;
   UText mUText = UTEXT_INITIALIZER;
   const uint16_t* mText = nullptr;
   size_t mTextSize;
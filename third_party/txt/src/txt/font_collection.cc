@@ -66,7 +66,7 @@ class TxtFallbackFontProvider
   TxtFallbackFontProvider(std::shared_ptr<FontCollection> font_collection)
       : font_collection_(font_collection) {}
 
-  virtual const std::shared_ptr<minikin::FontFamily>& matchFallbackFont(
+  virtual std::shared_ptr<minikin::FontFamily> matchFallbackFont(
       uint32_t ch,
       std::string locale) {
     std::shared_ptr<FontCollection> fc = font_collection_.lock();
@@ -94,14 +94,17 @@ FontCollection::~FontCollection() {
 }
 
 size_t FontCollection::GetFontManagersCount() const {
+  std::scoped_lock lock(mutex_);
   return GetFontManagerOrder().size();
 }
 
 void FontCollection::SetupDefaultFontManager() {
+  std::scoped_lock lock(mutex_);
   default_font_manager_ = GetDefaultFontManager();
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   default_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -110,6 +113,7 @@ void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   asset_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -118,6 +122,7 @@ void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   dynamic_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -126,6 +131,7 @@ void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   test_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -148,6 +154,7 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
 }
 
 void FontCollection::DisableFontFallback() {
+  std::scoped_lock lock(mutex_);
   enable_font_fallback_ = false;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -161,6 +168,7 @@ std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  std::scoped_lock lock(mutex_);
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -314,9 +322,10 @@ std::shared_ptr<minikin::FontFamily> FontCollection::CreateMinikinFontFamily(
   return std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
 }
 
-const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
+std::shared_ptr<minikin::FontFamily> FontCollection::MatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  std::scoped_lock lock(mutex_);
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
@@ -381,6 +390,7 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
+  std::scoped_lock lock(mutex_);
   font_collections_cache_.clear();
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -394,6 +404,7 @@ void FontCollection::ClearFontFamilyCache() {
 
 sk_sp<skia::textlayout::FontCollection>
 FontCollection::CreateSktFontCollection() {
+  std::scoped_lock lock(mutex_);
   if (!skt_collection_) {
     skt_collection_ = sk_make_sp<skia::textlayout::FontCollection>();
 
@@ -18,6 +18,7 @@
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -37,6 +38,9 @@
 
 namespace txt {
 
+// The public methods of this class may be called from several threads at once,
+// so that paragraphs using the same font collection can be laid out
+// concurrently.
 class FontCollection : public std::enable_shared_from_this<FontCollection> {
  public:
   FontCollection();
@@ -56,8 +60,9 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
       const std::string& locale);
 
   // Provides a FontFamily that contains glyphs for ch. This caches previously
-  // matched fonts. Also see FontCollection::DoMatchFallbackFont.
-  const std::shared_ptr<minikin::FontFamily>& MatchFallbackFont(
+  // matched fonts. Also see FontCollection::DoMatchFallbackFont. The family is
+  // returned by value since the cache may change once the lock is released.
+  std::shared_ptr<minikin::FontFamily> MatchFallbackFont(
       uint32_t ch,
       std::string locale);
 
@@ -90,6 +95,9 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
     };
   };
 
+  // Guards all of the state below. Public methods take the lock, private
+  // methods expect it to be held.
+  mutable std::mutex mutex_;
   sk_sp<SkFontMgr> default_font_manager_;
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/hyphenation_registry.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace txt {
+
+namespace {
+
+// Converts ICU style locale names like "en_US" to language tags.
+std::string NormalizeLocale(std::string locale) {
+  std::replace(locale.begin(), locale.end(), '_', '-');
+  return locale;
+}
+
+}  // namespace
+
+HyphenationRegistry& HyphenationRegistry::GetInstance() {
+  static HyphenationRegistry* instance = new HyphenationRegistry();
+  return *instance;
+}
+
+HyphenationRegistry::HyphenationRegistry() = default;
+
+HyphenationRegistry::~HyphenationRegistry() = default;
+
+bool HyphenationRegistry::RegisterDictionary(const std::string& locale,
+                                             const std::string& path,
+                                             size_t min_prefix,
+                                             size_t min_suffix) {
+  std::scoped_lock lock(mutex_);
+  Dictionary& dictionary = dictionaries_[NormalizeLocale(locale)];
+  if (dictionary.hyphenator) {
+    return false;
+  }
+  dictionary.loaded = false;
+  dictionary.path = path;
+  dictionary.min_prefix = min_prefix;
+  dictionary.min_suffix = min_suffix;
+  return true;
+}
+
+minikin::Hyphenator* HyphenationRegistry::GetHyphenator(
+    const std::string& locale) {
+  const std::string tag = NormalizeLocale(locale);
+  std::scoped_lock lock(mutex_);
+  if (minikin::Hyphenator* hyphenator = LoadDictionary(tag)) {
+    return hyphenator;
+  }
+  const size_t separator = tag.find('-');
+  if (separator == std::string::npos) {
+    return nullptr;
+  }
+  return LoadDictionary(tag.substr(0, separator));
+}
+
+minikin::Hyphenator* HyphenationRegistry::LoadDictionary(
+    const std::string& locale) {
+  auto found = dictionaries_.find(locale);
+  if (found == dictionaries_.end()) {
+    return nullptr;
+  }
+  Dictionary& dictionary = found->second;
+  if (!dictionary.loaded) {
+    // A dictionary that fails to load is not retried until it is registered
+    // again.
+    dictionary.loaded = true;
+    dictionary.mapping = fml::FileMapping::CreateReadOnly(dictionary.path);
+    if (!dictionary.mapping || dictionary.mapping->GetSize() == 0) {
+      FML_LOG(ERROR) << "Could not map the hyphenation patterns of " << locale
+                     << " at " << dictionary.path;
+      dictionary.mapping.reset();
+      return nullptr;
+    }
+    dictionary.hyphenator.reset(minikin::Hyphenator::loadBinary(
+        dictionary.mapping->GetMapping(), dictionary.min_prefix,
+        dictionary.min_suffix));
+  }
+  return dictionary.hyphenator.get();
+}
+
+}  // namespace txt
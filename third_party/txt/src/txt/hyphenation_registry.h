@@ -0,0 +1,81 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TXT_HYPHENATION_REGISTRY_H_
+#define TXT_HYPHENATION_REGISTRY_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "minikin/Hyphenator.h"
+
+namespace txt {
+
+// A process-wide registry of the hyphenation pattern dictionaries, keyed on
+// locale.
+//
+// Registering a dictionary only records the path of its pattern file, in the
+// binary format read by |minikin::Hyphenator::loadBinary|. The file is mapped
+// into memory the first time a hyphenator is requested for its locale, so the
+// patterns are paged in on demand and are shared by every font collection and
+// engine in the process instead of being copied per engine. Loaded
+// dictionaries stay mapped for the lifetime of the process.
+//
+// Paragraphs whose style enables |ParagraphStyle::hyphenate| are hyphenated
+// with the dictionary of their locale.
+//
+// All methods are thread safe.
+class HyphenationRegistry {
+ public:
+  static constexpr size_t kDefaultMinPrefix = 2;
+  static constexpr size_t kDefaultMinSuffix = 3;
+
+  static HyphenationRegistry& GetInstance();
+
+  HyphenationRegistry();
+
+  ~HyphenationRegistry();
+
+  // Registers the pattern file at |path| for |locale|, a BCP 47 language tag
+  // like "en-US". Words shorter than |min_prefix| + |min_suffix| code units
+  // are not hyphenated by the patterns. Returns false if the dictionary of
+  // |locale| is already in use, in which case it is not replaced.
+  bool RegisterDictionary(const std::string& locale,
+                          const std::string& path,
+                          size_t min_prefix = kDefaultMinPrefix,
+                          size_t min_suffix = kDefaultMinSuffix);
+
+  // Returns the hyphenator for |locale|, falling back to the dictionary of its
+  // language, or null if no dictionary can be loaded for it. The hyphenator
+  // remains valid for the lifetime of the registry.
+  minikin::Hyphenator* GetHyphenator(const std::string& locale);
+
+ private:
+  struct Dictionary {
+    std::string path;
+    size_t min_prefix = kDefaultMinPrefix;
+    size_t min_suffix = kDefaultMinSuffix;
+    bool loaded = false;
+    std::unique_ptr<fml::FileMapping> mapping;
+    std::unique_ptr<minikin::Hyphenator> hyphenator;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Dictionary> dictionaries_;
+
+  // Returns the hyphenator of the dictionary registered for exactly |locale|,
+  // loading it if needed. Must be called with the lock held.
+  minikin::Hyphenator* LoadDictionary(const std::string& locale);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(HyphenationRegistry);
+};
+
+}  // namespace txt
+
+#endif  // TXT_HYPHENATION_REGISTRY_H_
@@ -0,0 +1,39 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/layout_cache.h"
+
+#include "flutter/fml/trace_event.h"
+#include "minikin/Layout.h"
+#include "txt/text_blob_cache.h"
+
+namespace txt {
+
+void SetLayoutCacheBudget(size_t bytes) {
+  minikin::Layout::setCacheBudget(bytes);
+}
+
+void PurgeLayoutCache() {
+  TRACE_EVENT0("flutter", "PurgeLayoutCache");
+  minikin::Layout::purgeCaches();
+  TextBlobCache::GetInstance().Purge();
+}
+
+void TraceLayoutCacheStats() {
+#if !FLUTTER_RELEASE
+  minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  FML_TRACE_COUNTER("flutter", "LayoutCache", 0, "Hits", stats.hits, "Misses",
+                    stats.misses, "Evictions", stats.evictions);
+  FML_TRACE_COUNTER("flutter", "LayoutCacheMemory", 0, "Entries",
+                    stats.entries, "Bytes", stats.bytes, "BudgetBytes",
+                    stats.budget);
+
+  TextBlobCache::Stats blob_stats = TextBlobCache::GetInstance().GetStats();
+  FML_TRACE_COUNTER("flutter", "TextBlobCache", 0, "Hits", blob_stats.hits,
+                    "Misses", blob_stats.misses, "Entries", blob_stats.entries,
+                    "Bytes", blob_stats.bytes);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace txt
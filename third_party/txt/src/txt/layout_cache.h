@@ -0,0 +1,33 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TXT_LAYOUT_CACHE_H_
+#define TXT_LAYOUT_CACHE_H_
+
+#include <cstddef>
+
+namespace txt {
+
+// Controls the process-wide cache of shaped words that is shared by all
+// paragraphs. Words are shaped once per font collection and style, so the
+// cache is most effective for text that is laid out repeatedly, such as
+// scrolling lists and paragraphs relaid out at new widths.
+//
+// All functions are thread safe.
+
+// Sets the memory budget of the cache, in bytes. The least recently used
+// words are evicted to fit the new budget. A budget of zero disables caching.
+void SetLayoutCacheBudget(size_t bytes);
+
+// Drops all cached words and the cached text blobs of laid out runs (see
+// TextBlobCache). Used in low memory conditions.
+void PurgeLayoutCache();
+
+// Emits the hit, miss and eviction counts and the memory used by the cache, and
+// the statistics of the text blob cache, as timeline counters.
+void TraceLayoutCacheStats();
+
+}  // namespace txt
+
+#endif  // TXT_LAYOUT_CACHE_H_
@@ -18,6 +18,8 @@
 #ifndef LIB_TXT_SRC_PARAGRAPH_H_
 #define LIB_TXT_SRC_PARAGRAPH_H_
 
+#include <memory>
+
 #include "line_metrics.h"
 #include "paragraph_style.h"
 
@@ -142,6 +144,12 @@ class Paragraph {
   // before Painting and getting any statistics from this class.
   virtual void Layout(double width) = 0;
 
+  // Returns a copy of the contents of this paragraph that has not been laid
+  // out yet. The copy shares no mutable state with this paragraph, so it can
+  // be laid out on another thread while this paragraph is in use. Returns
+  // nullptr if the implementation does not support copies.
+  virtual std::unique_ptr<Paragraph> Clone() const { return nullptr; }
+
   // Paints the laid out text onto the supplied SkCanvas at (x, y) offset from
   // the origin. Only valid after Layout() is called.
   virtual void Paint(SkCanvas* canvas, double x, double y) = 0;
@@ -103,6 +103,11 @@ class ParagraphStyle {
   minikin::BreakStrategy break_strategy =
       minikin::BreakStrategy::kBreakStrategy_Greedy;
 
+  // Whether words may be broken across lines. Words are hyphenated with the
+  // dictionary registered for |locale| in the txt::HyphenationRegistry, and
+  // are never hyphenated if there is none.
+  bool hyphenate = false;
+
   TextStyle GetTextStyle() const;
 
   bool unlimited_lines() const;
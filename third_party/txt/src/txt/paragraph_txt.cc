@@ -45,6 +45,8 @@
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/effects/SkDashPathEffect.h"
 #include "third_party/skia/include/effects/SkDiscretePathEffect.h"
+#include "txt/hyphenation_registry.h"
+#include "txt/text_blob_cache.h"
 #include "unicode/ubidi.h"
 #include "unicode/utf16.h"
 
@@ -246,25 +248,61 @@ void ParagraphTxt::SetInlinePlaceholders(
     std::vector<PlaceholderRun> inline_placeholders,
     std::unordered_set<size_t> obj_replacement_char_indexes) {
   needs_layout_ = true;
+  needs_measure_ = true;
   inline_placeholders_ = std::move(inline_placeholders);
   obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
 }
 
+std::unique_ptr<Paragraph> ParagraphTxt::Clone() const {
+  auto paragraph = std::make_unique<ParagraphTxt>();
+  paragraph->SetText(text_, runs_.Clone());
+  paragraph->SetInlinePlaceholders(inline_placeholders_,
+                                   obj_replacement_char_indexes_);
+  paragraph->SetParagraphStyle(paragraph_style_);
+  paragraph->SetFontCollection(font_collection_);
+  return paragraph;
+}
+
 bool ParagraphTxt::ComputeLineBreaks() {
   line_metrics_.clear();
   line_widths_.clear();
+  line_hyphen_edits_.clear();
   max_intrinsic_width_ = 0;
 
-  std::vector<size_t> newline_positions;
-  // Discover and add all hard breaks.
-  for (size_t i = 0; i < text_.size(); ++i) {
-    ULineBreak ulb = static_cast<ULineBreak>(
-        u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
-    if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
-      newline_positions.push_back(i);
+  // Hyphenate with the dictionary of the paragraph's locale, if it has one.
+  minikin::Hyphenator* hyphenator =
+      paragraph_style_.hyphenate
+          ? HyphenationRegistry::GetInstance().GetHyphenator(
+                paragraph_style_.locale)
+          : nullptr;
+  if (hyphenator != nullptr) {
+    breaker_.setLocale(icu::Locale(paragraph_style_.locale.c_str()),
+                       hyphenator);
+  } else {
+    breaker_.setLocale();
+  }
+
+  // The hard breaks and the widths of the characters don't depend on the
+  // width of the paragraph. Unless the text or its styling changed since the
+  // last layout, the text is broken again using the stored widths instead of
+  // being shaped again.
+  const bool measure = needs_measure_;
+  std::vector<size_t>& newline_positions = newline_positions_;
+  if (measure) {
+    newline_positions.clear();
+    // Discover and add all hard breaks.
+    for (size_t i = 0; i < text_.size(); ++i) {
+      ULineBreak ulb = static_cast<ULineBreak>(
+          u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
+      if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
+        newline_positions.push_back(i);
+    }
+    // Break at the end of the paragraph.
+    newline_positions.push_back(text_.size());
+    block_char_widths_.clear();
+    block_char_widths_.resize(newline_positions.size());
+    block_widths_.assign(newline_positions.size(), 0);
   }
-  // Break at the end of the paragraph.
-  newline_positions.push_back(text_.size());
 
   // Calculate and add any breaks due to a line being too long.
   size_t run_index = 0;
@@ -280,6 +318,7 @@ bool ParagraphTxt::ComputeLineBreaks() {
       line_metrics_.emplace_back(block_start, block_end, block_end,
                                  block_end + 1, true);
       line_widths_.push_back(0);
+      line_hyphen_edits_.push_back(minikin::HyphenEdit::NO_EDIT);
       continue;
     }
 
@@ -293,6 +332,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
     breaker_.setText();
+    if (!measure) {
+      memcpy(breaker_.charWidths(), block_char_widths_[newline_index].data(),
+             block_size * sizeof(float));
+    }
 
     // Add the runs that include this line to the LineBreaker.
     double block_total_width = 0;
@@ -344,16 +387,27 @@ bool ParagraphTxt::ComputeLineBreaks() {
         inline_placeholder_index++;
       } else {
         // Is a regular text run.
-        double run_width = breaker_.addStyleRun(&paint, collection, font,
-                                                run_start, run_end, isRtl);
-        block_total_width += run_width;
+        if (measure) {
+          double run_width = breaker_.addStyleRun(&paint, collection, font,
+                                                  run_start, run_end, isRtl);
+          block_total_width += run_width;
+        } else {
+          breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                       run_end, isRtl);
+        }
       }
 
       if (run.end > block_end)
         break;
       run_index++;
     }
-    max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+    if (measure) {
+      block_char_widths_[newline_index].assign(
+          breaker_.charWidths(), breaker_.charWidths() + block_size);
+      block_widths_[newline_index] = block_total_width;
+    }
+    max_intrinsic_width_ =
+        std::max(max_intrinsic_width_, block_widths_[newline_index]);
 
     size_t breaks_count = breaker_.computeBreaks();
     const int* breaks = breaker_.getBreaks();
@@ -374,6 +428,9 @@ bool ParagraphTxt::ComputeLineBreaks() {
                                  line_end_excluding_whitespace,
                                  line_end_including_newline, hard_break);
       line_widths_.push_back(breaker_.getWidths()[i]);
+      line_hyphen_edits_.push_back(
+          breaker_.getFlags()[i] & (minikin::HyphenEdit::MASK_START_OF_LINE |
+                                    minikin::HyphenEdit::MASK_END_OF_LINE));
     }
 
     breaker_.finish();
@@ -686,9 +743,13 @@ void ParagraphTxt::Layout(double width) {
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
-    return;
+  if (needs_measure_) {
+    bidi_runs_.clear();
+    if (!ComputeBidiRuns(&bidi_runs_))
+      return;
+    needs_measure_ = false;
+  }
+  const std::vector<BidiRun>& bidi_runs = bidi_runs_;
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -696,7 +757,8 @@ void ParagraphTxt::Layout(double width) {
   font.setHinting(SkFontHinting::kSlight);
 
   minikin::Layout layout;
-  SkTextBlobBuilder builder;
+  std::vector<SkGlyphID> blob_glyphs;
+  std::vector<SkPoint> blob_positions;
   double y_offset = 0;
   double prev_max_descent = 0;
   double max_word_width = 0;
@@ -813,6 +875,18 @@ void ParagraphTxt::Layout(double width) {
       GetFontAndMinikinPaint(run.style(), &minikin_font, &minikin_paint);
       font.setSize(run.style().font_size);
 
+      // Draw the hyphens of a hyphenated break in the runs at the ends of the
+      // line. The widths of the hyphens were measured by the line breaker.
+      uint32_t hyphen_edit = line_hyphen_edits_[line_number];
+      if (run.is_ghost() || run.start() != line_metrics.start_index) {
+        hyphen_edit &= ~minikin::HyphenEdit::MASK_START_OF_LINE;
+      }
+      if (run.is_ghost() ||
+          run.end() != line_metrics.end_excluding_whitespace) {
+        hyphen_edit &= ~minikin::HyphenEdit::MASK_END_OF_LINE;
+      }
+      minikin_paint.hyphenEdit = hyphen_edit;
+
       std::shared_ptr<minikin::FontCollection> minikin_font_collection =
           GetMinikinFontCollectionForStyle(run.style());
       if (!minikin_font_collection) {
@@ -833,6 +907,8 @@ void ParagraphTxt::Layout(double width) {
           line_run_it == line_runs.end() - 1 &&
           (line_number == line_limit - 1 ||
            paragraph_style_.unlimited_lines())) {
+        // The ellipsis replaces the hyphen at the end of the line.
+        minikin_paint.hyphenEdit = minikin_paint.hyphenEdit.getStart();
         float ellipsis_width = layout.measureText(
             reinterpret_cast<const uint16_t*>(ellipsis.data()), 0,
             ellipsis.length(), ellipsis.length(), run.is_rtl(), minikin_font,
@@ -902,8 +978,8 @@ void ParagraphTxt::Layout(double width) {
         std::vector<GlyphPosition> glyph_positions;
 
         GetGlyphTypeface(layout, glyph_blob.start).apply(font);
-        const SkTextBlobBuilder::RunBuffer& blob_buffer =
-            builder.allocRunPos(font, glyph_blob.end - glyph_blob.start);
+        blob_glyphs.resize(glyph_blob.end - glyph_blob.start);
+        blob_positions.resize(glyph_blob.end - glyph_blob.start);
 
         double justify_x_offset_delta = 0;
         for (size_t glyph_index = glyph_blob.start;
@@ -914,16 +990,14 @@ void ParagraphTxt::Layout(double width) {
           // Add all the glyphs in this cluster to the text blob.
           do {
             size_t blob_index = glyph_index - glyph_blob.start;
-            blob_buffer.glyphs[blob_index] = layout.getGlyphId(glyph_index);
-
-            size_t pos_index = blob_index * 2;
-            blob_buffer.pos[pos_index] = layout.getX(glyph_index) +
-                                         justify_x_offset +
-                                         justify_x_offset_delta;
-            blob_buffer.pos[pos_index + 1] = layout.getY(glyph_index);
+            blob_glyphs[blob_index] = layout.getGlyphId(glyph_index);
+            blob_positions[blob_index].set(
+                layout.getX(glyph_index) + justify_x_offset +
+                    justify_x_offset_delta,
+                layout.getY(glyph_index));
 
             if (glyph_index == cluster_start_glyph_index)
-              glyph_x_offset = blob_buffer.pos[pos_index];
+              glyph_x_offset = blob_positions[blob_index].x();
 
             glyph_index++;
           } while (glyph_index < glyph_blob.end &&
@@ -1037,8 +1111,13 @@ void ParagraphTxt::Layout(double width) {
         Range<double> record_x_pos(
             glyph_positions.front().x_pos.start - run_x_offset,
             glyph_positions.back().x_pos.end - run_x_offset);
+        // Runs with the same glyphs at the same positions share a blob, both
+        // across relayouts of this paragraph and across paragraphs.
+        sk_sp<SkTextBlob> blob = TextBlobCache::GetInstance().GetOrCreate(
+            font, blob_glyphs.data(), blob_positions.data(),
+            blob_glyphs.size());
         paint_records.emplace_back(run.style(), SkPoint::Make(run_x_offset, 0),
-                                   builder.make(), *metrics, line_number,
+                                   std::move(blob), *metrics, line_number,
                                    record_x_pos.start, record_x_pos.end,
                                    run.is_ghost(), run.placeholder_run());
 
@@ -1369,11 +1448,13 @@ double ParagraphTxt::GetLongestLine() {
 
 void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
   needs_layout_ = true;
+  needs_measure_ = true;
   paragraph_style_ = style;
 }
 
 void ParagraphTxt::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
+  needs_measure_ = true;
   font_collection_ = std::move(font_collection);
 }
 
@@ -2015,6 +2096,8 @@ bool ParagraphTxt::DidExceedMaxLines() {
 
 void ParagraphTxt::SetDirty(bool dirty) {
   needs_layout_ = dirty;
+  if (dirty)
+    needs_measure_ = true;
 }
 
 std::vector<LineMetrics>& ParagraphTxt::GetLineMetrics() {
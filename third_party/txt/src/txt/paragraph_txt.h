@@ -73,6 +73,8 @@ class ParagraphTxt : public Paragraph {
   // (10k+ characters) to ensure speedy layout.
   virtual void Layout(double width) override;
 
+  std::unique_ptr<Paragraph> Clone() const override;
+
   virtual void Paint(SkCanvas* canvas, double x, double y) override;
 
   // Getter for paragraph_style_.
@@ -123,7 +125,8 @@ class ParagraphTxt : public Paragraph {
 
   // Sets the needs_layout_ to dirty. When Layout() is called, a new Layout will
   // be performed when this is set to true. Can also be used to prevent a new
-  // Layout from being calculated by setting to false.
+  // Layout from being calculated by setting to false. Setting it to true also
+  // discards the measurements kept for relayouts at a different width.
   void SetDirty(bool dirty = true);
 
  private:
@@ -164,6 +167,8 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
+  FRIEND_TEST(ParagraphTest, RepeatedRunsShareTextBlobs);
+  FRIEND_TEST(ParagraphTest, HyphenatedParagraph);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -189,6 +194,8 @@ class ParagraphTxt : public Paragraph {
   std::vector<LineMetrics> line_metrics_;
   size_t final_line_count_;
   std::vector<double> line_widths_;
+  // The hyphen edits of the hyphenated breaks at the ends of each line.
+  std::vector<uint32_t> line_hyphen_edits_;
 
   // Stores the result of Layout().
   std::vector<PaintRecord> records_;
@@ -320,6 +327,19 @@ class ParagraphTxt : public Paragraph {
 
   bool needs_layout_ = true;
 
+  // The width independent results of the last layout. When only the width
+  // passed to Layout() changes, the text is broken into lines again using the
+  // stored character widths instead of being shaped again. Invalidated when
+  // the text, its styling or the font collection changes.
+  bool needs_measure_ = true;
+  // The positions of the hard breaks, including the end of the paragraph.
+  std::vector<size_t> newline_positions_;
+  // The width of each character and the total width of each block of text
+  // ending at the corresponding hard break.
+  std::vector<std::vector<float>> block_char_widths_;
+  std::vector<double> block_widths_;
+  std::vector<BidiRun> bidi_runs_;
+
   struct WaveCoordinates {
     double x_start;
     double y_start;
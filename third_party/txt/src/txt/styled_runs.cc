@@ -41,6 +41,13 @@ void StyledRuns::swap(StyledRuns& other) {
   runs_.swap(other.runs_);
 }
 
+StyledRuns StyledRuns::Clone() const {
+  StyledRuns runs;
+  runs.styles_ = styles_;
+  runs.runs_ = runs_;
+  return runs;
+}
+
 size_t StyledRuns::AddStyle(const TextStyle& style) {
   const size_t style_index = styles_.size();
   styles_.push_back(style);
@@ -48,6 +48,9 @@ class StyledRuns {
 
   void swap(StyledRuns& other);
 
+  // Copies are explicit as runs are moved into the paragraph that uses them.
+  StyledRuns Clone() const;
+
   size_t AddStyle(const TextStyle& style);
 
   const TextStyle& GetStyle(size_t style_index) const;
@@ -0,0 +1,216 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/text_blob_cache.h"
+
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "flutter/fml/hash_combine.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace txt {
+
+namespace {
+
+size_t HashGlyphRun(const SkFont& font,
+                    const SkGlyphID* glyphs,
+                    const SkPoint* positions,
+                    size_t count) {
+  std::hash<std::string_view> hash_bytes;
+  return fml::HashCombine(
+      font.getTypeface() ? font.getTypeface()->uniqueID() : 0u, font.getSize(),
+      hash_bytes(std::string_view(reinterpret_cast<const char*>(glyphs),
+                                  count * sizeof(SkGlyphID))),
+      hash_bytes(std::string_view(reinterpret_cast<const char*>(positions),
+                                  count * sizeof(SkPoint))));
+}
+
+}  // namespace
+
+TextBlobCache& TextBlobCache::GetInstance() {
+  static TextBlobCache* instance = new TextBlobCache();
+  return *instance;
+}
+
+TextBlobCache::TextBlobCache(size_t budget) {
+  for (auto& shard : shards_) {
+    shard = std::make_unique<Shard>(budget / kShardCount);
+  }
+}
+
+TextBlobCache::~TextBlobCache() = default;
+
+bool TextBlobCache::Entry::Matches(const SkFont& font,
+                                   const SkGlyphID* glyphs,
+                                   const SkPoint* positions,
+                                   size_t count) const {
+  // The cached blobs hold a single run of glyphs with full positions.
+  SkTextBlob::Iter::ExperimentalRun run;
+  SkTextBlob::Iter iter(*blob);
+  return iter.experimentalNext(&run) &&
+         static_cast<size_t>(run.count) == count && run.font == font &&
+         std::memcmp(run.glyphs, glyphs, count * sizeof(SkGlyphID)) == 0 &&
+         std::memcmp(run.positions, positions, count * sizeof(SkPoint)) == 0;
+}
+
+size_t TextBlobCache::Entry::GetMemoryUsage() const {
+  // The glyphs and positions are only held by the blob.
+  SkTextBlob::Iter::ExperimentalRun run;
+  SkTextBlob::Iter iter(*blob);
+  const size_t count = iter.experimentalNext(&run) ? run.count : 0;
+  return sizeof(Entry) + sizeof(SkTextBlob) +
+         count * (sizeof(SkGlyphID) + sizeof(SkPoint));
+}
+
+sk_sp<SkTextBlob> TextBlobCache::GetOrCreate(const SkFont& font,
+                                             const SkGlyphID* glyphs,
+                                             const SkPoint* positions,
+                                             size_t count) {
+  const size_t hash = HashGlyphRun(font, glyphs, positions, count);
+  Shard& shard = GetShard(hash);
+  if (sk_sp<SkTextBlob> cached =
+          shard.Get(hash, font, glyphs, positions, count)) {
+    return cached;
+  }
+
+  // Build the blob without holding the lock of the shard. Another thread may
+  // build the same blob concurrently, in which case the blob cached first is
+  // kept.
+  SkTextBlobBuilder builder;
+  const SkTextBlobBuilder::RunBuffer& buffer =
+      builder.allocRunPos(font, count);
+  std::memcpy(buffer.glyphs, glyphs, count * sizeof(SkGlyphID));
+  std::memcpy(buffer.pos, positions, count * sizeof(SkPoint));
+  sk_sp<SkTextBlob> blob = builder.make();
+  // Empty runs make no blob.
+  if (!blob) {
+    return nullptr;
+  }
+  return shard.Put({hash, std::move(blob)}, font, glyphs, positions, count);
+}
+
+void TextBlobCache::SetBudget(size_t bytes) {
+  for (auto& shard : shards_) {
+    shard->SetBudget(bytes / kShardCount);
+  }
+}
+
+void TextBlobCache::Purge() {
+  for (auto& shard : shards_) {
+    shard->Purge();
+  }
+}
+
+TextBlobCache::Stats TextBlobCache::GetStats() const {
+  Stats stats;
+  for (const auto& shard : shards_) {
+    shard->AddStats(&stats);
+  }
+  return stats;
+}
+
+TextBlobCache::Shard::Shard(size_t budget) : budget_(budget) {}
+
+TextBlobCache::Shard::~Shard() = default;
+
+sk_sp<SkTextBlob> TextBlobCache::Shard::Get(size_t hash,
+                                            const SkFont& font,
+                                            const SkGlyphID* glyphs,
+                                            const SkPoint* positions,
+                                            size_t count) {
+  std::scoped_lock lock(mutex_);
+  sk_sp<SkTextBlob> blob = Find(hash, font, glyphs, positions, count);
+  if (blob) {
+    stats_.hits++;
+  } else {
+    stats_.misses++;
+  }
+  return blob;
+}
+
+sk_sp<SkTextBlob> TextBlobCache::Shard::Put(Entry entry,
+                                            const SkFont& font,
+                                            const SkGlyphID* glyphs,
+                                            const SkPoint* positions,
+                                            size_t count) {
+  const size_t entry_bytes = entry.GetMemoryUsage();
+
+  std::scoped_lock lock(mutex_);
+  if (sk_sp<SkTextBlob> cached =
+          Find(entry.hash, font, glyphs, positions, count)) {
+    return cached;
+  }
+  if (entry_bytes > budget_) {
+    // The blob would evict everything else. Hand it out without caching it.
+    return entry.blob;
+  }
+  sk_sp<SkTextBlob> blob = entry.blob;
+  entries_.push_front(std::move(entry));
+  index_.emplace(entries_.front().hash, entries_.begin());
+  stats_.entries++;
+  stats_.bytes += entry_bytes;
+  TrimToBudget();
+  return blob;
+}
+
+sk_sp<SkTextBlob> TextBlobCache::Shard::Find(size_t hash,
+                                             const SkFont& font,
+                                             const SkGlyphID* glyphs,
+                                             const SkPoint* positions,
+                                             size_t count) {
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->Matches(font, glyphs, positions, count)) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->blob;
+    }
+  }
+  return nullptr;
+}
+
+void TextBlobCache::Shard::SetBudget(size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  budget_ = bytes;
+  TrimToBudget();
+}
+
+void TextBlobCache::Shard::Purge() {
+  std::scoped_lock lock(mutex_);
+  stats_.evictions += entries_.size();
+  entries_.clear();
+  index_.clear();
+  stats_.entries = 0;
+  stats_.bytes = 0;
+}
+
+void TextBlobCache::Shard::AddStats(Stats* stats) const {
+  std::scoped_lock lock(mutex_);
+  stats->hits += stats_.hits;
+  stats->misses += stats_.misses;
+  stats->evictions += stats_.evictions;
+  stats->entries += stats_.entries;
+  stats->bytes += stats_.bytes;
+  stats->budget += budget_;
+}
+
+void TextBlobCache::Shard::TrimToBudget() {
+  while (stats_.bytes > budget_ && !entries_.empty()) {
+    EntryList::iterator oldest = std::prev(entries_.end());
+    auto range = index_.equal_range(oldest->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == oldest) {
+        index_.erase(it);
+        break;
+      }
+    }
+    stats_.bytes -= oldest->GetMemoryUsage();
+    stats_.entries--;
+    stats_.evictions++;
+    entries_.erase(oldest);
+  }
+}
+
+}  // namespace txt
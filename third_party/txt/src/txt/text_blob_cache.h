@@ -0,0 +1,150 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TXT_TEXT_BLOB_CACHE_H_
+#define TXT_TEXT_BLOB_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace txt {
+
+// A process-wide cache of the text blobs built by paragraph layout, keyed on
+// the font and the positioned glyphs of each blob. The glyphs of a cached blob
+// are compared with those of its single run, so they are not copied.
+//
+// Text blobs are immutable, so a blob can be shared by every paint record that
+// draws the same glyphs at the same relative positions. Relaying out a
+// paragraph reuses the blobs of its unchanged runs, and runs repeated across
+// paragraphs, like list items and table cells, share a single blob. Sharing a
+// blob also lets Skia reuse what it cached for the blob on the GPU.
+//
+// The cache is split into shards keyed on the hash of the glyph run, like the
+// layout cache of minikin. Each shard has its own lock, least recently used
+// list and share of the budget, so that threads laying out paragraphs only
+// contend when their runs map to the same shard. The least recently used blobs
+// of a shard are evicted once the memory it uses exceeds its share of the
+// budget. All methods are thread safe.
+class TextBlobCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t budget = 0;
+  };
+
+  static constexpr size_t kDefaultBudget = 1 << 20;
+
+  static TextBlobCache& GetInstance();
+
+  explicit TextBlobCache(size_t budget = kDefaultBudget);
+
+  ~TextBlobCache();
+
+  // Returns a blob drawing |count| glyphs with |font| at the given positions,
+  // creating it if it is not cached yet.
+  sk_sp<SkTextBlob> GetOrCreate(const SkFont& font,
+                                const SkGlyphID* glyphs,
+                                const SkPoint* positions,
+                                size_t count);
+
+  // Sets the memory budget of the cache, in bytes. A budget of zero disables
+  // caching.
+  void SetBudget(size_t bytes);
+
+  void Purge();
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    size_t hash;
+    sk_sp<SkTextBlob> blob;
+
+    bool Matches(const SkFont& other_font,
+                 const SkGlyphID* other_glyphs,
+                 const SkPoint* other_positions,
+                 size_t count) const;
+
+    size_t GetMemoryUsage() const;
+  };
+
+  // A part of the cache guarded by its own lock.
+  class Shard {
+   public:
+    explicit Shard(size_t budget);
+
+    ~Shard();
+
+    // Returns the cached blob for the glyph run and marks it as the most
+    // recently used, or returns null.
+    sk_sp<SkTextBlob> Get(size_t hash,
+                          const SkFont& font,
+                          const SkGlyphID* glyphs,
+                          const SkPoint* positions,
+                          size_t count);
+
+    // Caches the blob of |entry|, unless another thread has cached a blob
+    // for the same glyph run in the meantime, in which case that blob is
+    // returned instead.
+    sk_sp<SkTextBlob> Put(Entry entry,
+                          const SkFont& font,
+                          const SkGlyphID* glyphs,
+                          const SkPoint* positions,
+                          size_t count);
+
+    void SetBudget(size_t bytes);
+
+    void Purge();
+
+    // Adds the counters of this shard to |stats|.
+    void AddStats(Stats* stats) const;
+
+   private:
+    using EntryList = std::list<Entry>;
+
+    mutable std::mutex mutex_;
+    // Entries ordered from the most to the least recently used.
+    EntryList entries_;
+    std::unordered_multimap<size_t, EntryList::iterator> index_;
+    size_t budget_;
+    Stats stats_;
+
+    // Must be called with the lock held.
+    sk_sp<SkTextBlob> Find(size_t hash,
+                           const SkFont& font,
+                           const SkGlyphID* glyphs,
+                           const SkPoint* positions,
+                           size_t count);
+
+    // Must be called with the lock held.
+    void TrimToBudget();
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Shard);
+  };
+
+  static constexpr size_t kShardCount = 16;
+
+  std::array<std::unique_ptr<Shard>, kShardCount> shards_;
+
+  Shard& GetShard(size_t hash) { return *shards_[hash % kShardCount]; }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextBlobCache);
+};
+
+}  // namespace txt
+
+#endif  // TXT_TEXT_BLOB_CACHE_H_
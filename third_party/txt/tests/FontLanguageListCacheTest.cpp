@@ -31,7 +31,6 @@ TEST_F(FontLanguageListCacheTest, getId) {
   EXPECT_NE(0UL, FontStyle::registerLanguageList("jp"));
   EXPECT_NE(0UL, FontStyle::registerLanguageList("en,zh-Hans"));
 
-  std::scoped_lock _l(gMinikinLock);
   EXPECT_EQ(0UL, FontLanguageListCache::getId(""));
 
   EXPECT_EQ(FontLanguageListCache::getId("en"),
@@ -52,7 +51,6 @@ TEST_F(FontLanguageListCacheTest, getId) {
 }
 
 TEST_F(FontLanguageListCacheTest, getById) {
-  std::scoped_lock _l(gMinikinLock);
   uint32_t enLangId = FontLanguageListCache::getId("en");
   uint32_t jpLangId = FontLanguageListCache::getId("jp");
   FontLanguage english = FontLanguageListCache::getById(enLangId)[0];
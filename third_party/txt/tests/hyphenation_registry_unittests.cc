@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/hyphenation_registry.h"
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/paths.h"
+#include "gtest/gtest.h"
+#include "txt_test_utils.h"
+
+namespace txt {
+namespace testing {
+
+TEST(HyphenationRegistryTest, ReturnsNullWithoutDictionary) {
+  HyphenationRegistry registry;
+  ASSERT_EQ(registry.GetHyphenator("en-US"), nullptr);
+  ASSERT_EQ(registry.GetHyphenator("en"), nullptr);
+}
+
+TEST(HyphenationRegistryTest, ReturnsNullForMissingPatternFile) {
+  HyphenationRegistry registry;
+  ASSERT_TRUE(registry.RegisterDictionary("en_US", "/does/not/exist.hyb"));
+  ASSERT_EQ(registry.GetHyphenator("en-US"), nullptr);
+  // A dictionary that failed to load can be registered again.
+  ASSERT_TRUE(registry.RegisterDictionary("en-US", "/does/not/exist.hyb"));
+}
+
+TEST(HyphenationRegistryTest, HyphenatesWithMappedPatternFile) {
+  fml::ScopedTemporaryDirectory directory;
+  ASSERT_TRUE(WriteTestHyphenationPatterns(directory.fd(), "en.hyb"));
+  HyphenationRegistry registry;
+  ASSERT_TRUE(registry.RegisterDictionary(
+      "en", fml::paths::JoinPaths({directory.path(), "en.hyb"})));
+
+  // The dictionary of the language is used for its regional locales.
+  minikin::Hyphenator* hyphenator = registry.GetHyphenator("en-US");
+  ASSERT_NE(hyphenator, nullptr);
+  ASSERT_EQ(registry.GetHyphenator("en"), hyphenator);
+  // A loaded dictionary is not replaced.
+  ASSERT_FALSE(registry.RegisterDictionary("en", "/does/not/exist.hyb"));
+
+  const uint16_t word[] = {'h', 'y', 'p', 'h', 'e', 'n'};
+  const size_t length = sizeof(word) / sizeof(word[0]);
+  std::vector<minikin::HyphenationType> result;
+  hyphenator->hyphenate(&result, word, length, icu::Locale::getUS());
+  ASSERT_EQ(result.size(), length);
+  for (size_t i = 0; i < length; i++) {
+    ASSERT_EQ(result[i], i == 2
+                             ? minikin::HyphenationType::BREAK_AND_INSERT_HYPHEN
+                             : minikin::HyphenationType::DONT_BREAK);
+  }
+
+  // Words with letters outside of the alphabet of the patterns are not
+  // hyphenated by them.
+  const uint16_t other_word[] = {'H', 'Y', 'P', 'H', 'E', 'N'};
+  hyphenator->hyphenate(&result, other_word, length, icu::Locale::getUS());
+  for (minikin::HyphenationType type : result) {
+    ASSERT_EQ(type, minikin::HyphenationType::DONT_BREAK);
+  }
+}
+
+TEST(HyphenationRegistryTest, HyphenatorMemoizesWords) {
+  std::unique_ptr<minikin::Hyphenator> hyphenator(
+      minikin::Hyphenator::loadBinary(nullptr, 2, 3));
+  const uint16_t word[] = {'h', 'y', 0x00AD, 'p', 'h', 'e', 'n'};
+  const size_t length = sizeof(word) / sizeof(word[0]);
+
+  std::vector<minikin::HyphenationType> first;
+  hyphenator->hyphenate(&first, word, length, icu::Locale::getUS());
+  ASSERT_EQ(first.size(), length);
+  ASSERT_EQ(first[3], minikin::HyphenationType::BREAK_AND_INSERT_HYPHEN);
+  ASSERT_EQ(hyphenator->getMemoizedWordCount(), 1u);
+
+  std::vector<minikin::HyphenationType> second;
+  hyphenator->hyphenate(&second, word, length, icu::Locale::getUS());
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(hyphenator->getMemoizedWordCount(), 1u);
+
+  // Hyphenation rules depend on the locale, so it is part of the key.
+  hyphenator->hyphenate(&second, word, length, icu::Locale::getFrench());
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(hyphenator->getMemoizedWordCount(), 2u);
+}
+
+}  // namespace testing
+}  // namespace txt
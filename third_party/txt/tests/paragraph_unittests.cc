@@ -16,17 +16,26 @@
 
 #include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
 
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/paths.h"
+#include "minikin/FontCollection.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "third_party/skia/include/core/SkPath.h"
 #include "txt/font_style.h"
 #include "txt/font_weight.h"
+#include "txt/hyphenation_registry.h"
+#include "txt/layout_cache.h"
 #include "txt/paragraph_builder_txt.h"
 #include "txt/paragraph_txt.h"
 #include "txt/placeholder_run.h"
+#include "txt/text_blob_cache.h"
 #include "txt_test_utils.h"
 
 #define DISABLE_ON_WINDOWS(TEST) DISABLE_TEST_WINDOWS(TEST)
@@ -73,6 +82,264 @@ TEST_F(ParagraphTest, SimpleParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, ConcurrentLayoutMatchesSerialLayout) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto font_collection = GetTestFontCollection();
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  const double width = GetTestCanvasWidth() / 3;
+  auto expected = build_paragraph();
+  expected->Layout(width);
+
+  // Lay out the same text on several threads sharing one font collection and
+  // the process-wide layout caches.
+  constexpr size_t kThreadCount = 4;
+  std::vector<std::unique_ptr<ParagraphTxt>> paragraphs;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    paragraphs.push_back(build_paragraph());
+  }
+  std::vector<std::thread> threads;
+  for (auto& paragraph : paragraphs) {
+    threads.emplace_back([&paragraph, width]() {
+      for (int i = 0; i < 50; i++) {
+        paragraph->SetDirty();
+        paragraph->Layout(width);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& paragraph : paragraphs) {
+    EXPECT_EQ(paragraph->GetLineCount(), expected->GetLineCount());
+    EXPECT_DOUBLE_EQ(paragraph->GetLongestLine(), expected->GetLongestLine());
+    EXPECT_DOUBLE_EQ(paragraph->GetHeight(), expected->GetHeight());
+  }
+}
+
+TEST_F(ParagraphTest, RelayoutAtNewWidthMatchesFreshLayout) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line.\nSometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  // Changing only the width reuses the measurements of the previous layout.
+  auto paragraph = build_paragraph();
+  const double widths[] = {GetTestCanvasWidth(), 200, 350, 200};
+  for (double width : widths) {
+    paragraph->Layout(width);
+
+    auto expected = build_paragraph();
+    expected->Layout(width);
+    ASSERT_EQ(paragraph->GetLineCount(), expected->GetLineCount());
+    for (size_t i = 0; i < expected->line_metrics_.size(); i++) {
+      EXPECT_EQ(paragraph->line_metrics_[i].end_index,
+                expected->line_metrics_[i].end_index);
+    }
+    EXPECT_DOUBLE_EQ(paragraph->GetLongestLine(), expected->GetLongestLine());
+    EXPECT_DOUBLE_EQ(paragraph->GetMaxIntrinsicWidth(),
+                     expected->GetMaxIntrinsicWidth());
+    EXPECT_DOUBLE_EQ(paragraph->GetHeight(), expected->GetHeight());
+  }
+}
+
+TEST_F(ParagraphTest, LayoutCacheStaysWithinBudget) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+
+  const size_t default_budget = minikin::Layout::getCacheStats().budget;
+  constexpr size_t kBudget = 64 * 1024;
+  SetLayoutCacheBudget(kBudget);
+  PurgeLayoutCache();
+
+  paragraph->Layout(GetTestCanvasWidth());
+  minikin::LayoutCacheStats first = minikin::Layout::getCacheStats();
+  EXPECT_GT(first.entries, 0u);
+  EXPECT_LE(first.bytes, kBudget);
+
+  // Laying out the same words again is served by the cache.
+  paragraph->SetDirty();
+  paragraph->Layout(GetTestCanvasWidth());
+  minikin::LayoutCacheStats second = minikin::Layout::getCacheStats();
+  EXPECT_GT(second.hits, first.hits);
+  EXPECT_EQ(second.misses, first.misses);
+  EXPECT_EQ(second.entries, first.entries);
+
+  // Shrinking the budget evicts words.
+  SetLayoutCacheBudget(0);
+  minikin::LayoutCacheStats empty = minikin::Layout::getCacheStats();
+  EXPECT_EQ(empty.entries, 0u);
+  EXPECT_EQ(empty.bytes, 0u);
+  EXPECT_GE(empty.evictions, second.evictions + second.entries);
+
+  SetLayoutCacheBudget(default_budget);
+}
+
+TEST_F(ParagraphTest, AsciiLineBreaksMatchIcu) {
+  // The first text is broken without ICU. The second differs only by an
+  // accent on the last letter, which makes the line breaker fall back to ICU.
+  const char* ascii_text =
+      "Don't stop: it's 12 o'clock, \"almost\" done. Next; up  double e";
+  const char* icu_text =
+      "Don't stop: it's 12 o'clock, \"almost\" done. Next; up  double \u00e9";
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto layout = [&](const char* text) {
+    auto icu_string = icu::UnicodeString::fromUTF8(text);
+    std::u16string u16_text(icu_string.getBuffer(),
+                            icu_string.getBuffer() + icu_string.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(120);
+    return paragraph;
+  };
+  auto ascii_paragraph = layout(ascii_text);
+  auto icu_paragraph = layout(icu_text);
+
+  std::vector<LineMetrics>& ascii_lines = ascii_paragraph->GetLineMetrics();
+  std::vector<LineMetrics>& icu_lines = icu_paragraph->GetLineMetrics();
+  ASSERT_GT(ascii_lines.size(), 3ull);
+  ASSERT_EQ(ascii_lines.size(), icu_lines.size());
+  for (size_t i = 0; i < ascii_lines.size(); i++) {
+    EXPECT_EQ(ascii_lines[i].start_index, icu_lines[i].start_index);
+    EXPECT_EQ(ascii_lines[i].end_index, icu_lines[i].end_index);
+  }
+}
+
+TEST_F(ParagraphTest, RepeatedRunsShareTextBlobs) {
+  const char* text = "List item";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto build = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+  auto first = build();
+  auto second = build();
+
+  TextBlobCache::GetInstance().Purge();
+  first->Layout(GetTestCanvasWidth());
+  TextBlobCache::Stats before = TextBlobCache::GetInstance().GetStats();
+  second->Layout(GetTestCanvasWidth());
+  TextBlobCache::Stats after = TextBlobCache::GetInstance().GetStats();
+
+  ASSERT_EQ(first->records_.size(), 1ull);
+  ASSERT_EQ(second->records_.size(), 1ull);
+  EXPECT_EQ(first->records_[0].text(), second->records_[0].text());
+  EXPECT_EQ(after.hits, before.hits + 1);
+  EXPECT_EQ(after.misses, before.misses);
+
+  // A different color draws the same glyphs, so the blob is still shared.
+  text_style.color = SK_ColorRED;
+  auto red = build();
+  red->Layout(GetTestCanvasWidth());
+  ASSERT_EQ(red->records_.size(), 1ull);
+  EXPECT_EQ(first->records_[0].text(), red->records_[0].text());
+
+  // A different size does not.
+  text_style.font_size = 20;
+  auto larger = build();
+  larger->Layout(GetTestCanvasWidth());
+  ASSERT_EQ(larger->records_.size(), 1ull);
+  EXPECT_NE(first->records_[0].text(), larger->records_[0].text());
+}
+
+TEST_F(ParagraphTest, ItemizeLatin1UsesSingleRun) {
+  auto collection =
+      GetTestFontCollection()->GetMinikinFontCollectionForFamilies(
+          {"Roboto", "Noto Sans CJK JP"}, "en-US");
+  minikin::FontStyle style;
+
+  auto latin_text = icu::UnicodeString::fromUTF8(
+      "Caf\u00e9 na\u00efve, \u00bfqu\u00e9? 12.5\u00b0 \u00a9 "
+      "soft\u00adhyphen");
+  std::vector<minikin::FontCollection::Run> runs;
+  collection->itemize(latin_text.getBuffer(), latin_text.length(), style,
+                      &runs);
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0].start, 0);
+  EXPECT_EQ(runs[0].end, latin_text.length());
+
+  // Characters outside of Latin-1 still split the text into runs.
+  auto mixed_text = icu::UnicodeString::fromUTF8("Hello \u65e5\u672c world");
+  runs.clear();
+  collection->itemize(mixed_text.getBuffer(), mixed_text.length(), style,
+                      &runs);
+  ASSERT_EQ(runs.size(), 3u);
+  EXPECT_EQ(runs[0].end, 6);
+  EXPECT_EQ(runs[1].start, 6);
+  EXPECT_EQ(runs[1].end, 8);
+  EXPECT_NE(runs[0].fakedFont.font, runs[1].fakedFont.font);
+  EXPECT_EQ(runs[0].fakedFont.font, runs[2].fakedFont.font);
+}
+
 TEST_F(ParagraphTest, SimpleParagraphSmall) {
   const char* text =
       "Hello World Text Dialog. This is a very small text in order to check "
@@ -7117,4 +7384,56 @@ TEST_F(ParagraphTest, MixedTextHeightBehaviorRectsParagraph) {
 
   ASSERT_TRUE(Snapshot());
 }
+
+TEST_F(ParagraphTest, HyphenatedParagraph) {
+  fml::ScopedTemporaryDirectory directory;
+  ASSERT_TRUE(WriteTestHyphenationPatterns(directory.fd(), "en.hyb"));
+  HyphenationRegistry::GetInstance().RegisterDictionary(
+      "en-ZZ", fml::paths::JoinPaths({directory.path(), "en.hyb"}));
+
+  auto build_paragraph = [](const std::u16string& text, bool hyphenate) {
+    txt::ParagraphStyle paragraph_style;
+    paragraph_style.locale = "en-ZZ";
+    paragraph_style.hyphenate = hyphenate;
+    txt::ParagraphBuilderTxt builder(paragraph_style,
+                                     GetTestFontCollection());
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.font_size = 50;
+    text_style.color = SK_ColorBLACK;
+    builder.PushStyle(text_style);
+    builder.AddText(text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  // Without hyphenation, a word that does not fit is broken where the line
+  // is full.
+  auto paragraph = build_paragraph(u"hyphen", false);
+  paragraph->Layout(GetTestCanvasWidth());
+  const double word_width = paragraph->GetMaxIntrinsicWidth();
+  paragraph->Layout(word_width - 1);
+  ASSERT_EQ(paragraph->GetLineCount(), 2ull);
+  ASSERT_EQ(paragraph->line_metrics_[0].end_index, 5ull);
+  ASSERT_EQ(paragraph->line_hyphen_edits_[0], minikin::HyphenEdit::NO_EDIT);
+
+  // With hyphenation, it is broken as "hy-phen", and the first line ends
+  // with a hyphen.
+  paragraph = build_paragraph(u"hyphen", true);
+  paragraph->Layout(word_width - 1);
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_EQ(paragraph->GetLineCount(), 2ull);
+  ASSERT_EQ(paragraph->line_metrics_[0].end_index, 2ull);
+  ASSERT_EQ(paragraph->line_hyphen_edits_[0],
+            minikin::HyphenEdit::INSERT_HYPHEN_AT_END);
+  ASSERT_EQ(paragraph->line_hyphen_edits_[1], minikin::HyphenEdit::NO_EDIT);
+
+  // The width of the first line includes the hyphen.
+  auto prefix = build_paragraph(u"hy", true);
+  prefix->Layout(GetTestCanvasWidth());
+  ASSERT_GT(paragraph->GetLineMetrics()[0].width,
+            prefix->GetMaxIntrinsicWidth());
+
+  ASSERT_TRUE(Snapshot());
+}
 }  // namespace txt
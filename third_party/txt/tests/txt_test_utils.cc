@@ -16,8 +16,12 @@
 
 #include "txt_test_utils.h"
 
+#include <cstring>
 #include <sstream>
+#include <vector>
 
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "txt/asset_font_manager.h"
 #include "txt/typeface_font_asset_provider.h"
@@ -127,4 +131,44 @@ std::unique_ptr<ParagraphTxt> BuildParagraph(
       static_cast<txt::ParagraphTxt*>(builder.Build().release()));
 }
 
+bool WriteTestHyphenationPatterns(const fml::UniqueFD& directory,
+                                  const std::string& file_name) {
+  // Header: magic, version, offsets of the alphabet, trie and pattern tables,
+  // and the file size.
+  std::vector<uint32_t> words = {0x62ad7968, 0, 24, 64, 472, 500};
+
+  // Alphabet: version, and the first and past the last code point, followed
+  // by the code of each letter.
+  words.insert(words.end(), {0, 'a', 'z' + 1});
+  std::vector<uint8_t> codes(28);
+  for (uint8_t letter = 0; letter < 26; letter++) {
+    codes[letter] = letter + 1;
+  }
+  words.resize(words.size() + codes.size() / sizeof(uint32_t));
+  std::memcpy(&words[words.size() - codes.size() / sizeof(uint32_t)],
+              codes.data(), codes.size());
+
+  // Trie: version, character and link masks and shifts, pattern shift and
+  // entry count. The root links "y" to node 32, which links "p" to node 64,
+  // the node of the only pattern.
+  const uint32_t y = 'y' - 'a' + 1;
+  const uint32_t p = 'p' - 'a' + 1;
+  std::vector<uint32_t> trie(96);
+  trie[y] = y | (32 << 5);
+  trie[32 + p] = p | (64 << 5);
+  trie[64] = 1 << 16;
+  words.insert(words.end(), {0, 0x1f, 5, 0xffe0, 16, 96});
+  words.insert(words.end(), trie.begin(), trie.end());
+
+  // Patterns: version, entry count, and offset and size of the values. The
+  // pattern "y1p" is stored as the values 0 and 1 followed by one zero.
+  words.insert(words.end(), {0, 2, 24, 2, 0, (2u << 26) | (1u << 20)});
+  words.push_back(0x0100);
+
+  std::vector<uint8_t> file(words.size() * sizeof(uint32_t));
+  std::memcpy(file.data(), words.data(), file.size());
+  return fml::WriteAtomically(directory, file_name.c_str(),
+                              fml::DataMapping(std::move(file)));
+}
+
 }  // namespace txt
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "flutter/fml/command_line.h"
+#include "flutter/fml/unique_fd.h"
 #include "txt/font_collection.h"
 #include "txt/paragraph_builder_txt.h"
 #include "txt/paragraph_txt.h"
@@ -35,4 +36,11 @@ std::shared_ptr<FontCollection> GetTestFontCollection();
 
 std::unique_ptr<ParagraphTxt> BuildParagraph(ParagraphBuilderTxt& builder);
 
+// Writes the hyphenation patterns of a test dictionary to |file_name| in
+// |directory|, in the format read by minikin::Hyphenator::loadBinary. The
+// dictionary only hyphenates lowercase latin words, between a "y" and a
+// following "p", so that "hyphen" is hyphenated as "hy-phen".
+bool WriteTestHyphenationPatterns(const fml::UniqueFD& directory,
+                                  const std::string& file_name);
+
 }  // namespace txt